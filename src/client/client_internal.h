@@ -83,6 +83,9 @@ struct daos_event_private {
 	tse_sched_t		*evx_sched;
 };
 
+/** event is completed through the ring of its EQ, see daos_eq_ring */
+#define EVX_F_RING	(1U << 0)
+
 static inline struct daos_event_private *
 daos_ev2evx(struct daos_event *ev)
 {
@@ -95,18 +98,55 @@ daos_evx2ev(struct daos_event_private *evx)
 	return container_of(evx, struct daos_event, ev_private);
 }
 
+/**
+ * Environment variable to create EQs with a completion ring of this many
+ * slots (rounded up to power of 2), zero or unset means no ring.
+ */
+#define DAOS_EQ_RING_ENV	"DAOS_EQ_RING"
+
+struct daos_eq_ring_slot {
+	/** sequence number for producer and consumer to claim the slot */
+	uint64_t			 rs_seq;
+	struct daos_event_private	*rs_evx;
+};
+
+/**
+ * Bounded MPMC ring of completed events. Top-level events without children
+ * of an EQ with ring are launched and completed without taking the EQ lock,
+ * completion pushes the event to the ring, and poll drains it in batch.
+ * These events aren't on eq_running/eq_comp, so daos_eq_query() can only
+ * count them. Completions which can't fit in the ring are added to eq_comp
+ * under the lock as usual.
+ */
+struct daos_eq_ring {
+	uint64_t			 er_mask;
+	/** next slot to be consumed */
+	uint64_t			 er_head __attribute__((aligned(64)));
+	/** next slot to be produced */
+	uint64_t			 er_tail __attribute__((aligned(64)));
+	struct daos_eq_ring_slot	 er_slots[0];
+};
+
 struct daos_eq_private {
 	/* link chain in the global hash list */
 	struct d_hlink		eqx_hlink;
 	pthread_mutex_t		eqx_lock;
-	unsigned int		eqx_lock_init:1,
-				eqx_finalizing:1;
+	unsigned int		eqx_lock_init:1;
+	/** set (atomically) when the EQ is being destroyed */
+	int			eqx_finalizing;
 
 	/* CRT context associated with this eq */
 	crt_context_t		eqx_ctx;
 
 	/* Scheduler associated with this EQ */
 	tse_sched_t		eqx_sched;
+
+	/** completion ring, NULL if the EQ has no ring */
+	struct daos_eq_ring	*eqx_ring;
+	/** # events launched through the ring and not completed yet */
+	int			eqx_ring_running;
+	/** # events in the ring which haven't been polled */
+	int			eqx_ring_comp;
 };
 
 static inline struct daos_eq_private *
@@ -77,6 +77,15 @@ static unsigned int eq_ref;
  */
 static tse_sched_t daos_sched_g;
 
+/** generation of EQ handles, see eq_tls_cache */
+static uint64_t eq_tls_gen;
+
+static void
+eq_tls_gen_bump(void)
+{
+	__atomic_fetch_add(&eq_tls_gen, 1, __ATOMIC_RELEASE);
+}
+
 int
 daos_eq_lib_init()
 {
@@ -156,6 +165,8 @@ daos_eq_lib_fini()
 	}
 
 	eq_ref = 0;
+	/* handles of the next initialization could match cached ones */
+	eq_tls_gen_bump();
 unlock:
 	D_MUTEX_UNLOCK(&daos_eq_lock);
 	return rc;
@@ -178,6 +189,8 @@ daos_eq_free(struct d_hlink *hlink)
 	if (eqx->eqx_lock_init)
 		D_MUTEX_DESTROY(&eqx->eqx_lock);
 
+	if (eqx->eqx_ring != NULL)
+		D_FREE(eqx->eqx_ring);
 	D_FREE_PTR(eq);
 }
 
@@ -185,13 +198,34 @@ struct d_hlink_ops	eq_h_ops = {
 	.hop_free	= daos_eq_free,
 };
 
+static struct daos_eq_ring *
+daos_eq_ring_alloc(unsigned int depth)
+{
+	struct daos_eq_ring	*ring;
+	uint64_t		 nr;
+	uint64_t		 i;
+
+	for (nr = 1; nr < depth; nr <<= 1)
+		;
+
+	D_ALLOC(ring, sizeof(*ring) + nr * sizeof(ring->er_slots[0]));
+	if (ring == NULL)
+		return NULL;
+
+	ring->er_mask = nr - 1;
+	for (i = 0; i < nr; i++)
+		ring->er_slots[i].rs_seq = i;
+	return ring;
+}
+
 static struct daos_eq *
-daos_eq_alloc(void)
+daos_eq_alloc(unsigned int ring_depth)
 {
 	struct daos_eq		*eq;
 	struct daos_eq_private	*eqx;
 	int			rc;
 
+	D_CASSERT(sizeof(eq->eq_private) >= sizeof(*eqx));
 	D_ALLOC_PTR(eq);
 	if (eq == NULL)
 		return NULL;
@@ -208,6 +242,12 @@ daos_eq_alloc(void)
 		goto out;
 	eqx->eqx_lock_init = 1;
 
+	if (ring_depth != 0) {
+		eqx->eqx_ring = daos_eq_ring_alloc(ring_depth);
+		if (eqx->eqx_ring == NULL)
+			goto out;
+	}
+
 	daos_hhash_hlink_init(&eqx->eqx_hlink, &eq_h_ops);
 	return eq;
 out:
@@ -251,6 +291,160 @@ daos_eq_handle(struct daos_eq_private *eqx, daos_handle_t *h)
 	daos_hhash_link_key(&eqx->eqx_hlink, &h->cookie);
 }
 
+/** max number of EQs cached by each thread */
+#define EQ_TLS_CACHE_NR		4
+
+struct eq_tls_ent {
+	uint64_t		 cookie;
+	struct daos_eq_private	*eqx;
+};
+
+/**
+ * Per-thread cache of EQs with completion ring, so launching, completing and
+ * polling their events don't look up the global handle hash.
+ *
+ * The cache doesn't hold reference of EQ, the handle hash holds it until the
+ * EQ is destroyed. Each EQ destroy and the final daos_eq_lib_fini() bump
+ * \a eq_tls_gen, a thread drops all cached EQs once it sees a new generation,
+ * so it never touches an EQ which could have been freed. Using an EQ while
+ * another thread is destroying it is not allowed by the API anyway.
+ */
+static __thread struct eq_tls_ent	eq_tls_cache[EQ_TLS_CACHE_NR];
+static __thread unsigned int		eq_tls_next;
+/** generation of the EQs cached by this thread */
+static __thread uint64_t		eq_tls_cache_gen;
+
+/** look up EQ, the returned EQ should be released by daos_eq_release() */
+static struct daos_eq_private *
+daos_eq_acquire(daos_handle_t eqh)
+{
+	struct daos_eq_private	*eqx;
+	uint64_t		 gen;
+	int			 i;
+
+	gen = __atomic_load_n(&eq_tls_gen, __ATOMIC_ACQUIRE);
+	if (gen != eq_tls_cache_gen) {
+		memset(eq_tls_cache, 0, sizeof(eq_tls_cache));
+		eq_tls_cache_gen = gen;
+	} else {
+		for (i = 0; i < EQ_TLS_CACHE_NR; i++) {
+			if (eq_tls_cache[i].eqx != NULL &&
+			    eq_tls_cache[i].cookie == eqh.cookie)
+				return eq_tls_cache[i].eqx;
+		}
+	}
+
+	eqx = daos_eq_lookup(eqh);
+	if (eqx == NULL || eqx->eqx_ring == NULL)
+		return eqx;
+
+	/* the handle hash holds reference of the EQ until it's destroyed */
+	daos_eq_putref(eqx);
+	i = eq_tls_next++ % EQ_TLS_CACHE_NR;
+	eq_tls_cache[i].cookie = eqh.cookie;
+	eq_tls_cache[i].eqx = eqx;
+	return eqx;
+}
+
+static void
+daos_eq_release(struct daos_eq_private *eqx)
+{
+	/* EQ with ring is from the thread cache, no reference is held */
+	if (eqx->eqx_ring == NULL)
+		daos_eq_putref(eqx);
+}
+
+/**
+ * Push a completed event to the ring, status of the event is changed to
+ * COMPLETED before it can be seen by consumers.
+ *
+ * \return	0 on success, -DER_AGAIN if the ring is full
+ */
+static int
+daos_eq_ring_push(struct daos_eq_ring *ring, struct daos_event_private *evx)
+{
+	struct daos_eq_ring_slot	*slot;
+	uint64_t			 pos;
+	int64_t				 dif;
+
+	pos = __atomic_load_n(&ring->er_tail, __ATOMIC_RELAXED);
+	for (;;) {
+		slot = &ring->er_slots[pos & ring->er_mask];
+		dif = __atomic_load_n(&slot->rs_seq, __ATOMIC_ACQUIRE) - pos;
+		if (dif == 0) {
+			/* pos is reloaded on failure */
+			if (__atomic_compare_exchange_n(&ring->er_tail, &pos,
+							pos + 1, true,
+							__ATOMIC_RELAXED,
+							__ATOMIC_RELAXED))
+				break;
+		} else if (dif < 0) {
+			return -DER_AGAIN;
+		} else {
+			pos = __atomic_load_n(&ring->er_tail, __ATOMIC_RELAXED);
+		}
+	}
+
+	slot->rs_evx = evx;
+	evx->evx_status = DAOS_EVS_COMPLETED;
+	__atomic_store_n(&slot->rs_seq, pos + 1, __ATOMIC_RELEASE);
+	return 0;
+}
+
+/** pop a completed event from the ring, NULL if the ring is empty */
+static struct daos_event_private *
+daos_eq_ring_pop(struct daos_eq_ring *ring)
+{
+	struct daos_eq_ring_slot	*slot;
+	struct daos_event_private	*evx;
+	uint64_t			 pos;
+	int64_t				 dif;
+
+	pos = __atomic_load_n(&ring->er_head, __ATOMIC_RELAXED);
+	for (;;) {
+		slot = &ring->er_slots[pos & ring->er_mask];
+		dif = __atomic_load_n(&slot->rs_seq, __ATOMIC_ACQUIRE) -
+		      (pos + 1);
+		if (dif == 0) {
+			if (__atomic_compare_exchange_n(&ring->er_head, &pos,
+							pos + 1, true,
+							__ATOMIC_RELAXED,
+							__ATOMIC_RELAXED))
+				break;
+		} else if (dif < 0) {
+			return NULL;
+		} else {
+			pos = __atomic_load_n(&ring->er_head, __ATOMIC_RELAXED);
+		}
+	}
+
+	evx = slot->rs_evx;
+	__atomic_store_n(&slot->rs_seq, pos + ring->er_mask + 1,
+			 __ATOMIC_RELEASE);
+	return evx;
+}
+
+/**
+ * Move all events in the ring to eq_comp, so they can be found by the slow
+ * paths (test, query, fini and destroy). The caller should hold eqx_lock.
+ */
+static void
+daos_eq_ring_flush(struct daos_eq_private *eqx)
+{
+	struct daos_eq			*eq = daos_eqx2eq(eqx);
+	struct daos_event_private	*evx;
+
+	if (eqx->eqx_ring == NULL)
+		return;
+
+	while ((evx = daos_eq_ring_pop(eqx->eqx_ring)) != NULL) {
+		evx->evx_flags &= ~EVX_F_RING;
+		d_list_add_tail(&evx->evx_link, &eq->eq_comp);
+		eq->eq_n_comp++;
+		__atomic_sub_fetch(&eqx->eqx_ring_comp, 1, __ATOMIC_RELAXED);
+	}
+}
+
 static void
 daos_event_launch_locked(struct daos_eq_private *eqx,
 			 struct daos_event_private *evx)
@@ -391,6 +585,50 @@ daos_event_complete_locked(struct daos_eq_private *eqx,
 	return 0;
 }
 
+/** launch top-level event without child through the ring, no lock */
+static int
+daos_event_launch_ring(struct daos_eq_private *eqx,
+		       struct daos_event_private *evx)
+{
+	/* NB: pairs with daos_eq_destroy(), which sets eqx_finalizing
+	 * before checking eqx_ring_running.
+	 */
+	__atomic_add_fetch(&eqx->eqx_ring_running, 1, __ATOMIC_SEQ_CST);
+	if (__atomic_load_n(&eqx->eqx_finalizing, __ATOMIC_SEQ_CST)) {
+		__atomic_sub_fetch(&eqx->eqx_ring_running, 1,
+				   __ATOMIC_RELAXED);
+		D_ERROR("Event queue is in progress of finalizing\n");
+		return -DER_NONEXIST;
+	}
+
+	evx->evx_flags |= EVX_F_RING;
+	evx->evx_status = DAOS_EVS_RUNNING;
+	return 0;
+}
+
+static void
+daos_event_complete_ring(struct daos_eq_private *eqx,
+			 struct daos_event_private *evx, int rc)
+{
+	struct daos_eq	*eq = daos_eqx2eq(eqx);
+
+	rc = daos_event_complete_cb(evx, rc);
+	daos_evx2ev(evx)->ev_error = rc;
+
+	__atomic_add_fetch(&eqx->eqx_ring_comp, 1, __ATOMIC_RELAXED);
+	if (daos_eq_ring_push(eqx->eqx_ring, evx) != 0) {
+		/* the ring is full, fall back to eq_comp */
+		__atomic_sub_fetch(&eqx->eqx_ring_comp, 1, __ATOMIC_RELAXED);
+		D_MUTEX_LOCK(&eqx->eqx_lock);
+		evx->evx_flags &= ~EVX_F_RING;
+		evx->evx_status = DAOS_EVS_COMPLETED;
+		d_list_add_tail(&evx->evx_link, &eq->eq_comp);
+		eq->eq_n_comp++;
+		D_MUTEX_UNLOCK(&eqx->eqx_lock);
+	}
+	__atomic_sub_fetch(&eqx->eqx_ring_running, 1, __ATOMIC_RELEASE);
+}
+
 int
 daos_event_launch(struct daos_event *ev)
 {
@@ -409,14 +647,22 @@ daos_event_launch(struct daos_event *ev)
 		goto out;
 	}
 
+	evx->evx_flags &= ~EVX_F_RING;
 	if (!daos_handle_is_inval(evx->evx_eqh)) {
-		eqx = daos_eq_lookup(evx->evx_eqh);
+		eqx = daos_eq_acquire(evx->evx_eqh);
 		if (eqx == NULL) {
 			D_ERROR("Can't find eq from handle %"PRIu64"\n",
 				evx->evx_eqh.cookie);
 			return -DER_NONEXIST;
 		}
 
+		if (eqx->eqx_ring != NULL && evx->evx_parent == NULL &&
+		    evx->evx_nchild == 0) {
+			rc = daos_event_launch_ring(eqx, evx);
+			daos_eq_release(eqx);
+			return rc;
+		}
+
 		D_MUTEX_LOCK(&eqx->eqx_lock);
 		if (eqx->eqx_finalizing) {
 			D_ERROR("Event queue is in progress of finalizing\n");
@@ -441,7 +687,7 @@ daos_event_launch(struct daos_event *ev)
 		D_MUTEX_UNLOCK(&eqx->eqx_lock);
 
 	if (eqx != NULL)
-		daos_eq_putref(eqx);
+		daos_eq_release(eqx);
 
 	return rc;
 }
@@ -472,9 +718,16 @@ daos_event_complete(struct daos_event *ev, int rc)
 	struct daos_eq_private		*eqx = NULL;
 
 	if (!daos_handle_is_inval(evx->evx_eqh)) {
-		eqx = daos_eq_lookup(evx->evx_eqh);
+		eqx = daos_eq_acquire(evx->evx_eqh);
 		D_ASSERT(eqx != NULL);
 
+		if (evx->evx_flags & EVX_F_RING) {
+			D_ASSERT(evx->evx_status == DAOS_EVS_RUNNING ||
+				 evx->evx_status == DAOS_EVS_ABORTED);
+			daos_event_complete_ring(eqx, evx, rc);
+			daos_eq_release(eqx);
+			return;
+		}
 		D_MUTEX_LOCK(&eqx->eqx_lock);
 	}
 
@@ -487,7 +740,7 @@ daos_event_complete(struct daos_event *ev, int rc)
 		D_MUTEX_UNLOCK(&eqx->eqx_lock);
 
 	if (eqx != NULL)
-		daos_eq_putref(eqx);
+		daos_eq_release(eqx);
 }
 
 struct ev_progress_arg {
@@ -540,6 +793,16 @@ ev_progress_cb(void *arg)
 		return 1;
 	}
 
+	/* the event may be in the ring, move it to eq_comp */
+	if (evx->evx_flags & EVX_F_RING) {
+		daos_eq_ring_flush(eqx);
+		/* still running, or not published to the ring yet */
+		if (evx->evx_flags & EVX_F_RING) {
+			D_MUTEX_UNLOCK(&eqx->eqx_lock);
+			return 0;
+		}
+	}
+
 	/*
 	 * Check again if the event is still in completed/aborted state, then
 	 * remove it from the event queue.
@@ -575,7 +838,7 @@ daos_event_test(struct daos_event *ev, int64_t timeout, bool *flag)
 	epa.eqx = NULL;
 
 	if (!daos_handle_is_inval(evx->evx_eqh)) {
-		epa.eqx = daos_eq_lookup(evx->evx_eqh);
+		epa.eqx = daos_eq_acquire(evx->evx_eqh);
 		if (epa.eqx == NULL) {
 			D_ERROR("Can't find eq from handle %"PRIu64"\n",
 				evx->evx_eqh.cookie);
@@ -586,9 +849,9 @@ daos_event_test(struct daos_event *ev, int64_t timeout, bool *flag)
 	/* pass the timeout to crt_progress() with a conditional callback */
 	rc = crt_progress(evx->evx_ctx, timeout, ev_progress_cb, &epa);
 
-	/** drop ref grabbed in daos_eq_lookup() */
+	/** drop ref grabbed in daos_eq_acquire() */
 	if (epa.eqx)
-		daos_eq_putref(epa.eqx);
+		daos_eq_release(epa.eqx);
 
 	if (rc != 0 && rc != -DER_TIMEDOUT) {
 		D_ERROR("crt progress failed with %d\n", rc);
@@ -608,13 +871,19 @@ daos_eq_create(daos_handle_t *eqh)
 {
 	struct daos_eq_private	*eqx;
 	struct daos_eq		*eq;
+	unsigned int		 ring_depth = 0;
+	char			*env;
 	int			 rc = 0;
 
 	/** not thread-safe, but best effort */
 	if (eq_ref == 0)
 		return -DER_UNINIT;
 
-	eq = daos_eq_alloc();
+	env = getenv(DAOS_EQ_RING_ENV);
+	if (env != NULL)
+		ring_depth = strtoul(env, NULL, 0);
+
+	eq = daos_eq_alloc(ring_depth);
 	if (eq == NULL)
 		return -DER_NOMEM;
 
@@ -637,6 +906,51 @@ struct eq_progress_arg {
 	int			  count;
 };
 
+/** no event is running or waiting to be polled in the ring */
+static bool
+eq_ring_idle(struct daos_eq_private *eqx)
+{
+	return __atomic_load_n(&eqx->eqx_ring_running, __ATOMIC_ACQUIRE) == 0 &&
+	       __atomic_load_n(&eqx->eqx_ring_comp, __ATOMIC_ACQUIRE) == 0;
+}
+
+/**
+ * Poll completed events from the ring without taking the EQ lock.
+ *
+ * \return	1 if polling is done, 0 to continue with eq_comp.
+ */
+static int
+eq_progress_ring(struct eq_progress_arg *epa)
+{
+	struct daos_eq_private		*eqx = epa->eqx;
+	struct daos_eq			*eq = daos_eqx2eq(eqx);
+	struct daos_event_private	*evx;
+	int				 n_comp;
+
+	while (epa->count < epa->n_events) {
+		evx = daos_eq_ring_pop(eqx->eqx_ring);
+		if (evx == NULL)
+			break;
+
+		__atomic_sub_fetch(&eqx->eqx_ring_comp, 1, __ATOMIC_RELAXED);
+		evx->evx_flags &= ~EVX_F_RING;
+		evx->evx_status = DAOS_EVS_READY;
+		if (epa->events != NULL)
+			epa->events[epa->count++] = daos_evx2ev(evx);
+	}
+
+	if (epa->count == epa->n_events)
+		return 1;
+
+	/* NB: racy read, the locked path catches up in the next round */
+	n_comp = __atomic_load_n(&eq->eq_n_comp, __ATOMIC_RELAXED);
+	if (n_comp != 0 ||
+	    __atomic_load_n(&eqx->eqx_finalizing, __ATOMIC_ACQUIRE))
+		return 0;
+
+	return epa->count > 0 ? 1 : 0;
+}
+
 static int
 eq_progress_cb(void *arg)
 {
@@ -650,6 +964,24 @@ eq_progress_cb(void *arg)
 
 	tse_sched_progress(&epa->eqx->eqx_sched);
 
+	if (epa->eqx->eqx_ring != NULL) {
+		if (eq_progress_ring(epa))
+			return 1;
+
+		/* nothing to poll, skip the lock unless events are in
+		 * eq_comp, or the EQ is being destroyed.
+		 */
+		if (__atomic_load_n(&eq->eq_n_comp, __ATOMIC_RELAXED) == 0 &&
+		    !__atomic_load_n(&epa->eqx->eqx_finalizing,
+				     __ATOMIC_ACQUIRE)) {
+			if (epa->wait_running && eq_ring_idle(epa->eqx) &&
+			    __atomic_load_n(&eq->eq_n_running,
+					    __ATOMIC_RELAXED) == 0)
+				return 1;
+			return 0;
+		}
+	}
+
 	D_MUTEX_LOCK(&epa->eqx->eqx_lock);
 	d_list_for_each_entry_safe(evx, tmp, &eq->eq_comp, evx_link) {
 		D_ASSERT(eq->eq_n_comp > 0);
@@ -689,7 +1021,8 @@ eq_progress_cb(void *arg)
 	}
 
 	/* wait only if there are running events? */
-	if (epa->wait_running && d_list_empty(&eq->eq_running)) {
+	if (epa->wait_running && d_list_empty(&eq->eq_running) &&
+	    (epa->eqx->eqx_ring == NULL || eq_ring_idle(epa->eqx))) {
 		D_MUTEX_UNLOCK(&epa->eqx->eqx_lock);
 		return 1;
 	}
@@ -711,7 +1044,7 @@ daos_eq_poll(daos_handle_t eqh, int wait_running, int64_t timeout,
 		return -DER_INVAL;
 
 	/** look up private eq */
-	epa.eqx = daos_eq_lookup(eqh);
+	epa.eqx = daos_eq_acquire(eqh);
 	if (epa.eqx == NULL)
 		return -DER_NONEXIST;
 
@@ -723,8 +1056,8 @@ daos_eq_poll(daos_handle_t eqh, int wait_running, int64_t timeout,
 	/* pass the timeout to crt_progress() with a conditional callback */
 	rc = crt_progress(epa.eqx->eqx_ctx, timeout, eq_progress_cb, &epa);
 
-	/* drop ref grabbed in daos_eq_lookup() */
-	daos_eq_putref(epa.eqx);
+	/* drop ref grabbed in daos_eq_acquire() */
+	daos_eq_release(epa.eqx);
 
 	if (rc != 0 && rc != -DER_TIMEDOUT) {
 		D_ERROR("crt progress failed with %d\n", rc);
@@ -752,13 +1085,16 @@ daos_eq_query(daos_handle_t eqh, daos_eq_query_t query,
 
 	count = 0;
 	D_MUTEX_LOCK(&eqx->eqx_lock);
+	daos_eq_ring_flush(eqx);
 
 	if (n_events == 0 || events == NULL) {
 		if ((query & DAOS_EQR_COMPLETED) != 0)
 			count += eq->eq_n_comp;
 
 		if ((query & DAOS_EQR_WAITING) != 0)
-			count += eq->eq_n_running;
+			count += eq->eq_n_running +
+				 __atomic_load_n(&eqx->eqx_ring_running,
+						 __ATOMIC_ACQUIRE);
 		goto out;
 	}
 
@@ -817,7 +1153,11 @@ daos_event_abort_locked(struct daos_eq_private *eqx,
 
 	/* if aborted event is not a child event, move it to the
 	 * head of launched list */
-	if (evx->evx_parent == NULL && eqx != NULL) {
+	/* NB: event launched through the ring is not on eq_running, it is
+	 * delivered by the ring once it is completed.
+	 */
+	if (evx->evx_parent == NULL && eqx != NULL &&
+	    !(evx->evx_flags & EVX_F_RING)) {
 		struct daos_eq *eq = daos_eqx2eq(eqx);
 
 		d_list_del(&evx->evx_link);
@@ -848,17 +1188,31 @@ daos_eq_destroy(daos_handle_t eqh, int flags)
 
 	eq = daos_eqx2eq(eqx);
 
+	/* prevent other threads to launch new event, set it before checking
+	 * events launched through the ring, see daos_event_launch_ring().
+	 */
+	__atomic_store_n(&eqx->eqx_finalizing, 1, __ATOMIC_SEQ_CST);
+	daos_eq_ring_flush(eqx);
+
 	/* If it is not force destroyed, then we need check if
 	 * there are still events linked here */
 	if (((flags & DAOS_EQ_DESTROY_FORCE) == 0) &&
 	    (!d_list_empty(&eq->eq_running) ||
-	     !d_list_empty(&eq->eq_comp))) {
+	     !d_list_empty(&eq->eq_comp) || !eq_ring_idle(eqx))) {
+		__atomic_store_n(&eqx->eqx_finalizing, 0, __ATOMIC_RELEASE);
 		rc = -DER_BUSY;
 		goto out;
 	}
 
-	/* prevent other threads to launch new event */
-	eqx->eqx_finalizing = 1;
+	/* events of the ring are not tracked and can't be aborted */
+	if (!eq_ring_idle(eqx)) {
+		D_ERROR("Can't abort %d events launched through the ring\n",
+			__atomic_load_n(&eqx->eqx_ring_running,
+					__ATOMIC_RELAXED));
+		__atomic_store_n(&eqx->eqx_finalizing, 0, __ATOMIC_RELEASE);
+		rc = -DER_BUSY;
+		goto out;
+	}
 
 	/* abort all launched events */
 	d_list_for_each_entry_safe(evx, tmp, &eq->eq_running, evx_link) {
@@ -879,8 +1233,11 @@ daos_eq_destroy(daos_handle_t eqh, int flags)
 
 out:
 	D_MUTEX_UNLOCK(&eqx->eqx_lock);
-	if (rc == 0)
+	if (rc == 0) {
 		daos_eq_delete(eqx);
+		/* invalidate the EQ cached by all threads before freeing it */
+		eq_tls_gen_bump();
+	}
 	daos_eq_putref(eqx);
 	return rc;
 }
@@ -1028,6 +1385,14 @@ daos_event_fini(struct daos_event *ev)
 		if (eqx == NULL)
 			return -DER_NONEXIST;
 		eq = daos_eqx2eq(eqx);
+
+		/* completed event may be in the ring, move it to eq_comp */
+		if ((evx->evx_flags & EVX_F_RING) &&
+		    evx->evx_status == DAOS_EVS_COMPLETED) {
+			D_MUTEX_LOCK(&eqx->eqx_lock);
+			daos_eq_ring_flush(eqx);
+			D_MUTEX_UNLOCK(&eqx->eqx_lock);
+		}
 	}
 
 	/* If there are child events */
@@ -1129,7 +1494,7 @@ daos_event_abort(struct daos_event *ev)
 	struct daos_eq_private		*eqx = NULL;
 
 	if (!daos_handle_is_inval(evx->evx_eqh)) {
-		eqx = daos_eq_lookup(evx->evx_eqh);
+		eqx = daos_eq_acquire(evx->evx_eqh);
 		if (eqx == NULL) {
 			D_ERROR("Invalid EQ handle %"PRIu64"\n",
 				evx->evx_eqh.cookie);
@@ -1142,7 +1507,7 @@ daos_event_abort(struct daos_event *ev)
 
 	if (eqx != NULL) {
 		D_MUTEX_UNLOCK(&eqx->eqx_lock);
-		daos_eq_putref(eqx);
+		daos_eq_release(eqx);
 	}
 
 	return 0;
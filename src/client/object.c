@@ -236,3 +236,21 @@ daos_obj_list_recx(daos_handle_t oh, daos_epoch_t epoch, daos_key_t *dkey,
 
 	return dc_task_schedule(task, true);
 }
+
+void
+daos_obj_buf_invalidate(void *buf, daos_size_t len)
+{
+	dc_obj_buf_invalidate(buf, len);
+}
+
+int
+daos_obj_buf_query(daos_obj_buf_stat_t *stat)
+{
+	return dc_obj_buf_query(stat);
+}
+
+int
+daos_obj_batch_query(daos_obj_batch_stat_t *stat)
+{
+	return dc_obj_batch_query(stat);
+}
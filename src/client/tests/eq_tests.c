@@ -30,6 +30,7 @@
 #define D_LOGFAC	DD_FAC(tests)
 
 #include <pthread.h>
+#include <sched.h>
 #include <stdarg.h>
 #include <stdlib.h>
 #include <setjmp.h>
@@ -48,6 +49,13 @@
 #define EQT_EV_COUNT		1000
 #define EQ_COUNT		5
 #define EQT_SLEEP_INV		2
+/** slots of the completion ring, less than EQT_EV_COUNT to test overflow */
+#define EQT_RING_DEPTH		"256"
+
+/** in-flight events per producer thread of the EQ benchmark */
+#define EQT_PERF_DEPTH		64
+#define EQT_PERF_ITERS		500
+#define EQT_PERF_THREADS	16
 
 #define DAOS_TEST_FMT	"-------- %s test_%s: %s\n"
 
@@ -976,6 +984,277 @@ out_free:
 	return rc;
 }
 
+struct eq_perf_arg {
+	daos_handle_t	epa_eqh;
+	int		epa_rc;
+};
+
+/** wait until the consumer has polled the event */
+static void
+eq_perf_wait_ready(struct daos_event *ev)
+{
+	struct daos_event_private *evx = daos_ev2evx(ev);
+
+	while (__atomic_load_n(&evx->evx_status, __ATOMIC_ACQUIRE) !=
+	       DAOS_EVS_READY)
+		sched_yield();
+}
+
+static void *
+eq_perf_producer(void *arg)
+{
+	struct eq_perf_arg	*epa = arg;
+	struct daos_event	 events[EQT_PERF_DEPTH];
+	int			 rc = 0;
+	int			 i;
+	int			 j;
+
+	for (j = 0; j < EQT_PERF_DEPTH; j++) {
+		rc = daos_event_init(&events[j], epa->epa_eqh, NULL);
+		if (rc != 0)
+			goto out;
+	}
+
+	for (i = 0; i < EQT_PERF_ITERS; i++) {
+		for (j = 0; j < EQT_PERF_DEPTH; j++) {
+			eq_perf_wait_ready(&events[j]);
+			rc = daos_event_launch(&events[j]);
+			if (rc != 0)
+				goto out;
+			daos_event_complete(&events[j], 0);
+		}
+	}
+
+	for (j = 0; j < EQT_PERF_DEPTH; j++) {
+		eq_perf_wait_ready(&events[j]);
+		daos_event_fini(&events[j]);
+	}
+out:
+	epa->epa_rc = rc;
+	return NULL;
+}
+
+/**
+ * \a nthreads producers launch and complete events of the same EQ, which
+ * are polled by the calling thread, return the rate in events per second.
+ */
+static int
+eq_perf_run(int nthreads, bool ring, double *rate)
+{
+	struct eq_perf_arg	 args[EQT_PERF_THREADS];
+	pthread_t		 threads[EQT_PERF_THREADS];
+	struct daos_event	*eps[EQT_PERF_DEPTH];
+	struct timeval		 then;
+	struct timeval		 now;
+	daos_handle_t		 eqh;
+	long			 total;
+	long			 polled;
+	int			 rc;
+	int			 i;
+
+	if (ring)
+		setenv(DAOS_EQ_RING_ENV, "1024", 1);
+	rc = daos_eq_create(&eqh);
+	unsetenv(DAOS_EQ_RING_ENV);
+	if (rc != 0)
+		return rc;
+
+	gettimeofday(&then, NULL);
+	for (i = 0; i < nthreads; i++) {
+		args[i].epa_eqh = eqh;
+		args[i].epa_rc = 0;
+		rc = pthread_create(&threads[i], NULL, eq_perf_producer,
+				    &args[i]);
+		D_ASSERT(rc == 0);
+	}
+
+	total = (long)nthreads * EQT_PERF_ITERS * EQT_PERF_DEPTH;
+	for (polled = 0; polled < total; ) {
+		rc = daos_eq_poll(eqh, 0, -1, EQT_PERF_DEPTH, eps);
+		if (rc < 0) {
+			print_error("EQ poll returned error: %d\n", rc);
+			break;
+		}
+		polled += rc;
+	}
+	gettimeofday(&now, NULL);
+
+	for (i = 0; i < nthreads; i++) {
+		pthread_join(threads[i], NULL);
+		if (rc >= 0 && args[i].epa_rc != 0)
+			rc = args[i].epa_rc;
+	}
+	if (rc < 0)
+		goto out;
+
+	*rate = polled / ((now.tv_sec - then.tv_sec) +
+			  (now.tv_usec - then.tv_usec) / 1000000.0);
+	/* all events have been polled, so the EQ should be empty */
+	rc = daos_eq_destroy(eqh, 0);
+	if (rc != 0)
+		print_error("Failed to destroy EQ: %d\n", rc);
+	return rc;
+out:
+	daos_eq_destroy(eqh, 1);
+	return rc;
+}
+
+static int
+eq_test_8()
+{
+	double	rate_lock;
+	double	rate_ring;
+	int	nthreads;
+	int	rc = 0;
+
+	DAOS_TEST_ENTRY("8", "Event rate of EQ with and without ring");
+
+	print_message("%8s %16s %16s\n", "threads", "lock (ev/s)",
+		      "ring (ev/s)");
+	for (nthreads = 1; nthreads <= EQT_PERF_THREADS; nthreads *= 2) {
+		rc = eq_perf_run(nthreads, false, &rate_lock);
+		if (rc != 0)
+			break;
+
+		rc = eq_perf_run(nthreads, true, &rate_ring);
+		if (rc != 0)
+			break;
+
+		print_message("%8d %16.0f %16.0f\n", nthreads, rate_lock,
+			      rate_ring);
+	}
+
+	DAOS_TEST_EXIT(rc);
+	return rc;
+}
+
+/** steps of eq_test_9, the thread and the main thread take turns */
+enum {
+	EQT_STEP_CACHED		= 1,
+	EQT_STEP_DESTROYED,
+	EQT_STEP_POLLED,
+	EQT_STEP_FINI,
+};
+
+struct eq_stale_arg {
+	pthread_mutex_t	esa_mutex;
+	pthread_cond_t	esa_cond;
+	daos_handle_t	esa_eqh;
+	int		esa_step;
+	int		esa_rc;
+};
+
+static void
+eq_stale_step(struct eq_stale_arg *esa, int step)
+{
+	pthread_mutex_lock(&esa->esa_mutex);
+	esa->esa_step = step;
+	pthread_cond_broadcast(&esa->esa_cond);
+	pthread_mutex_unlock(&esa->esa_mutex);
+}
+
+static void
+eq_stale_wait(struct eq_stale_arg *esa, int step)
+{
+	pthread_mutex_lock(&esa->esa_mutex);
+	while (esa->esa_step < step)
+		pthread_cond_wait(&esa->esa_cond, &esa->esa_mutex);
+	pthread_mutex_unlock(&esa->esa_mutex);
+}
+
+/** cache the EQ, then use its stale handle after the EQ is destroyed */
+static void *
+eq_stale_thread(void *arg)
+{
+	struct eq_stale_arg	*esa = arg;
+	struct daos_event	 ev;
+	struct daos_event	*ep;
+	int			 rc;
+
+	rc = daos_event_init(&ev, esa->esa_eqh, NULL);
+	if (rc != 0)
+		goto out;
+
+	rc = daos_event_launch(&ev);
+	if (rc != 0)
+		goto out;
+	daos_event_complete(&ev, 0);
+
+	rc = daos_eq_poll(esa->esa_eqh, 0, -1, 1, &ep);
+	if (rc != 1 || ep != &ev) {
+		print_error("Failed to poll the event: %d\n", rc);
+		rc = -1;
+		goto out;
+	}
+	daos_event_fini(&ev);
+
+	eq_stale_step(esa, EQT_STEP_CACHED);
+	eq_stale_wait(esa, EQT_STEP_DESTROYED);
+
+	rc = daos_eq_poll(esa->esa_eqh, 0, DAOS_EQ_NOWAIT, 1, &ep);
+	if (rc != -DER_NONEXIST) {
+		print_error("Poll of destroyed EQ returned %d\n", rc);
+		rc = -1;
+		goto out;
+	}
+	rc = 0;
+out:
+	esa->esa_rc = rc;
+	eq_stale_step(esa, EQT_STEP_POLLED);
+	/* exit after the library has been finalized */
+	eq_stale_wait(esa, EQT_STEP_FINI);
+	return NULL;
+}
+
+/**
+ * Destroy an EQ which is cached by another thread, then finalize the library
+ * before that thread exits. It also finalizes the library for main().
+ */
+static int
+eq_test_9()
+{
+	struct eq_stale_arg	esa;
+	pthread_t		thread;
+	int			rc;
+
+	DAOS_TEST_ENTRY("9", "Destroy EQ cached by another thread");
+
+	memset(&esa, 0, sizeof(esa));
+	pthread_mutex_init(&esa.esa_mutex, NULL);
+	pthread_cond_init(&esa.esa_cond, NULL);
+
+	setenv(DAOS_EQ_RING_ENV, EQT_RING_DEPTH, 1);
+	rc = daos_eq_create(&esa.esa_eqh);
+	unsetenv(DAOS_EQ_RING_ENV);
+	if (rc != 0) {
+		print_error("Failed daos_eq_create: %d\n", rc);
+		goto out;
+	}
+
+	rc = pthread_create(&thread, NULL, eq_stale_thread, &esa);
+	D_ASSERT(rc == 0);
+
+	eq_stale_wait(&esa, EQT_STEP_CACHED);
+	rc = daos_eq_destroy(esa.esa_eqh, 0);
+	if (rc != 0)
+		print_error("Failed to destroy EQ: %d\n", rc);
+	eq_stale_step(&esa, EQT_STEP_DESTROYED);
+
+	eq_stale_wait(&esa, EQT_STEP_POLLED);
+	daos_eq_lib_fini();
+	daos_hhash_fini();
+	eq_stale_step(&esa, EQT_STEP_FINI);
+
+	pthread_join(thread, NULL);
+	if (rc == 0)
+		rc = esa.esa_rc;
+out:
+	pthread_cond_destroy(&esa.esa_cond);
+	pthread_mutex_destroy(&esa.esa_mutex);
+	DAOS_TEST_EXIT(rc);
+	return rc;
+}
+
 int
 main(int argc, char **argv)
 {
@@ -1051,12 +1330,42 @@ main(int argc, char **argv)
 		test_fail++;
 	}
 
+	/* run query & poll test again with an EQ with completion ring */
+	daos_eq_destroy(my_eqh, 1);
+	setenv(DAOS_EQ_RING_ENV, EQT_RING_DEPTH, 1);
+	rc = daos_eq_create(&my_eqh);
+	unsetenv(DAOS_EQ_RING_ENV);
+	if (rc != 0) {
+		print_error("Failed daos_eq_create: %d\n", rc);
+		goto out_lib;
+	}
+
+	rc = eq_test_2();
+	if (rc != 0) {
+		print_error("EQ TEST 2 (ring) failed: %d\n", rc);
+		test_fail++;
+	}
+
+	rc = eq_test_8();
+	if (rc != 0) {
+		print_error("EQ TEST 8 failed: %d\n", rc);
+		test_fail++;
+	}
+
+	daos_eq_destroy(my_eqh, 1);
+
+	/* it finalizes the EQ library and the handle hash */
+	rc = eq_test_9();
+	if (rc != 0) {
+		print_error("EQ TEST 9 failed: %d\n", rc);
+		test_fail++;
+	}
+
 	if (test_fail)
 		print_error("ERROR, %d test(s) failed\n", test_fail);
 	else
 		print_message("SUCCESS, all tests passed\n");
-
-	daos_eq_destroy(my_eqh, 1);
+	goto out_debug;
 out_lib:
 	daos_eq_lib_fini();
 out_hhash:
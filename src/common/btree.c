@@ -29,6 +29,10 @@
  */
 #define D_LOGFAC	DD_FAC(tree)
 
+#include <endian.h>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
 #include <daos_errno.h>
 #include <daos/btree.h>
 
@@ -507,12 +511,267 @@ btr_rec_copy_hkey(struct btr_context *tcx, struct btr_record *dst_rec,
 	btr_hkey_copy(tcx, &dst_rec->rec_hkey[0], &src_rec->rec_hkey[0]);
 }
 
+/**
+ * Key array of BTR_FEAT_KEY_ARRAY.
+ *
+ * The key array is a search-only mirror of hkeys of records in the node, it
+ * is stored after records of the node and aligned to cache line. Each key is
+ * normalized to one (BTR_FEAT_UINT_KEY or 8 bytes hkey) or two (16 bytes
+ * hkey) 64-bit unsigned integers, so memcmp order of hkey becomes integer
+ * order. Two-word keys are stored as two arrays (high words then low words),
+ * both of them have tc_order slots.
+ *
+ * NB: the key array is rebuilt by btr_node_keys_sync() whenever records of
+ * a node are changed, it is always in the same allocation as the records so
+ * btr_node_tx_add() covers it.
+ */
+#define BTR_KEY_ALIGN		64
+/** search window for vectorized scan, binary search is used above it */
+#define BTR_KEY_SCAN_MAX	32
+
+static inline int
+btr_key_words(struct btr_context *tcx)
+{
+	if (tcx->tc_feats & BTR_FEAT_UINT_KEY)
+		return 1;
+
+	return btr_hkey_size(tcx) / sizeof(uint64_t);
+}
+
+static inline int
+btr_node_keys_off(struct btr_context *tcx)
+{
+	int off = sizeof(struct btr_node) + tcx->tc_order * btr_rec_size(tcx);
+
+	return (off + BTR_KEY_ALIGN - 1) & ~(BTR_KEY_ALIGN - 1);
+}
+
 static inline int
 btr_node_size(struct btr_context *tcx)
 {
+	if (tcx->tc_feats & BTR_FEAT_KEY_ARRAY)
+		return btr_node_keys_off(tcx) +
+		       tcx->tc_order * btr_key_words(tcx) * sizeof(uint64_t);
+
 	return sizeof(struct btr_node) + tcx->tc_order * btr_rec_size(tcx);
 }
 
+static uint64_t *
+btr_node_keys(struct btr_context *tcx, TMMID(struct btr_node) nd_mmid)
+{
+	char	*addr = (char *)btr_mmid2ptr(tcx, nd_mmid);
+
+	D_ASSERT(tcx->tc_feats & BTR_FEAT_KEY_ARRAY);
+	return (uint64_t *)&addr[btr_node_keys_off(tcx)];
+}
+
+/** convert a hkey to the integer format of the key array */
+static void
+btr_key_normalize(struct btr_context *tcx, char *hkey, uint64_t *words)
+{
+	uint64_t tmp;
+
+	memcpy(&tmp, hkey, sizeof(tmp));
+	if (tcx->tc_feats & BTR_FEAT_UINT_KEY) {
+		words[0] = tmp;
+		return;
+	}
+	/* memcmp order equals integer order of big endian */
+	words[0] = be64toh(tmp);
+	if (btr_key_words(tcx) == 2) {
+		memcpy(&tmp, hkey + sizeof(tmp), sizeof(tmp));
+		words[1] = be64toh(tmp);
+	}
+}
+
+/** rebuild the key array from records of the node */
+static void
+btr_node_keys_sync(struct btr_context *tcx, TMMID(struct btr_node) nd_mmid)
+{
+	struct btr_node	*nd;
+	uint64_t	*keys;
+	uint64_t	 words[2];
+	int		 nwords;
+	int		 i;
+
+	if (!(tcx->tc_feats & BTR_FEAT_KEY_ARRAY))
+		return;
+
+	nd = btr_mmid2ptr(tcx, nd_mmid);
+	keys = btr_node_keys(tcx, nd_mmid);
+	nwords = btr_key_words(tcx);
+
+	for (i = 0; i < nd->tn_keyn; i++) {
+		struct btr_record *rec = btr_node_rec_at(tcx, nd_mmid, i);
+
+		btr_key_normalize(tcx, &rec->rec_hkey[0], words);
+		keys[i] = words[0];
+		if (nwords == 2)
+			keys[tcx->tc_order + i] = words[1];
+	}
+}
+
+/** is key at \a at of the key array less than \a skey */
+static inline bool
+btr_key_lt(uint64_t *hi, uint64_t *lo, int at, uint64_t *skey)
+{
+	if (hi[at] != skey[0] || lo == NULL)
+		return hi[at] < skey[0];
+
+	return lo[at] < skey[1];
+}
+
+/**
+ * Count keys which are less than \a skey, keys are sorted so the result is
+ * also the lower bound of \a skey. \a lo is NULL for one-word keys.
+ */
+typedef int (*btr_key_scan_t)(uint64_t *hi, uint64_t *lo, int nr,
+			      uint64_t *skey);
+
+static int
+btr_key_scan_scalar(uint64_t *hi, uint64_t *lo, int nr, uint64_t *skey)
+{
+	int	i;
+	int	cnt;
+
+	for (i = cnt = 0; i < nr; i++)
+		cnt += btr_key_lt(hi, lo, i, skey);
+	return cnt;
+}
+
+#if defined(__x86_64__)
+/* NB: there is no unsigned 64-bit compare before AVX-512, so flip the sign
+ * bit of both operands and use the signed compare.
+ */
+__attribute__((target("sse4.2")))
+static int
+btr_key_scan_sse42(uint64_t *hi, uint64_t *lo, int nr, uint64_t *skey)
+{
+	__m128i	sign = _mm_set1_epi64x(INT64_MIN);
+	__m128i	kh = _mm_xor_si128(_mm_set1_epi64x(skey[0]), sign);
+	__m128i	kl = _mm_xor_si128(_mm_set1_epi64x(lo ? skey[1] : 0), sign);
+	int	cnt = 0;
+	int	i;
+
+	for (i = 0; i + 2 <= nr; i += 2) {
+		__m128i	h;
+		__m128i	lt;
+
+		h  = _mm_xor_si128(_mm_loadu_si128((__m128i *)&hi[i]), sign);
+		lt = _mm_cmpgt_epi64(kh, h);
+		if (lo != NULL) {
+			__m128i	l;
+			__m128i	eq;
+
+			l  = _mm_loadu_si128((__m128i *)&lo[i]);
+			l  = _mm_xor_si128(l, sign);
+			eq = _mm_cmpeq_epi64(kh, h);
+			lt = _mm_or_si128(lt, _mm_and_si128(eq,
+						_mm_cmpgt_epi64(kl, l)));
+		}
+		cnt += __builtin_popcount(_mm_movemask_pd(
+						_mm_castsi128_pd(lt)));
+	}
+	for (; i < nr; i++)
+		cnt += btr_key_lt(hi, lo, i, skey);
+	return cnt;
+}
+
+__attribute__((target("avx2")))
+static int
+btr_key_scan_avx2(uint64_t *hi, uint64_t *lo, int nr, uint64_t *skey)
+{
+	__m256i	sign = _mm256_set1_epi64x(INT64_MIN);
+	__m256i	kh = _mm256_xor_si256(_mm256_set1_epi64x(skey[0]), sign);
+	__m256i	kl = _mm256_xor_si256(_mm256_set1_epi64x(lo ? skey[1] : 0),
+				      sign);
+	int	cnt = 0;
+	int	i;
+
+	for (i = 0; i + 4 <= nr; i += 4) {
+		__m256i	h;
+		__m256i	lt;
+
+		h  = _mm256_loadu_si256((__m256i *)&hi[i]);
+		h  = _mm256_xor_si256(h, sign);
+		lt = _mm256_cmpgt_epi64(kh, h);
+		if (lo != NULL) {
+			__m256i	l;
+			__m256i	eq;
+
+			l  = _mm256_loadu_si256((__m256i *)&lo[i]);
+			l  = _mm256_xor_si256(l, sign);
+			eq = _mm256_cmpeq_epi64(kh, h);
+			lt = _mm256_or_si256(lt, _mm256_and_si256(eq,
+						_mm256_cmpgt_epi64(kl, l)));
+		}
+		cnt += __builtin_popcount(_mm256_movemask_pd(
+						_mm256_castsi256_pd(lt)));
+	}
+	for (; i < nr; i++)
+		cnt += btr_key_lt(hi, lo, i, skey);
+	return cnt;
+}
+#endif
+
+static btr_key_scan_t	btr_key_scan = btr_key_scan_scalar;
+
+/** choose the fastest key scanner supported by this CPU */
+static void
+btr_key_scan_init(void)
+{
+#if defined(__x86_64__)
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2"))
+		btr_key_scan = btr_key_scan_avx2;
+	else if (__builtin_cpu_supports("sse4.2"))
+		btr_key_scan = btr_key_scan_sse42;
+#endif
+}
+
+/**
+ * Search the key array of a node for the normalized key \a skey. The
+ * returned record index and comparison result \a cmp_p are the same as
+ * what the binary search of btr_probe() can return.
+ */
+static int
+btr_node_search_keys(struct btr_context *tcx, TMMID(struct btr_node) nd_mmid,
+		     uint64_t *skey, int *cmp_p)
+{
+	struct btr_node	*nd = btr_mmid2ptr(tcx, nd_mmid);
+	uint64_t	*hi = btr_node_keys(tcx, nd_mmid);
+	uint64_t	*lo = NULL;
+	int		 start = 0;
+	int		 end = nd->tn_keyn;
+	int		 at;
+
+	D_ASSERT(nd->tn_keyn > 0);
+	if (btr_key_words(tcx) == 2)
+		lo = &hi[tcx->tc_order];
+
+	/* narrow down the lower bound to a small window */
+	while (end - start > BTR_KEY_SCAN_MAX) {
+		at = (start + end) / 2;
+		if (btr_key_lt(hi, lo, at, skey))
+			start = at + 1;
+		else
+			end = at;
+	}
+	at = start + btr_key_scan(&hi[start], lo ? &lo[start] : NULL,
+				  end - start, skey);
+
+	if (at == nd->tn_keyn) { /* all keys are less than skey */
+		*cmp_p = BTR_CMP_LT;
+		return at - 1;
+	}
+
+	if (hi[at] == skey[0] && (lo == NULL || lo[at] == skey[1]))
+		*cmp_p = BTR_CMP_EQ;
+	else
+		*cmp_p = BTR_CMP_GT;
+	return at;
+}
+
 static int
 btr_node_alloc(struct btr_context *tcx, TMMID(struct btr_node) *nd_mmid_p)
 {
@@ -775,6 +1034,7 @@ btr_root_start(struct btr_context *tcx, struct btr_record *rec)
 
 	rec_dst = btr_node_rec_at(tcx, nd_mmid, 0);
 	btr_rec_copy(tcx, rec_dst, rec, 1);
+	btr_node_keys_sync(tcx, nd_mmid);
 
 	if (btr_has_tx(tcx))
 		btr_root_tx_add(tcx); /* XXX check error */
@@ -828,6 +1088,7 @@ btr_root_grow(struct btr_context *tcx, TMMID(struct btr_node) mmid_left,
 	nd = btr_mmid2ptr(tcx, nd_mmid);
 	nd->tn_child	= mmid_left;
 	nd->tn_keyn	= 1;
+	btr_node_keys_sync(tcx, nd_mmid);
 
 	at = !btr_node_is_equal(tcx, mmid_left, tcx->tc_trace->tr_node);
 
@@ -869,6 +1130,7 @@ btr_node_insert_rec_only(struct btr_context *tcx, struct btr_trace *trace,
 
 	btr_rec_copy(tcx, rec_a, rec, 1);
 	nd->tn_keyn++;
+	btr_node_keys_sync(tcx, trace->tr_node);
 }
 
 /**
@@ -1003,6 +1265,9 @@ btr_node_split_and_insert(struct btr_context *tcx, struct btr_trace *trace,
 	D_DEBUG(DB_TRACE, "left keyn %d, right keyn %d\n",
 		nd_left->tn_keyn, nd_right->tn_keyn);
 
+	btr_node_keys_sync(tcx, mmid_left);
+	btr_node_keys_sync(tcx, mmid_right);
+
 	rec->rec_mmid = umem_id_t2u(mmid_right);
 	if (level == 0)
 		rc = btr_root_grow(tcx, mmid_left, rec);
@@ -1052,56 +1317,36 @@ btr_node_direct_rec_at(struct btr_context *tcx, TMMID(struct btr_node) nd_mmid,
 }
 
 /**
- * Try to find \a key within a btree, it will store the searching path in
- * tcx::tc_traces.
+ * Search \a key from the node stored in trace of \a level, the searching
+ * path from \a level to the leaf is stored in tcx::tc_traces, traces of
+ * upper levels are untouched.
+ *
+ * \param hkey	[IN]	hashed key of \a key, used if \a opc has
+ *			BTR_PROBE_EQ.
+ * \param skey	[IN]	normalized \a hkey, it is only used if the tree
+ *			has BTR_FEAT_KEY_ARRAY.
  *
  * \return	see btr_probe_rc
  */
 static enum btr_probe_rc
-btr_probe(struct btr_context *tcx, int opc, daos_iov_t *key,
-	  daos_hash_out_t *anchor)
+btr_probe_level(struct btr_context *tcx, int opc, int level, daos_iov_t *key,
+		char *hkey, uint64_t *skey)
 {
 	struct btr_record	*rec;
 	int			 start;
 	int			 end;
 	int			 at;
 	int			 cmp;
-	int			 level;
 	bool			 nextl;
-	char			 hkey_buf[DAOS_HKEY_MAX];
-	char			*hkey = &hkey_buf[0];
 	TMMID(struct btr_node)	 nd_mmid;
 
-	memset(&tcx->tc_traces[0], 0,
-	       sizeof(tcx->tc_traces[0]) * BTR_TRACE_MAX);
-
-	/* depth could be changed by dbtree_delete/dbtree_iter_delete from
-	 * a different btr_context, so we always reinitialize both depth
-	 * and start point of trace for the context.
-	 */
-	btr_context_set_depth(tcx, tcx->tc_tins.ti_root->tr_depth);
-
-	if (btr_root_empty(tcx)) { /* empty tree */
-		D_DEBUG(DB_TRACE, "Empty tree\n");
-		return PROBE_RC_NONE;
-	}
-
-	if (opc & BTR_PROBE_EQ) {
-		if (key != NULL) {
-			btr_hkey_gen(tcx, key, hkey);
-		} else {
-			D_ASSERT(anchor != NULL);
-			D_ASSERT(opc != BTR_PROBE_UPDATE);
-			D_ASSERT((tcx->tc_feats & BTR_FEAT_DIRECT_KEY) == 0);
-
-			btr_hkey_copy(tcx, hkey, &anchor->body[0]);
-		}
-	}
-
-	nd_mmid = tcx->tc_tins.ti_root->tr_node;
+	if (level == 0)
+		nd_mmid = tcx->tc_tins.ti_root->tr_node;
+	else
+		nd_mmid = tcx->tc_trace[level].tr_node;
 	start = end = 0;
 
-	for (nextl = true, level = 0 ;;) {
+	for (nextl = true;;) {
 		if (nextl) { /* search a new level of the tree */
 			nextl	= false;
 			start	= 0;
@@ -1112,7 +1357,16 @@ btr_probe(struct btr_context *tcx, int opc, daos_iov_t *key,
 				level, TMMID_P(nd_mmid), end + 1);
 		}
 
-		if (opc & BTR_PROBE_EQ) {
+		if (opc & BTR_PROBE_EQ &&
+		    tcx->tc_feats & BTR_FEAT_KEY_ARRAY) {
+			/* search the whole node in one step */
+			at = btr_node_search_keys(tcx, nd_mmid, skey, &cmp);
+			start = end = at;
+
+			D_DEBUG(DB_TRACE, "searched key array at %d, cmp %d\n",
+				at, cmp);
+
+		} else if (opc & BTR_PROBE_EQ) {
 			/* binary search */
 			at = (start + end) / 2;
 			if (tcx->tc_feats & BTR_FEAT_DIRECT_KEY) {
@@ -1222,6 +1476,52 @@ btr_probe(struct btr_context *tcx, int opc, daos_iov_t *key,
 	}
 }
 
+/**
+ * Try to find \a key within a btree, it will store the searching path in
+ * tcx::tc_traces.
+ *
+ * \return	see btr_probe_rc
+ */
+static enum btr_probe_rc
+btr_probe(struct btr_context *tcx, int opc, daos_iov_t *key,
+	  daos_hash_out_t *anchor)
+{
+	char			 hkey_buf[DAOS_HKEY_MAX];
+	char			*hkey = &hkey_buf[0];
+	uint64_t		 skey[2];
+
+	memset(&tcx->tc_traces[0], 0,
+	       sizeof(tcx->tc_traces[0]) * BTR_TRACE_MAX);
+
+	/* depth could be changed by dbtree_delete/dbtree_iter_delete from
+	 * a different btr_context, so we always reinitialize both depth
+	 * and start point of trace for the context.
+	 */
+	btr_context_set_depth(tcx, tcx->tc_tins.ti_root->tr_depth);
+
+	if (btr_root_empty(tcx)) { /* empty tree */
+		D_DEBUG(DB_TRACE, "Empty tree\n");
+		return PROBE_RC_NONE;
+	}
+
+	if (opc & BTR_PROBE_EQ) {
+		if (key != NULL) {
+			btr_hkey_gen(tcx, key, hkey);
+		} else {
+			D_ASSERT(anchor != NULL);
+			D_ASSERT(opc != BTR_PROBE_UPDATE);
+			D_ASSERT((tcx->tc_feats & BTR_FEAT_DIRECT_KEY) == 0);
+
+			btr_hkey_copy(tcx, hkey, &anchor->body[0]);
+		}
+
+		if (tcx->tc_feats & BTR_FEAT_KEY_ARRAY)
+			btr_key_normalize(tcx, hkey, skey);
+	}
+
+	return btr_probe_level(tcx, opc, 0, key, hkey, skey);
+}
+
 static bool
 btr_probe_next(struct btr_context *tcx)
 {
@@ -1568,6 +1868,615 @@ dbtree_update(daos_handle_t toh, daos_iov_t *key, daos_iov_t *val)
 	return rc;
 }
 
+/** default fill factor (percentage) of bulk loaded nodes */
+#define BTR_BULK_FILL_DEF	90
+
+/** context for sorting a bulk of keys by their hkeys */
+struct btr_bulk_sort {
+	struct btr_context	*bs_tcx;
+	/** scratch records which only have hkeys of input keys */
+	union btr_rec_buf	*bs_recs;
+	/** sorted indexes of input keys */
+	unsigned int		*bs_idx;
+};
+
+static int
+btr_bulk_sort_cmp(void *array, int a, int b)
+{
+	struct btr_bulk_sort	*bs = array;
+	union btr_rec_buf	*ra = &bs->bs_recs[bs->bs_idx[a]];
+	union btr_rec_buf	*rb = &bs->bs_recs[bs->bs_idx[b]];
+	int			 rc;
+
+	rc = btr_hkey_cmp(bs->bs_tcx, &ra->rb_rec, &rb->rb_rec.rec_hkey[0]);
+	switch (rc) {
+	default:
+		D_ASSERT(0);
+	case BTR_CMP_EQ:
+		return 0;
+	case BTR_CMP_LT:
+		return -1;
+	case BTR_CMP_GT:
+		return 1;
+	}
+}
+
+static void
+btr_bulk_sort_swap(void *array, int a, int b)
+{
+	struct btr_bulk_sort	*bs = array;
+	unsigned int		 tmp;
+
+	tmp = bs->bs_idx[a];
+	bs->bs_idx[a] = bs->bs_idx[b];
+	bs->bs_idx[b] = tmp;
+}
+
+static daos_sort_ops_t btr_bulk_sort_ops = {
+	.so_cmp		= btr_bulk_sort_cmp,
+	.so_swap	= btr_bulk_sort_swap,
+};
+
+/**
+ * Sort input keys by hkey, if \a unique is true, it returns -DER_EXIST if
+ * there are keys with the same hkey.
+ */
+static int
+btr_bulk_sort(struct btr_bulk_sort *bs, unsigned int nr, bool unique)
+{
+	bool	sorted = true;
+	int	i;
+
+	for (i = 0; i < nr; i++)
+		bs->bs_idx[i] = i;
+
+	/* input is supposed to be sorted, don't bother to sort it again */
+	for (i = 1; i < nr && sorted; i++)
+		sorted = btr_bulk_sort_cmp(bs, i - 1, i) < 0;
+
+	if (!sorted)
+		daos_array_sort(bs, nr, false, &btr_bulk_sort_ops);
+
+	for (i = 1; i < nr && unique; i++) {
+		if (btr_bulk_sort_cmp(bs, i - 1, i) == 0)
+			return -DER_EXIST;
+	}
+	return 0;
+}
+
+/** free a node created by bulk loading and all its descendants */
+static void
+btr_bulk_node_free(struct btr_context *tcx, TMMID(struct btr_node) nd_mmid)
+{
+	struct btr_node *nd = btr_mmid2ptr(tcx, nd_mmid);
+	int		 i;
+
+	if (btr_node_is_leaf(tcx, nd_mmid)) {
+		for (i = 0; i < nd->tn_keyn; i++)
+			btr_rec_free(tcx, btr_node_rec_at(tcx, nd_mmid, i),
+				     NULL);
+	} else {
+		for (i = 0; i <= nd->tn_keyn; i++)
+			btr_bulk_node_free(tcx,
+					   btr_node_child_at(tcx, nd_mmid, i));
+	}
+	btr_node_free(tcx, nd_mmid);
+}
+
+/**
+ * Build all leaves from the sorted keys, each leaf is described by a
+ * record in \a ups, which has the leaf mmid and the first hkey of the leaf,
+ * they are the records to be stored in the parent level.
+ */
+static int
+btr_bulk_build_leaves(struct btr_context *tcx, struct btr_bulk_sort *bs,
+		      daos_iov_t *keys, daos_iov_t *vals, unsigned int nr,
+		      union btr_rec_buf *ups, unsigned int leaf_nr)
+{
+	struct btr_node		*nd;
+	TMMID(struct btr_node)	 nd_mmid;
+	int			 i;
+	int			 j;
+	int			 k;
+	int			 rc;
+
+	for (i = k = 0; i < leaf_nr; i++) {
+		/* spread keys evenly, so no leaf is nearly empty */
+		int cnt = nr / leaf_nr + (i < nr % leaf_nr);
+
+		rc = btr_node_alloc(tcx, &nd_mmid);
+		if (rc != 0)
+			goto failed;
+
+		btr_node_set(tcx, nd_mmid, BTR_NODE_LEAF);
+		nd = btr_mmid2ptr(tcx, nd_mmid);
+		ups[i].rb_rec.rec_mmid = umem_id_t2u(nd_mmid);
+
+		for (j = 0; j < cnt; j++, k++) {
+			struct btr_record	*rec;
+			unsigned int		 idx = bs->bs_idx[k];
+
+			rec = btr_node_rec_at(tcx, nd_mmid, j);
+			btr_rec_copy_hkey(tcx, rec, &bs->bs_recs[idx].rb_rec);
+			rc = btr_rec_alloc(tcx, &keys[idx], &vals[idx], rec);
+			if (rc != 0) {
+				i++; /* release the current leaf as well */
+				goto failed;
+			}
+			nd->tn_keyn++;
+		}
+		btr_node_keys_sync(tcx, nd_mmid);
+		btr_rec_copy_hkey(tcx, &ups[i].rb_rec,
+				  btr_node_rec_at(tcx, nd_mmid, 0));
+	}
+	return 0;
+ failed:
+	D_DEBUG(DB_TRACE, "Failed to build leaves: %d\n", rc);
+	while (--i >= 0)
+		btr_bulk_node_free(tcx, umem_id_u2t(ups[i].rb_rec.rec_mmid,
+						    struct btr_node));
+	return rc;
+}
+
+/**
+ * Build a new level of the tree on top of \a nr nodes described by \a ups,
+ * \a ups is also used to return records of the new level.
+ */
+static int
+btr_bulk_build_level(struct btr_context *tcx, union btr_rec_buf *ups,
+		     unsigned int nr, unsigned int per_node,
+		     unsigned int *nr_p)
+{
+	struct btr_node		*nd;
+	TMMID(struct btr_node)	 nd_mmid;
+	int			 node_nr;
+	int			 i;
+	int			 j;
+	int			 k;
+	int			 rc;
+
+	/* each node has per_node + 1 children, but at least two */
+	node_nr = (nr + per_node) / (per_node + 1);
+	if (node_nr > nr / 2)
+		node_nr = nr / 2;
+
+	for (i = k = 0; i < node_nr; i++) {
+		int cnt = nr / node_nr + (i < nr % node_nr);
+
+		rc = btr_node_alloc(tcx, &nd_mmid);
+		if (rc != 0)
+			goto failed;
+
+		/* the first child has no key, its hkey is the separator
+		 * of the new node in the upper level.
+		 */
+		nd = btr_mmid2ptr(tcx, nd_mmid);
+		nd->tn_child = umem_id_u2t(ups[k].rb_rec.rec_mmid,
+					   struct btr_node);
+		for (j = 1; j < cnt; j++) {
+			btr_rec_copy(tcx, btr_node_rec_at(tcx, nd_mmid, j - 1),
+				     &ups[k + j].rb_rec, 1);
+		}
+		nd->tn_keyn = cnt - 1;
+		btr_node_keys_sync(tcx, nd_mmid);
+
+		/* NB: i <= k so the source record has been consumed */
+		btr_rec_copy_hkey(tcx, &ups[i].rb_rec, &ups[k].rb_rec);
+		ups[i].rb_rec.rec_mmid = umem_id_t2u(nd_mmid);
+		k += cnt;
+	}
+	*nr_p = node_nr;
+	return 0;
+ failed:
+	D_DEBUG(DB_TRACE, "Failed to build tree level: %d\n", rc);
+	/* release new nodes and all nodes not attached yet */
+	for (j = 0; j < i; j++)
+		btr_bulk_node_free(tcx, umem_id_u2t(ups[j].rb_rec.rec_mmid,
+						    struct btr_node));
+	for (j = k; j < nr; j++)
+		btr_bulk_node_free(tcx, umem_id_u2t(ups[j].rb_rec.rec_mmid,
+						    struct btr_node));
+	return rc;
+}
+
+/**
+ * Build an empty tree bottom-up from the sorted keys, instead of inserting
+ * them one by one.
+ */
+static int
+btr_bulk_build(struct btr_context *tcx, struct btr_bulk_sort *bs,
+	       daos_iov_t *keys, daos_iov_t *vals, unsigned int nr,
+	       unsigned int fill)
+{
+	struct btr_root		*root = tcx->tc_tins.ti_root;
+	union btr_rec_buf	*ups;
+	TMMID(struct btr_node)	 nd_mmid;
+	unsigned int		 per_node;
+	unsigned int		 up_nr;
+	int			 depth;
+	int			 rc;
+
+	D_ASSERT(btr_root_empty(tcx));
+	/* number of keys of each node, full node has tc_order - 1 keys */
+	per_node = max((tcx->tc_order - 1) * fill / 100, 1U);
+
+	up_nr = (nr + per_node - 1) / per_node;
+	D_ALLOC(ups, up_nr * sizeof(*ups));
+	if (ups == NULL)
+		return -DER_NOMEM;
+
+	rc = btr_bulk_build_leaves(tcx, bs, keys, vals, nr, ups, up_nr);
+	if (rc != 0)
+		goto out;
+
+	for (depth = 1; up_nr > 1; depth++) {
+		rc = btr_bulk_build_level(tcx, ups, up_nr, per_node, &up_nr);
+		if (rc != 0)
+			goto out;
+	}
+
+	nd_mmid = umem_id_u2t(ups[0].rb_rec.rec_mmid, struct btr_node);
+	btr_node_set(tcx, nd_mmid, BTR_NODE_ROOT);
+
+	if (btr_has_tx(tcx)) {
+		rc = btr_root_tx_add(tcx);
+		if (rc != 0) {
+			btr_bulk_node_free(tcx, nd_mmid);
+			goto out;
+		}
+	}
+	root->tr_node  = nd_mmid;
+	root->tr_depth = depth;
+	btr_context_set_depth(tcx, depth);
+
+	D_DEBUG(DB_TRACE, "Bulk loaded %u records, depth %d\n", nr, depth);
+ out:
+	D_FREE(ups);
+	return rc;
+}
+
+static int
+btr_bulk_insert(struct btr_context *tcx, daos_iov_t *keys, daos_iov_t *vals,
+		unsigned int nr, unsigned int fill, unsigned int *new_nr)
+{
+	struct btr_bulk_sort	bs = { 0 };
+	unsigned int		inserted = 0;
+	int			i;
+	int			rc = 0;
+
+	if (!btr_root_empty(tcx) || (tcx->tc_feats & BTR_FEAT_DIRECT_KEY))
+		goto insert_one;
+
+	D_ALLOC(bs.bs_recs, nr * sizeof(*bs.bs_recs));
+	D_ALLOC(bs.bs_idx, nr * sizeof(*bs.bs_idx));
+	if (bs.bs_recs == NULL || bs.bs_idx == NULL)
+		D_GOTO(out, rc = -DER_NOMEM);
+
+	bs.bs_tcx = tcx;
+	for (i = 0; i < nr; i++)
+		btr_hkey_gen(tcx, &keys[i], &bs.bs_recs[i].rb_rec.rec_hkey[0]);
+
+	rc = btr_bulk_sort(&bs, nr, true);
+	if (rc == 0) {
+		rc = btr_bulk_build(tcx, &bs, keys, vals, nr, fill);
+		if (rc == 0)
+			inserted = nr;
+		D_GOTO(out, rc);
+	}
+	/* duplicated keys or hash collision, the last value should win
+	 * which is what one by one insertion does.
+	 */
+	D_DEBUG(DB_TRACE, "Duplicated hkeys, insert one by one\n");
+ insert_one:
+	for (i = 0; i < nr; i++) {
+		rc = btr_probe(tcx, BTR_PROBE_UPDATE, &keys[i], NULL);
+		if (rc == PROBE_RC_EQ) {
+			rc = btr_update_only(tcx, &keys[i], &vals[i]);
+		} else if (rc == PROBE_RC_ERR) {
+			rc = -DER_INVAL;
+		} else {
+			rc = btr_insert(tcx, &keys[i], &vals[i]);
+			inserted += (rc == 0);
+		}
+		if (rc != 0)
+			break;
+	}
+ out:
+	D_FREE(bs.bs_recs);
+	D_FREE(bs.bs_idx);
+	if (rc == 0 && new_nr != NULL)
+		*new_nr = inserted;
+	return rc;
+}
+
+static int
+btr_tx_bulk_insert(struct btr_context *tcx, daos_iov_t *keys,
+		   daos_iov_t *vals, unsigned int nr, unsigned int fill,
+		   unsigned int *new_nr)
+{
+#if DAOS_HAS_PMDK
+	struct umem_instance *umm = btr_umm(tcx);
+	int		      rc = 0;
+
+	TX_BEGIN(umm->umm_u.pmem_pool) {
+		rc = btr_bulk_insert(tcx, keys, vals, nr, fill, new_nr);
+		if (rc != 0)
+			pmemobj_tx_abort(rc);
+	} TX_ONABORT {
+		rc = umem_tx_errno(rc);
+		D_DEBUG(DB_TRACE, "dbtree_bulk_insert tx aborted: %d\n", rc);
+
+	} TX_FINALLY {
+		D_DEBUG(DB_TRACE, "dbtree_bulk_insert tx exited\n");
+	} TX_END
+
+	return rc;
+#else
+	D_ASSERT(0);
+	return -DER_NO_PERM;
+#endif
+}
+
+/**
+ * Insert a batch of keys and values in one transaction.
+ *
+ * If the tree is empty, keys are sorted by hkey (it is cheap if they are
+ * already in order), then the tree is built bottom-up by filling leaves and
+ * intermediate nodes to \a fill percent of their capacity, which is much
+ * faster than probing and splitting nodes for each key. Otherwise, or if
+ * there are duplicated keys, keys are inserted one by one, and the value
+ * of an existing key is updated.
+ *
+ * \param toh		[IN]	Tree open handle.
+ * \param keys		[IN]	Array of keys, better to be sorted.
+ * \param vals		[IN]	Array of values.
+ * \param nr		[IN]	Number of keys and values.
+ * \param fill		[IN]	Fill factor (percentage) of nodes, zero
+ *				means the default value.
+ * \param new_nr	[OUT]	Optional, returned number of new records.
+ *
+ * \return		0	success
+ *			-ve	error code
+ */
+int
+dbtree_bulk_insert(daos_handle_t toh, daos_iov_t *keys, daos_iov_t *vals,
+		   unsigned int nr, unsigned int fill, unsigned int *new_nr)
+{
+	struct btr_context *tcx;
+	int		    rc;
+
+	tcx = btr_hdl2tcx(toh);
+	if (tcx == NULL)
+		return -DER_NO_HDL;
+
+	if (fill > 100)
+		return -DER_INVAL;
+
+	if (nr == 0) {
+		if (new_nr != NULL)
+			*new_nr = 0;
+		return 0;
+	}
+
+	if (fill == 0)
+		fill = BTR_BULK_FILL_DEF;
+
+	/* depth might be changed by other contexts, see btr_probe */
+	btr_context_set_depth(tcx, tcx->tc_tins.ti_root->tr_depth);
+
+	if (btr_has_tx(tcx))
+		rc = btr_tx_bulk_insert(tcx, keys, vals, nr, fill, new_nr);
+	else
+		rc = btr_bulk_insert(tcx, keys, vals, nr, fill, new_nr);
+
+	return rc;
+}
+
+/** compare \a key with the record at \a at of a node, see btr_probe_level */
+static int
+btr_node_cmp_at(struct btr_context *tcx, TMMID(struct btr_node) nd_mmid,
+		unsigned int at, daos_iov_t *key, char *hkey)
+{
+	struct btr_record *rec;
+
+	if (tcx->tc_feats & BTR_FEAT_DIRECT_KEY) {
+		rec = btr_node_direct_rec_at(tcx, nd_mmid, at);
+		return btr_key_cmp(tcx, rec, key);
+	}
+	rec = btr_node_rec_at(tcx, nd_mmid, at);
+	return btr_hkey_cmp(tcx, rec, hkey);
+}
+
+/**
+ * Check if the node on the path of the last probe at \a level can cover
+ * \a key. Bounds of the node are separators of the nearest ancestors which
+ * have keys on the left or right side of the path.
+ */
+static bool
+btr_probe_covered(struct btr_context *tcx, int level, daos_iov_t *key,
+		  char *hkey)
+{
+	struct btr_trace	*trace;
+	struct btr_node		*nd;
+	bool			 has_lo = false;
+	bool			 has_hi = false;
+	int			 cmp;
+
+	while (--level >= 0 && !(has_lo && has_hi)) {
+		trace = &tcx->tc_trace[level];
+		nd = btr_mmid2ptr(tcx, trace->tr_node);
+
+		/* child tr_at covers keys in [rec[tr_at - 1], rec[tr_at]) */
+		if (!has_hi && trace->tr_at < nd->tn_keyn) {
+			has_hi = true;
+			cmp = btr_node_cmp_at(tcx, trace->tr_node,
+					      trace->tr_at, key, hkey);
+			if (cmp != BTR_CMP_GT)
+				return false;
+		}
+		if (!has_lo && trace->tr_at > 0) {
+			has_lo = true;
+			cmp = btr_node_cmp_at(tcx, trace->tr_node,
+					      trace->tr_at - 1, key, hkey);
+			if (cmp == BTR_CMP_GT || cmp == BTR_CMP_ERR)
+				return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Climb up the path of the last probe until the subtree can cover \a key,
+ * it returns level of the subtree, so the next probe can start from there.
+ */
+static int
+btr_probe_climb(struct btr_context *tcx, daos_iov_t *key, char *hkey)
+{
+	int	level;
+
+	for (level = tcx->tc_depth - 1; level > 0; level--) {
+		if (btr_probe_covered(tcx, level, key, hkey))
+			break;
+	}
+	return level;
+}
+
+/**
+ * Prefetch the leaf next to the current one if the next key in the sorted
+ * batch is out of the current leaf.
+ */
+static void
+btr_probe_prefetch(struct btr_context *tcx, char *hkey_next)
+{
+	struct btr_trace	*trace;
+	struct btr_node		*nd;
+	TMMID(struct btr_node)	 nd_mmid;
+
+	if (tcx->tc_depth < 2)
+		return;
+
+	trace = &tcx->tc_trace[tcx->tc_depth - 1];
+	nd = btr_mmid2ptr(tcx, trace->tr_node);
+	if (btr_hkey_cmp(tcx, btr_node_rec_at(tcx, trace->tr_node,
+					      nd->tn_keyn - 1),
+			 hkey_next) != BTR_CMP_LT)
+		return;
+
+	trace--;
+	nd = btr_mmid2ptr(tcx, trace->tr_node);
+	if (trace->tr_at >= nd->tn_keyn)
+		return;
+
+	nd_mmid = btr_node_child_at(tcx, trace->tr_node, trace->tr_at + 1);
+	nd = btr_mmid2ptr(tcx, nd_mmid);
+	__builtin_prefetch(nd);
+	__builtin_prefetch(btr_node_rec_at(tcx, nd_mmid, nd->tn_keyn / 2));
+}
+
+/**
+ * Look up a batch of keys and return their values, it is equivalent to
+ * calling dbtree_lookup() for each key, but it is more efficient.
+ *
+ * Keys are sorted by hkey (unless the tree has BTR_FEAT_DIRECT_KEY), each
+ * probe starts from the lowest node on the path of the previous probe
+ * which covers the key, instead of descending from the root, so nodes
+ * shared by multiple keys are only searched once.
+ *
+ * \param toh		[IN]	Tree open handle.
+ * \param keys		[IN]	Array of keys to search.
+ * \param vals		[OUT]	Array of returned value addresses, or sink
+ *				buffers to store returned values.
+ * \param rcs		[OUT]	Array of lookup results of keys, zero if the
+ *				key is found, otherwise negative error code,
+ *				e.g. -DER_NONEXIST.
+ * \param nr		[IN]	Number of keys.
+ *
+ * \return		0	all keys have been searched
+ *			-ve	error code
+ */
+int
+dbtree_lookup_batch(daos_handle_t toh, daos_iov_t *keys, daos_iov_t *vals,
+		    int *rcs, unsigned int nr)
+{
+	struct btr_bulk_sort	 bs = { 0 };
+	struct btr_context	*tcx;
+	char			*hkey;
+	bool			 sorted;
+	bool			 restart;
+	uint64_t		 skey[2];
+	int			 level;
+	int			 idx;
+	int			 i;
+	int			 rc = 0;
+
+	tcx = btr_hdl2tcx(toh);
+	if (tcx == NULL)
+		return -DER_NO_HDL;
+
+	memset(&tcx->tc_traces[0], 0,
+	       sizeof(tcx->tc_traces[0]) * BTR_TRACE_MAX);
+	btr_context_set_depth(tcx, tcx->tc_tins.ti_root->tr_depth);
+
+	if (btr_root_empty(tcx)) {
+		for (i = 0; i < nr; i++)
+			rcs[i] = -DER_NONEXIST;
+		return 0;
+	}
+
+	D_ALLOC(bs.bs_recs, nr * sizeof(*bs.bs_recs));
+	if (bs.bs_recs == NULL)
+		D_GOTO(out, rc = -DER_NOMEM);
+
+	/* direct keys can't be sorted without the tree */
+	sorted = !(tcx->tc_feats & BTR_FEAT_DIRECT_KEY);
+	if (sorted) {
+		D_ALLOC(bs.bs_idx, nr * sizeof(*bs.bs_idx));
+		if (bs.bs_idx == NULL)
+			D_GOTO(out, rc = -DER_NOMEM);
+
+		bs.bs_tcx = tcx;
+		for (i = 0; i < nr; i++)
+			btr_hkey_gen(tcx, &keys[i],
+				     &bs.bs_recs[i].rb_rec.rec_hkey[0]);
+
+		btr_bulk_sort(&bs, nr, false);
+	}
+
+	for (i = 0, restart = true; i < nr; i++) {
+		struct btr_record *rec;
+
+		idx = sorted ? bs.bs_idx[i] : i;
+		hkey = &bs.bs_recs[idx].rb_rec.rec_hkey[0];
+		if (tcx->tc_feats & BTR_FEAT_KEY_ARRAY)
+			btr_key_normalize(tcx, hkey, skey);
+
+		level = restart ? 0 : btr_probe_climb(tcx, &keys[idx], hkey);
+		D_DEBUG(DB_TRACE, "Probe key %d from level %d\n", i, level);
+
+		rc = btr_probe_level(tcx, BTR_PROBE_EQ, level, &keys[idx],
+				     hkey, skey);
+		/* path can be incomplete on error, probe from the root */
+		restart = (rc == PROBE_RC_ERR);
+		if (rc != PROBE_RC_EQ) {
+			rcs[idx] = -DER_NONEXIST;
+			continue;
+		}
+
+		rec = btr_trace2rec(tcx, tcx->tc_depth - 1);
+		rcs[idx] = btr_rec_fetch(tcx, rec, NULL, &vals[idx]);
+
+		if (sorted && i + 1 < nr) {
+			btr_probe_prefetch(tcx, &bs.bs_recs[bs.bs_idx[i + 1]].
+						rb_rec.rec_hkey[0]);
+		}
+	}
+	rc = 0;
+ out:
+	D_FREE(bs.bs_recs);
+	D_FREE(bs.bs_idx);
+	return rc;
+}
+
 /**
  * Delete the leaf record pointed by @cur_tr from the current node, then fill
  * the deletion gap by shifting remainded records on the specified direction.
@@ -1604,6 +2513,7 @@ btr_node_del_leaf_only(struct btr_context *tcx, struct btr_trace *trace,
 		btr_rec_move(tcx, btr_rec_at(tcx, rec, 1), rec,
 			     trace->tr_at);
 	}
+	btr_node_keys_sync(tcx, trace->tr_node);
 }
 
 /**
@@ -1682,6 +2592,10 @@ btr_node_del_leaf_rebal(struct btr_context *tcx,
 	}
 	cur_nd->tn_keyn++;
 	sib_nd->tn_keyn--;
+
+	btr_node_keys_sync(tcx, cur_tr->tr_node);
+	btr_node_keys_sync(tcx, sib_mmid);
+	btr_node_keys_sync(tcx, par_tr->tr_node);
 }
 
 /**
@@ -1752,6 +2666,8 @@ btr_node_del_leaf_merge(struct btr_context *tcx,
 		dst_nd->tn_keyn += src_nd->tn_keyn;
 		D_ASSERT(dst_nd->tn_keyn < tcx->tc_order);
 		src_nd->tn_keyn = 0;
+		btr_node_keys_sync(tcx, sib_on_right ?
+				   cur_tr->tr_node : sib_mmid);
 	}
 
 	/* point at the node that needs be removed from the parent */
@@ -1862,6 +2778,7 @@ btr_node_del_child_only(struct btr_context *tcx, struct btr_trace *trace,
 			rec->rec_mmid = umem_id_t2u(nd->tn_child);
 		}
 	}
+	btr_node_keys_sync(tcx, trace->tr_node);
 }
 
 /**
@@ -1927,6 +2844,10 @@ btr_node_del_child_rebal(struct btr_context *tcx,
 	}
 	cur_nd->tn_keyn++;
 	sib_nd->tn_keyn--;
+
+	btr_node_keys_sync(tcx, cur_tr->tr_node);
+	btr_node_keys_sync(tcx, sib_mmid);
+	btr_node_keys_sync(tcx, par_tr->tr_node);
 }
 
 /**
@@ -2000,6 +2921,7 @@ btr_node_del_child_merge(struct btr_context *tcx,
 	dst_nd->tn_keyn += src_nd->tn_keyn + 1;
 	D_ASSERT(dst_nd->tn_keyn < tcx->tc_order);
 	src_nd->tn_keyn = 0;
+	btr_node_keys_sync(tcx, sib_on_right ? cur_tr->tr_node : sib_mmid);
 
 	/* point at the node that needs be removed from the parent */
 	par_tr->tr_at += sib_on_right;
@@ -2644,6 +3566,16 @@ dbtree_close(daos_handle_t toh)
 	return 0;
 }
 
+/**
+ * DRAM consumed by an open tree handle, for callers which retain handles and
+ * account for their memory, e.g. the VOS object cache.
+ */
+size_t
+dbtree_hdl_size(daos_handle_t toh)
+{
+	return btr_hdl2tcx(toh) == NULL ? 0 : sizeof(struct btr_context);
+}
+
 /** Destroy a tree node and all its children recursively. */
 static void
 btr_node_destroy(struct btr_context *tcx, TMMID(struct btr_node) nd_mmid,
@@ -3175,13 +4107,37 @@ btr_class_init(TMMID(struct btr_root) root_mmid, struct btr_root *root,
 		*tree_feats |= special_feat;
 	}
 
-	if ((*tree_feats & tc->tc_feats) != *tree_feats) {
+	/* BTR_FEAT_KEY_ARRAY is implemented by the library, it is not
+	 * required to be registered by the class.
+	 */
+	if ((*tree_feats & (tc->tc_feats | BTR_FEAT_KEY_ARRAY)) !=
+	    *tree_feats) {
 		D_ERROR("Unsupported features "DF_X64"/"DF_X64"\n",
 			*tree_feats, tc->tc_feats);
 		return -DER_PROTO;
 	}
 
 	tins->ti_ops = tc->tc_ops;
+
+	if (*tree_feats & BTR_FEAT_KEY_ARRAY) {
+		int	size;
+
+		if (*tree_feats & BTR_FEAT_DIRECT_KEY) {
+			D_ERROR("Key array can't be used by direct key\n");
+			return -DER_INVAL;
+		}
+
+		if (!(*tree_feats & BTR_FEAT_UINT_KEY)) {
+			size = tc->tc_ops->to_hkey_size(tins);
+			if (tc->tc_ops->to_hkey_cmp != NULL ||
+			    (size != sizeof(uint64_t) &&
+			     size != 2 * sizeof(uint64_t))) {
+				D_ERROR("Key array is unsupported by class "
+					"%d, hkey size %d\n", tree_class, size);
+				return -DER_INVAL;
+			}
+		}
+	}
 	return rc;
 }
 
@@ -3218,5 +4174,7 @@ dbtree_class_register(unsigned int tree_class, uint64_t tree_feats,
 	btr_class_registered[tree_class].tc_ops = ops;
 	btr_class_registered[tree_class].tc_feats = tree_feats;
 
+	btr_key_scan_init();
+
 	return 0;
 }
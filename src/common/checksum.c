@@ -39,8 +39,218 @@ static struct daos_csum_entry	csum_dict[] = {
 		.cs_name	= "crc64",
 		.cs_size	= sizeof(uint64_t),
 	},
+	[DAOS_CS_CRC32C] = {
+		.cs_name	= "crc32c",
+		.cs_size	= sizeof(uint32_t),
+	},
+	[DAOS_CS_XXH64] = {
+		.cs_name	= "xxh64",
+		.cs_size	= sizeof(uint64_t),
+	},
 };
 
+/** type of checksum \a csum */
+static inline int
+daos_csum_type(daos_csum_t *csum)
+{
+#if defined(__x86_64__)
+	return csum->dc_csum;
+#else
+	return csum->dc_type;
+#endif
+}
+
+/**
+ * xxHash64, see https://github.com/Cyan4973/xxHash
+ *
+ * Input is consumed in stripes of 32 bytes by four independent accumulators,
+ * the remainder is mixed into the result by xxh64_digest(). It's plain C, so
+ * it's also used on platforms without ISA-L.
+ */
+#define XXH_P1		11400714785074694791ULL
+#define XXH_P2		14029467366897019727ULL
+#define XXH_P3		1609587929392839161ULL
+#define XXH_P4		9650029242287828579ULL
+#define XXH_P5		2870177450012600261ULL
+#define XXH_STRIPE	32
+
+static inline uint64_t
+xxh_rotl(uint64_t x, int r)
+{
+	return (x << r) | (x >> (64 - r));
+}
+
+static inline uint64_t
+xxh_read64(const uint8_t *p)
+{
+	uint64_t v;
+
+	memcpy(&v, p, sizeof(v)); /* little endian */
+	return v;
+}
+
+static inline uint32_t
+xxh_read32(const uint8_t *p)
+{
+	uint32_t v;
+
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static inline uint64_t
+xxh64_round(uint64_t acc, uint64_t input)
+{
+	acc += input * XXH_P2;
+	acc = xxh_rotl(acc, 31);
+	return acc * XXH_P1;
+}
+
+static inline uint64_t
+xxh64_merge(uint64_t acc, uint64_t val)
+{
+	acc ^= xxh64_round(0, val);
+	return acc * XXH_P1 + XXH_P4;
+}
+
+static inline void
+xxh64_stripe(uint64_t *v, const uint8_t *p)
+{
+	v[0] = xxh64_round(v[0], xxh_read64(p));
+	v[1] = xxh64_round(v[1], xxh_read64(p + 8));
+	v[2] = xxh64_round(v[2], xxh_read64(p + 16));
+	v[3] = xxh64_round(v[3], xxh_read64(p + 24));
+}
+
+static void
+xxh64_reset(struct daos_xxh64_state *st)
+{
+	memset(st, 0, sizeof(*st));
+	/* seed is always zero */
+	st->xs_v[0] = XXH_P1 + XXH_P2;
+	st->xs_v[1] = XXH_P2;
+	st->xs_v[2] = 0;
+	st->xs_v[3] = -XXH_P1;
+}
+
+static void
+xxh64_update(struct daos_xxh64_state *st, const uint8_t *p, uint64_t len)
+{
+	uint32_t fill;
+
+	if (len == 0)
+		return;
+
+	st->xs_total += len;
+	if (st->xs_memsize + len < XXH_STRIPE) {
+		memcpy(st->xs_mem + st->xs_memsize, p, len);
+		st->xs_memsize += len;
+		return;
+	}
+
+	if (st->xs_memsize != 0) {
+		fill = XXH_STRIPE - st->xs_memsize;
+		memcpy(st->xs_mem + st->xs_memsize, p, fill);
+		xxh64_stripe(st->xs_v, st->xs_mem);
+		p += fill;
+		len -= fill;
+		st->xs_memsize = 0;
+	}
+
+	for (; len >= XXH_STRIPE; p += XXH_STRIPE, len -= XXH_STRIPE)
+		xxh64_stripe(st->xs_v, p);
+
+	if (len != 0) {
+		memcpy(st->xs_mem, p, len);
+		st->xs_memsize = len;
+	}
+}
+
+static uint64_t
+xxh64_digest(const struct daos_xxh64_state *st)
+{
+	const uint64_t	*v = st->xs_v;
+	const uint8_t	*p = st->xs_mem;
+	uint32_t	 len = st->xs_memsize;
+	uint64_t	 h;
+
+	if (st->xs_total >= XXH_STRIPE) {
+		h = xxh_rotl(v[0], 1) + xxh_rotl(v[1], 7) +
+		    xxh_rotl(v[2], 12) + xxh_rotl(v[3], 18);
+		h = xxh64_merge(h, v[0]);
+		h = xxh64_merge(h, v[1]);
+		h = xxh64_merge(h, v[2]);
+		h = xxh64_merge(h, v[3]);
+	} else {
+		h = v[2] /* seed */ + XXH_P5;
+	}
+	h += st->xs_total;
+
+	for (; len >= 8; p += 8, len -= 8) {
+		h ^= xxh64_round(0, xxh_read64(p));
+		h = xxh_rotl(h, 27) * XXH_P1 + XXH_P4;
+	}
+	if (len >= 4) {
+		h ^= (uint64_t)xxh_read32(p) * XXH_P1;
+		h = xxh_rotl(h, 23) * XXH_P2 + XXH_P3;
+		p += 4;
+		len -= 4;
+	}
+	for (; len > 0; p++, len--) {
+		h ^= (*p) * XXH_P5;
+		h = xxh_rotl(h, 11) * XXH_P1;
+	}
+
+	h ^= h >> 33;
+	h *= XXH_P2;
+	h ^= h >> 29;
+	h *= XXH_P3;
+	h ^= h >> 32;
+	return h;
+}
+
+/** number of buffers hashed in lockstep by xxh64_lanes() */
+#define XXH_LANES	4
+
+/**
+ * Compute xxHash64 of up to XXH_LANES buffers in parallel lanes.
+ *
+ * Stripes of all lanes are consumed in lockstep while each lane has a full
+ * stripe, accumulators of different lanes have no dependency on each other,
+ * so the CPU can overlap their multiplications, which is the bottleneck
+ * when hashing a single buffer.
+ */
+static void
+xxh64_lanes(daos_iov_t *iovs, int nr, daos_csum_buf_t *csums)
+{
+	struct daos_xxh64_state	st[XXH_LANES];
+	uint64_t		min = UINT64_MAX;
+	uint64_t		off;
+	uint64_t		h;
+	int			i;
+
+	D_ASSERT(nr <= XXH_LANES);
+	for (i = 0; i < nr; i++) {
+		xxh64_reset(&st[i]);
+		min = min(min, iovs[i].iov_len);
+	}
+
+	for (off = 0; off + XXH_STRIPE <= min; off += XXH_STRIPE) {
+		for (i = 0; i < nr; i++)
+			xxh64_stripe(st[i].xs_v,
+				     (uint8_t *)iovs[i].iov_buf + off);
+	}
+
+	for (i = 0; i < nr; i++) {
+		st[i].xs_total = off;
+		if (iovs[i].iov_len > off)
+			xxh64_update(&st[i], (uint8_t *)iovs[i].iov_buf + off,
+				     iovs[i].iov_len - off);
+		h = xxh64_digest(&st[i]);
+		memcpy(csums[i].cs_csum, &h, sizeof(h));
+	}
+}
+
 /**
  * This function converts checksum name to csum_type
  */
@@ -60,6 +270,19 @@ daos_name_to_type(const char *cs_name)
 	return DAOS_CS_UNKNOWN;
 }
 
+/**
+ * This function returns name of checksum type \a type, or NULL if the type
+ * is not supported.
+ */
+const char *
+daos_csum_type2name(unsigned int type)
+{
+	if (type >= DAOS_CS_MAX)
+		return NULL;
+
+	return csum_dict[type].cs_name;
+}
+
 
 /**
  * This function initializes a checksum and
@@ -79,12 +302,14 @@ daos_csum_init(const char *cs_name, daos_csum_t *cs_obj)
 #if defined(__x86_64__)
 	cs_obj->dc_csum = type;
 #else
-	rc = mchecksum_init(cs_name, &cs_obj->dc_csum);
-	if (rc < 0) {
+	cs_obj->dc_type = type;
+	if (type != DAOS_CS_XXH64 &&
+	    mchecksum_init(cs_name, &cs_obj->dc_csum) < 0) {
 		D_ERROR("Error in initializing checksum\n");
 		return -DER_NOMEM;
 	}
 #endif
+	xxh64_reset(&cs_obj->dc_xxh64);
 	cs_obj->dc_init = 1;
 	memset(cs_obj->dc_buf, 0, DAOS_CSUM_SIZE);
 	D_DEBUG(DB_IO, "Initialize checksum=%s\n", dict->cs_name);
@@ -96,13 +321,16 @@ daos_csum_reset(daos_csum_t *cs_obj)
 {
 	if (!cs_obj->dc_init)
 		return -DER_UNINIT;
-#if defined(__x86_64__)
 	memset(cs_obj->dc_buf, 0, DAOS_CSUM_SIZE);
-#else
-	rc = mchecksum_reset(cs_obj->dc_csum);
-	if (rc < 0) {
-		D_ERROR("Error resetting mchecksum: %d\n", rc);
-		return -DER_UNINIT;
+	xxh64_reset(&cs_obj->dc_xxh64);
+#if !defined(__x86_64__)
+	if (cs_obj->dc_type != DAOS_CS_XXH64) {
+		int rc = mchecksum_reset(cs_obj->dc_csum);
+
+		if (rc < 0) {
+			D_ERROR("Error resetting mchecksum: %d\n", rc);
+			return -DER_UNINIT;
+		}
 	}
 #endif
 	return 0;
@@ -112,7 +340,8 @@ inline int
 daos_csum_free(daos_csum_t *cs_obj)
 {
 #if !defined(__x86_64__)
-	mchecksum_destroy(cs_obj->dc_csum);
+	if (cs_obj->dc_type != DAOS_CS_XXH64)
+		mchecksum_destroy(cs_obj->dc_csum);
 #endif
 	return 0;
 }
@@ -120,53 +349,57 @@ daos_csum_free(daos_csum_t *cs_obj)
 inline daos_size_t
 daos_csum_get_size(daos_csum_t *csum)
 {
-#if defined(__x86_64__)
-	return csum_dict[csum->dc_csum].cs_size;
-#else
-	return mchecksum_get_size(*checksum);
+	return csum_dict[daos_csum_type(csum)].cs_size;
+}
+
+/** store result of hash which doesn't keep it in dc_buf */
+static void
+daos_csum_finalize(daos_csum_t *csum)
+{
+	uint64_t h;
+
+	if (daos_csum_type(csum) != DAOS_CS_XXH64) {
+#if !defined(__x86_64__)
+		mchecksum_get(csum->dc_csum, csum->dc_buf,
+			      daos_csum_get_size(csum), MCHECKSUM_FINALIZE);
 #endif
+		return;
+	}
+
+	h = xxh64_digest(&csum->dc_xxh64);
+	memcpy(csum->dc_buf, &h, sizeof(h));
 }
 
 inline int
 daos_csum_get(daos_csum_t *csum, daos_csum_buf_t *csum_buf)
 {
-	if (csum_buf->cs_buf_len != csum_dict[csum->dc_csum].cs_size) {
+	if (csum_buf->cs_buf_len != daos_csum_get_size(csum)) {
 		D_ERROR("Incorrect result buffer size provided\n");
 		return -DER_INVAL;
 	}
-#if defined(__x86_64__)
-	memcpy(csum_buf->cs_csum, csum->dc_buf,
-	       csum_dict[csum->dc_csum].cs_size);
-#else
-	mchecksum_get(csum, csum_buf->cs_csum, csum_buf->cs_buf_len,
-		      MCHECKSUM_FINALIZE);
-#endif
+	daos_csum_finalize(csum);
+	memcpy(csum_buf->cs_csum, csum->dc_buf, daos_csum_get_size(csum));
 	return 0;
 }
 inline int
 daos_csum_compare(daos_csum_t *csum, daos_csum_t *csum_src)
 {
-
-#if defined(__x86_64__)
-	return (csum->dc_csum == csum_src->dc_csum) &&
+	daos_csum_finalize(csum);
+	daos_csum_finalize(csum_src);
+	return (daos_csum_type(csum) == daos_csum_type(csum_src)) &&
 		!(memcmp(csum->dc_buf, csum_src->dc_buf,
-			 csum_dict[csum->dc_csum].cs_size));
-#else
-	size_t	hash_size;
-
-	hash_size = mchecksum_get_size(csum_src.dc_csum);
-	mchecksum_get(csum_src.dc_csum, &csum_src.dc_buf, hash_size,
-		      MCHECKSUM_FINALIZE);
-	mchecksum_get(csum.dc_csum, &csum.dc_buf, hash_size,
-		      MCHEKSUM_FINALIZE);
-	return !(strncmp(csum_src.dc_buf, csum.dc_buf, hash_size));
-#endif
+			 daos_csum_get_size(csum)));
 }
 
 static int
 daos_csum_update(daos_csum_t *csum, const void *buf,
 		 uint64_t len)
 {
+	if (daos_csum_type(csum) == DAOS_CS_XXH64) {
+		xxh64_update(&csum->dc_xxh64, buf, len);
+		return 0;
+	}
+
 #if defined(__x86_64__)
 	switch (csum->dc_csum) {
 	case DAOS_CS_CRC64:
@@ -180,9 +413,13 @@ daos_csum_update(daos_csum_t *csum, const void *buf,
 		break;
 	}
 	case DAOS_CS_CRC32:
+	case DAOS_CS_CRC32C:
 	{
 		uint32_t *cur_crc32;
 
+		/* NB: crc32_iscsi of ISA-L is CRC32C, it folds the input with
+		 * PCLMULQDQ and the SSE4.2 crc32 instruction.
+		 */
 		cur_crc32 = (uint32_t *)csum->dc_buf;
 		*cur_crc32 = crc32_iscsi((unsigned char *)buf,
 					 (int)len,
@@ -198,7 +435,7 @@ daos_csum_update(daos_csum_t *csum, const void *buf,
 	/* accumulates a partial checksum of the input data */
 	int	 rc;
 
-	rc = mchecksum_update(csum->checksum, buf, len);
+	rc = mchecksum_update(csum->dc_csum, buf, len);
 	if (rc < 1)
 		return -DER_NOSYS;
 #endif
@@ -209,7 +446,7 @@ int
 daos_csum_compute(daos_csum_t *csum, daos_sg_list_t *sgl)
 {
 	int	i;
-	int	rc;
+	int	rc = 0;
 
 	if (!sgl->sg_iovs)
 		return 0;
@@ -229,3 +466,127 @@ failed:
 	return rc;
 }
 
+/**
+ * Compute checksum of each iov of \a sgl separately, checksum of the i-th
+ * iov is returned in \a csums[i]. \a csum only provides the checksum type,
+ * its running checksum is not changed.
+ */
+int
+daos_csum_compute_iovs(daos_csum_t *csum, daos_sg_list_t *sgl,
+		       daos_csum_buf_t *csums)
+{
+	daos_csum_t	tmp;
+	daos_size_t	size;
+	daos_iov_t	*iov;
+	int		i;
+	int		rc;
+
+	if (!sgl->sg_iovs)
+		return 0;
+
+	size = daos_csum_get_size(csum);
+	for (i = 0; i < sgl->sg_nr_out; i++) {
+		if (csums[i].cs_buf_len != size || csums[i].cs_csum == NULL) {
+			D_ERROR("Incorrect result buffer size provided\n");
+			return -DER_INVAL;
+		}
+		csums[i].cs_len = size;
+	}
+
+	if (daos_csum_type(csum) == DAOS_CS_XXH64) {
+		for (i = 0; i < sgl->sg_nr_out; i += XXH_LANES)
+			xxh64_lanes(&sgl->sg_iovs[i],
+				    min(XXH_LANES, sgl->sg_nr_out - i),
+				    &csums[i]);
+		return 0;
+	}
+	/* CRC kernels of ISA-L are already vectorized for one buffer */
+	tmp = *csum;
+	for (i = 0; i < sgl->sg_nr_out; i++) {
+		iov = &sgl->sg_iovs[i];
+		rc = daos_csum_reset(&tmp);
+		if (rc == 0 && iov->iov_buf != NULL && iov->iov_len != 0)
+			rc = daos_csum_update(&tmp, iov->iov_buf,
+					      iov->iov_len);
+		if (rc == 0)
+			rc = daos_csum_get(&tmp, &csums[i]);
+		if (rc != 0) {
+			D_ERROR("Error in computing checksum: %d\n", rc);
+			return rc;
+		}
+	}
+	return 0;
+}
+
+/**
+ * Compute checksums of \a nr consecutive ranges of \a sgl, the i-th range is
+ * \a lens[i] bytes and starts right after the end of the (i-1)-th range, its
+ * checksum is returned in \a csums[i]. \a csum only provides the checksum
+ * type, its running checksum is not changed.
+ *
+ * It is used to checksum each extent of an I/O descriptor separately, while
+ * data of all extents are packed in the same sgl.
+ */
+int
+daos_csum_compute_ranges(daos_csum_t *csum, daos_sg_list_t *sgl,
+			 unsigned int nr, daos_size_t *lens,
+			 daos_csum_buf_t *csums)
+{
+	daos_csum_t	tmp;
+	daos_size_t	size;
+	daos_size_t	off = 0; /* offset within the current iov */
+	unsigned int	at = 0;	 /* index of the current iov */
+	int		i;
+	int		rc;
+
+	size = daos_csum_get_size(csum);
+	tmp = *csum;
+	for (i = 0; i < nr; i++) {
+		daos_size_t	left = lens[i];
+
+		if (csums[i].cs_buf_len != size || csums[i].cs_csum == NULL) {
+			D_ERROR("Incorrect result buffer size provided\n");
+			return -DER_INVAL;
+		}
+
+		rc = daos_csum_reset(&tmp);
+		if (rc != 0)
+			return rc;
+
+		while (left > 0) {
+			daos_iov_t	*iov;
+			daos_size_t	 nob;
+
+			if (at >= sgl->sg_nr) {
+				D_ERROR("sgl is shorter than ranges, "
+					DF_U64" bytes left\n", left);
+				return -DER_INVAL;
+			}
+
+			iov = &sgl->sg_iovs[at];
+			nob = min(left, iov->iov_len - off);
+			if (nob != 0 && iov->iov_buf != NULL) {
+				rc = daos_csum_update(&tmp, iov->iov_buf + off,
+						      nob);
+				if (rc != 0) {
+					D_ERROR("Error in updating checksum: "
+						"%d\n", rc);
+					return -DER_IO;
+				}
+			}
+
+			off += nob;
+			left -= nob;
+			if (off == iov->iov_len) { /* move to the next iov */
+				off = 0;
+				at++;
+			}
+		}
+
+		rc = daos_csum_get(&tmp, &csums[i]);
+		if (rc != 0)
+			return rc;
+		csums[i].cs_len = size;
+	}
+	return 0;
+}
@@ -87,6 +87,643 @@ static d_hash_table_ops_t lru_ops = {
 };
 
 
+/**
+ * Shared cache
+ *
+ * Items are linked on singly linked hash buckets, which are read without
+ * lock. Writers (insertion and removal) are serialized by the shard lock,
+ * they publish changes of bucket with atomic stores, a removed item is
+ * put on the retired list of the shard, and it's freed only if all readers
+ * which might have seen it have left (epoch based reclamation):
+ *
+ * - the global epoch is increased every time an item is retired, and the
+ *   item is tagged with the epoch before the increment.
+ * - a reader publishes the global epoch in its slot before searching a
+ *   bucket, and clears it after taking a reference of the found item.
+ * - a retired item can be freed if all active readers have a larger epoch.
+ *
+ * Items are evicted by a CLOCK hand, so a lookup hit only sets the clock
+ * bit of the item (if it is not set yet) instead of moving it to the list
+ * head.
+ */
+
+/** max number of threads which can search the cache without lock */
+#define LRU_READER_MAX		64
+#define LRU_HASH_SEED		0x5eed1e55
+
+/** a reader slot, it's only written by the owner thread in the fast path */
+struct lru_reader {
+	/** epoch when the reader started to search, zero if it's inactive */
+	uint64_t		lr_epoch;
+	/** lookup hits of the reader */
+	uint64_t		lr_hits;
+	/** lookup misses of the reader */
+	uint64_t		lr_misses;
+} __attribute__((aligned(64)));
+
+struct lru_shard {
+	/** serialize insertion, removal and clock sweep */
+	pthread_mutex_t		 ls_lock;
+	/** hash buckets */
+	struct daos_llink	**ls_buckets;
+	/** retired items waiting for readers */
+	d_list_t		 ls_retired;
+	/** # items in the hash buckets */
+	uint32_t		 ls_nr;
+	/** clock hand, it is a bucket index */
+	uint32_t		 ls_hand;
+	/** total cost of items in the hash buckets */
+	uint64_t		 ls_cost;
+	/** hits, misses of threads without reader slot, and evictions */
+	struct daos_lru_stat	 ls_stat;
+} __attribute__((aligned(64)));
+
+struct lru_shared {
+	/** global epoch for reclamation, it starts from 1 */
+	uint64_t		 ls_epoch;
+	/** number of shards, power of 2 */
+	uint32_t		 ls_shard_nr;
+	/** bits of number of buckets per shard */
+	uint32_t		 ls_bucket_bits;
+	/** max number of items per shard */
+	uint32_t		 ls_shard_csize;
+	/** memory budget per shard, zero means unlimited */
+	uint64_t		 ls_shard_budget;
+	/** shards */
+	struct lru_shard	*ls_shards;
+	/** reader slots, indexed by thread ID */
+	struct lru_reader	 ls_readers[LRU_READER_MAX];
+};
+
+/**
+ * thread ID for reader slots, it is shared by all shared caches, it's
+ * LRU_READER_MAX if the thread has no slot.
+ */
+static __thread int	lru_tid = -1;
+/** bitmap of thread IDs in use, a thread releases its ID on exit */
+static uint64_t		lru_tid_map;
+static pthread_key_t	lru_tid_key;
+static pthread_once_t	lru_tid_once = PTHREAD_ONCE_INIT;
+static int		lru_tid_key_rc;
+
+D_CASSERT(LRU_READER_MAX == sizeof(lru_tid_map) * 8);
+
+/** destructor of \a lru_tid_key, \a arg is the thread ID plus one */
+static void
+lru_tid_free(void *arg)
+{
+	int tid = (int)(uintptr_t)arg - 1;
+
+	/* NB: the slot is inactive, the next owner sees its last state */
+	__atomic_fetch_and(&lru_tid_map, ~(1ULL << tid), __ATOMIC_RELEASE);
+}
+
+static void
+lru_tid_key_create(void)
+{
+	lru_tid_key_rc = pthread_key_create(&lru_tid_key, lru_tid_free);
+	if (lru_tid_key_rc != 0)
+		D_ERROR("Failed to create key of reader slot: %d\n",
+			lru_tid_key_rc);
+}
+
+/**
+ * Take a free thread ID, it returns LRU_READER_MAX if all of them are in
+ * use. The ID is released on thread exit, so it can be reused by threads
+ * created later.
+ */
+static int
+lru_tid_alloc(void)
+{
+	uint64_t	map;
+	int		tid;
+
+	pthread_once(&lru_tid_once, lru_tid_key_create);
+	if (lru_tid_key_rc != 0)
+		return LRU_READER_MAX;
+
+	map = __atomic_load_n(&lru_tid_map, __ATOMIC_RELAXED);
+	do {
+		if (map == ~0ULL)
+			return LRU_READER_MAX;
+		tid = __builtin_ctzll(~map);
+	} while (!__atomic_compare_exchange_n(&lru_tid_map, &map,
+					      map | (1ULL << tid), true,
+					      __ATOMIC_ACQUIRE,
+					      __ATOMIC_RELAXED));
+
+	if (pthread_setspecific(lru_tid_key, (void *)(uintptr_t)(tid + 1))) {
+		lru_tid_free((void *)(uintptr_t)(tid + 1));
+		return LRU_READER_MAX;
+	}
+	return tid;
+}
+
+static struct lru_reader *
+lru_reader_enter(struct lru_shared *ls)
+{
+	struct lru_reader *reader;
+
+	/* a thread without slot retries, some threads might have exited */
+	if (lru_tid < 0 || lru_tid == LRU_READER_MAX)
+		lru_tid = lru_tid_alloc();
+
+	if (lru_tid == LRU_READER_MAX)
+		return NULL; /* too many threads, search with lock */
+
+	reader = &ls->ls_readers[lru_tid];
+	/* NB: seq_cst store, the next search of bucket can't be reordered
+	 * before it, see lru_shared_reclaim().
+	 */
+	__atomic_store_n(&reader->lr_epoch,
+			 __atomic_load_n(&ls->ls_epoch, __ATOMIC_SEQ_CST),
+			 __ATOMIC_SEQ_CST);
+	return reader;
+}
+
+static void
+lru_reader_exit(struct lru_reader *reader)
+{
+	__atomic_store_n(&reader->lr_epoch, 0, __ATOMIC_RELEASE);
+}
+
+/** the shard is over its size or memory budget */
+static inline bool
+lru_shard_full(struct lru_shared *ls, struct lru_shard *shard)
+{
+	return shard->ls_nr > ls->ls_shard_csize ||
+	       (ls->ls_shard_budget != 0 &&
+		shard->ls_cost > ls->ls_shard_budget);
+}
+
+static inline struct lru_shard *
+lru_hash2shard(struct lru_shared *ls, uint32_t hash)
+{
+	return &ls->ls_shards[hash & (ls->ls_shard_nr - 1)];
+}
+
+static inline struct daos_llink **
+lru_hash2bucket(struct lru_shared *ls, struct lru_shard *shard, uint32_t hash)
+{
+	uint32_t idx = hash / ls->ls_shard_nr;
+
+	return &shard->ls_buckets[idx & ((1U << ls->ls_bucket_bits) - 1)];
+}
+
+/** take a reference unless the item is being retired (zero refcount) */
+static bool
+lru_ref_get_unless_zero(struct daos_llink *llink)
+{
+	uint32_t ref = __atomic_load_n(&llink->ll_ref, __ATOMIC_RELAXED);
+
+	do {
+		if (ref == 0)
+			return false;
+	} while (!__atomic_compare_exchange_n(&llink->ll_ref, &ref, ref + 1,
+					      true, __ATOMIC_ACQUIRE,
+					      __ATOMIC_RELAXED));
+	return true;
+}
+
+/** drop the reference of cache if nobody else holds the item */
+static bool
+lru_ref_put_idle(struct daos_llink *llink)
+{
+	uint32_t ref = 1;
+
+	return __atomic_compare_exchange_n(&llink->ll_ref, &ref, 0, false,
+					   __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+}
+
+static struct daos_llink *
+lru_shared_search(struct daos_lru_cache *lcache, struct daos_llink **bucket,
+		  uint32_t hash, void *key, unsigned int key_size)
+{
+	struct daos_llink *llink;
+
+	llink = __atomic_load_n(bucket, __ATOMIC_ACQUIRE);
+	for (; llink != NULL;
+	     llink = __atomic_load_n(&llink->ll_next, __ATOMIC_ACQUIRE)) {
+		if (llink->ll_hash != hash || daos_lru_ref_evicted(llink))
+			continue;
+
+		if (!lcache->dlc_ops->lop_cmp_keys(key, key_size, llink))
+			continue;
+
+		if (!lru_ref_get_unless_zero(llink))
+			continue;
+
+		/* avoid writing to the item if the bit is already set */
+		if (!__atomic_load_n(&llink->ll_clock, __ATOMIC_RELAXED))
+			__atomic_store_n(&llink->ll_clock, 1, __ATOMIC_RELAXED);
+		return llink;
+	}
+	return NULL;
+}
+
+/** free retired items which can't be seen by any reader, shard is locked */
+static void
+lru_shared_reclaim(struct lru_shared *ls, struct lru_shard *shard)
+{
+	struct daos_llink *llink;
+	struct daos_llink *tmp;
+	uint64_t	   min = UINT64_MAX;
+	uint64_t	   epoch;
+	int		   i;
+
+	if (d_list_empty(&shard->ls_retired))
+		return;
+
+	/* order the removal from bucket before checking readers */
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	for (i = 0; i < LRU_READER_MAX; i++) {
+		epoch = __atomic_load_n(&ls->ls_readers[i].lr_epoch,
+					__ATOMIC_SEQ_CST);
+		if (epoch != 0 && epoch < min)
+			min = epoch;
+	}
+
+	d_list_for_each_entry_safe(llink, tmp, &shard->ls_retired, ll_qlink) {
+		if (llink->ll_retire >= min)
+			continue;
+
+		d_list_del_init(&llink->ll_qlink);
+		llink->ll_ops->lop_free_ref(llink);
+	}
+}
+
+/**
+ * Remove an item from its bucket and retire it, the caller has dropped the
+ * reference of cache and holds the shard lock.
+ */
+static void
+lru_shared_unlink(struct lru_shared *ls, struct lru_shard *shard,
+		  struct daos_llink *llink)
+{
+	struct daos_llink **prev;
+
+	D_ASSERT(__atomic_load_n(&llink->ll_ref, __ATOMIC_RELAXED) == 0);
+	prev = lru_hash2bucket(ls, shard, llink->ll_hash);
+	while (*prev != llink) {
+		D_ASSERT(*prev != NULL);
+		prev = &(*prev)->ll_next;
+	}
+	/* NB: don't reset ll_next, readers might be on this item */
+	__atomic_store_n(prev, llink->ll_next, __ATOMIC_RELEASE);
+	shard->ls_nr--;
+	shard->ls_cost -= llink->ll_cost;
+
+	llink->ll_retire = __atomic_fetch_add(&ls->ls_epoch, 1,
+					      __ATOMIC_SEQ_CST);
+	d_list_add_tail(&llink->ll_qlink, &shard->ls_retired);
+}
+
+/** CLOCK sweep until the shard is within its size, shard is locked */
+static void
+lru_shared_sweep(struct lru_shared *ls, struct lru_shard *shard)
+{
+	struct daos_llink *llink;
+	struct daos_llink *next;
+	uint32_t	   mask = (1U << ls->ls_bucket_bits) - 1;
+	uint32_t	   i;
+
+	/* give up after two rounds, all items could be busy */
+	for (i = 0; i <= 2 * mask && lru_shard_full(ls, shard); i++) {
+		llink = shard->ls_buckets[shard->ls_hand];
+		shard->ls_hand = (shard->ls_hand + 1) & mask;
+
+		for (; llink != NULL; llink = next) {
+			next = llink->ll_next;
+			if (__atomic_load_n(&llink->ll_clock,
+					    __ATOMIC_RELAXED)) {
+				__atomic_store_n(&llink->ll_clock, 0,
+						 __ATOMIC_RELAXED);
+				continue;
+			}
+
+			if (!lru_ref_put_idle(llink))
+				continue; /* busy */
+
+			D_DEBUG(DB_TRACE, "Evict %p from shared cache\n",
+				llink);
+			lru_shared_unlink(ls, shard, llink);
+			shard->ls_stat.ls_evictions++;
+		}
+	}
+	lru_shared_reclaim(ls, shard);
+}
+
+static int
+lru_shared_hold(struct daos_lru_cache *lcache, void *key,
+		unsigned int key_size, void *create_args,
+		struct daos_llink **rlink)
+{
+	struct lru_shared	 *ls = lcache->dlc_shared;
+	struct lru_shard	 *shard;
+	struct lru_reader	 *reader;
+	struct daos_llink	**bucket;
+	struct daos_llink	 *llink;
+	uint32_t		  hash;
+	int			  rc;
+
+	hash = d_hash_murmur64(key, key_size, LRU_HASH_SEED);
+	shard = lru_hash2shard(ls, hash);
+	bucket = lru_hash2bucket(ls, shard, hash);
+
+	reader = lru_reader_enter(ls);
+	if (reader != NULL) {
+		llink = lru_shared_search(lcache, bucket, hash, key, key_size);
+		lru_reader_exit(reader);
+		if (llink != NULL) {
+			reader->lr_hits++;
+			D_GOTO(out, rc = 0);
+		}
+		reader->lr_misses++;
+		if (!create_args)
+			return -DER_NONEXIST;
+	}
+
+	D_MUTEX_LOCK(&shard->ls_lock);
+	/* NB: items can't be removed from bucket while holding the lock */
+	llink = lru_shared_search(lcache, bucket, hash, key, key_size);
+	if (reader == NULL) {
+		if (llink != NULL)
+			shard->ls_stat.ls_hits++;
+		else
+			shard->ls_stat.ls_misses++;
+		shard->ls_stat.ls_locked++;
+	}
+
+	if (llink != NULL || !create_args) {
+		D_MUTEX_UNLOCK(&shard->ls_lock);
+		D_GOTO(out, rc = llink != NULL ? 0 : -DER_NONEXIST);
+	}
+
+	rc = lcache->dlc_ops->lop_alloc_ref(key, key_size, create_args,
+					    &llink);
+	if (rc) {
+		D_MUTEX_UNLOCK(&shard->ls_lock);
+		return rc;
+	}
+
+	D_DEBUG(DB_TRACE, "Inserting %p into shared cache\n", llink);
+	llink->ll_evicted = 0;
+	/* 2Q: a new item is the first candidate of the CLOCK hand */
+	llink->ll_clock	  = (lcache->dlc_policy == DAOS_LRU_POL_LRU);
+	llink->ll_ref	  = 2; /* 1 for caller, 1 for cache */
+	llink->ll_hash	  = hash;
+	llink->ll_ops	  = lcache->dlc_ops;
+	llink->ll_next	  = *bucket;
+	D_INIT_LIST_HEAD(&llink->ll_qlink);
+	/* publish the fully initialized item */
+	__atomic_store_n(bucket, llink, __ATOMIC_RELEASE);
+	shard->ls_nr++;
+	shard->ls_cost += llink->ll_cost;
+
+	if (lru_shard_full(ls, shard))
+		lru_shared_sweep(ls, shard);
+	D_MUTEX_UNLOCK(&shard->ls_lock);
+out:
+	if (rc == 0)
+		*rlink = llink;
+	return rc;
+}
+
+static void
+lru_shared_release(struct daos_lru_cache *lcache, struct daos_llink *llink)
+{
+	struct lru_shared	*ls = lcache->dlc_shared;
+	struct lru_shard	*shard;
+	struct lru_reader	*reader;
+	uint32_t		 ref;
+
+	shard = lru_hash2shard(ls, llink->ll_hash);
+	/* NB: the item can be evicted by others once the reference is
+	 * dropped, it can only be accessed within the reader epoch (or
+	 * shard lock) after that.
+	 */
+	reader = lru_reader_enter(ls);
+	if (reader == NULL)
+		D_MUTEX_LOCK(&shard->ls_lock);
+
+	ref = __atomic_sub_fetch(&llink->ll_ref, 1, __ATOMIC_RELEASE);
+	D_ASSERT(ref >= 1);
+	if (ref == 1 && daos_lru_ref_evicted(llink)) {
+		/* the last holder of an evicted item, remove it */
+		if (reader != NULL)
+			D_MUTEX_LOCK(&shard->ls_lock);
+
+		if (lru_ref_put_idle(llink)) {
+			D_DEBUG(DB_TRACE, "Evict %p from shared cache\n",
+				llink);
+			lru_shared_unlink(ls, shard, llink);
+		}
+		if (reader != NULL)
+			D_MUTEX_UNLOCK(&shard->ls_lock);
+	}
+
+	if (reader != NULL)
+		lru_reader_exit(reader);
+	else
+		D_MUTEX_UNLOCK(&shard->ls_lock);
+}
+
+static void
+lru_shared_evict(struct daos_lru_cache *lcache, daos_lru_cond_cb_t cond,
+		 void *args)
+{
+	struct lru_shared	*ls = lcache->dlc_shared;
+	struct lru_shard	*shard;
+	struct daos_llink	*llink;
+	struct daos_llink	*next;
+	unsigned int		 cntr = 0;
+	int			 i;
+	int			 j;
+
+	for (i = 0; i < ls->ls_shard_nr; i++) {
+		shard = &ls->ls_shards[i];
+
+		D_MUTEX_LOCK(&shard->ls_lock);
+		for (j = 0; j < (1U << ls->ls_bucket_bits); j++) {
+			llink = shard->ls_buckets[j];
+			for (; llink != NULL; llink = next) {
+				next = llink->ll_next;
+				if (cond != NULL && !cond(llink, args))
+					continue;
+
+				/* busy items will be removed on release */
+				daos_lru_ref_evict(llink);
+				if (lru_ref_put_idle(llink)) {
+					lru_shared_unlink(ls, shard, llink);
+					cntr++;
+				}
+			}
+		}
+		lru_shared_reclaim(ls, shard);
+		D_MUTEX_UNLOCK(&shard->ls_lock);
+	}
+	D_DEBUG(DB_TRACE, "Evicted %d items from shared cache\n", cntr);
+}
+
+static void
+lru_shared_destroy(struct daos_lru_cache *lcache)
+{
+	struct lru_shared	*ls = lcache->dlc_shared;
+	struct lru_shard	*shard;
+	int			 i;
+
+	lru_shared_evict(lcache, NULL, NULL);
+	for (i = 0; i < ls->ls_shard_nr; i++) {
+		shard = &ls->ls_shards[i];
+
+		D_ASSERTF(shard->ls_nr == 0, "busy=%u\n", shard->ls_nr);
+		/* nobody is supposed to search the cache now */
+		D_ASSERT(d_list_empty(&shard->ls_retired));
+		D_MUTEX_DESTROY(&shard->ls_lock);
+		D_FREE(shard->ls_buckets);
+	}
+	D_FREE(ls->ls_shards);
+	D_FREE_PTR(ls);
+}
+
+int
+daos_lru_cache_create_shared(int bits, int shard_bits,
+			     struct daos_llink_ops *ops,
+			     struct daos_lru_cache **lcache)
+{
+	struct daos_lru_cache	*lru_cache;
+	struct lru_shared	*ls;
+	struct lru_shard	*shard;
+	int			 i;
+	int			 rc = 0;
+
+	D_DEBUG(DB_TRACE, "Creating a shared cache of size (2^%d), "
+		"shards (2^%d)\n", bits, shard_bits);
+
+	if (ops == NULL ||
+	    ops->lop_cmp_keys == NULL ||
+	    ops->lop_alloc_ref == NULL ||
+	    ops->lop_free_ref == NULL) {
+		D_ERROR("Error missing ops/mandatory-ops for LRU cache\n");
+		return -DER_INVAL;
+	}
+
+	if (bits < 0 || shard_bits < 0 || shard_bits > bits) {
+		D_ERROR("Invalid cache size 2^%d, shards 2^%d\n",
+			bits, shard_bits);
+		return -DER_INVAL;
+	}
+
+	D_ALLOC_PTR(lru_cache);
+	if (lru_cache == NULL)
+		return -DER_NOMEM;
+
+	D_ALLOC_PTR(ls);
+	if (ls == NULL)
+		D_GOTO(failed, rc = -DER_NOMEM);
+
+	lru_cache->dlc_shared = ls;
+	lru_cache->dlc_csize = (1 << bits);
+	lru_cache->dlc_ops = ops;
+
+	ls->ls_epoch = 1;
+	ls->ls_shard_nr = (1 << shard_bits);
+	ls->ls_shard_csize = (1 << (bits - shard_bits));
+	/* one bucket for two items, same as the LRU cache */
+	ls->ls_bucket_bits = max(2, bits - shard_bits - 1);
+
+	D_ALLOC(ls->ls_shards, ls->ls_shard_nr * sizeof(*ls->ls_shards));
+	if (ls->ls_shards == NULL)
+		D_GOTO(failed, rc = -DER_NOMEM);
+
+	for (i = 0; i < ls->ls_shard_nr; i++) {
+		shard = &ls->ls_shards[i];
+
+		D_INIT_LIST_HEAD(&shard->ls_retired);
+		D_ALLOC(shard->ls_buckets,
+			sizeof(*shard->ls_buckets) << ls->ls_bucket_bits);
+		if (shard->ls_buckets == NULL)
+			break;
+
+		rc = D_MUTEX_INIT(&shard->ls_lock, NULL);
+		if (rc != 0) {
+			D_FREE(shard->ls_buckets);
+			break;
+		}
+	}
+
+	if (i < ls->ls_shard_nr) {
+		while (--i >= 0) {
+			D_MUTEX_DESTROY(&ls->ls_shards[i].ls_lock);
+			D_FREE(ls->ls_shards[i].ls_buckets);
+		}
+		D_FREE(ls->ls_shards);
+		D_GOTO(failed, rc = rc ? rc : -DER_NOMEM);
+	}
+
+	*lcache = lru_cache;
+	return 0;
+failed:
+	if (ls != NULL)
+		D_FREE_PTR(ls);
+	D_FREE_PTR(lru_cache);
+	return rc;
+}
+
+void
+daos_lru_cache_stat(struct daos_lru_cache *lcache, struct daos_lru_stat *stat)
+{
+	struct lru_shared	*ls = lcache->dlc_shared;
+	struct lru_shard	*shard;
+	int			 i;
+
+	if (ls == NULL) {
+		*stat = lcache->dlc_stat;
+		stat->ls_nr = lcache->dlc_busy_nr + lcache->dlc_idle_nr;
+		stat->ls_cost = lcache->dlc_cost;
+		return;
+	}
+
+	/* NB: counters are read without lock, it's just a snapshot */
+	memset(stat, 0, sizeof(*stat));
+	for (i = 0; i < LRU_READER_MAX; i++) {
+		stat->ls_hits += ls->ls_readers[i].lr_hits;
+		stat->ls_misses += ls->ls_readers[i].lr_misses;
+	}
+
+	for (i = 0; i < ls->ls_shard_nr; i++) {
+		shard = &ls->ls_shards[i];
+		stat->ls_hits += shard->ls_stat.ls_hits;
+		stat->ls_misses += shard->ls_stat.ls_misses;
+		stat->ls_evictions += shard->ls_stat.ls_evictions;
+		stat->ls_locked += shard->ls_stat.ls_locked;
+		stat->ls_nr += shard->ls_nr;
+		stat->ls_cost += shard->ls_cost;
+	}
+}
+
+int
+daos_lru_cache_config(struct daos_lru_cache *lcache, uint64_t budget,
+		      enum daos_lru_policy policy)
+{
+	struct lru_shared *ls = lcache->dlc_shared;
+
+	if (policy != DAOS_LRU_POL_LRU && policy != DAOS_LRU_POL_2Q) {
+		D_ERROR("Invalid LRU policy %d\n", policy);
+		return -DER_INVAL;
+	}
+
+	D_DEBUG(DB_TRACE, "LRU cache budget "DF_U64", policy %d\n",
+		budget, policy);
+	lcache->dlc_budget = budget;
+	lcache->dlc_policy = policy;
+	if (ls != NULL && budget != 0)
+		ls->ls_shard_budget = max(budget / ls->ls_shard_nr, 1);
+	else if (ls != NULL)
+		ls->ls_shard_budget = 0;
+	return 0;
+}
+
 int
 daos_lru_cache_create(int bits, uint32_t feats,
 		      struct daos_llink_ops *ops,
@@ -124,6 +761,7 @@ daos_lru_cache_create(int bits, uint32_t feats,
 	lru_cache->dlc_ops = ops;
 
 	D_INIT_LIST_HEAD(&lru_cache->dlc_idle_list);
+	D_INIT_LIST_HEAD(&lru_cache->dlc_probe_list);
 	D_INIT_LIST_HEAD(&lru_cache->dlc_busy_list);
 
 	*lcache = lru_cache;
@@ -139,6 +777,11 @@ daos_lru_cache_destroy(struct daos_lru_cache *lcache)
 {
 
 	D_DEBUG(DB_TRACE, "Destroying LRU cache\n");
+	if (lcache->dlc_shared != NULL) {
+		lru_shared_destroy(lcache);
+		D_FREE_PTR(lcache);
+		return;
+	}
 	/**
 	 * Cannot destroy if either lcache is NULL or
 	 * if there are busy references.
@@ -151,14 +794,120 @@ daos_lru_cache_destroy(struct daos_lru_cache *lcache)
 	D_FREE_PTR(lcache);
 }
 
+/** remove an idle item from the idle or probation list */
+static void
+lru_idle_del(struct daos_lru_cache *lcache, struct daos_llink *llink)
+{
+	D_ASSERT(lcache->dlc_idle_nr > 0);
+	lcache->dlc_idle_nr--;
+	if (!llink->ll_clock) {
+		D_ASSERT(lcache->dlc_probe_nr > 0);
+		lcache->dlc_probe_nr--;
+		lcache->dlc_probe_cost -= llink->ll_cost;
+	}
+	d_list_del_init(&llink->ll_qlink);
+}
+
+/**
+ * Move an item to the head of the idle list, or the probation list if it
+ * hasn't been referenced again since insertion (2Q policy).
+ */
+static void
+lru_idle_add(struct daos_lru_cache *lcache, struct daos_llink *llink)
+{
+	lcache->dlc_idle_nr++;
+	if (llink->ll_clock) {
+		d_list_move(&llink->ll_qlink, &lcache->dlc_idle_list);
+		return;
+	}
+	lcache->dlc_probe_nr++;
+	lcache->dlc_probe_cost += llink->ll_cost;
+	d_list_move(&llink->ll_qlink, &lcache->dlc_probe_list);
+}
+
+/** delete an item from hash table, it's freed within hash callback */
+static void
+lru_delete(struct daos_lru_cache *lcache, struct daos_llink *llink)
+{
+	lcache->dlc_cost -= llink->ll_cost;
+	d_hash_rec_delete_at(&lcache->dlc_htable, &llink->ll_hlink);
+}
+
+/** the cache is over its size or memory budget */
+static inline bool
+lru_full(struct daos_lru_cache *lcache)
+{
+	return lcache->dlc_busy_nr + lcache->dlc_idle_nr >= lcache->dlc_csize ||
+	       (lcache->dlc_budget != 0 &&
+		lcache->dlc_cost > lcache->dlc_budget);
+}
+
+/**
+ * Evict idle items until the cache is within its size and budget. Items on
+ * the probation list are evicted first if they take more than a quarter of
+ * the cache, so a scan can only flush that much of the working set.
+ */
+static void
+lru_evict_idle(struct daos_lru_cache *lcache)
+{
+	struct daos_llink *llink;
+	d_list_t	  *head;
+
+	while (lcache->dlc_idle_nr != 0 && lru_full(lcache)) {
+		D_DEBUG(DB_TRACE, "Evicting from object cache :%d, %d\n",
+			lcache->dlc_idle_nr, lcache->dlc_busy_nr);
+
+		head = &lcache->dlc_idle_list;
+		if (lcache->dlc_probe_nr != 0 &&
+		    (lcache->dlc_probe_nr == lcache->dlc_idle_nr ||
+		     lcache->dlc_probe_nr >= (lcache->dlc_csize >> 2) ||
+		     (lcache->dlc_budget != 0 &&
+		      lcache->dlc_probe_cost >= (lcache->dlc_budget >> 2))))
+			head = &lcache->dlc_probe_list;
+
+		/** evict from the tail of the list */
+		D_ASSERT(!d_list_empty(head));
+		llink = container_of(head->prev, struct daos_llink, ll_qlink);
+
+		lru_idle_del(lcache, llink);
+		/* tell lop_free_ref it has been evicted */
+		llink->ll_evicted = 1;
+		lru_delete(lcache, llink);
+		lcache->dlc_stat.ls_evictions++;
+	}
+}
+
+static void
+lru_evict_list(struct daos_lru_cache *lcache, d_list_t *head,
+	       daos_lru_cond_cb_t cond, void *args)
+{
+	struct daos_llink *llink;
+	struct daos_llink *tmp;
+	unsigned int	   cntr = 0;
+
+	d_list_for_each_entry_safe(llink, tmp, head, ll_qlink) {
+		if (cond == NULL || cond(llink, args)) {
+			lru_idle_del(lcache, llink);
+			lru_delete(lcache, llink);
+			cntr++;
+		}
+	}
+	D_DEBUG(DB_TRACE, "Evicted %d items from %s list\n", cntr,
+		head == &lcache->dlc_idle_list ? "idle" : "probation");
+}
+
 void
 daos_lru_cache_evict(struct daos_lru_cache *lcache,
 		     daos_lru_cond_cb_t cond, void *args)
 {
 	struct daos_llink *llink;
-	struct daos_llink *tmp;
 	unsigned int	   cntr;
 
+	if (lcache->dlc_shared != NULL) {
+		lru_shared_evict(lcache, cond, args);
+		return;
+	}
+
 	cntr = 0;
 	d_list_for_each_entry(llink, &lcache->dlc_busy_list, ll_qlink) {
 		if (cond == NULL || cond(llink, args))
@@ -167,18 +916,8 @@ daos_lru_cache_evict(struct daos_lru_cache *lcache,
 	}
 	D_DEBUG(DB_TRACE, "Marked %d busy items as evicted\n", cntr);
 
-	cntr = 0;
-	d_list_for_each_entry_safe(llink, tmp, &lcache->dlc_idle_list,
-				   ll_qlink) {
-		if (cond == NULL || cond(llink, args)) {
-			d_list_del_init(&llink->ll_qlink);
-			d_hash_rec_delete_at(&lcache->dlc_htable,
-					     &llink->ll_hlink);
-			lcache->dlc_idle_nr--;
-			cntr++;
-		}
-	}
-	D_DEBUG(DB_TRACE, "Evicted %d items from idle list\n", cntr);
+	lru_evict_list(lcache, &lcache->dlc_idle_list, cond, args);
+	lru_evict_list(lcache, &lcache->dlc_probe_list, cond, args);
 }
 
 static struct daos_llink *
@@ -228,12 +967,10 @@ lru_mark_busy(struct daos_lru_cache *lcache, struct daos_llink *llink)
 	D_DEBUG(DB_TRACE, "Ref to get busy held: %u, filled :%u\n",
 		lcache->dlc_busy_nr, lcache->dlc_idle_nr);
 
-	if (d_list_empty(&llink->ll_qlink)) { /* new item */
-		d_list_add(&llink->ll_qlink, &lcache->dlc_busy_list);
-	} else {
-		lcache->dlc_idle_nr--;
-		d_list_move(&llink->ll_qlink, &lcache->dlc_busy_list);
-	}
+	if (!d_list_empty(&llink->ll_qlink)) /* not a new item */
+		lru_idle_del(lcache, llink);
+
+	d_list_add(&llink->ll_qlink, &lcache->dlc_busy_list);
 	lcache->dlc_busy_nr++;
 }
 
@@ -249,18 +986,23 @@ daos_lru_ref_hold(struct daos_lru_cache *lcache, void *key,
 	if (lcache->dlc_ops->lop_print_key)
 		lcache->dlc_ops->lop_print_key(key, key_size);
 
+	if (lcache->dlc_shared != NULL)
+		return lru_shared_hold(lcache, key, key_size, create_args,
+				       rlink);
+
 	llink = lru_fast_search(lcache, &lcache->dlc_busy_list, key, key_size);
 	if (llink)
-		D_GOTO(found, rc = 0);
+		D_GOTO(hit, rc = 0);
 
 	llink = lru_fast_search(lcache, &lcache->dlc_idle_list, key, key_size);
 	if (llink)
-		D_GOTO(found, rc = 0);
+		D_GOTO(hit, rc = 0);
 
 	llink = lru_hash_search(lcache, key, key_size);
 	if (llink)
-		D_GOTO(found, rc = 0);
+		D_GOTO(hit, rc = 0);
 
+	lcache->dlc_stat.ls_misses++;
 	if (!create_args)
 		D_GOTO(out, rc = -DER_NONEXIST);
 
@@ -272,6 +1014,8 @@ daos_lru_ref_hold(struct daos_lru_cache *lcache, void *key,
 
 	D_DEBUG(DB_TRACE, "Inserting into LRU Hash table\n");
 	llink->ll_evicted = 0;
+	/* 2Q: it stays on probation until it is referenced again */
+	llink->ll_clock	  = (lcache->dlc_policy == DAOS_LRU_POL_LRU);
 	llink->ll_ref	  = 1; /* 1 for caller */
 	llink->ll_ops	  = lcache->dlc_ops;
 	D_INIT_LIST_HEAD(&llink->ll_qlink);
@@ -279,10 +1023,18 @@ daos_lru_ref_hold(struct daos_lru_cache *lcache, void *key,
 	rc = d_hash_rec_insert(&lcache->dlc_htable, key, key_size,
 			       &llink->ll_hlink, true);
 	D_ASSERT(rc == 0);
-found:
+	lcache->dlc_cost += llink->ll_cost;
+	lru_mark_busy(lcache, llink);
+	goto found;
+hit:
+	lcache->dlc_stat.ls_hits++;
 	if (llink->ll_ref == 2) /* 1 for hash, 1 for the first holder */
 		lru_mark_busy(lcache, llink);
-
+	/* NB: set it after lru_mark_busy, it tells which list the item was
+	 * on, the item will be moved to the main LRU on release.
+	 */
+	llink->ll_clock = 1;
+found:
 	*rlink = llink;
 out:
 	return rc;
@@ -291,6 +1043,11 @@ out:
 void
 daos_lru_ref_release(struct daos_lru_cache *lcache, struct daos_llink *llink)
 {
+	if (lcache->dlc_shared != NULL) {
+		lru_shared_release(lcache, llink);
+		return;
+	}
+
 	D_ASSERT(lcache != NULL && llink != NULL && llink->ll_ref > 1);
 	D_DEBUG(DB_TRACE, "Releasing item %p, ref=%d\n", llink, llink->ll_ref);
 
@@ -305,31 +1062,42 @@ daos_lru_ref_release(struct daos_lru_cache *lcache, struct daos_llink *llink)
 		if (llink->ll_evicted) {
 			D_DEBUG(DB_TRACE, "Evict %p from LRU cache\n", llink);
 			d_list_del_init(&llink->ll_qlink);
-			/* be freed within hash callback */
-			d_hash_rec_delete_at(&lcache->dlc_htable,
-					     &llink->ll_hlink);
+			lru_delete(lcache, llink);
 		} else {
 			D_DEBUG(DB_TRACE,
 				"Moving %p to the idle list\n", llink);
-			lcache->dlc_idle_nr++;
-			d_list_move(&llink->ll_qlink, &lcache->dlc_idle_list);
+			lru_idle_add(lcache, llink);
 		}
 	}
 
-	while (lcache->dlc_idle_nr != 0 &&
-	       (lcache->dlc_busy_nr + lcache->dlc_idle_nr >=
-		lcache->dlc_csize)) {
-		D_DEBUG(DB_TRACE, "Evicting from object cache :%d, %d\n",
-			lcache->dlc_idle_nr, lcache->dlc_busy_nr);
+	lru_evict_idle(lcache);
+	D_DEBUG(DB_TRACE, "Done releasing reference\n");
+}
 
-		/** evict from the tail of the list */
-		D_ASSERT(!d_list_empty(&lcache->dlc_idle_list));
-		llink = container_of(lcache->dlc_idle_list.prev,
-				     struct daos_llink, ll_qlink);
+void
+daos_lru_ref_cost_set(struct daos_lru_cache *lcache, struct daos_llink *llink,
+		      uint32_t cost)
+{
+	struct lru_shared	*ls = lcache->dlc_shared;
+	struct lru_shard	*shard;
 
-		d_list_del_init(&llink->ll_qlink);
-		d_hash_rec_delete_at(&lcache->dlc_htable, &llink->ll_hlink);
-		lcache->dlc_idle_nr--;
+	D_DEBUG(DB_TRACE, "Item %p cost %u -> %u\n", llink, llink->ll_cost,
+		cost);
+	if (ls == NULL) {
+		/* busy items are not on the probation list */
+		D_ASSERT(llink->ll_ref > 1);
+		lcache->dlc_cost = lcache->dlc_cost - llink->ll_cost + cost;
+		llink->ll_cost = cost;
+		lru_evict_idle(lcache);
+		return;
 	}
-	D_DEBUG(DB_TRACE, "Done releasing reference\n");
+
+	D_ASSERT(__atomic_load_n(&llink->ll_ref, __ATOMIC_RELAXED) > 1);
+	shard = lru_hash2shard(ls, llink->ll_hash);
+	D_MUTEX_LOCK(&shard->ls_lock);
+	shard->ls_cost = shard->ls_cost - llink->ll_cost + cost;
+	llink->ll_cost = cost;
+	if (lru_shard_full(ls, shard))
+		lru_shared_sweep(ls, shard);
+	D_MUTEX_UNLOCK(&shard->ls_lock);
 }
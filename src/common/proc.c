@@ -552,6 +552,10 @@ struct crt_msg_field DMF_REC_SIZE_ARRAY =
 	DEFINE_CRT_MSG("daos_rec_size", CMF_ARRAY_FLAG, sizeof(uint64_t),
 			crt_proc_uint64_t);
 
+struct crt_msg_field DMF_CSUM_ARRAY =
+	DEFINE_CRT_MSG("daos_csum_buf_t", CMF_ARRAY_FLAG,
+			sizeof(daos_csum_buf_t), daos_proc_csum_buf);
+
 struct crt_msg_field DMF_NR_ARRAY =
 	DEFINE_CRT_MSG("daos_rec_size", CMF_ARRAY_FLAG, sizeof(uint32_t),
 			crt_proc_uint32_t);
@@ -273,6 +273,10 @@ ik_btr_open_create(bool create, char *args)
 			feats = BTR_FEAT_UINT_KEY;
 			args += 1;
 		}
+		if (args[0] == 'k') { /* search node by key array */
+			feats |= BTR_FEAT_KEY_ARRAY;
+			args += 1;
+		}
 		if (args[0] == 'i') { /* inplace create/open */
 			inplace = true;
 			if (args[1] != IK_SEP) {
@@ -667,16 +671,107 @@ ik_btr_gen_keys(unsigned int *arr, unsigned int key_nr)
 	}
 }
 
+/* insert all keys of @arr by dbtree_bulk_insert */
+static int
+ik_btr_bulk_insert(unsigned int *arr, unsigned int key_nr)
+{
+	daos_iov_t	*keys;
+	daos_iov_t	*vals;
+	uint64_t	*ukeys;
+	char		*strs;
+	unsigned int	 new_nr = 0;
+	int		 i;
+	int		 rc;
+
+	keys = malloc(key_nr * sizeof(*keys));
+	vals = malloc(key_nr * sizeof(*vals));
+	ukeys = malloc(key_nr * sizeof(*ukeys));
+	strs = malloc(key_nr * 16);
+	D_ASSERT(keys != NULL && vals != NULL && ukeys != NULL &&
+		 strs != NULL);
+
+	for (i = 0; i < key_nr; i++) {
+		ukeys[i] = arr[i];
+		sprintf(&strs[i * 16], "%u", arr[i]);
+		daos_iov_set(&keys[i], &ukeys[i], sizeof(ukeys[i]));
+		daos_iov_set(&vals[i], &strs[i * 16],
+			     strlen(&strs[i * 16]) + 1);
+	}
+
+	rc = dbtree_bulk_insert(ik_toh, keys, vals, key_nr, 0, &new_nr);
+	if (rc == 0 && new_nr != key_nr) {
+		D_PRINT("Bulk inserted %u records, expected %u\n",
+			new_nr, key_nr);
+		rc = -1;
+	}
+
+	free(keys);
+	free(vals);
+	free(ukeys);
+	free(strs);
+	return rc;
+}
+
+/* lookup all keys of @arr by dbtree_lookup_batch */
+static int
+ik_btr_lookup_batch(unsigned int *arr, unsigned int key_nr, bool exist)
+{
+	daos_iov_t	*keys;
+	daos_iov_t	*vals;
+	uint64_t	*ukeys;
+	int		*rcs;
+	char		 buf[16];
+	int		 i;
+	int		 rc;
+
+	keys = malloc(key_nr * sizeof(*keys));
+	vals = malloc(key_nr * sizeof(*vals));
+	ukeys = malloc(key_nr * sizeof(*ukeys));
+	rcs = malloc(key_nr * sizeof(*rcs));
+	D_ASSERT(keys != NULL && vals != NULL && ukeys != NULL &&
+		 rcs != NULL);
+
+	for (i = 0; i < key_nr; i++) {
+		ukeys[i] = arr[i];
+		daos_iov_set(&keys[i], &ukeys[i], sizeof(ukeys[i]));
+		daos_iov_set(&vals[i], NULL, 0); /* get address */
+	}
+
+	rc = dbtree_lookup_batch(ik_toh, keys, vals, rcs, key_nr);
+	for (i = 0; i < key_nr && rc == 0; i++) {
+		if (!exist) {
+			if (rcs[i] != -DER_NONEXIST) {
+				D_PRINT("Found deleted key %u\n", arr[i]);
+				rc = -1;
+			}
+			continue;
+		}
+
+		sprintf(buf, "%u", arr[i]);
+		if (rcs[i] != 0 || strcmp(vals[i].iov_buf, buf) != 0) {
+			D_PRINT("Failed to lookup key %u: %d\n", arr[i],
+				rcs[i]);
+			rc = -1;
+		}
+	}
+
+	free(keys);
+	free(vals);
+	free(ukeys);
+	free(rcs);
+	return rc;
+}
+
 #define DEL_BATCH	10000
 /**
  * batch btree operations:
- * 1) insert @key_nr number of integer keys
+ * 1) insert @key_nr number of integer keys, either one by one or in bulk
  * 2) lookup all the rest keys
  * 3) delete nr=DEL_BATCH keys
  * 4) repeat 2) and 3) util all keys are deleted
  */
 static int
-ik_btr_batch_oper(unsigned int key_nr)
+ik_btr_batch_oper(unsigned int key_nr, bool bulk)
 {
 	unsigned int	*arr;
 	char		 buf[64];
@@ -692,9 +787,17 @@ ik_btr_batch_oper(unsigned int key_nr)
 	arr = malloc(key_nr * sizeof(*arr));
 	D_ASSERT(arr != NULL);
 
-	D_PRINT("Batch add %d records.\n", key_nr);
+	D_PRINT("Batch add %d records%s.\n", key_nr, bulk ? " in bulk" : "");
 	ik_btr_gen_keys(arr, key_nr);
-	for (i = 0; i < key_nr; i++) {
+	if (bulk) {
+		rc = ik_btr_bulk_insert(arr, key_nr);
+		if (rc != 0) {
+			D_PRINT("Bulk insert failed: %d\n", rc);
+			return -1;
+		}
+	}
+
+	for (i = 0; i < key_nr && !bulk; i++) {
 		sprintf(buf, "%d:%d", arr[i], arr[i]);
 
 		rc = ik_btr_kv_operate(BTR_OPC_UPDATE, buf, verbose);
@@ -713,6 +816,14 @@ ik_btr_batch_oper(unsigned int key_nr)
 		int	j;
 
 		D_PRINT("Batch lookup %d records.\n", key_nr - i);
+		rc = ik_btr_lookup_batch(&arr[i], key_nr - i, true);
+		if (rc == 0 && i > 0)
+			rc = ik_btr_lookup_batch(arr, i, false);
+		if (rc != 0) {
+			D_PRINT("Batch lookup failed: %d\n", rc);
+			return -1;
+		}
+
 		for (j = i; j < key_nr; j++) {
 			sprintf(buf, "%d", arr[j]);
 
@@ -814,6 +925,93 @@ out:
 	return rc;
 }
 
+/**
+ * Compare lookup performance of the default node layout and the key array
+ * (BTR_FEAT_KEY_ARRAY) layout, both trees have the same order and keys.
+ */
+static int
+ik_btr_probe_perf(unsigned int key_nr)
+{
+	unsigned int	*arr;
+	uint64_t	 feats[2];
+	int		 i;
+	int		 j;
+	int		 rc = 0;
+
+	if (key_nr == 0 || key_nr > (1U << 28)) {
+		D_PRINT("Invalid key number: %d\n", key_nr);
+		return -1;
+	}
+
+	if (!daos_handle_is_inval(ik_toh)) {
+		D_ERROR("Tree has been opened\n");
+		return -1;
+	}
+
+	D_PRINT("Btree probe performance test, order=%u, keys=%u\n",
+		ik_order, key_nr);
+
+	arr = malloc(key_nr * sizeof(*arr));
+	D_ASSERT(arr != NULL);
+
+	feats[0] = BTR_FEAT_UINT_KEY;
+	feats[1] = BTR_FEAT_UINT_KEY | BTR_FEAT_KEY_ARRAY;
+
+	for (i = 0; i < 2; i++) {
+		daos_iov_t	key_iov;
+		daos_iov_t	val_iov;
+		uint64_t	key;
+		double		then;
+		double		now;
+
+		rc = dbtree_create(IK_TREE_CLASS, feats[i], ik_order, &ik_uma,
+				   &ik_root_mmid, &ik_toh);
+		if (rc != 0) {
+			D_ERROR("Failed to create tree: %d\n", rc);
+			D_GOTO(out, rc = -1);
+		}
+
+		ik_btr_gen_keys(arr, key_nr);
+		for (j = 0; j < key_nr; j++) {
+			key = arr[j];
+			daos_iov_set(&key_iov, &key, sizeof(key));
+			daos_iov_set(&val_iov, &key, sizeof(key));
+			rc = dbtree_update(ik_toh, &key_iov, &val_iov);
+			if (rc != 0) {
+				D_ERROR("update failed: %d\n", rc);
+				D_GOTO(out_tree, rc = -1);
+			}
+		}
+
+		ik_btr_gen_keys(arr, key_nr);
+		then = dts_time_now();
+		for (j = 0; j < key_nr; j++) {
+			key = arr[j];
+			daos_iov_set(&key_iov, &key, sizeof(key));
+			daos_iov_set(&val_iov, NULL, 0);
+			rc = dbtree_lookup(ik_toh, &key_iov, &val_iov);
+			if (rc != 0) {
+				D_ERROR("lookup "DF_U64" failed: %d\n",
+					key, rc);
+				D_GOTO(out_tree, rc = -1);
+			}
+		}
+		now = dts_time_now();
+		D_PRINT("%-9s layout: lookup = %10.2f/sec, %6.1f ns/probe\n",
+			i == 0 ? "record" : "key array", key_nr / (now - then),
+			(now - then) * 1e9 / key_nr);
+out_tree:
+		dbtree_destroy(ik_toh);
+		ik_toh = DAOS_HDL_INVAL;
+		ik_root_mmid = TMMID_NULL(struct btr_root);
+		if (rc != 0)
+			break;
+	}
+out:
+	free(arr);
+	return rc;
+}
+
 static struct option btr_ops[] = {
 	{ "create",	required_argument,	NULL,	'C'	},
 	{ "destroy",	no_argument,		NULL,	'D'	},
@@ -826,7 +1024,9 @@ static struct option btr_ops[] = {
 	{ "query",	no_argument,		NULL,	'q'	},
 	{ "iterate",	required_argument,	NULL,	'i'	},
 	{ "batch",	required_argument,	NULL,	'b'	},
+	{ "bulk",	required_argument,	NULL,	'B'	},
 	{ "perf",	required_argument,	NULL,	'p'	},
+	{ "probe_perf",	required_argument,	NULL,	'P'	},
 	{ NULL,		0,			NULL,	0	},
 };
 
@@ -848,7 +1048,7 @@ main(int argc, char **argv)
 
 	optind = 0;
 	ik_uma.uma_id = UMEM_CLASS_VMEM;
-	while ((rc = getopt_long(argc, argv, "mC:Docqu:d:r:f:i:b:p:",
+	while ((rc = getopt_long(argc, argv, "mC:Docqu:d:r:f:i:b:B:p:P:",
 				 btr_ops, NULL)) != -1) {
 		switch (rc) {
 		case 'C':
@@ -883,11 +1083,17 @@ main(int argc, char **argv)
 			rc = ik_btr_iterate(optarg);
 			break;
 		case 'b':
-			rc = ik_btr_batch_oper(atoi(optarg));
+			rc = ik_btr_batch_oper(atoi(optarg), false);
+			break;
+		case 'B':
+			rc = ik_btr_batch_oper(atoi(optarg), true);
 			break;
 		case 'p':
 			rc = ik_btr_perf(atoi(optarg));
 			break;
+		case 'P':
+			rc = ik_btr_probe_perf(atoi(optarg));
+			break;
 		case 'm':
 			ik_uma.uma_id = UMEM_CLASS_PMEM;
 			ik_uma.uma_u.pmem_pool = pmemobj_create(POOL_NAME,
@@ -29,6 +29,7 @@ Usage: btree.sh [OPTIONS]
     Options:
         -s [num]  Run with num keys
         ukey      Use integer keys
+        karray    Search tree nodes by key array
         perf      Run performance tests
         direct    Use direct string key
 EOF
@@ -37,6 +38,7 @@ EOF
 
 PERF=""
 UINT=""
+KARR=""
 while [ $# -gt 0 ]; do
     case "$1" in
     -s)
@@ -56,6 +58,10 @@ while [ $# -gt 0 ]; do
         shift
         UINT="+"
         ;;
+    karray)
+        shift
+        KARR="k"
+        ;;
     direct)
         BTR=$DAOS_DIR/build/src/common/tests/btree_direct
         KEYS=${KEYS:-"delta,lambda,kappa,omega,beta,alpha,epsilon"}
@@ -76,7 +82,7 @@ if [ -z ${PERF} ]; then
 
     echo "B+tree functional test..."
     DAOS_DEBUG=$DDEBUG			\
-    $BTR	-C ${UINT}${IPL}o:$ORDER		\
+    $BTR	-C ${UINT}${KARR}${IPL}o:$ORDER		\
 	-c				\
 	-o				\
 	-u $RECORDS			\
@@ -94,20 +100,32 @@ if [ -z ${PERF} ]; then
 	-D
 
     echo "B+tree batch operations test..."
-    $BTR	-C ${UINT}${IPL}o:$ORDER		\
+    $BTR	-C ${UINT}${KARR}${IPL}o:$ORDER		\
 	-c				\
 	-o				\
 	-b $BAT_NUM			\
 	-D
+
+    echo "B+tree bulk insert test..."
+    $BTR	-C ${UINT}${KARR}${IPL}o:$ORDER		\
+	-c				\
+	-o				\
+	-B $BAT_NUM			\
+	-D
 else
     echo "B+tree performance test..."
-    $BTR	-C ${UINT}${IPL}o:$ORDER		\
+    $BTR	-C ${UINT}${KARR}${IPL}o:$ORDER		\
 	-p $BAT_NUM			\
 	-D
 
+    echo "B+tree probe performance test, record vs key array layout"
+    $BTR	-C ${UINT}${IPL}o:$ORDER		\
+	-c				\
+	-P $BAT_NUM
+
     echo "B+tree performance test using pmemobj"
     $BTR    -m                      \
-	-C ${UINT}${IPL}o:$ORDER   \
+	-C ${UINT}${KARR}${IPL}o:$ORDER   \
 	-p $BAT_NUM             \
 	-D
 fi
@@ -827,6 +827,51 @@ sk_btr_check_order(struct kv_node *kv, unsigned int key_nr)
 	return -1;
 }
 
+/* lookup all keys of @kv by dbtree_lookup_batch */
+static int
+sk_btr_lookup_batch(struct kv_node *kv, unsigned int key_nr, bool exist)
+{
+	daos_iov_t	*keys;
+	daos_iov_t	*vals;
+	int		*rcs;
+	int		 i;
+	int		 rc;
+
+	keys = malloc(key_nr * sizeof(*keys));
+	vals = malloc(key_nr * sizeof(*vals));
+	rcs = malloc(key_nr * sizeof(*rcs));
+	D_ASSERT(keys != NULL && vals != NULL && rcs != NULL);
+
+	for (i = 0; i < key_nr; i++) {
+		keys[i] = kv[i].key;
+		daos_iov_set(&vals[i], NULL, 0); /* get address */
+	}
+
+	rc = dbtree_lookup_batch(sk_toh, keys, vals, rcs, key_nr);
+	for (i = 0; i < key_nr && rc == 0; i++) {
+		if (!exist) {
+			if (rcs[i] != -DER_NONEXIST) {
+				D_PRINT("Found deleted key %s\n",
+					(char *)kv[i].key.iov_buf);
+				rc = -1;
+			}
+			continue;
+		}
+
+		if (rcs[i] != 0 ||
+		    strcmp(vals[i].iov_buf, kv[i].val.iov_buf) != 0) {
+			D_PRINT("Failed to lookup key %s: %d\n",
+				(char *)kv[i].key.iov_buf, rcs[i]);
+			rc = -1;
+		}
+	}
+
+	free(keys);
+	free(vals);
+	free(rcs);
+	return rc;
+}
+
 #define DEL_BATCH	10000
 /**
  * batch btree operations:
@@ -882,6 +927,14 @@ sk_btr_batch_oper(unsigned int key_nr)
 		int	j;
 
 		D_PRINT("Batch lookup %d records.\n", key_nr - i);
+		rc = sk_btr_lookup_batch(&kv[i], key_nr - i, true);
+		if (rc == 0 && i > 0)
+			rc = sk_btr_lookup_batch(kv, i, false);
+		if (rc != 0) {
+			D_PRINT("Batch lookup failed: %d\n", rc);
+			return -1;
+		}
+
 		for (j = i; j < key_nr; j++) {
 			key = kv[j].key.iov_buf;
 			sprintf(buf, "%s", key);
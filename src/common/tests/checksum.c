@@ -24,6 +24,8 @@
 
 #include <string.h>
 #include <errno.h>
+#include <getopt.h>
+#include <sys/time.h>
 
 #include <daos/checksum.h>
 
@@ -65,6 +67,262 @@ exit:
 }
 
 
+static uint64_t
+csum_get_u64(daos_csum_t *csum)
+{
+	daos_csum_buf_t	csum_buf;
+	uint64_t	val = 0;
+
+	daos_csum_set(&csum_buf, &val, daos_csum_get_size(csum));
+	daos_csum_get(csum, &csum_buf);
+	return val;
+}
+
+/* known answers of xxHash64 with zero seed */
+static int
+test_checksum_xxh64(void)
+{
+	static const struct {
+		const char	*str;
+		uint64_t	 val;
+	} vectors[] = {
+		{ "",		0xef46db3751d8e999ULL },
+		{ "a",		0xd24ec4f1a98c6e5bULL },
+		{ "abc",	0x44bc2cf5ad770999ULL },
+		{ "Nobody inspects the spammish repetition",
+				0xfbcea83c8a378bf1ULL },
+	};
+	daos_csum_t	csum;
+	daos_iov_t	iov;
+	daos_sg_list_t	sgl;
+	uint64_t	val;
+	int		i;
+	int		rc;
+
+	rc = daos_csum_init("xxh64", &csum);
+	if (rc != 0)
+		return rc;
+
+	for (i = 0; i < ARRAY_SIZE(vectors); i++) {
+		daos_csum_reset(&csum);
+		daos_iov_set(&iov, (void *)vectors[i].str,
+			     strlen(vectors[i].str));
+		sgl.sg_nr = sgl.sg_nr_out = 1;
+		sgl.sg_iovs = &iov;
+
+		rc = daos_csum_compute(&csum, &sgl);
+		if (rc != 0)
+			break;
+
+		val = csum_get_u64(&csum);
+		if (val != vectors[i].val) {
+			D_ERROR("xxh64 of \"%s\": "DF_X64" != "DF_X64"\n",
+				vectors[i].str, val, vectors[i].val);
+			rc = -DER_IO;
+			break;
+		}
+	}
+	daos_csum_free(&csum);
+	return rc;
+}
+
+#define CSUM_TEST_IOVS	9
+
+/*
+ * Checksum of a buffer should not depend on how it is split into iovs, and
+ * per-iov (or per-range) checksums should match checksums of iovs computed
+ * one by one.
+ */
+static int
+test_checksum_iovs(char *cs_name)
+{
+	daos_iov_t	iovs[CSUM_TEST_IOVS];
+	daos_csum_buf_t	csums[CSUM_TEST_IOVS];
+	uint64_t	vals[CSUM_TEST_IOVS];
+	daos_size_t	lens[CSUM_TEST_IOVS];
+	daos_iov_t	iov;
+	daos_sg_list_t	sgl;
+	daos_csum_t	csum;
+	uint64_t	val;
+	daos_size_t	size;
+	char		buf[4096];
+	int		off;
+	int		i;
+	int		rc;
+
+	rc = daos_csum_init(cs_name, &csum);
+	if (rc != 0)
+		return rc;
+
+	size = daos_csum_get_size(&csum);
+	for (i = 0; i < sizeof(buf); i++)
+		buf[i] = rand();
+
+	daos_iov_set(&iovs[0], buf, sizeof(buf));
+	sgl.sg_nr = sgl.sg_nr_out = 1;
+	sgl.sg_iovs = iovs;
+	rc = daos_csum_compute(&csum, &sgl);
+	if (rc != 0)
+		D_GOTO(out, rc);
+	val = csum_get_u64(&csum);
+
+	/* iovs of odd sizes, across stripes of the hash */
+	for (i = off = 0; i < CSUM_TEST_IOVS - 1; i++) {
+		daos_iov_set(&iovs[i], &buf[off], (i * 67 + 1) % 509);
+		off += iovs[i].iov_len;
+	}
+	daos_iov_set(&iovs[i], &buf[off], sizeof(buf) - off);
+	sgl.sg_nr = sgl.sg_nr_out = CSUM_TEST_IOVS;
+
+	daos_csum_reset(&csum);
+	rc = daos_csum_compute(&csum, &sgl);
+	if (rc != 0)
+		D_GOTO(out, rc);
+	if (csum_get_u64(&csum) != val) {
+		D_ERROR("%s: checksum depends on iovs\n", cs_name);
+		D_GOTO(out, rc = -DER_IO);
+	}
+
+	memset(vals, 0, sizeof(vals));
+	for (i = 0; i < CSUM_TEST_IOVS; i++)
+		daos_csum_set(&csums[i], &vals[i], size);
+
+	rc = daos_csum_compute_iovs(&csum, &sgl, csums);
+	if (rc != 0)
+		D_GOTO(out, rc);
+
+	for (i = 0; i < CSUM_TEST_IOVS; i++) {
+		sgl.sg_iovs = &iovs[i];
+		sgl.sg_nr = sgl.sg_nr_out = 1;
+		daos_csum_reset(&csum);
+		rc = daos_csum_compute(&csum, &sgl);
+		if (rc != 0)
+			D_GOTO(out, rc);
+
+		if (csum_get_u64(&csum) != vals[i]) {
+			D_ERROR("%s: checksum of iov %d mismatch\n",
+				cs_name, i);
+			D_GOTO(out, rc = -DER_IO);
+		}
+	}
+
+	/* ranges which don't align with iovs of sgl */
+	for (i = 0; i < CSUM_TEST_IOVS; i++) {
+		lens[i] = sizeof(buf) / CSUM_TEST_IOVS;
+		vals[i] = 0;
+	}
+	sgl.sg_iovs = iovs;
+	sgl.sg_nr = sgl.sg_nr_out = CSUM_TEST_IOVS;
+	rc = daos_csum_compute_ranges(&csum, &sgl, CSUM_TEST_IOVS, lens,
+				      csums);
+	if (rc != 0)
+		D_GOTO(out, rc);
+
+	for (i = 0; i < CSUM_TEST_IOVS; i++) {
+		daos_iov_set(&iov, &buf[i * lens[i]], lens[i]);
+		sgl.sg_iovs = &iov;
+		sgl.sg_nr = sgl.sg_nr_out = 1;
+		daos_csum_reset(&csum);
+		rc = daos_csum_compute(&csum, &sgl);
+		if (rc != 0)
+			D_GOTO(out, rc);
+
+		if (csum_get_u64(&csum) != vals[i]) {
+			D_ERROR("%s: checksum of range %d mismatch\n",
+				cs_name, i);
+			D_GOTO(out, rc = -DER_IO);
+		}
+	}
+	D_PRINT("%s: iovs test pass\n", cs_name);
+out:
+	daos_csum_free(&csum);
+	return rc;
+}
+
+static double
+csum_now(void)
+{
+	struct timeval	tv;
+
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec + tv.tv_usec / 1000000.0;
+}
+
+/* throughput of checksum on one core, in GB/s */
+static int
+test_checksum_perf(char *cs_name, daos_size_t buf_size, daos_size_t iov_size,
+		   int loops)
+{
+	daos_iov_t	*iovs;
+	daos_csum_buf_t	*csums;
+	uint64_t	*vals;
+	daos_sg_list_t	 sgl;
+	daos_csum_t	 csum;
+	char		*buf;
+	double		 then;
+	double		 whole;
+	double		 per_iov;
+	int		 nr;
+	int		 i;
+	int		 rc;
+
+	rc = daos_csum_init(cs_name, &csum);
+	if (rc != 0)
+		return rc;
+
+	nr = (buf_size + iov_size - 1) / iov_size;
+	D_ALLOC(buf, buf_size);
+	D_ALLOC(iovs, nr * sizeof(*iovs));
+	D_ALLOC(csums, nr * sizeof(*csums));
+	D_ALLOC(vals, nr * sizeof(*vals));
+	if (buf == NULL || iovs == NULL || csums == NULL || vals == NULL)
+		D_GOTO(out, rc = -DER_NOMEM);
+
+	for (i = 0; i < buf_size; i++)
+		buf[i] = i;
+
+	for (i = 0; i < nr; i++) {
+		daos_iov_set(&iovs[i], &buf[i * iov_size],
+			     min(iov_size, buf_size - i * iov_size));
+		daos_csum_set(&csums[i], &vals[i], daos_csum_get_size(&csum));
+	}
+	sgl.sg_nr = sgl.sg_nr_out = nr;
+	sgl.sg_iovs = iovs;
+
+	then = csum_now();
+	for (i = 0; i < loops && rc == 0; i++) {
+		daos_csum_reset(&csum);
+		rc = daos_csum_compute(&csum, &sgl);
+	}
+	whole = csum_now() - then;
+
+	then = csum_now();
+	for (i = 0; i < loops && rc == 0; i++)
+		rc = daos_csum_compute_iovs(&csum, &sgl, csums);
+	per_iov = csum_now() - then;
+	if (rc != 0)
+		D_GOTO(out, rc);
+
+	D_PRINT("%-8s sgl: %6.2f GB/s, per-iov (%d x "DF_U64"): %6.2f GB/s\n",
+		cs_name, (double)buf_size * loops / whole / 1e9, nr, iov_size,
+		(double)buf_size * loops / per_iov / 1e9);
+out:
+	D_FREE(vals);
+	D_FREE(csums);
+	D_FREE(iovs);
+	D_FREE(buf);
+	daos_csum_free(&csum);
+	return rc;
+}
+
+static struct option csum_ops[] = {
+	/** run throughput test on a buffer of this size (MB) */
+	{ "perf",	required_argument,	NULL,	'p'	},
+	/** size of iov (KB) for throughput test, 4KB by default */
+	{ "iov",	required_argument,	NULL,	'i'	},
+	{ NULL,		0,			NULL,	0	},
+};
+
 int main(int argc, char *argv[])
 {
 
@@ -73,7 +331,42 @@ int main(int argc, char *argv[])
 	daos_csum_t	*csum = &csum_local;
 	daos_csum_t	*csum_cmp = &csum_cmp_local;
 	daos_csum_buf_t	csum_buf;
+	daos_size_t	perf_size = 0;
+	daos_size_t	iov_size = 4096;
+	char		*cs_names[] = {"crc32", "crc64", "crc32c", "xxh64"};
 	int		test_fail = 0;
+	int		i;
+
+	while ((rc = getopt_long(argc, argv, "p:i:", csum_ops, NULL)) != -1) {
+		switch (rc) {
+		default:
+			fprintf(stderr, "unknown opc=%c\n", rc);
+			exit(-1);
+		case 'p':
+			perf_size = strtoull(optarg, NULL, 10) << 20;
+			break;
+		case 'i':
+			iov_size = strtoull(optarg, NULL, 10) << 10;
+			break;
+		}
+	}
+
+	if (perf_size != 0) {
+		if (iov_size == 0) {
+			D_ERROR("invalid iov size\n");
+			return -1;
+		}
+		for (i = 0; i < ARRAY_SIZE(cs_names); i++) {
+			/* about 4GB for each checksum */
+			rc = test_checksum_perf(cs_names[i], perf_size,
+						iov_size,
+						max(1, (4ULL << 30) /
+						       perf_size));
+			if (rc != 0)
+				return rc;
+		}
+		return 0;
+	}
 
 	rc = test_checksum_simple("crc64", csum, &csum_buf);
 	if (rc != 0) {
@@ -107,10 +400,24 @@ int main(int argc, char *argv[])
 		D_ERROR("Error in generating crc32 checksum\n");
 		test_fail++;
 	}
+
+	rc = test_checksum_xxh64();
+	if (rc != 0) {
+		D_ERROR("Error in xxh64 known answer test: %d\n", rc);
+		test_fail++;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(cs_names); i++) {
+		rc = test_checksum_iovs(cs_names[i]);
+		if (rc != 0) {
+			D_ERROR("Error in %s iovs test: %d\n", cs_names[i], rc);
+			test_fail++;
+		}
+	}
 	if (test_fail)
 		D_PRINT("%d tests failed\n", test_fail);
 	else
 		D_PRINT("All tests pass\n");
 
-	return rc;
+	return test_fail ? -1 : 0;
 }
@@ -30,9 +30,12 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/mman.h>
+#include <pthread.h>
 #include <daos/common.h>
 #include <daos/lru.h>
 
+#define UINT_REF_COST	100
+
 /** integer key reference */
 struct uint_ref {
 	struct daos_llink	ur_llink;
@@ -62,6 +65,7 @@ uint_ref_lru_alloc(void *key, unsigned int ksize,
 		return -DER_NOMEM;
 	}
 	ref->ur_key = *(uint64_t *)key;
+	ref->ur_llink.ll_cost = UINT_REF_COST;
 	*link = &ref->ur_llink;
 
 	return 0;
@@ -106,6 +110,163 @@ test_ref_hold(struct daos_lru_cache *cache,
 }
 
 
+#define SHARED_THREADS	8
+/* more than reader slots of the shared cache, they should be reused */
+#define SHARED_SEQ_THREADS	256
+
+struct shared_arg {
+	struct daos_lru_cache	*sa_cache;
+	int			 sa_num_keys;
+	int			 sa_seed;
+	int			 sa_loops;
+};
+
+/* hold and release random keys, evict some of them */
+static void *
+shared_thread(void *arg)
+{
+	struct shared_arg	*sa = arg;
+	struct daos_llink	*link;
+	struct uint_ref		*ref;
+	unsigned int		 seed = sa->sa_seed;
+	uint64_t		 key;
+	int			 rc;
+	int			 i;
+
+	for (i = 0; i < sa->sa_loops; i++) {
+		key = rand_r(&seed) % sa->sa_num_keys;
+		rc = daos_lru_ref_hold(sa->sa_cache, &key, sizeof(key),
+				       (void *)1, &link);
+		D_ASSERT(rc == 0);
+
+		ref = container_of(link, struct uint_ref, ur_llink);
+		D_ASSERT(ref->ur_key == key);
+		if (i % 64 == 0)
+			daos_lru_ref_evict(link);
+
+		daos_lru_ref_release(sa->sa_cache, link);
+	}
+	return NULL;
+}
+
+static void
+shared_test(struct daos_lru_cache *tcache, int num_keys)
+{
+	struct shared_arg	args[SHARED_THREADS];
+	pthread_t		threads[SHARED_THREADS];
+	struct daos_lru_stat	stat;
+	uint64_t		lookups;
+	int			i;
+	int			rc;
+
+	daos_lru_cache_stat(tcache, &stat);
+	lookups = stat.ls_hits + stat.ls_misses;
+
+	D_PRINT("Run %d threads on the shared cache\n", SHARED_THREADS);
+	for (i = 0; i < SHARED_THREADS; i++) {
+		args[i].sa_cache = tcache;
+		args[i].sa_num_keys = num_keys;
+		args[i].sa_seed = i;
+		args[i].sa_loops = 100000;
+		rc = pthread_create(&threads[i], NULL, shared_thread, &args[i]);
+		D_ASSERT(rc == 0);
+	}
+
+	for (i = 0; i < SHARED_THREADS; i++)
+		pthread_join(threads[i], NULL);
+
+	daos_lru_cache_stat(tcache, &stat);
+	D_PRINT("hits "DF_U64", misses "DF_U64", evictions "DF_U64
+		", cached "DF_U64"\n", stat.ls_hits, stat.ls_misses,
+		stat.ls_evictions, stat.ls_nr);
+	D_ASSERT(stat.ls_hits + stat.ls_misses - lookups ==
+		 SHARED_THREADS * 100000ULL);
+
+	/* threads exit one by one, none of them should search with lock */
+	D_PRINT("Run %d threads on the shared cache one by one\n",
+		SHARED_SEQ_THREADS);
+	lookups = stat.ls_locked;
+	for (i = 0; i < SHARED_SEQ_THREADS; i++) {
+		args[0].sa_seed = i;
+		args[0].sa_loops = 100;
+		rc = pthread_create(&threads[0], NULL, shared_thread, &args[0]);
+		D_ASSERT(rc == 0);
+		pthread_join(threads[0], NULL);
+	}
+
+	daos_lru_cache_stat(tcache, &stat);
+	D_ASSERT(stat.ls_locked == lookups);
+}
+
+#define BUDGET_HOT_KEYS	8
+
+/* a scan of cold keys shouldn't flush hot keys out of the 2Q cache */
+static void
+budget_test(int bits, int num_keys)
+{
+	struct daos_lru_cache	*tcache;
+	struct daos_llink	*link;
+	struct daos_lru_stat	 stat;
+	uint64_t		 budget;
+	uint64_t		 key;
+	int			 rc;
+	int			 i;
+	int			 j;
+
+	rc = daos_lru_cache_create(bits, D_HASH_FT_NOLOCK,
+				   &uint_ref_llink_ops, &tcache);
+	D_ASSERT(rc == 0);
+
+	/* the budget is smaller than the size of the cache */
+	budget = 4 * BUDGET_HOT_KEYS * UINT_REF_COST;
+	rc = daos_lru_cache_config(tcache, budget, DAOS_LRU_POL_2Q);
+	D_ASSERT(rc == 0);
+
+	D_PRINT("Scan %d keys on cache with budget "DF_U64"\n",
+		num_keys, budget);
+	for (j = 0; j < 2; j++) {
+		for (key = 0; key < BUDGET_HOT_KEYS; key++) {
+			rc = daos_lru_ref_hold(tcache, &key, sizeof(key),
+					       (void *)1, &link);
+			D_ASSERT(rc == 0);
+			daos_lru_ref_release(tcache, link);
+		}
+	}
+
+	for (i = 0; i < num_keys; i++) {
+		key = BUDGET_HOT_KEYS + i;
+		rc = daos_lru_ref_hold(tcache, &key, sizeof(key), (void *)1,
+				       &link);
+		D_ASSERT(rc == 0);
+		daos_lru_ref_release(tcache, link);
+
+		daos_lru_cache_stat(tcache, &stat);
+		D_ASSERT(stat.ls_cost <= budget);
+	}
+
+	for (key = 0; key < BUDGET_HOT_KEYS; key++) {
+		rc = daos_lru_ref_hold(tcache, &key, sizeof(key), NULL,
+				       &link);
+		D_ASSERTF(rc == 0, "hot key "DF_U64" is evicted\n", key);
+		daos_lru_ref_release(tcache, link);
+	}
+
+	/* a busy item can grow over the budget, it is kept */
+	rc = daos_lru_ref_hold(tcache, &key, sizeof(key), (void *)1, &link);
+	D_ASSERT(rc == 0);
+	daos_lru_ref_cost_set(tcache, link, budget + 1);
+	daos_lru_cache_stat(tcache, &stat);
+	D_ASSERT(stat.ls_nr == 1 && stat.ls_cost == budget + 1);
+	daos_lru_ref_release(tcache, link);
+
+	daos_lru_cache_stat(tcache, &stat);
+	D_PRINT("hits "DF_U64", misses "DF_U64", evictions "DF_U64
+		", cached "DF_U64", cost "DF_U64"\n", stat.ls_hits,
+		stat.ls_misses, stat.ls_evictions, stat.ls_nr, stat.ls_cost);
+	D_ASSERT(stat.ls_nr == 0 && stat.ls_cost == 0);
+	daos_lru_cache_destroy(tcache);
+}
+
 int
 main(int argc, char **argv)
 {
@@ -119,13 +280,19 @@ main(int argc, char **argv)
 		return rc;
 
 	if (argc < 3) {
-		D_ERROR("<exec><size bits(^2)><num_keys>\n");
+		D_ERROR("<exec><size bits(^2)><num_keys>[<shard bits(^2)>]\n");
 		exit(-1);
 	}
 
-	rc = daos_lru_cache_create(atoi(argv[1]), D_HASH_FT_RWLOCK,
-				   &uint_ref_llink_ops,
-				   &tcache);
+	if (argc > 3)
+		rc = daos_lru_cache_create_shared(atoi(argv[1]),
+						  atoi(argv[3]),
+						  &uint_ref_llink_ops,
+						  &tcache);
+	else
+		rc = daos_lru_cache_create(atoi(argv[1]), D_HASH_FT_RWLOCK,
+					   &uint_ref_llink_ops,
+					   &tcache);
 	if (rc)
 		D_ASSERTF(0, "Error in creating lru cache\n");
 
@@ -169,6 +336,11 @@ main(int argc, char **argv)
 	daos_lru_ref_release(tcache, link_ret[1]);
 	D_PRINT("Completed ref release for key: %"PRIu64"\n",
 		keys[1]);
+
+	if (argc > 3)
+		shared_test(tcache, num_keys);
+	else
+		budget_test(atoi(argv[1]), num_keys);
 exit:
 	daos_lru_cache_destroy(tcache);
 	if (keys)
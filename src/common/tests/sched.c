@@ -30,6 +30,7 @@
 #include <stdarg.h>
 #include <stdlib.h>
 #include <setjmp.h>
+#include <sys/time.h>
 #include <cmocka.h>
 #include <daos/common.h>
 #include <daos/tse.h>
@@ -815,6 +816,228 @@ out:
 	return rc;
 }
 
+#define PERF_ITERS	100000
+/** one update task and one shard task per replica */
+#define PERF_REPLICAS	3
+
+int
+perf_comp_cb(tse_task_t *task, void *data)
+{
+	int *counter = *((int **)data);
+
+	*counter = *counter + 1;
+	return 0;
+}
+
+int
+perf_body_fn(tse_task_t *task)
+{
+	return 0;
+}
+
+/**
+ * Create, schedule and complete tasks in the same pattern as an update of
+ * replicated object, and return the number of tasks per second.
+ */
+static int
+sched_perf_run(unsigned int flags, double *rate)
+{
+	tse_sched_t	sched;
+	tse_task_t	*task;
+	tse_task_t	*shards[PERF_REPLICAS];
+	struct timeval	then;
+	struct timeval	now;
+	int		counter = 0;
+	int		*cnt_ptr = &counter;
+	int		i, j, rc;
+
+	rc = tse_sched_init_ext(&sched, NULL, 0, flags);
+	if (rc != 0) {
+		print_error("Failed to init scheduler: %d\n", rc);
+		return rc;
+	}
+
+	gettimeofday(&then, NULL);
+	for (i = 0; i < PERF_ITERS; i++) {
+		rc = tse_task_create(perf_body_fn, &sched, NULL, &task);
+		if (rc != 0)
+			D_GOTO(out, rc);
+
+		rc = tse_task_register_comp_cb(task, perf_comp_cb, &cnt_ptr,
+					       sizeof(cnt_ptr));
+		if (rc != 0)
+			D_GOTO(out, rc);
+
+		for (j = 0; j < PERF_REPLICAS; j++) {
+			rc = tse_task_create(NULL, &sched, NULL, &shards[j]);
+			if (rc != 0)
+				D_GOTO(out, rc);
+
+			rc = tse_task_register_comp_cb(shards[j], perf_comp_cb,
+						       &cnt_ptr,
+						       sizeof(cnt_ptr));
+			if (rc != 0)
+				D_GOTO(out, rc);
+
+			rc = tse_task_schedule(shards[j], false);
+			if (rc != 0)
+				D_GOTO(out, rc);
+		}
+
+		rc = tse_task_register_deps(task, PERF_REPLICAS, shards);
+		if (rc != 0)
+			D_GOTO(out, rc);
+
+		rc = tse_task_schedule(task, false);
+		if (rc != 0)
+			D_GOTO(out, rc);
+
+		for (j = 0; j < PERF_REPLICAS; j++)
+			tse_task_complete(shards[j], 0);
+
+		/* run body of the update task, which is ready now */
+		tse_sched_progress(&sched);
+		tse_task_complete(task, 0);
+	}
+	gettimeofday(&now, NULL);
+
+	if (counter != PERF_ITERS * (PERF_REPLICAS + 1)) {
+		print_error("%d tasks completed, %d expected\n", counter,
+			    PERF_ITERS * (PERF_REPLICAS + 1));
+		D_GOTO(out, rc = -DER_INVAL);
+	}
+
+	if (!tse_sched_check_complete(&sched)) {
+		print_error("Scheduler should not have in-flight tasks\n");
+		D_GOTO(out, rc = -DER_INVAL);
+	}
+
+	*rate = counter / ((now.tv_sec - then.tv_sec) +
+			   (now.tv_usec - then.tv_usec) / 1000000.0);
+out:
+	tse_sched_complete(&sched, rc, rc != 0);
+	return rc;
+}
+
+static int
+sched_test_7()
+{
+	double	rate;
+	int	rc;
+
+	TSE_TEST_ENTRY("7", "Task create/complete rate");
+
+	rc = sched_perf_run(0, &rate);
+	if (rc != 0) {
+		print_error("Failed to run tasks: %d\n", rc);
+		D_GOTO(out, rc);
+	}
+	print_message("Multi-thread scheduler:  %.0f tasks/sec\n", rate);
+
+	rc = sched_perf_run(TSE_SCHED_F_SINGLE, &rate);
+	if (rc != 0) {
+		print_error("Failed to run tasks: %d\n", rc);
+		D_GOTO(out, rc);
+	}
+	print_message("Single-thread scheduler: %.0f tasks/sec\n", rate);
+out:
+	TSE_TEST_EXIT(rc);
+	return rc;
+}
+
+#define NUM_DEFERS 16
+
+struct defer_arg {
+	tse_task_t	*tasks[NUM_DEFERS];
+	int		 bodies;
+	int		 calls;
+};
+
+static void
+defer_cb(tse_sched_t *sched, void *arg)
+{
+	struct defer_arg	*da = arg;
+	int			 i;
+
+	da->calls++;
+	if (da->bodies != NUM_DEFERS) {
+		print_error("Deferred before all bodies: %d\n", da->bodies);
+		return;
+	}
+
+	/* complete the "batch" */
+	for (i = 0; i < NUM_DEFERS; i++)
+		tse_task_complete(da->tasks[i], 0);
+}
+
+int
+defer_body_fn(tse_task_t *task)
+{
+	struct defer_arg *da = tse_task_get_priv(task);
+
+	da->bodies++;
+	return tse_sched_defer(tse_task2sched(task), defer_cb, da);
+}
+
+static int
+sched_test_8()
+{
+	tse_sched_t		sched;
+	struct defer_arg	*da = NULL;
+	bool			flag;
+	int			i, rc;
+
+	TSE_TEST_ENTRY("8", "Callback deferred to end of progress");
+
+	print_message("Init Scheduler\n");
+	rc = tse_sched_init(&sched, NULL, 0);
+	if (rc != 0) {
+		print_error("Failed to init scheduler: %d\n", rc);
+		D_GOTO(out, rc);
+	}
+
+	D_ALLOC_PTR(da);
+	if (da == NULL)
+		D_GOTO(out, rc = -DER_NOMEM);
+
+	print_message("Schedule tasks which defer the same callback\n");
+	for (i = 0; i < NUM_DEFERS; i++) {
+		rc = tse_task_create(defer_body_fn, &sched, da, &da->tasks[i]);
+		if (rc != 0) {
+			print_error("Failed to init task: %d\n", rc);
+			D_GOTO(out, rc);
+		}
+
+		rc = tse_task_schedule(da->tasks[i], false);
+		if (rc != 0) {
+			print_error("Failed to schedule task %d\n", rc);
+			D_GOTO(out, rc);
+		}
+	}
+
+	tse_sched_progress(&sched);
+
+	print_message("Verify callback is called once\n");
+	if (da->calls != 1) {
+		print_error("Callback called %d times\n", da->calls);
+		D_GOTO(out, rc = -DER_INVAL);
+	}
+
+	print_message("Check scheduler is empty\n");
+	flag = tse_sched_check_complete(&sched);
+	if (!flag) {
+		print_error("Scheduler should not have in-flight tasks\n");
+		D_GOTO(out, rc = -DER_INVAL);
+	}
+
+	tse_sched_complete(&sched, 0, false);
+out:
+	if (da)
+		D_FREE_PTR(da);
+	TSE_TEST_EXIT(rc);
+	return rc;
+}
+
 int
 main(int argc, char **argv)
 {
@@ -861,6 +1084,18 @@ main(int argc, char **argv)
 		test_fail++;
 	}
 
+	rc = sched_test_7();
+	if (rc != 0) {
+		print_error("SCHED TEST 7 failed: %d\n", rc);
+		test_fail++;
+	}
+
+	rc = sched_test_8();
+	if (rc != 0) {
+		print_error("SCHED TEST 8 failed: %d\n", rc);
+		test_fail++;
+	}
+
 	if (test_fail)
 		print_error("ERROR, %d test(s) failed\n", test_fail);
 	else
@@ -43,11 +43,184 @@ struct tse_task_link {
 	tse_task_t		*tl_task;
 };
 
+enum {
+	TSE_POOL_TASK,
+	TSE_POOL_CB,
+	TSE_POOL_LINK,
+	TSE_POOL_TYPES,
+};
+
+/** free objects of the same size, linked by their first bytes */
+struct tse_pool_slab {
+	d_list_t	ps_free;
+	uint32_t	ps_nr;
+	uint32_t	ps_size;
+};
+
+/**
+ * Per-scheduler pool of free tasks, callbacks and dependency links, so the
+ * hot path of creating and completing tasks doesn't go to the heap. A task
+ * can be released after its scheduler is finalized, so the pool is referenced
+ * by the scheduler and by each task allocated from it. Callbacks and links are
+ * always freed before their task, which holds the pool for them.
+ */
+struct tse_pool {
+	pthread_mutex_t		tp_lock;
+	struct tse_pool_slab	tp_slabs[TSE_POOL_TYPES];
+	uint32_t		tp_ref;
+	/* no locking for single threaded scheduler */
+	bool			tp_single;
+};
+
+static inline void
+tse_pool_lock(struct tse_pool *pool)
+{
+	if (!pool->tp_single)
+		D_MUTEX_LOCK(&pool->tp_lock);
+}
+
+static inline void
+tse_pool_unlock(struct tse_pool *pool)
+{
+	if (!pool->tp_single)
+		D_MUTEX_UNLOCK(&pool->tp_lock);
+}
+
+static int
+tse_pool_create(bool single, struct tse_pool **poolp)
+{
+	struct tse_pool	*pool;
+	int		 i;
+	int		 rc;
+
+	D_ALLOC_PTR(pool);
+	if (pool == NULL)
+		return -DER_NOMEM;
+
+	rc = D_MUTEX_INIT(&pool->tp_lock, NULL);
+	if (rc != 0) {
+		D_FREE_PTR(pool);
+		return rc;
+	}
+
+	for (i = 0; i < TSE_POOL_TYPES; i++)
+		D_INIT_LIST_HEAD(&pool->tp_slabs[i].ps_free);
+
+	pool->tp_slabs[TSE_POOL_TASK].ps_size = sizeof(tse_task_t);
+	pool->tp_slabs[TSE_POOL_CB].ps_size = sizeof(struct tse_task_cb) +
+					      TSE_CB_ARG_INLINE;
+	pool->tp_slabs[TSE_POOL_LINK].ps_size = sizeof(struct tse_task_link);
+	pool->tp_ref = 1;
+	pool->tp_single = single;
+	*poolp = pool;
+	return 0;
+}
+
+static void
+tse_pool_destroy(struct tse_pool *pool)
+{
+	struct tse_pool_slab	*slab;
+	d_list_t		*obj;
+	int			 i;
+
+	for (i = 0; i < TSE_POOL_TYPES; i++) {
+		slab = &pool->tp_slabs[i];
+		while (!d_list_empty(&slab->ps_free)) {
+			obj = slab->ps_free.next;
+			d_list_del(obj);
+			D_FREE(obj);
+		}
+	}
+	D_MUTEX_DESTROY(&pool->tp_lock);
+	D_FREE_PTR(pool);
+}
+
+static void
+tse_pool_decref(struct tse_pool *pool)
+{
+	bool	destroy;
+
+	tse_pool_lock(pool);
+	D_ASSERT(pool->tp_ref > 0);
+	destroy = --pool->tp_ref == 0;
+	tse_pool_unlock(pool);
+
+	if (destroy)
+		tse_pool_destroy(pool);
+}
+
+/** Allocate a zeroed object, a task takes a reference of the pool */
+static void *
+tse_pool_get(struct tse_pool *pool, int type)
+{
+	struct tse_pool_slab	*slab = &pool->tp_slabs[type];
+	d_list_t		*obj = NULL;
+
+	tse_pool_lock(pool);
+	if (!d_list_empty(&slab->ps_free)) {
+		obj = slab->ps_free.next;
+		d_list_del(obj);
+		slab->ps_nr--;
+	}
+	if (type == TSE_POOL_TASK)
+		pool->tp_ref++;
+	tse_pool_unlock(pool);
+
+	if (obj != NULL) {
+		memset(obj, 0, slab->ps_size);
+		return obj;
+	}
+
+	D_ALLOC(obj, slab->ps_size);
+	if (obj == NULL && type == TSE_POOL_TASK)
+		tse_pool_decref(pool);
+	return obj;
+}
+
+static void
+tse_pool_put(struct tse_pool *pool, int type, void *ptr)
+{
+	struct tse_pool_slab	*slab = &pool->tp_slabs[type];
+	d_list_t		*obj = ptr;
+	bool			 destroy = false;
+
+	tse_pool_lock(pool);
+	if (slab->ps_nr < TSE_POOL_MAX) {
+		d_list_add(obj, &slab->ps_free);
+		slab->ps_nr++;
+		obj = NULL;
+	}
+	if (type == TSE_POOL_TASK) {
+		D_ASSERT(pool->tp_ref > 0);
+		destroy = --pool->tp_ref == 0;
+	}
+	tse_pool_unlock(pool);
+
+	if (obj != NULL)
+		D_FREE(obj);
+	if (destroy)
+		tse_pool_destroy(pool);
+}
+
+static inline void
+tse_sched_lock(struct tse_sched_private *dsp)
+{
+	if (!dsp->dsp_single)
+		D_MUTEX_LOCK(&dsp->dsp_lock);
+}
+
+static inline void
+tse_sched_unlock(struct tse_sched_private *dsp)
+{
+	if (!dsp->dsp_single)
+		D_MUTEX_UNLOCK(&dsp->dsp_lock);
+}
+
 static void tse_sched_decref(struct tse_sched_private *dsp);
 
 int
-tse_sched_init(tse_sched_t *sched, tse_sched_comp_cb_t comp_cb,
-	       void *udata)
+tse_sched_init_ext(tse_sched_t *sched, tse_sched_comp_cb_t comp_cb,
+		   void *udata, unsigned int flags)
 {
 	struct tse_sched_private *dsp = tse_sched2priv(sched);
 	int rc;
@@ -60,24 +233,43 @@ tse_sched_init(tse_sched_t *sched, tse_sched_comp_cb_t comp_cb,
 	D_INIT_LIST_HEAD(&dsp->dsp_running_list);
 	D_INIT_LIST_HEAD(&dsp->dsp_complete_list);
 	D_INIT_LIST_HEAD(&dsp->dsp_comp_cb_list);
+	D_INIT_LIST_HEAD(&dsp->dsp_defer_list);
 
 	dsp->dsp_refcount = 1;
 	dsp->dsp_inflight = 0;
+	dsp->dsp_single = !!(flags & TSE_SCHED_F_SINGLE);
 
-	rc = D_MUTEX_INIT(&dsp->dsp_lock, NULL);
+	rc = tse_pool_create(dsp->dsp_single, &dsp->dsp_pool);
 	if (rc != 0)
 		return rc;
 
+	rc = D_MUTEX_INIT(&dsp->dsp_lock, NULL);
+	if (rc != 0)
+		D_GOTO(failed, rc);
+
 	if (comp_cb != NULL) {
 		rc = tse_sched_register_comp_cb(sched, comp_cb, udata);
-		if (rc != 0)
-			return rc;
+		if (rc != 0) {
+			D_MUTEX_DESTROY(&dsp->dsp_lock);
+			D_GOTO(failed, rc);
+		}
 	}
 
 	sched->ds_udata = udata;
 	sched->ds_result = 0;
 
 	return 0;
+failed:
+	tse_pool_decref(dsp->dsp_pool);
+	dsp->dsp_pool = NULL;
+	return rc;
+}
+
+int
+tse_sched_init(tse_sched_t *sched, tse_sched_comp_cb_t comp_cb,
+	       void *udata)
+{
+	return tse_sched_init_ext(sched, comp_cb, udata, 0);
 }
 
 static inline uint32_t
@@ -216,9 +408,9 @@ tse_task_addref(tse_task_t *task)
 
 	D_ASSERT(dsp != NULL);
 
-	D_MUTEX_LOCK(&dsp->dsp_lock);
+	tse_sched_lock(dsp);
 	tse_task_addref_locked(dtp);
-	D_MUTEX_UNLOCK(&dsp->dsp_lock);
+	tse_sched_unlock(dsp);
 }
 
 void
@@ -229,9 +421,9 @@ tse_task_decref(tse_task_t *task)
 	bool			   zombie;
 
 	D_ASSERT(dsp != NULL);
-	D_MUTEX_LOCK(&dsp->dsp_lock);
+	tse_sched_lock(dsp);
 	zombie = tse_task_decref_locked(dtp);
-	D_MUTEX_UNLOCK(&dsp->dsp_lock);
+	tse_sched_unlock(dsp);
 	if (!zombie)
 		return;
 
@@ -242,7 +434,25 @@ tse_task_decref(tse_task_t *task)
 	 * user also free it. This now requires task to be on the heap all the
 	 * time.
 	 */
-	D_FREE_PTR(task);
+	tse_pool_put(dtp->dtp_pool, TSE_POOL_TASK, task);
+}
+
+/**
+ * Drop the scheduler reference of the pool, tasks which are still referenced
+ * release the pool at last.
+ */
+static void
+tse_sched_pool_release(struct tse_sched_private *dsp)
+{
+	struct tse_pool	*pool;
+
+	tse_sched_lock(dsp);
+	pool = dsp->dsp_pool;
+	dsp->dsp_pool = NULL;
+	tse_sched_unlock(dsp);
+
+	if (pool != NULL)
+		tse_pool_decref(pool);
 }
 
 void
@@ -254,6 +464,8 @@ tse_sched_fini(tse_sched_t *sched)
 	D_ASSERT(d_list_empty(&dsp->dsp_init_list));
 	D_ASSERT(d_list_empty(&dsp->dsp_running_list));
 	D_ASSERT(d_list_empty(&dsp->dsp_complete_list));
+	D_ASSERT(d_list_empty(&dsp->dsp_defer_list));
+	tse_sched_pool_release(dsp);
 	D_MUTEX_DESTROY(&dsp->dsp_lock);
 }
 
@@ -268,13 +480,13 @@ tse_sched_decref(struct tse_sched_private *dsp)
 {
 	bool	finalize;
 
-	D_MUTEX_LOCK(&dsp->dsp_lock);
+	tse_sched_lock(dsp);
 
 	D_ASSERT(dsp->dsp_refcount > 0);
 	dsp->dsp_refcount--;
 	finalize = dsp->dsp_refcount == 0;
 
-	D_MUTEX_UNLOCK(&dsp->dsp_lock);
+	tse_sched_unlock(dsp);
 
 	if (finalize)
 		tse_sched_fini(tse_priv2sched(dsp));
@@ -294,13 +506,65 @@ tse_sched_register_comp_cb(tse_sched_t *sched,
 	dsc->dsc_comp_cb = comp_cb;
 	dsc->dsc_arg = arg;
 
-	D_MUTEX_LOCK(&dsp->dsp_lock);
+	tse_sched_lock(dsp);
 	d_list_add(&dsc->dsc_list,
 		      &dsp->dsp_comp_cb_list);
-	D_MUTEX_UNLOCK(&dsp->dsp_lock);
+	tse_sched_unlock(dsp);
 	return 0;
 }
 
+int
+tse_sched_defer(tse_sched_t *sched, tse_sched_defer_cb_t cb, void *arg)
+{
+	struct tse_sched_private	*dsp = tse_sched2priv(sched);
+	struct tse_sched_defer		*dsd;
+	int				 rc = 0;
+
+	tse_sched_lock(dsp);
+	d_list_for_each_entry(dsd, &dsp->dsp_defer_list, dsd_list) {
+		if (dsd->dsd_cb == cb && dsd->dsd_arg == arg)
+			D_GOTO(out, rc = 0);
+	}
+
+	D_ALLOC_PTR(dsd);
+	if (dsd == NULL)
+		D_GOTO(out, rc = -DER_NOMEM);
+
+	dsd->dsd_cb = cb;
+	dsd->dsd_arg = arg;
+	d_list_add_tail(&dsd->dsd_list, &dsp->dsp_defer_list);
+out:
+	tse_sched_unlock(dsp);
+	return rc;
+}
+
+/**
+ * Call the deferred callbacks, after the bodies of ready tasks have been
+ * executed by tse_sched_process_init().
+ */
+static int
+tse_sched_process_defer(struct tse_sched_private *dsp)
+{
+	struct tse_sched_defer	*dsd;
+	d_list_t		 list;
+	int			 processed = 0;
+
+	D_INIT_LIST_HEAD(&list);
+	tse_sched_lock(dsp);
+	d_list_splice_init(&dsp->dsp_defer_list, &list);
+	tse_sched_unlock(dsp);
+
+	while (!d_list_empty(&list)) {
+		dsd = d_list_entry(list.next, struct tse_sched_defer,
+				   dsd_list);
+		d_list_del(&dsd->dsd_list);
+		dsd->dsd_cb(tse_priv2sched(dsp), dsd->dsd_arg);
+		D_FREE_PTR(dsd);
+		processed++;
+	}
+	return processed;
+}
+
 /** MSC - we probably need just 1 completion cb instead of a list */
 static int
 tse_sched_complete_cb(tse_sched_t *sched)
@@ -347,7 +611,10 @@ register_cb(tse_task_t *task, bool is_comp, tse_task_cb_t cb,
 		return -DER_NO_PERM;
 	}
 
-	D_ALLOC(dtc, sizeof(*dtc) + arg_size);
+	if (arg_size <= TSE_CB_ARG_INLINE)
+		dtc = tse_pool_get(dtp->dtp_pool, TSE_POOL_CB);
+	else
+		D_ALLOC(dtc, sizeof(*dtc) + arg_size);
 	if (dtc == NULL)
 		return -DER_NOMEM;
 
@@ -358,13 +625,13 @@ register_cb(tse_task_t *task, bool is_comp, tse_task_cb_t cb,
 
 	D_ASSERT(dtp->dtp_sched != NULL);
 
-	D_MUTEX_LOCK(&dtp->dtp_sched->dsp_lock);
+	tse_sched_lock(dtp->dtp_sched);
 	if (is_comp)
 		d_list_add(&dtc->dtc_list, &dtp->dtp_comp_cb_list);
 	else /** MSC - don't see a need for more than 1 prep cb */
 		d_list_add_tail(&dtc->dtc_list, &dtp->dtp_prep_cb_list);
 
-	D_MUTEX_UNLOCK(&dtp->dtp_sched->dsp_lock);
+	tse_sched_unlock(dtp->dtp_sched);
 
 	return 0;
 }
@@ -393,6 +660,15 @@ tse_task_register_cbs(tse_task_t *task, tse_task_cb_t prep_cb,
 	return 0;
 }
 
+static void
+tse_task_cb_free(struct tse_task_private *dtp, struct tse_task_cb *dtc)
+{
+	if (dtc->dtc_arg_size <= TSE_CB_ARG_INLINE)
+		tse_pool_put(dtp->dtp_pool, TSE_POOL_CB, dtc);
+	else
+		D_FREE(dtc);
+}
+
 /*
  * Execute the prep callback(s) of the task.
  */
@@ -413,7 +689,7 @@ tse_task_prep_callback(tse_task_t *task)
 				task->dt_result = rc;
 		}
 
-		D_FREE(dtc);
+		tse_task_cb_free(dtp, dtc);
 
 		/** Task was re-initialized; break */
 		if (!dtp->dtp_running && !dtp->dtp_completing)
@@ -446,7 +722,7 @@ tse_task_complete_callback(tse_task_t *task)
 		if (task->dt_result == 0)
 			task->dt_result = ret;
 
-		D_FREE(dtc);
+		tse_task_cb_free(dtp, dtc);
 
 		/** Task was re-initialized; break */
 		if (!dtp->dtp_completing) {
@@ -472,7 +748,7 @@ tse_sched_process_init(struct tse_sched_private *dsp)
 	int				processed = 0;
 
 	D_INIT_LIST_HEAD(&list);
-	D_MUTEX_LOCK(&dsp->dsp_lock);
+	tse_sched_lock(dsp);
 	d_list_for_each_entry_safe(dtp, tmp, &dsp->dsp_init_list,
 				      dtp_list) {
 		if (dtp->dtp_dep_cnt == 0 || dsp->dsp_cancelling) {
@@ -480,7 +756,7 @@ tse_sched_process_init(struct tse_sched_private *dsp)
 			dsp->dsp_inflight++;
 		}
 	}
-	D_MUTEX_UNLOCK(&dsp->dsp_lock);
+	tse_sched_unlock(dsp);
 
 	while (!d_list_empty(&list)) {
 		tse_task_t *task;
@@ -491,7 +767,7 @@ tse_sched_process_init(struct tse_sched_private *dsp)
 
 		task = tse_priv2task(dtp);
 
-		D_MUTEX_LOCK(&dsp->dsp_lock);
+		tse_sched_lock(dsp);
 		if (dsp->dsp_cancelling) {
 			tse_task_complete_locked(dtp, dsp);
 		} else {
@@ -502,7 +778,7 @@ tse_sched_process_init(struct tse_sched_private *dsp)
 			tse_task_addref_locked(dtp);
 			bumped = true;
 		}
-		D_MUTEX_UNLOCK(&dsp->dsp_lock);
+		tse_sched_unlock(dsp);
 
 		if (!dsp->dsp_cancelling) {
 			/** if task is reinitialized in prep cb, skip over it */
@@ -541,7 +817,7 @@ tse_task_post_process(tse_task_t *task)
 		tse_priv2sched(dsp)->ds_result = task->dt_result;
 
 	/* Check dependent list */
-	D_MUTEX_LOCK(&dsp->dsp_lock);
+	tse_sched_lock(dsp);
 	while (!d_list_empty(&dtp->dtp_dep_list)) {
 		struct tse_task_link	*tlink;
 		tse_task_t		*task_tmp;
@@ -552,7 +828,7 @@ tse_task_post_process(tse_task_t *task)
 		d_list_del(&tlink->tl_link);
 		task_tmp = tlink->tl_task;
 		dtp_tmp = tse_task2priv(task_tmp);
-		D_FREE_PTR(tlink);
+		tse_pool_put(dtp->dtp_pool, TSE_POOL_LINK, tlink);
 
 		/* see if the dependent task is ready to be scheduled */
 		D_ASSERT(dtp_tmp->dtp_dep_cnt > 0);
@@ -575,9 +851,9 @@ tse_task_post_process(tse_task_t *task)
 
 			dtp_tmp->dtp_completing = 1;
 			/** release lock for CB */
-			D_MUTEX_UNLOCK(&dsp->dsp_lock);
+			tse_sched_unlock(dsp);
 			done = tse_task_complete_callback(task_tmp);
-			D_MUTEX_LOCK(&dsp->dsp_lock);
+			tse_sched_lock(dsp);
 
 			/*
 			 * task reinserted itself in scheduler by
@@ -598,7 +874,7 @@ tse_task_post_process(tse_task_t *task)
 
 	D_ASSERT(dsp->dsp_inflight > 0);
 	dsp->dsp_inflight--;
-	D_MUTEX_UNLOCK(&dsp->dsp_lock);
+	tse_sched_unlock(dsp);
 
 	if (task->dt_result == 0)
 		task->dt_result = rc;
@@ -616,9 +892,9 @@ tse_sched_process_complete(struct tse_sched_private *dsp)
 
 	/* pick tasks from complete_list */
 	D_INIT_LIST_HEAD(&comp_list);
-	D_MUTEX_LOCK(&dsp->dsp_lock);
+	tse_sched_lock(dsp);
 	d_list_splice_init(&dsp->dsp_complete_list, &comp_list);
-	D_MUTEX_UNLOCK(&dsp->dsp_lock);
+	tse_sched_unlock(dsp);
 
 	d_list_for_each_entry_safe(dtp, tmp, &comp_list, dtp_list) {
 		tse_task_t *task = tse_priv2task(dtp);
@@ -638,10 +914,10 @@ tse_sched_check_complete(tse_sched_t *sched)
 	bool completed;
 
 	/* check if all tasks are done */
-	D_MUTEX_LOCK(&dsp->dsp_lock);
+	tse_sched_lock(dsp);
 	completed = (d_list_empty(&dsp->dsp_init_list) &&
 		     dsp->dsp_inflight == 0);
-	D_MUTEX_UNLOCK(&dsp->dsp_lock);
+	tse_sched_unlock(dsp);
 
 	return completed;
 }
@@ -657,6 +933,7 @@ tse_sched_run(tse_sched_t *sched)
 		bool	completed;
 
 		processed += tse_sched_process_init(dsp);
+		processed += tse_sched_process_defer(dsp);
 		processed += tse_sched_process_complete(dsp);
 		completed = tse_sched_check_complete(sched);
 		if (completed || processed == 0)
@@ -679,10 +956,10 @@ tse_sched_progress(tse_sched_t *sched)
 	if (dsp->dsp_cancelling)
 		return;
 
-	D_MUTEX_LOCK(&dsp->dsp_lock);
+	tse_sched_lock(dsp);
 	/** +1 for tse_sched_run() */
 	tse_sched_addref_locked(dsp);
-	D_MUTEX_UNLOCK(&dsp->dsp_lock);
+	tse_sched_unlock(dsp);
 
 	if (!dsp->dsp_cancelling)
 		tse_sched_run(sched);
@@ -698,7 +975,7 @@ tse_sched_complete_inflight(struct tse_sched_private *dsp)
 	struct tse_task_private *tmp;
 	int			  processed = 0;
 
-	D_MUTEX_LOCK(&dsp->dsp_lock);
+	tse_sched_lock(dsp);
 	d_list_for_each_entry_safe(dtp, tmp, &dsp->dsp_running_list,
 				      dtp_list)
 		if (dtp->dtp_dep_cnt == 0) {
@@ -706,7 +983,7 @@ tse_sched_complete_inflight(struct tse_sched_private *dsp)
 			tse_task_complete_locked(dtp, dsp);
 			processed++;
 		}
-	D_MUTEX_UNLOCK(&dsp->dsp_lock);
+	tse_sched_unlock(dsp);
 
 	return processed;
 }
@@ -719,9 +996,9 @@ tse_sched_complete(tse_sched_t *sched, int ret, bool cancel)
 	if (sched->ds_result == 0)
 		sched->ds_result = ret;
 
-	D_MUTEX_LOCK(&dsp->dsp_lock);
+	tse_sched_lock(dsp);
 	if (dsp->dsp_cancelling || dsp->dsp_completing) {
-		D_MUTEX_UNLOCK(&dsp->dsp_lock);
+		tse_sched_unlock(dsp);
 		return;
 	}
 
@@ -734,7 +1011,7 @@ tse_sched_complete(tse_sched_t *sched, int ret, bool cancel)
 	while (1) {
 		/** +1 for tse_sched_run */
 		tse_sched_addref_locked(dsp);
-		D_MUTEX_UNLOCK(&dsp->dsp_lock);
+		tse_sched_unlock(dsp);
 
 		tse_sched_run(sched);
 		if (dsp->dsp_inflight == 0)
@@ -742,11 +1019,13 @@ tse_sched_complete(tse_sched_t *sched, int ret, bool cancel)
 		if (dsp->dsp_cancelling)
 			tse_sched_complete_inflight(dsp);
 
-		D_MUTEX_LOCK(&dsp->dsp_lock);
+		tse_sched_lock(dsp);
 	}
 
 	tse_sched_complete_cb(sched);
 	sched->ds_udata = NULL;
+	/* no more task of this scheduler, don't wait for the last reference */
+	tse_sched_pool_release(dsp);
 	tse_sched_decref(dsp);
 }
 
@@ -768,7 +1047,7 @@ tse_task_complete(tse_task_t *task, int ret)
 	/** Execute task completion callbacks first. */
 	done = tse_task_complete_callback(task);
 
-	D_MUTEX_LOCK(&dsp->dsp_lock);
+	tse_sched_lock(dsp);
 
 	if (!dsp->dsp_cancelling) {
 		/** +1 for tse_sched_run() */
@@ -782,7 +1061,7 @@ tse_task_complete(tse_task_t *task, int ret)
 	} else {
 		tse_task_decref_locked(dtp);
 	}
-	D_MUTEX_UNLOCK(&dsp->dsp_lock);
+	tse_sched_unlock(dsp);
 
 	/** update task in scheduler lists. */
 	if (!dsp->dsp_cancelling && done)
@@ -822,13 +1101,13 @@ tse_task_add_dependent(tse_task_t *task, tse_task_t *dep)
 	if (dep_dtp->dtp_completed)
 		return 0;
 
-	D_ALLOC_PTR(tlink);
+	tlink = tse_pool_get(dtp->dtp_pool, TSE_POOL_LINK);
 	if (tlink == NULL)
 		return -DER_NOMEM;
 
 	D_DEBUG(DB_TRACE, "Add dependent %p ---> %p\n", dep_dtp, dtp);
 
-	D_MUTEX_LOCK(&dtp->dtp_sched->dsp_lock);
+	tse_sched_lock(dtp->dtp_sched);
 
 	tse_task_addref_locked(dtp);
 	tlink->tl_task = task;
@@ -836,7 +1115,7 @@ tse_task_add_dependent(tse_task_t *task, tse_task_t *dep)
 	d_list_add_tail(&tlink->tl_link, &dep_dtp->dtp_dep_list);
 	dtp->dtp_dep_cnt++;
 
-	D_MUTEX_UNLOCK(&dtp->dtp_sched->dsp_lock);
+	tse_sched_unlock(dtp->dtp_sched);
 
 	return 0;
 }
@@ -861,7 +1140,12 @@ tse_task_create(tse_task_func_t task_func, tse_sched_t *sched, void *priv,
 	struct tse_task_private	 *dtp;
 	tse_task_t		 *task;
 
-	D_ALLOC_PTR(task);
+	if (dsp->dsp_pool == NULL) {
+		D_ERROR("Can't create task for a completed scheduler\n");
+		return -DER_NO_PERM;
+	}
+
+	task = tse_pool_get(dsp->dsp_pool, TSE_POOL_TASK);
 	if (task == NULL)
 		return -DER_NOMEM;
 
@@ -878,6 +1162,7 @@ tse_task_create(tse_task_func_t task_func, tse_sched_t *sched, void *priv,
 	dtp->dtp_func	  = task_func;
 	dtp->dtp_priv	  = priv;
 	dtp->dtp_sched	  = dsp;
+	dtp->dtp_pool	  = dsp->dsp_pool;
 
 	*taskp = task;
 	return 0;
@@ -893,7 +1178,7 @@ tse_task_schedule(tse_task_t *task, bool instant)
 	D_ASSERT(!instant || dtp->dtp_func);
 
 	/* Add task to scheduler */
-	D_MUTEX_LOCK(&dsp->dsp_lock);
+	tse_sched_lock(dsp);
 	if (dtp->dtp_func == NULL || instant) {
 		/** If task has no body function, mark it as running */
 		dsp->dsp_inflight++;
@@ -908,7 +1193,7 @@ tse_task_schedule(tse_task_t *task, bool instant)
 		d_list_add_tail(&dtp->dtp_list, &dsp->dsp_init_list);
 	}
 	tse_sched_addref_locked(dsp);
-	D_MUTEX_UNLOCK(&dsp->dsp_lock);
+	tse_sched_unlock(dsp);
 
 	/* if caller wants to run the task instantly, call the task body
 	 * function now.
@@ -936,7 +1221,7 @@ tse_task_reinit(tse_task_t *task)
 
 	D_CASSERT(sizeof(task->dt_private) >= sizeof(*dtp));
 
-	D_MUTEX_LOCK(&dsp->dsp_lock);
+	tse_sched_lock(dsp);
 
 	if (dsp->dsp_cancelling) {
 		D_ERROR("Scheduler is cancelling, can't re-insert task\n");
@@ -968,14 +1253,14 @@ tse_task_reinit(tse_task_t *task)
 	/** Move back to init list */
 	d_list_move_tail(&dtp->dtp_list, &dsp->dsp_init_list);
 
-	D_MUTEX_UNLOCK(&dsp->dsp_lock);
+	tse_sched_unlock(dsp);
 
 	task->dt_result = 0;
 
 	return 0;
 
 err_unlock:
-	D_MUTEX_UNLOCK(&dsp->dsp_lock);
+	tse_sched_unlock(dsp);
 	return rc;
 }
 
@@ -35,10 +35,19 @@
 
 /* NB: tse_task_private is TSE_PRIV_SIZE = 504 bytes for now */
 #define TSE_TASK_ARG_LEN		376
+/** max number of free objects of each type cached by the pool */
+#define TSE_POOL_MAX			256
+/** callbacks with up to this size of arguments are allocated from the pool */
+#define TSE_CB_ARG_INLINE		128
+
+struct tse_pool;
 
 struct tse_task_private {
 	struct tse_sched_private	*dtp_sched;
 
+	/* pool the task is allocated from, it can outlive the scheduler */
+	struct tse_pool			*dtp_pool;
+
 	/* function for the task */
 	tse_task_func_t			 dtp_func;
 
@@ -70,7 +79,8 @@ struct tse_task_private {
 					 dtp_completing:1,
 					/* task is in running state */
 					 dtp_running:1,
-					 dtp_dep_cnt:30;
+					/* 29 bits to pack flags in 32 bits */
+					 dtp_dep_cnt:29;
 	/* refcount of the task */
 	uint32_t			 dtp_refcnt;
 	/**
@@ -123,13 +133,21 @@ struct tse_sched_private {
 	/* the list for complete callback */
 	d_list_t	dsp_comp_cb_list;
 
+	/* callbacks deferred to the end of progress, see tse_sched_defer */
+	d_list_t	dsp_defer_list;
+
+	/* free tasks, callbacks and dependency links */
+	struct tse_pool	*dsp_pool;
+
 	int		dsp_refcount;
 
 	/* number of tasks being executed */
 	int		dsp_inflight;
 
 	uint32_t	dsp_cancelling:1,
-			dsp_completing:1;
+			dsp_completing:1,
+			/* TSE_SCHED_F_SINGLE, dsp_lock is not used */
+			dsp_single:1;
 };
 
 struct tse_sched_comp {
@@ -138,6 +156,12 @@ struct tse_sched_comp {
 	void			*dsc_arg;
 };
 
+struct tse_sched_defer {
+	d_list_t		dsd_list;
+	tse_sched_defer_cb_t	dsd_cb;
+	void			*dsd_arg;
+};
+
 
 static inline struct tse_task_private *
 tse_task2priv(tse_task_t *task)
@@ -1929,3 +1929,19 @@ dc_cont_hdl2pool_hdl(daos_handle_t coh)
 	dc_cont_put(dc);
 	return ph;
 }
+
+/** Return true if the container is opened with end-to-end checksum */
+bool
+dc_cont_csum_enabled(daos_handle_t coh)
+{
+	struct dc_cont	*dc;
+	bool		 enabled;
+
+	dc = dc_hdl2cont(coh);
+	if (dc == NULL)
+		return false;
+
+	enabled = !!(dc->dc_capas & DAOS_COO_CSUM);
+	dc_cont_put(dc);
+	return enabled;
+}
@@ -910,51 +910,71 @@ set_container_purged_epoch(daos_handle_t vos_chdl,
 			    NULL, &finish);
 }
 
+/** Number of scanned objects between two progress reports */
+#define CONT_AGG_PROGRESS_INTV	(1 << 16)
+
+/** Aggregation of a container on a target */
+struct cont_agg_arg {
+	struct cont_tgt_epoch_aggregate_in	*ca_in;
+	/** VOS container handle */
+	daos_handle_t				 ca_coh;
+	/** credits for each vos_epoch_aggregate() call */
+	unsigned int				 ca_credits;
+	/** objects found in the object index */
+	uint64_t				 ca_scanned;
+	/** objects skipped since they are clean in the epoch range */
+	uint64_t				 ca_skipped;
+	/** objects actually aggregated */
+	uint64_t				 ca_aggregated;
+};
+
 static int
-cont_epoch_aggregate_one(void *vin)
+cont_agg_obj(struct cont_agg_arg *arg, daos_unit_oid_t oid,
+	     daos_epoch_range_t *epr)
 {
-	struct cont_tgt_epoch_aggregate_in	*in  = vin;
-	unsigned int				credits;
-	vos_iter_param_t			param;
-	struct ds_pool_child			*pool_child;
-	daos_handle_t				iter_hdl;
-	daos_handle_t				vos_chdl;
-	char					*purge_credits;
-	char					*opstr;
-	int					aggregated;
-	int					found;
-	int					rc;
-	bool					finish;
+	vos_purge_anchor_t	anchor;
+	bool			finish;
+	int			rc;
 
-	purge_credits = getenv("DAOS_PURGE_CREDITS");
-	credits = daos_env2uint(purge_credits);
-	if (credits == 0)
-		credits = DAOS_PURGE_CREDITS_MAX;
+	memset(&anchor, 0, sizeof(anchor));
+	while (true) {
+		unsigned int	l_credits = arg->ca_credits;
 
-	pool_child = ds_pool_child_lookup(in->tai_pool_uuid);
-	if (pool_child == NULL) {
-		D_ERROR(DF_CONT": pool child is NULL\n",
-			DP_CONT(in->tai_pool_uuid,
-				in->tai_cont_uuid));
-		return -DER_NO_HDL;
+		finish = false;
+		rc = vos_epoch_aggregate(arg->ca_coh, oid, epr, &l_credits,
+					 &anchor, &finish);
+		if (rc != 0)
+			return rc;
+
+		if (finish)
+			break;
+		ABT_thread_yield();
 	}
 
-	opstr = "opening vos container handle\n";
-	rc = vos_cont_open(pool_child->spc_hdl, in->tai_cont_uuid,
-			   &vos_chdl);
-	if (rc != 0) {
-		D_ERROR(DF_CONT": Failed %s : %d",
-			DP_CONT(in->tai_pool_uuid,
-				in->tai_cont_uuid), opstr, rc);
-		/*
-		 * Aggregate ULT is run in background so ignore return values
-		 * further more aggregation is idempotent.
-		 */
-		D_GOTO(pool_child, rc);
+	if (anchor.pa_skipped) {
+		arg->ca_skipped++;
+	} else {
+		D_DEBUG(DB_EPC, "Finished "DF_UOID" "DF_U64"->"DF_U64"\n",
+			DP_UOID(oid), epr->epr_lo, epr->epr_hi);
+		arg->ca_aggregated++;
 	}
+	return 0;
+}
+
+/** Aggregate all objects of the container */
+static int
+cont_agg_run(struct cont_agg_arg *arg)
+{
+	struct cont_tgt_epoch_aggregate_in	*in = arg->ca_in;
+	vos_iter_param_t			 param;
+	daos_handle_t				 iter_hdl;
+	double					 start;
+	char					*opstr;
+	unsigned int				 cheap = 0;
+	int					 rc;
 
 	memset(&param, 0, sizeof(param));
-	param.ip_hdl	    = vos_chdl;
+	param.ip_hdl	    = arg->ca_coh;
 	param.ip_epr.epr_lo = in->tai_start_epoch;
 	param.ip_epr.epr_hi = in->tai_end_epoch;
 
@@ -964,27 +984,15 @@ cont_epoch_aggregate_one(void *vin)
 		D_ERROR(DF_CONT": failed %s : %d",
 			DP_CONT(in->tai_pool_uuid,
 				in->tai_cont_uuid), opstr, rc);
-		D_GOTO(cont_close, rc);
+		return rc;
 	}
 
 	opstr = "setting first probe for vos obj iterator";
 	rc = vos_iter_probe(iter_hdl, NULL);
-	if (rc == -DER_NONEXIST) {
-		D_DEBUG(DF_DSMS, DF_CONT": No objects to iterate\n",
-			DP_CONT(in->tai_pool_uuid, in->tai_cont_uuid));
-		/* empty container then set the highest epoch and exit */
-		set_container_purged_epoch(vos_chdl, in, &param.ip_epr);
-		D_GOTO(out, rc = 0);
-	}
-
-	if (rc != 0) {
-		D_ERROR("failed %s : %d\n", opstr, rc);
-		D_GOTO(out, rc);
-	}
-
-	for (aggregated = 0, found = 0; true; ) {
+	start = ABT_get_wtime();
+	while (true) {
 		vos_iter_entry_t	ent;
-		vos_purge_anchor_t	anchor;
+		uint64_t		aggregated;
 
 		if (rc == 0) {
 			opstr = "iter fetch with vos obj iterator";
@@ -993,9 +1001,7 @@ cont_epoch_aggregate_one(void *vin)
 
 		if (rc == -DER_NONEXIST) {
 			D_DEBUG(DF_DSMS, DF_CONT": Finish obj iteration\n",
-				DP_CONT(in->tai_pool_uuid,
-					in->tai_cont_uuid));
-			set_container_purged_epoch(vos_chdl, in, &param.ip_epr);
+				DP_CONT(in->tai_pool_uuid, in->tai_cont_uuid));
 			rc = 0;
 			break;
 		}
@@ -1004,41 +1010,101 @@ cont_epoch_aggregate_one(void *vin)
 			D_ERROR("obj iterator in "DF_CONT" failed to %s: %d",
 				DP_CONT(in->tai_pool_uuid,
 					in->tai_cont_uuid), opstr, rc);
-
-			D_GOTO(out, rc);
+			break;
 		}
-		found++;
-
-		memset(&anchor, 0, sizeof(vos_purge_anchor_t));
-		while (true) {
-			unsigned int	l_credits = credits;
-
-			finish = false;
-			rc = vos_epoch_aggregate(vos_chdl, ent.ie_oid,
-						 &param.ip_epr, &l_credits,
-						 &anchor, &finish);
-			if (rc != 0)
-				D_GOTO(out, rc);
-
-			if (finish) {
-				D_DEBUG(DB_EPC,
-					"Finished "DF_U64"->"DF_U64")\n",
-					param.ip_epr.epr_lo,
-					param.ip_epr.epr_hi);
-				break;
-			}
+
+		aggregated = arg->ca_aggregated;
+		arg->ca_scanned++;
+		rc = cont_agg_obj(arg, ent.ie_oid, &param.ip_epr);
+		if (rc != 0)
+			break;
+
+		if (arg->ca_scanned % CONT_AGG_PROGRESS_INTV == 0)
+			D_DEBUG(DF_DSMS, DF_CONT": scanned "DF_U64" objects, "
+				"skipped "DF_U64", %.1f objects/sec\n",
+				DP_CONT(in->tai_pool_uuid, in->tai_cont_uuid),
+				arg->ca_scanned, arg->ca_skipped,
+				arg->ca_scanned / (ABT_get_wtime() - start));
+
+		/* Skipping objects doesn't yield, so charge them on the
+		 * credits as well to avoid starving other ULTs.
+		 */
+		if (aggregated == arg->ca_aggregated &&
+		    ++cheap >= arg->ca_credits) {
+			cheap = 0;
 			ABT_thread_yield();
 		}
-		aggregated++;
+
 		opstr = "iter next with vos obj iterator";
 		rc = vos_iter_next(iter_hdl);
 	}
-	D_DEBUG(DF_DSMS, DF_CONT": aggregated %d/%d objects\n",
-		DP_CONT(in->tai_pool_uuid, in->tai_cont_uuid),
-			aggregated, found);
-out:
+
 	vos_iter_finish(iter_hdl);
-cont_close:
+	return rc;
+}
+
+static int
+cont_epoch_aggregate_one(void *vin)
+{
+	struct cont_tgt_epoch_aggregate_in	*in  = vin;
+	struct cont_agg_arg			 arg;
+	daos_epoch_range_t			 range;
+	struct ds_pool_child			*pool_child;
+	daos_handle_t				 vos_chdl;
+	unsigned int				 credits;
+	double					 elapsed;
+	char					*opstr;
+	int					 rc;
+
+	credits = daos_env2uint(getenv("DAOS_PURGE_CREDITS"));
+	if (credits == 0)
+		credits = DAOS_PURGE_CREDITS_MAX;
+
+	pool_child = ds_pool_child_lookup(in->tai_pool_uuid);
+	if (pool_child == NULL) {
+		D_ERROR(DF_CONT": pool child is NULL\n",
+			DP_CONT(in->tai_pool_uuid,
+				in->tai_cont_uuid));
+		return -DER_NO_HDL;
+	}
+
+	opstr = "opening vos container handle\n";
+	rc = vos_cont_open(pool_child->spc_hdl, in->tai_cont_uuid,
+			   &vos_chdl);
+	if (rc != 0) {
+		D_ERROR(DF_CONT": Failed %s : %d",
+			DP_CONT(in->tai_pool_uuid,
+				in->tai_cont_uuid), opstr, rc);
+		/*
+		 * Aggregate ULT is run in background so ignore return values
+		 * further more aggregation is idempotent.
+		 */
+		D_GOTO(pool_child, rc);
+	}
+
+	memset(&arg, 0, sizeof(arg));
+	arg.ca_in	= in;
+	arg.ca_coh	= vos_chdl;
+	arg.ca_credits	= credits;
+
+	elapsed = ABT_get_wtime();
+	rc = cont_agg_run(&arg);
+	elapsed = ABT_get_wtime() - elapsed;
+
+	D_DEBUG(DF_DSMS, DF_CONT": aggregated "DF_U64"/"DF_U64" objects, "
+		"skipped "DF_U64" clean objects, %.3f sec, "
+		"%.1f objects/sec: %d\n",
+		DP_CONT(in->tai_pool_uuid, in->tai_cont_uuid),
+		arg.ca_aggregated, arg.ca_scanned, arg.ca_skipped, elapsed,
+		elapsed > 0 ? arg.ca_scanned / elapsed : 0, rc);
+
+	/* all objects are done, the whole range is aggregated */
+	if (rc == 0) {
+		range.epr_lo = in->tai_start_epoch;
+		range.epr_hi = in->tai_end_epoch;
+		set_container_purged_epoch(vos_chdl, in, &range);
+	}
+
 	vos_cont_close(vos_chdl);
 pool_child:
 	ds_pool_child_put(pool_child);
@@ -1070,7 +1136,8 @@ ds_cont_tgt_epoch_aggregate_handler(crt_rpc_t *rpc)
 	if (out->tao_rc != 0)
 		return;
 
-	rc = dss_thread_collective(cont_epoch_aggregate_one, in);
+	rc = dss_thread_collective_pool(cont_epoch_aggregate_one, in,
+					DSS_POOL_AGGREGATE);
 	if (rc != 0)
 		D_ERROR(DF_CONT": failed to aggregate "DF_U64"->"DF_U64": %d\n",
 			DP_CONT(in->tai_pool_uuid, in->tai_cont_uuid),
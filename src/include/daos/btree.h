@@ -94,7 +94,11 @@ struct btr_node {
 	uint64_t			tn_gen;
 	/** the first child, it is unused on leaf node */
 	TMMID(struct btr_node)		tn_child;
-	/** records in this node */
+	/**
+	 * records in this node. If BTR_FEAT_KEY_ARRAY is set, a key array
+	 * which mirrors hkeys of these records is stored after the records,
+	 * see btr_node_keys() for the details.
+	 */
 	struct btr_record		tn_recs[0];
 };
 
@@ -452,6 +456,15 @@ enum btr_feats {
 	 * to_key_cmp callback
 	 */
 	BTR_FEAT_DIRECT_KEY		= (1 << 1),
+	/** Besides the records, each tree node stores the (normalized)
+	 * fixed-size keys contiguously in a separate cache-line aligned key
+	 * array, so probe can search a node with vectorized compares instead
+	 * of calling to_hkey_cmp for each record.  It is supported by trees
+	 * using BTR_FEAT_UINT_KEY, or by classes having 8 or 16 bytes hkey
+	 * and no to_hkey_cmp callback (memcmp order). It can be set for any
+	 * tree of these classes, the class doesn't need to register it.
+	 */
+	BTR_FEAT_KEY_ARRAY		= (1 << 2),
 };
 
 /**
@@ -482,8 +495,14 @@ int  dbtree_open(TMMID(struct btr_root) root_mmid, struct umem_attr *uma,
 int  dbtree_open_inplace(struct btr_root *root, struct umem_attr *uma,
 			 daos_handle_t *toh);
 int  dbtree_close(daos_handle_t toh);
+size_t dbtree_hdl_size(daos_handle_t toh);
 int  dbtree_destroy(daos_handle_t toh);
 int  dbtree_update(daos_handle_t toh, daos_iov_t *key, daos_iov_t *val);
+int  dbtree_lookup_batch(daos_handle_t toh, daos_iov_t *keys,
+			 daos_iov_t *vals, int *rcs, unsigned int nr);
+int  dbtree_bulk_insert(daos_handle_t toh, daos_iov_t *keys,
+			daos_iov_t *vals, unsigned int nr, unsigned int fill,
+			unsigned int *new_nr);
 int  dbtree_fetch(daos_handle_t toh, dbtree_probe_opc_t opc,
 		  daos_iov_t *key, daos_iov_t *key_out, daos_iov_t *val_out);
 int  dbtree_lookup(daos_handle_t toh, daos_iov_t *key, daos_iov_t *val_out);
@@ -36,17 +36,37 @@
 enum {
 	DAOS_CS_CRC32 = 0,
 	DAOS_CS_CRC64 = 1,
+	/** CRC32 with Castagnoli polynomial, same as "crc32" of ISA-L */
+	DAOS_CS_CRC32C = 2,
+	/** xxHash64, fast non-cryptographic hash */
+	DAOS_CS_XXH64 = 3,
 	DAOS_CS_MAX,
 	DAOS_CS_UNKNOWN,
 };
 
+/** running state of xxHash64 */
+struct daos_xxh64_state {
+	/** total length of input */
+	uint64_t		xs_total;
+	/** four accumulators, one for each 8 bytes of a 32 bytes stripe */
+	uint64_t		xs_v[4];
+	/** input which hasn't been consumed, it's less than one stripe */
+	uint8_t			xs_mem[32];
+	/** size of xs_mem */
+	uint32_t		xs_memsize;
+};
+
 struct daos_csum {
 	int			dc_init:1;
 #if defined(__x86_64__)
 	int			dc_csum;
 #else
 	mchecksum_object_t	dc_csum;
+	/** checksum type, xxHash64 isn't supported by mchecksum */
+	int			dc_type;
 #endif
+	/** state of hash which doesn't keep its result in dc_buf */
+	struct daos_xxh64_state	dc_xxh64;
 	char			dc_buf[DAOS_CSUM_SIZE];
 
 };
@@ -56,6 +76,13 @@ int		daos_csum_init(const char *cs_name, daos_csum_t *checksum);
 int		daos_csum_free(daos_csum_t *csum);
 int		daos_csum_reset(daos_csum_t *csum);
 int		daos_csum_compute(daos_csum_t *csum, daos_sg_list_t *sgl);
+int		daos_csum_compute_iovs(daos_csum_t *csum, daos_sg_list_t *sgl,
+				       daos_csum_buf_t *csums);
+int		daos_csum_compute_ranges(daos_csum_t *csum,
+					 daos_sg_list_t *sgl, unsigned int nr,
+					 daos_size_t *lens,
+					 daos_csum_buf_t *csums);
+const char	*daos_csum_type2name(unsigned int type);
 daos_size_t	daos_csum_get_size(daos_csum_t *csum);
 int		daos_csum_get(daos_csum_t *csum, daos_csum_buf_t *csum_buf);
 int		daos_csum_compare(daos_csum_t *csum, daos_csum_t *csum_src);
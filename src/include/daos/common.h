@@ -249,9 +249,32 @@ d_rank_list_t *daos_rank_list_parse(const char *str, const char *sep);
 enum {
 	DSS_KEY_FAIL_LOC = 0,
 	DSS_REBUILD_RES_PERCENTAGE,
+	DSS_SCRUB_RES_PERCENTAGE,
+	/** scheduling policy of server xstreams, DSS_SCHED_* */
+	DSS_SCHED_POLICY,
+	/** weights of scheduling classes for DSS_SCHED_WFQ, 0 - 100 */
+	DSS_SCHED_WEIGHT_IO,
+	DSS_SCHED_WEIGHT_META,
+	DSS_SCHED_WEIGHT_AGGREGATE,
+	/** non-zero to let idle xstreams steal ULTs created for DSS_XS_ANY */
+	DSS_WORK_STEAL,
 	DSS_KEY_NUM,
 };
 
+/** scheduling policies of server xstreams */
+enum {
+	/**
+	 * I/O first, rebuild and scrub are choosen by random with their
+	 * percentages.
+	 */
+	DSS_SCHED_PRIO = 0,
+	/** weighted-fair queueing across I/O, metadata, rebuild, aggregation
+	 * and scrub classes, and ULTs which can run on any xstream.
+	 */
+	DSS_SCHED_WFQ,
+	DSS_SCHED_MAX,
+};
+
 void
 daos_fail_loc_set(uint64_t id);
 void
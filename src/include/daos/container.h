@@ -39,6 +39,7 @@ int dc_cont_tgt_idx2ptr(daos_handle_t coh, uint32_t tgt_idx,
 			struct pool_target **tgt);
 int dc_cont_hdl2uuid(daos_handle_t coh, uuid_t *hdl_uuid, uuid_t *con_uuid);
 daos_handle_t dc_cont_hdl2pool_hdl(daos_handle_t coh);
+bool dc_cont_csum_enabled(daos_handle_t coh);
 
 int dc_cont_local2global(daos_handle_t coh, daos_iov_t *glob);
 int dc_cont_global2local(daos_handle_t poh, daos_iov_t glob,
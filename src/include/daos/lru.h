@@ -46,12 +46,31 @@ struct daos_llink_ops {
 struct daos_llink {
 	/* LRU hash link */
 	d_list_t		ll_hlink;
-	/* LRU queue link */
+	/*
+	 * LRU queue link, it links the item on the retired list of the
+	 * shared cache after it has been removed from the hash bucket.
+	 */
 	d_list_t		ll_qlink;
 	/* Ref count for this reference */
-	unsigned int		ll_ref:30;
+	uint32_t		ll_ref;
 	/** has been evicted */
-	unsigned int		ll_evicted:1;
+	uint16_t		ll_evicted;
+	/**
+	 * clock reference bit of the shared cache, or the item has been
+	 * referenced again after insertion (2Q policy)
+	 */
+	uint16_t		ll_clock;
+	/** hash of the key, only for the shared cache */
+	uint32_t		ll_hash;
+	/**
+	 * memory cost of the item in bytes, it can be set by lop_alloc_ref
+	 * or daos_lru_ref_cost_set()
+	 */
+	uint32_t		ll_cost;
+	/** next item in the hash bucket, only for the shared cache */
+	struct daos_llink	*ll_next;
+	/** epoch when it was retired, only for the shared cache */
+	uint64_t		ll_retire;
 	/**
 	 * ops to allocate and free reference
 	 * for this llink.
@@ -59,6 +78,39 @@ struct daos_llink {
 	struct daos_llink_ops	*ll_ops;
 };
 
+/** statistics of LRU cache */
+struct daos_lru_stat {
+	/** # lookups which found the item in cache */
+	uint64_t		ls_hits;
+	/** # lookups which didn't find the item in cache */
+	uint64_t		ls_misses;
+	/** # items evicted to make room for new items */
+	uint64_t		ls_evictions;
+	/** # items in the cache */
+	uint64_t		ls_nr;
+	/** total cost of items in the cache, in bytes */
+	uint64_t		ls_cost;
+	/**
+	 * # lookups of the shared cache by threads without reader slot, they
+	 * search with lock
+	 */
+	uint64_t		ls_locked;
+};
+
+/** replacement policies of LRU cache */
+enum daos_lru_policy {
+	/** new items are inserted as recently used */
+	DAOS_LRU_POL_LRU	= 0,
+	/**
+	 * new items are inserted on a probation queue which is evicted
+	 * first, they are promoted to the main LRU only if they are
+	 * referenced again, so one pass of scan can't flush the working set.
+	 */
+	DAOS_LRU_POL_2Q,
+};
+
+struct lru_shared;
+
 /**
  * LRU cache implementation using d_hash_table
  * and d_list_t
@@ -70,14 +122,33 @@ struct daos_lru_cache {
 	uint32_t		dlc_idle_nr;
 	/* # busy items in the LRU (referenced by caller) */
 	uint32_t		dlc_busy_nr;
+	/* # idle items on the probation list, they're also in dlc_idle_nr */
+	uint32_t		dlc_probe_nr;
+	/** replacement policy, see daos_lru_policy */
+	uint32_t		dlc_policy;
+	/** memory budget of the cache in bytes, zero means unlimited */
+	uint64_t		dlc_budget;
+	/** total cost of all items in the cache */
+	uint64_t		dlc_cost;
+	/** total cost of items on the probation list */
+	uint64_t		dlc_probe_cost;
 	/* Queue head, holds idle refs (no refcnt) */
 	d_list_t		dlc_idle_list;
+	/** idle items which haven't been referenced again (2Q policy) */
+	d_list_t		dlc_probe_list;
 	/** list head of busy items in the LRU */
 	d_list_t		dlc_busy_list;
 	/* Holds all refs but needs lookup */
 	struct d_hash_table	dlc_htable;
 	/* ops to allocate and free reference */
 	struct daos_llink_ops	*dlc_ops;
+	/** statistics, hits and misses of shared cache are in readers */
+	struct daos_lru_stat	dlc_stat;
+	/**
+	 * Sharded hash table and readers of the shared cache, it is NULL
+	 * for the LRU cache, see daos_lru_cache_create_shared().
+	 */
+	struct lru_shared	*dlc_shared;
 };
 
 /**
@@ -98,6 +169,58 @@ daos_lru_cache_create(int bits, uint32_t feats,
 		      struct daos_llink_ops *ops,
 		      struct daos_lru_cache **lcache);
 
+/**
+ * Create a DAOS LRU cache which can be shared by multiple threads.
+ *
+ * Items are spread over 2^shard_bits shards, each shard has its own lock
+ * which only serializes insertion and removal. Lookups don't take any lock
+ * or change shared list heads, they only take reference of the found item
+ * and set its clock bit. Items are evicted by a CLOCK hand instead of LRU
+ * order, and removed items are freed after all concurrent lookups which
+ * might still see them have finished (epoch based reclamation).
+ *
+ * All functions of LRU cache can be used for the shared cache.
+ *
+ * \param bits		[IN]	power2(bits) is the size of the cache
+ * \param shard_bits	[IN]	power2(shard_bits) is the number of shards
+ * \param ops		[IN]	DAOS LRU callbacks
+ * \param lcache	[OUT]	Newly created cache
+ *
+ * \return			0 on success and negative
+ *				on failure.
+ */
+int
+daos_lru_cache_create_shared(int bits, int shard_bits,
+			     struct daos_llink_ops *ops,
+			     struct daos_lru_cache **lcache);
+
+/**
+ * Bound the cache by memory cost of items as well as number of items, and
+ * set its replacement policy.
+ *
+ * Idle items are evicted once the total cost of items exceeds \a budget,
+ * cost of each item is ll_cost of it. Shards of the shared cache have equal
+ * share of the budget.
+ *
+ * \param lcache	[IN]	DAOS LRU cache
+ * \param budget	[IN]	Memory budget in bytes, zero means unlimited
+ * \param policy	[IN]	Replacement policy, see daos_lru_policy
+ *
+ * \return			0 on success, -DER_INVAL for invalid policy
+ */
+int
+daos_lru_cache_config(struct daos_lru_cache *lcache, uint64_t budget,
+		      enum daos_lru_policy policy);
+
+/**
+ * Return statistics of the cache.
+ *
+ * \param lcache	[IN]	DAOS LRU cache
+ * \param stat		[OUT]	Returned statistics
+ */
+void
+daos_lru_cache_stat(struct daos_lru_cache *lcache, struct daos_lru_stat *stat);
+
 /**
  * Destroy an LRU cache
  * This function destroys and LRU cache
@@ -149,6 +272,18 @@ daos_lru_ref_hold(struct daos_lru_cache *lcache, void *key, unsigned int ksize,
 void
 daos_lru_ref_release(struct daos_lru_cache *lcache, struct daos_llink *llink);
 
+/**
+ * Change memory cost of an item, the caller should hold the item. Idle items
+ * are evicted if the cache is over its budget.
+ *
+ * \param lcache	[IN]	DAOS LRU cache
+ * \param llink		[IN]	DAOS LRU link
+ * \param cost		[IN]	New cost of the item in bytes
+ */
+void
+daos_lru_ref_cost_set(struct daos_lru_cache *lcache, struct daos_llink *llink,
+		      uint32_t cost);
+
 /**
  * Evict the item from LRU after releasing the last refcount on it.
  *
@@ -157,7 +292,7 @@ daos_lru_ref_release(struct daos_lru_cache *lcache, struct daos_llink *llink);
 static inline void
 daos_lru_ref_evict(struct daos_llink *llink)
 {
-	llink->ll_evicted = 1;
+	__atomic_store_n(&llink->ll_evicted, 1, __ATOMIC_RELEASE);
 }
 
 /**
@@ -168,7 +303,7 @@ daos_lru_ref_evict(struct daos_llink *llink)
 static inline bool
 daos_lru_ref_evicted(struct daos_llink *llink)
 {
-	return llink->ll_evicted;
+	return __atomic_load_n(&llink->ll_evicted, __ATOMIC_ACQUIRE);
 }
 
 #endif
@@ -99,6 +99,9 @@ int dc_obj_fetch_md(daos_obj_id_t oid, struct daos_obj_md *md);
 int dc_obj_layout_get(daos_handle_t oh, struct pl_obj_layout **layout,
 		      unsigned int *grp_nr, unsigned int *grp_size);
 int dc_obj_layout_refresh(daos_handle_t oh);
+void dc_obj_buf_invalidate(void *buf, daos_size_t len);
+int dc_obj_buf_query(daos_obj_buf_stat_t *stat);
+int dc_obj_batch_query(daos_obj_batch_stat_t *stat);
 
 #define ENUM_ANCHOR_SHARD_OFF		28
 #define ENUM_ANCHOR_SHARD_LENGTH	4
@@ -36,10 +36,12 @@
 /** types of placement maps */
 typedef enum {
 	PL_TYPE_UNKNOWN,
-	/** only support ring map for the time being */
+	/** consistent hash rings */
 	PL_TYPE_RING,
 	/** reserved */
 	PL_TYPE_PETALS,
+	/** jump consistent hash over fault domains */
+	PL_TYPE_JUMP,
 } pl_map_type_t;
 
 struct pl_map_init_attr {
@@ -49,6 +51,9 @@ struct pl_map_init_attr {
 			pool_comp_type_t	domain;
 			unsigned int		ring_nr;
 		} ia_ring;
+		struct pl_jump_init_attr {
+			pool_comp_type_t	domain;
+		} ia_jump;
 	};
 };
 
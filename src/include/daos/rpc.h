@@ -62,6 +62,7 @@ extern struct crt_msg_field DMF_EPOCH_STATE;
 extern struct crt_msg_field DMF_HASH_OUT;
 extern struct crt_msg_field DMF_KEY_DESC_ARRAY;
 extern struct crt_msg_field DMF_REC_SIZE_ARRAY;
+extern struct crt_msg_field DMF_CSUM_ARRAY;
 extern struct crt_msg_field DMF_SGL;
 extern struct crt_msg_field DMF_SGL_ARRAY;
 extern struct crt_msg_field DMF_SGL_DESC;
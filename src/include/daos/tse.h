@@ -94,6 +94,48 @@ int
 tse_sched_init(tse_sched_t *sched, tse_sched_comp_cb_t comp_cb,
 		void *udata);
 
+/** the scheduler and its tasks are only accessed by one thread */
+#define TSE_SCHED_F_SINGLE	(1U << 0)
+
+/**
+ * Initialize the scheduler like tse_sched_init(), with \a flags to tune it.
+ * If the scheduler has TSE_SCHED_F_SINGLE, it skips locking, so tasks must
+ * be created, scheduled, completed and released by the initializing thread,
+ * or by threads serialized with it, like ULTs of the same xstream.
+ *
+ * \param sched [input]		scheduler to be initialized.
+ * \param comp_cb [input]	Optional callback to be called when scheduler
+ *				is done.
+ * \param udata [input]		Optional pointer to user data.
+ * \param flags [input]		TSE_SCHED_F_* flags.
+ *
+ * \return			0 if initialization succeeds.
+ * \return			negative errno if initialization fails.
+ */
+int
+tse_sched_init_ext(tse_sched_t *sched, tse_sched_comp_cb_t comp_cb,
+		   void *udata, unsigned int flags);
+
+/** callback deferred to the end of a progress window of the scheduler */
+typedef void (*tse_sched_defer_cb_t)(tse_sched_t *sched, void *arg);
+
+/**
+ * Defer \a cb to the end of the current progress window of the scheduler,
+ * which is after tse_sched_progress() has executed bodies of all ready tasks,
+ * or the next call of it if the scheduler is not being progressed. Tasks can
+ * use it to batch their requests. Nothing is deferred if \a cb with the same
+ * \a arg is already pending.
+ *
+ * \param sched [input]		scheduler of the tasks.
+ * \param cb [input]		callback to be called once.
+ * \param arg [input]		argument of the callback.
+ *
+ * \return			0 if success.
+ * \return			negative errno if it fails.
+ */
+int
+tse_sched_defer(tse_sched_t *sched, tse_sched_defer_cb_t cb, void *arg);
+
 /**
  * Finish the scheduler.
  *
@@ -1169,6 +1169,41 @@ daos_obj_list_recx(daos_handle_t oh, daos_epoch_t epoch, daos_key_t *dkey,
 		   daos_hash_out_t *anchor, bool incr_order,
 		   daos_event_t *ev);
 
+/**
+ * Drop cached network registration of buffers overlapping with the range.
+ * If the registration cache of I/O buffers is enabled (DAOS_OBJ_BULK_CACHE_MB),
+ * this should be called before freeing or remapping a buffer which has been
+ * used by object I/O. It is a no-op if the cache is disabled.
+ *
+ * \param buf	[IN]	Start address of the range.
+ * \param len	[IN]	Length of the range in bytes.
+ */
+void
+daos_obj_buf_invalidate(void *buf, daos_size_t len);
+
+/**
+ * Query statistics of the registration cache of I/O buffers.
+ *
+ * \param stat	[OUT]	Returned statistics.
+ *
+ * \return		0		Success
+ *			-DER_UNINIT	The cache is disabled
+ */
+int
+daos_obj_buf_query(daos_obj_buf_stat_t *stat);
+
+/**
+ * Query statistics of batching of small updates, which is enabled by
+ * setting DAOS_OBJ_BATCH in the environment.
+ *
+ * \param stat	[OUT]	Returned statistics.
+ *
+ * \return		0		Success
+ *			-DER_UNINIT	Batching is disabled
+ */
+int
+daos_obj_batch_query(daos_obj_batch_stat_t *stat);
+
 #if defined(__cplusplus)
 }
 #endif
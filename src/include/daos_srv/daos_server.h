@@ -133,6 +133,29 @@ struct dss_nvme_context {
 	d_list_t		 dnc_pollers;
 };
 
+/**
+ * NVMe blob on the blobstore of the calling xstream, see srv_nvme.c.
+ *
+ * All the blob functions must be called from a ULT running on the xstream
+ * which owns the blobstore, they submit the request to SPDK then wait for
+ * its completion, which is driven by the xstream progress loop through
+ * dss_nvme_poll(). They return -DER_UNINIT if the xstream has no NVMe.
+ */
+struct dss_nvme_blob;
+
+/** I/O unit of the NVMe blob, offset & length of blob I/O must align to it */
+#define DSS_NVME_BLK_SZ		(4UL << 10)
+
+int dss_nvme_blob_create(daos_size_t size, uint64_t *blob_id);
+int dss_nvme_blob_delete(uint64_t blob_id);
+int dss_nvme_blob_open(uint64_t blob_id, struct dss_nvme_blob **blob);
+int dss_nvme_blob_close(struct dss_nvme_blob *blob);
+int dss_nvme_blob_rw(struct dss_nvme_blob *blob, daos_off_t off, void *buf,
+		     daos_size_t len, bool update);
+/** DMA safe buffer for blob I/O */
+void *dss_nvme_dma_alloc(daos_size_t size);
+void dss_nvme_dma_free(void *buf);
+
 struct dss_module_info {
 	crt_context_t		dmi_ctx;
 	struct dss_nvme_context	dmi_nvme_ctxt;
@@ -216,8 +239,18 @@ typedef ABT_pool (*dss_abt_pool_choose_cb_t)(crt_rpc_t *rpc, ABT_pool *pools);
 
 void dss_abt_pool_choose_cb_register(unsigned int mod_id,
 				     dss_abt_pool_choose_cb_t cb);
+/** stream_id of dss_ult_create(): the current xstream */
+#define DSS_XS_SELF	(-1)
+/**
+ * stream_id of dss_ult_create(): any xstream, the ULT can be stolen by idle
+ * xstreams if work stealing (DSS_WORK_STEAL) is enabled.
+ */
+#define DSS_XS_ANY	(-2)
+
 int dss_ult_create(void (*func)(void *), void *arg,
 		   int stream_id, ABT_thread *ult);
+int dss_ult_create_pool(void (*func)(void *), void *arg,
+			unsigned int pool_type, ABT_thread *ult);
 int dss_ult_create_all(void (*func)(void *), void *arg);
 int dss_ult_create_execute(int (*func)(void *), void *arg,
 			   void (*user_cb)(void *), void *cb_args,
@@ -301,6 +334,8 @@ dss_thread_collective_reduce(struct dss_coll_ops *ops,
 
 int dss_task_collective(int (*func)(void *), void *arg);
 int dss_thread_collective(int (*func)(void *), void *arg);
+int dss_thread_collective_pool(int (*func)(void *), void *arg,
+			       unsigned int pool_type);
 
 int dss_task_run(tse_task_t *task, unsigned int type, tse_task_cb_t cb,
 		 void *arg);
@@ -335,6 +370,31 @@ enum {
 	DSS_OFFLOAD_MAX		= 7
 };
 
+/** opcodes of offload task */
+enum {
+	/** checksum of sgl, at_params is struct dss_acc_csum */
+	DSS_ACC_OP_CSUM		= 0,
+};
+
+/** parameters of DSS_ACC_OP_CSUM */
+struct dss_acc_csum {
+	/** checksum type, and running checksum if ac_csums is NULL */
+	daos_csum_t		*ac_csum;
+	/** data to be checksummed */
+	daos_sg_list_t		*ac_sgl;
+	/**
+	 * Optional, returned checksum of each iov of ac_sgl, or of each range
+	 * of ac_lens, all iovs are checksummed into ac_csum if it is NULL.
+	 */
+	daos_csum_buf_t		*ac_csums;
+	/**
+	 * Optional, lengths of \a ac_nr consecutive ranges of ac_sgl, which
+	 * are checksummed separately, see daos_csum_compute_ranges().
+	 */
+	daos_size_t		*ac_lens;
+	unsigned int		 ac_nr;
+};
+
 struct dss_acc_task {
 	/**
 	 * Type of offload for this operation
@@ -364,20 +424,33 @@ struct dss_acc_task {
  */
 int dss_acc_offload(struct dss_acc_task *at_args);
 
-/** Different type of ES pools, there are 3 pools for now
+/** Different type of ES pools, there are 6 pools for now, each of them is a
+ * scheduling class of the xstream scheduler (see DSS_SCHED_POLICY).
  *
- *  DSS_POOL_PRIV     Private pool: I/O requests will be added to this pool.
- *  DSS_POOL_SHARE    Shared pool: Other requests and ULT created during
- *                    processing rpc.
- *  DSS_POOL_REBUILD  Private pool: pools specially for rebuild tasks.
+ *  DSS_POOL_PRIV       Private pool: I/O requests will be added to this pool.
+ *  DSS_POOL_SHARE      Shared pool: Other requests and ULT created during
+ *                      processing rpc.
+ *  DSS_POOL_STEAL      Shared pool: ULTs created for DSS_XS_ANY, idle
+ *                      xstreams can steal them from each other.
+ *  DSS_POOL_REBUILD    Private pool: pools specially for rebuild tasks.
+ *  DSS_POOL_AGGREGATE  Shared pool: epoch aggregation ULTs.
+ *  DSS_POOL_SCRUB      Private pool: lowest priority pool for the background
+ *                      scrubber, its share of the xstream is bounded by
+ *                      dss_scrub_res_percentage.
  */
 enum {
 	DSS_POOL_PRIV,
 	DSS_POOL_SHARE,
+	DSS_POOL_STEAL,
 	DSS_POOL_REBUILD,
+	DSS_POOL_AGGREGATE,
+	DSS_POOL_SCRUB,
 	DSS_POOL_CNT,
 };
 
+/** Maximum percentage of xstream time for the background scrubber */
+extern unsigned int dss_scrub_res_percentage;
+
 /* DAOS object API on the server side */
 int ds_obj_open(daos_handle_t coh, daos_obj_id_t oid,
 		daos_epoch_t epoch, unsigned int mode,
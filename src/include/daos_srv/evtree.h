@@ -56,12 +56,19 @@ enum {
 /** size of embedded bytes in data pointer (tiny extent) */
 #define EVT_PTR_PAYLOAD			16
 
+/** bits for \a evt_ptr::pt_flags */
+enum evt_ptr_flags {
+	/** extent data is stored on NVMe, see \a evt_ptr::pt_blk_off */
+	EVT_PTR_NVME			= (1 << 0),
+};
+
 /** EVTree data pointer */
 struct evt_ptr {
 	/** buffer mmid */
 	umem_id_t			pt_mmid;
 	/** cookie to insert this extent */
 	uuid_t				pt_cookie;
+	/** checksum of the extent, see \a pt_cs_len and \a pt_cs_type */
 	uint64_t			pt_csum;
 	/** number of indices */
 	uint64_t			pt_inum;
@@ -71,9 +78,20 @@ struct evt_ptr {
 	uint32_t			pt_ref;
 	/** Pool map version for the record */
 	uint32_t			pt_ver;
-	uint32_t			pt_pad_32;
-	/** embedded payload for tiny extent */
-	char				pt_payload[EVT_PTR_PAYLOAD];
+	/** checksum type, it is only valid if \a pt_cs_len is non-zero */
+	uint16_t			pt_cs_type;
+	/** size of checksum in \a pt_csum, zero means no checksum */
+	uint16_t			pt_cs_len;
+	/** see \a evt_ptr_flags */
+	uint32_t			pt_flags;
+	/** reserved */
+	uint32_t			pt_pad32;
+	union {
+		/** embedded payload for tiny extent */
+		char			pt_payload[EVT_PTR_PAYLOAD];
+		/** NVMe block offset of the extent data (EVT_PTR_NVME) */
+		uint64_t		pt_blk_off;
+	};
 };
 
 /** Reference on a evtree data pointer, see \a evt_ptr */
@@ -141,6 +159,11 @@ struct evt_node {
 	 *
 	 * non-leaf node:
 	 * rect[0], rect[1], ... rect[order - 1], child[0], child[1], ...
+	 *
+	 * With EVT_FEAT_NODE_SOA, rectangles are stored as three arrays
+	 * in the same space:
+	 * off_lo[0 ... order - 1], off_hi[0 ... order - 1],
+	 * epc_lo[0 ... order - 1]
 	 */
 	uint64_t			tn_body[0];
 };
@@ -154,14 +177,24 @@ struct evt_root {
 	uint32_t			tr_order;
 	/** see \a evt_feats */
 	uint64_t			tr_feats;
+	/**
+	 * Generation stamp, it is changed by every modification of the tree,
+	 * and is unique within the process, see \a evt_find.
+	 */
+	uint64_t			tr_gen;
 };
 
 enum evt_feats {
 	/** rectangles are Sorted by their Start Offset */
 	EVT_FEAT_SORT_SOFF		= (1 << 0),
+	/**
+	 * Rectangles of a node are stored as structure of arrays, so the
+	 * overlap test against all rectangles of a node can be vectorized.
+	 */
+	EVT_FEAT_NODE_SOA		= (1 << 1),
 };
 
-#define EVT_FEAT_DEFAULT		EVT_FEAT_SORT_SOFF
+#define EVT_FEAT_DEFAULT		(EVT_FEAT_SORT_SOFF | EVT_FEAT_NODE_SOA)
 
 /**
  * Data struct to pass in or return a versioned extent and its data block.
@@ -188,6 +221,19 @@ struct evt_entry {
 	umem_id_t			 en_mmid;
 	/** the returned memory address for \a evt_find */
 	void				*en_addr;
+	/** see \a evt_ptr_flags */
+	uint32_t			 en_flags;
+	/**
+	 * NVMe block offset of the whole extent if \a en_flags has
+	 * EVT_PTR_NVME, \a en_addr is NULL in this case.
+	 */
+	uint64_t			 en_blk_off;
+	/**
+	 * checksum of the whole extent \a en_rect returned by \a evt_find,
+	 * cs_len is zero if there is no checksum, or if the extent has been
+	 * trimmed and the checksum can't verify it anymore.
+	 */
+	daos_csum_buf_t			 en_csum;
 };
 
 #define ERT_ENT_EMBEDDED		32
@@ -245,12 +291,30 @@ struct evt_policy_ops {
 	/** TODO: add more member functions */
 };
 
+/**
+ * Callbacks for extent data which is not stored in the memory class of the
+ * tree (see \a EVT_PTR_NVME), provided by the tree user on create/open.
+ */
+struct evt_desc_cbs {
+	/**
+	 * Free \a blk_cnt NVMe blocks starting from \a blk_off, it is called
+	 * within the transaction of the tree operation which releases the
+	 * extent data (overwrite, tree destroy etc).
+	 */
+	int	(*dc_nvme_free_cb)(struct umem_instance *umm, uint64_t blk_off,
+				   uint32_t blk_cnt, void *args);
+	void	*dc_nvme_free_args;
+	/** block size of \a EVT_PTR_NVME extents */
+	uint32_t dc_blk_sz;
+};
+
 /**
  * Create a new tree and open it.
  *
  * \param feats		[IN]	Feature bits, see \a evt_feats
  * \param order		[IN]	Tree order
  * \param uma		[IN]	Memory class attributes
+ * \param cbs		[IN]	Optional, callbacks for NVMe extents
  * \param root_mmidp	[OUT]	The returned tree root mmid
  * \param toh		[OUT]	The returned tree open handle
  *
@@ -258,7 +322,8 @@ struct evt_policy_ops {
  *			-ve	error code
  */
 int evt_create(uint64_t feats, unsigned int order, struct umem_attr *uma,
-	       TMMID(struct evt_root) *root_mmidp, daos_handle_t *toh);
+	       struct evt_desc_cbs *cbs, TMMID(struct evt_root) *root_mmidp,
+	       daos_handle_t *toh);
 
 /**
  * Create a new tree in the specified address of root \a root, and open it.
@@ -266,6 +331,7 @@ int evt_create(uint64_t feats, unsigned int order, struct umem_attr *uma,
  * \param feats		[IN]	Feature bits, see \a evt_feats
  * \param order		[IN]	Tree order
  * \param uma		[IN]	Memory class attributes
+ * \param cbs		[IN]	Optional, callbacks for NVMe extents
  * \param root		[IN]	The address to create the tree.
  * \param toh		[OUT]	The returned tree open handle
  *
@@ -273,32 +339,34 @@ int evt_create(uint64_t feats, unsigned int order, struct umem_attr *uma,
  *			-ve	error code
  */
 int evt_create_inplace(uint64_t feats, unsigned int order,
-		       struct umem_attr *uma, struct evt_root *root,
-		       daos_handle_t *toh);
+		       struct umem_attr *uma, struct evt_desc_cbs *cbs,
+		       struct evt_root *root, daos_handle_t *toh);
 /**
  * Open a tree by its memory ID \a root_mmid
  *
  * \param root_mmid	[IN]	Memory ID of the tree root
  * \param uma		[IN]	Memory class attributes
+ * \param cbs		[IN]	Optional, callbacks for NVMe extents
  * \param toh		[OUT]	The returned tree open handle
  *
  * \return		0	Success
  *			-ve	error code
  */
 int evt_open(TMMID(struct evt_root) root_mmid, struct umem_attr *uma,
-	     daos_handle_t *toh);
+	     struct evt_desc_cbs *cbs, daos_handle_t *toh);
 /**
  * Open a tree by its root address \a root
  *
  * \param root		[IN]	Root address of the tree
  * \param uma		[IN]	Memory class attributes
+ * \param cbs		[IN]	Optional, callbacks for NVMe extents
  * \param toh		[OUT]	The returned tree open handle
  *
  * \return		0	Success
  *			-ve	error code
  */
 int evt_open_inplace(struct evt_root *root, struct umem_attr *uma,
-		     daos_handle_t *toh);
+		     struct evt_desc_cbs *cbs, daos_handle_t *toh);
 
 /**
  * Close a opened tree
@@ -321,10 +389,13 @@ int evt_destroy(daos_handle_t toh);
  * \param toh		[IN]	The tree open handle
  * \param rect		[IN]	The versioned extent to insert
  * \param inob		[IN]	Number of bytes per index in \a rect
+ * \param csum		[IN]	Optional, checksum of the extent, it can't
+ *				be larger than 8 bytes.
  * \param mmid		[IN]	Memory ID of the input data.
  */
 int evt_insert(daos_handle_t toh, uuid_t cookie, uint32_t pm_ver,
-	       struct evt_rect *rect, uint32_t inob, umem_id_t mmid);
+	       struct evt_rect *rect, uint32_t inob, daos_csum_buf_t *csum,
+	       umem_id_t mmid);
 
 /**
  * Insert a new extented version \a rect into a opened tree, and copy data in
@@ -333,10 +404,49 @@ int evt_insert(daos_handle_t toh, uuid_t cookie, uint32_t pm_ver,
  * \param toh		[IN]	The tree open handle
  * \param rect		[IN]	The versioned extent to insert
  * \param inob		[IN]	Number of bytes per index in \a rect
+ * \param csum		[IN]	Optional, checksum of the extent
  * \param sgl		[IN]	Scatter/gather list to copy in
  */
 int evt_insert_sgl(daos_handle_t toh, uuid_t cookie, uint32_t pm_ver,
-		   struct evt_rect *rect, uint32_t inob, daos_sg_list_t *sgl);
+		   struct evt_rect *rect, uint32_t inob, daos_csum_buf_t *csum,
+		   daos_sg_list_t *sgl);
+
+/**
+ * Insert a new extented version \a rect whose data has been written to NVMe
+ * blocks starting from \a blk_off. The tree takes over the ownership of these
+ * blocks, they are released by \a evt_desc_cbs::dc_nvme_free_cb.
+ *
+ * \param toh		[IN]	The tree open handle, it must be created or
+ *				opened with \a evt_desc_cbs
+ * \param rect		[IN]	The versioned extent to insert
+ * \param inob		[IN]	Number of bytes per index in \a rect
+ * \param csum		[IN]	Optional, checksum of the extent
+ * \param blk_off	[IN]	NVMe block offset of the extent data
+ */
+int evt_insert_nvme(daos_handle_t toh, uuid_t cookie, uint32_t pm_ver,
+		    struct evt_rect *rect, uint32_t inob,
+		    daos_csum_buf_t *csum, uint64_t blk_off);
+
+/**
+ * Insert a batch of versioned extents, it is for repopulating an object, e.g.
+ * rebuild. If the tree is empty, extents are sorted by epoch and offset, then
+ * packed to full leaves and nodes bottom-up, which is much faster than
+ * inserting them one by one and generates denser tree with less overlap.
+ * Otherwise, or if there are extents overlapping in the same epoch, they are
+ * inserted one by one.
+ *
+ * \param toh		[IN]	The tree open handle
+ * \param ents		[IN]	Array of extents to insert, for each of them:
+ *				- en_rect: the versioned extent
+ *				- en_inob: number of bytes per index
+ *				- en_csum: checksum, cs_len is zero if none
+ *				- en_mmid: memory ID of the data, or
+ *				- en_blk_off: NVMe block offset of the data
+ *				  if en_flags has EVT_PTR_NVME.
+ * \param nr		[IN]	Number of extents in \a ents
+ */
+int evt_insert_bulk(daos_handle_t toh, uuid_t cookie, uint32_t pm_ver,
+		    struct evt_entry *ents, unsigned int nr);
 
 /**
  * Search the tree and return all versioned extents which overlap with \a rect
@@ -354,10 +464,39 @@ int evt_insert_sgl(daos_handle_t toh, uuid_t cookie, uint32_t pm_ver,
  * covered will be filled with any rectangles that are entirely covered
  * at the specified epoch for the range.  If the covered rectangle is only
  * partially covered by the range,
+ *
+ * Visible rectangles of the latest queries are cached per thread until the
+ * tree is modified, repeating a query returns them from the cache, with an
+ * empty \a covered.
  */
 int evt_find(daos_handle_t toh, struct evt_rect *rect,
 	     struct evt_entry_list *ent_list, d_list_t *covered);
 
+/**
+ * Delete all versioned extents which overlap with \a rect in offset and are
+ * lower than or equal to it in epoch, extents partially overlapping with the
+ * offset range are trimmed. The tree is scanned in one pass and all data
+ * being released is freed within one transaction, so the cost is proportional
+ * to the number of tree nodes overlapping with \a rect.
+ *
+ * NB: data of a trimmed extent is released only after all parts of it have
+ * been deleted.
+ *
+ * \param toh		[IN]	The tree open handle
+ * \param rect		[IN]	The offset range and the highest epoch to
+ *				delete.
+ */
+int evt_delete_range(daos_handle_t toh, struct evt_rect *rect);
+
+/**
+ * Enable or disable the visibility cache of \a evt_find for the calling
+ * thread, it is enabled by default.
+ */
+void evt_vis_cache_set(bool enable);
+
+/** Release the visibility cache of the calling thread */
+void evt_vis_cache_fini(void);
+
 /**
  * Debug function, it outputs status of tree nodes at level \a debug_level,
  * or all levels if \a debug_level is negative.
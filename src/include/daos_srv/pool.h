@@ -89,6 +89,15 @@ struct ds_pool_child {
 	uuid_t		spc_uuid;
 	uint32_t	spc_map_version;
 	int		spc_ref;
+	/** background scrubber of this target, see srv_scrub.c */
+	ABT_thread	spc_scrub_ult;
+	/** set by the owner of the child to stop the scrubber */
+	bool		spc_scrub_stop;
+	/** the sleeping scrubber waits on it, signaled on stop */
+	ABT_mutex	spc_scrub_lock;
+	ABT_cond	spc_scrub_cv;
+	/** number of corrupted records found by the scrubber */
+	uint64_t	spc_scrub_corrupted;
 };
 
 struct ds_pool_child *ds_pool_child_lookup(const uuid_t uuid);
@@ -211,8 +211,9 @@ void vea_hint_unload(struct vea_hint_context *thc);
  * \param resrvd_list [OUT]	List for storing the reserved extents
  *
  * \return			Zero on success, reserved extent(s) will be
- *				added in the @resrvd_list; Appropriated
- *				negative value on error
+ *				added in the @resrvd_list; -DER_NOSPACE when
+ *				no free extent is large enough; Appropriated
+ *				negative value on other error
  */
 int vea_reserve(struct vea_space_info *vsi, uint32_t blk_cnt,
 		struct vea_hint_context *hint, d_list_t *resrvd_list);
@@ -245,7 +246,8 @@ int vea_tx_publish(struct vea_space_info *vsi, struct vea_hint_context *hint,
 		   d_list_t *resrvd_list);
 
 /**
- * Free allocated extent.
+ * Free allocated extent. It should be part of transaction manipulated by
+ * caller.
  *
  * \param vsi     [IN]		In-memory compound index
  * \param blk_off [IN]		Start offset of the extent to be freed
@@ -254,7 +256,8 @@ int vea_tx_publish(struct vea_space_info *vsi, struct vea_hint_context *hint,
  * \return			Zero on success; Appropriated negative value
  *				on error
  */
-int vea_free(struct vea_space_info *vsi, uint64_t blk_off, uint32_t blk_cnt);
+int vea_tx_free(struct vea_space_info *vsi, uint64_t blk_off,
+		uint32_t blk_cnt);
 
 /**
  * Set an arbitrary age to a free extent with specified start offset.
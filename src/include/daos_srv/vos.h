@@ -71,11 +71,15 @@ vos_fini(void);
  * \param path	[IN]	Path of the memory pool
  * \param uuid	[IN]    Pool UUID
  * \param size	[IN]	Size of the pool
+ * \param nvme_size	[IN]	Size of the NVMe blob for large records, zero
+ *			means all records are stored in the memory pool.
+ *			The blob is created by the first vos_pool_open().
  *
  * \return              Zero on success, negative value if error
  */
 int
-vos_pool_create(const char *path, uuid_t uuid, daos_size_t size);
+vos_pool_create(const char *path, uuid_t uuid, daos_size_t size,
+		daos_size_t nvme_size);
 
 /**
  * Destroy a Versioned Object Storage Pool (VOSP)
@@ -198,6 +202,9 @@ vos_epoch_flush(daos_handle_t coh, daos_epoch_t epoch);
  * Data in all these epochs will be aggregated to the last epoch
  * \a epr::epr_hi, aggregated epochs will be discarded except the last one,
  * which is kept as aggregation result.
+ * Objects which have not been modified within \a epr since their last
+ * aggregation are skipped without scanning their trees, and reported by
+ * \a anchor::pa_skipped.
  *
  * \param coh	  [IN]		Container open handle
  * \param oid	  [IN]		Object handle for aggregation
@@ -265,7 +272,10 @@ vos_epoch_discard(daos_handle_t coh, daos_epoch_range_t *epr,
  * \param iod_nr [IN]	Number of I/O descriptors in \a iods.
  * \param iods	[IN/OUT]
  *			Array of I/O descriptors. The returned record
- *			sizes are also stored in this parameter.
+ *			sizes are also stored in this parameter. If
+ *			iod_csums is provided, the stored checksum of
+ *			each extent is returned in it, cs_len is zero if
+ *			the extent was not written by exactly one update.
  * \param sgls	[OUT]	Scatter/gather list to store the returned record values
  *			or value addresses.
  *
@@ -294,7 +304,8 @@ vos_obj_fetch(daos_handle_t coh, daos_unit_oid_t oid, daos_epoch_t epoch,
  *			used during rebuild.
  * \param dkey	[IN]	Distribution key.
  * \param iod_nr [IN]	Number of I/O descriptors in \a iods.
- * \param iods [IN]	Array of I/O descriptors.
+ * \param iods [IN]	Array of I/O descriptors. Checksums in iod_csums are
+ *			stored with extents and returned by fetch.
  * \param sgls	[IN/OUT]
  *			Scatter/gather list to pass in record value buffers,
  *			if caller sets the input buffer size only without
@@ -438,6 +449,23 @@ vos_obj_zc_update_end(daos_handle_t ioh, uuid_t cookie, uint32_t pm_ver,
 int
 vos_obj_zc_sgl_at(daos_handle_t ioh, unsigned int idx, daos_sg_list_t **sgl_pp);
 
+/**
+ * Flush records of a zero-copy update whose data has been completely stored
+ * in the ZC buffers, so persisting them can overlap with transferring data
+ * of other records. It is optional, vos_obj_zc_update_end() flushes all the
+ * records which have not been flushed. This function can yield.
+ *
+ * \param ioh	[IN]	The ZC I/O handle.
+ * \param idx	[IN]	Index of the I/O descriptor array.
+ * \param rec	[IN]	Index of the first record (iov of the ZC sgl).
+ * \param nr	[IN]	Number of records.
+ *
+ * \return		Zero on success, negative value if error
+ */
+int
+vos_obj_zc_flush(daos_handle_t ioh, unsigned int idx, unsigned int rec,
+		 unsigned int nr);
+
 /**
  * VOS iterator APIs
  */
@@ -525,6 +553,23 @@ int
 vos_iter_fetch(daos_handle_t ih, vos_iter_entry_t *entry,
 	       daos_hash_out_t *anchor);
 
+/**
+ * Copy the data of the current entry of the iterator, only VOS_ITER_RECX
+ * supports it. Data on NVMe is read from the device, so it may yield.
+ *
+ * \param ih	[IN]	Iterator handle
+ * \param iov	[IN/OUT]
+ *			Buffer for the data, iov_len is set to the size
+ *			of the data on success.
+ *
+ * \return		Zero on success
+ *			-DER_TRUNC if \a iov is too small
+ *			-DER_NOSYS if the iterator doesn't support it
+ *			negative value if error
+ */
+int
+vos_iter_copy(daos_handle_t ih, daos_iov_t *iov);
+
 /**
  * Delete the current data entry of the iterator
  *
@@ -32,6 +32,25 @@ enum vos_oi_attr {
 	/** TODO: Additional attributes to support metadata storage for SR */
 };
 
+/**
+ * statistics of objects of a pool in the VOS object cache
+ */
+struct vos_ocache_stat {
+	/** # lookups which found the object in cache */
+	uint64_t		os_hits;
+	/** # lookups which didn't find the object in cache */
+	uint64_t		os_misses;
+	/**
+	 * # objects evicted to make room for new objects, or because the
+	 * cached version became stale
+	 */
+	uint64_t		os_evictions;
+	/** # objects in cache */
+	uint64_t		os_nr;
+	/** DRAM consumed by cached objects, in bytes */
+	uint64_t		os_cost;
+};
+
 /**
  * pool attributes returned to query
  */
@@ -42,6 +61,8 @@ typedef struct {
 	daos_size_t		pif_size;
 	/** Current vailable space */
 	daos_size_t		pif_avail;
+	/** objects of the pool in the object cache, it is not persistent */
+	struct vos_ocache_stat	pif_ocache;
 	/** TODO */
 } vos_pool_info_t;
 
@@ -115,6 +136,11 @@ typedef struct {
 	daos_hash_out_t		pa_recx_max;
 	/** Save OID for aggregation optimization */
 	daos_unit_oid_t		pa_oid;
+	/**
+	 * Returned as true if the object was skipped, because it has not been
+	 * modified within the range since its last aggregation.
+	 */
+	bool			pa_skipped;
 } vos_purge_anchor_t;
 
 /**
@@ -163,6 +189,11 @@ typedef struct {
 			daos_csum_buf_t		ie_csum;
 			/** pool map version */
 			uint32_t		ie_ver;
+			/**
+			 * data of the extent is on NVMe, \a ie_iov is empty,
+			 * see vos_iter_copy()
+			 */
+			bool			ie_nvme;
 		};
 	};
 } vos_iter_entry_t;
@@ -321,10 +321,16 @@ typedef struct {
  *
  * DAOS_COO_NOSLIP disables the automatic epoch slip at epoch commit time. See
  * daos_epoch_commit().
+ *
+ * DAOS_COO_CSUM enables end-to-end checksum of object I/O through this
+ * container handle. The client computes checksum for each extent of an
+ * update and the server verifies and stores them, checksums are returned by
+ * fetch (in iod_csums if it is provided) and verified by the client.
  */
 #define DAOS_COO_RO	(1U << 0)
 #define DAOS_COO_RW	(1U << 1)
 #define DAOS_COO_NOSLIP	(1U << 2)
+#define DAOS_COO_CSUM	(1U << 3)
 
 /** Container information */
 typedef struct {
@@ -686,6 +692,30 @@ typedef struct {
 	unsigned short	kd_csum_len;
 } daos_key_desc_t;
 
+/** Statistics of the registration cache of object I/O buffers */
+typedef struct {
+	/** # bulk transfers reusing a cached registration */
+	uint64_t	bs_hits;
+	/** # bulk transfers registering the buffer */
+	uint64_t	bs_misses;
+	/** # registrations dropped to stay within the budget */
+	uint64_t	bs_evictions;
+	/** # registrations dropped by daos_obj_buf_invalidate() */
+	uint64_t	bs_invalidated;
+	/** # cached registrations */
+	uint64_t	bs_nr;
+	/** bytes of cached registrations */
+	uint64_t	bs_bytes;
+} daos_obj_buf_stat_t;
+
+/** Statistics of batching of small object updates */
+typedef struct {
+	/** # batch RPCs sent */
+	uint64_t	bs_rpcs;
+	/** # updates sent by batch RPCs */
+	uint64_t	bs_updates;
+} daos_obj_batch_stat_t;
+
 /**
  * 256-bit object ID, it can identify a unique bottom level object.
  * (a shard of upper level object).
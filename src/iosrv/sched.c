@@ -0,0 +1,172 @@
+/**
+ * (C) Copyright 2016 Intel Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * GOVERNMENT LICENSE RIGHTS-OPEN SOURCE SOFTWARE
+ * The Government's rights to use, modify, reproduce, release, perform, display,
+ * or disclose this software are subject to the terms of the Apache License as
+ * provided in Contract No. B609815.
+ * Any reproduction of computer software, computer software documentation, or
+ * portions thereof marked with this legend must also reproduce the markings.
+ */
+/**
+ * This file is part of the DAOS server. It implements the policies which
+ * choose the scheduling class (ES pool) an xstream serves next, they only
+ * look at the sizes of the pools so they can be tested without Argobots.
+ */
+#define D_LOGFAC       DD_FAC(server)
+
+#include <daos/common.h>
+#include "srv_internal.h"
+
+/**
+ * Weights of I/O, metadata, any-xstream and aggregation classes for
+ * DSS_SCHED_WFQ, weights of rebuild and scrub are dss_rebuild_res_percentage
+ * and dss_scrub_res_percentage.
+ */
+unsigned int	dss_sched_weights[DSS_POOL_CNT] = {
+	[DSS_POOL_PRIV]		= 60,
+	[DSS_POOL_SHARE]	= 20,
+	[DSS_POOL_STEAL]	= 20,
+	[DSS_POOL_AGGREGATE]	= 10,
+};
+
+/**
+ * The progress ULT of the xstream always sits in the shared pool, so the
+ * shared pool is never empty. If nothing else than the progress ULT can
+ * run, the classes which only run on an idle xstream take turns with it,
+ * otherwise they would never run, and the network must still be polled.
+ *
+ * \return	true if it is the turn of the idle classes
+ */
+static bool
+sched_idle_turn(struct sched_data *data)
+{
+	data->sd_idle_turn = !data->sd_idle_turn;
+	return data->sd_idle_turn;
+}
+
+/**
+ * DSS_SCHED_PRIO: I/O request ULTs first, then other requests and collective
+ * or created ULTs. The rebuild ULT will be choosen by
+ * dss_rebuild_res_percentage, the scrub ULT is only choosen by
+ * dss_scrub_res_percentage or if the xstream is idle.
+ */
+static int
+prio_class_pick(struct sched_data *data, size_t *sizes)
+{
+	int	idle = -1;
+
+	if (sizes[DSS_POOL_SCRUB] != 0 &&
+	    rand() % 100 < dss_scrub_res_percentage)
+		return DSS_POOL_SCRUB;
+
+	if (sizes[DSS_POOL_REBUILD] != 0 &&
+	    rand() % 100 <= dss_rebuild_res_percentage)
+		return DSS_POOL_REBUILD;
+
+	if (sizes[DSS_POOL_PRIV] != 0)
+		return DSS_POOL_PRIV;
+
+	if (sizes[DSS_POOL_STEAL] != 0)
+		idle = DSS_POOL_STEAL;
+	else if (sizes[DSS_POOL_AGGREGATE] != 0)
+		idle = DSS_POOL_AGGREGATE;
+	else if (sizes[DSS_POOL_SCRUB] != 0)
+		idle = DSS_POOL_SCRUB;
+
+	if (sizes[DSS_POOL_SHARE] == 0)
+		return idle;
+
+	if (idle < 0 || sizes[DSS_POOL_SHARE] > 1 || !sched_idle_turn(data))
+		return DSS_POOL_SHARE;
+
+	return idle;
+}
+
+static unsigned int
+dss_sched_weight(int cls)
+{
+	switch (cls) {
+	case DSS_POOL_REBUILD:
+		return dss_rebuild_res_percentage;
+	case DSS_POOL_SCRUB:
+		return dss_scrub_res_percentage;
+	default:
+		return dss_sched_weights[cls];
+	}
+}
+
+/**
+ * DSS_SCHED_WFQ: smooth weighted round-robin over non-empty classes. Each
+ * round, every non-empty class earns credits equal to its weight, the class
+ * with the most credits is served and pays the sum of weights of this round.
+ * Over any interval in which a set of classes stay non-empty, each of them is
+ * served in proportion to its weight, deterministically and without bursts.
+ * Classes with zero weight are only served if the xstream is idle, i.e.
+ * nothing else than the progress ULT is runnable.
+ */
+static int
+wfq_class_pick(struct sched_data *data, size_t *sizes)
+{
+	unsigned int	weight;
+	int64_t		total = 0;
+	bool		busy = false;
+	int		idle = -1;
+	int		cls = -1;
+	int		i;
+
+	for (i = 0; i < DSS_POOL_CNT; i++) {
+		if (sizes[i] == 0) {
+			/* don't accumulate credits while being empty */
+			data->sd_credits[i] = 0;
+			continue;
+		}
+
+		weight = dss_sched_weight(i);
+		if (weight == 0) {
+			if (idle < 0)
+				idle = i;
+			continue;
+		}
+
+		if (sizes[i] > (i == DSS_POOL_SHARE ? 1 : 0))
+			busy = true;
+
+		data->sd_credits[i] += weight;
+		total += weight;
+		if (cls < 0 || data->sd_credits[i] > data->sd_credits[cls])
+			cls = i;
+	}
+
+	if (cls < 0)
+		return idle;
+
+	data->sd_credits[cls] -= total;
+	if (idle >= 0 && !busy && sched_idle_turn(data))
+		return idle;
+
+	return cls;
+}
+
+struct dss_sched_policy_ops dss_sched_policies[DSS_SCHED_MAX] = {
+	[DSS_SCHED_PRIO] = {
+		.so_name	= "prio",
+		.so_class_pick	= prio_class_pick,
+	},
+	[DSS_SCHED_WFQ] = {
+		.so_name	= "wfq",
+		.so_class_pick	= wfq_class_pick,
+	},
+};
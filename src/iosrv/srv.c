@@ -40,6 +40,8 @@
 unsigned int	dss_nxstreams;
 
 unsigned int	dss_rebuild_res_percentage = 30;
+/** Maximum percentage of xstream time the background scrubber can consume */
+unsigned int	dss_scrub_res_percentage = 10;
 
 /** Per-xstream configuration data */
 struct dss_xstream {
@@ -69,8 +71,19 @@ struct dss_xstream_data {
 
 static struct dss_xstream_data	xstream_data;
 
-struct sched_data {
-    uint32_t event_freq;
+/** Scheduling policy of all xstreams, DSS_SCHED_* */
+static unsigned int	dss_sched_policy = DSS_SCHED_WFQ;
+
+/** Idle xstreams steal ULTs from DSS_POOL_STEAL of other xstreams */
+static bool		dss_work_steal;
+
+static const char *dss_sched_class_names[DSS_POOL_CNT] = {
+	[DSS_POOL_PRIV]		= "io",
+	[DSS_POOL_SHARE]	= "meta",
+	[DSS_POOL_STEAL]	= "any",
+	[DSS_POOL_REBUILD]	= "rebuild",
+	[DSS_POOL_AGGREGATE]	= "aggregate",
+	[DSS_POOL_SCRUB]	= "scrub",
 };
 
 static int
@@ -93,36 +106,80 @@ dss_sched_init(ABT_sched sched, ABT_sched_config config)
 	return ret;
 }
 
-static ABT_unit
-normal_unit_pop(ABT_pool *pools, ABT_pool *pool)
+static void
+dss_sched_lat_record(struct sched_data *data, int cls, double now)
 {
-	ABT_unit unit;
+	uint64_t	usecs;
+	int		bucket = 0;
 
-	/* Let's pop I/O request ULT first */
-	ABT_pool_pop(pools[DSS_POOL_PRIV], &unit);
-	if (unit != ABT_UNIT_NULL) {
-		*pool = pools[DSS_POOL_PRIV];
-		return unit;
+	usecs = (now - data->sd_wait_since[cls]) * 1000000;
+	while (usecs != 0 && bucket < SCHED_LAT_BUCKETS - 1) {
+		usecs >>= 1;
+		bucket++;
 	}
+	data->sd_lat_hist[cls][bucket]++;
+}
 
-	/* Other request and ollective ULT or created ULT */
-	ABT_pool_pop(pools[DSS_POOL_SHARE], &unit);
-	if (unit != ABT_UNIT_NULL) {
-		*pool = pools[DSS_POOL_SHARE];
-		return unit;
-	}
+static struct dss_xstream *
+dss_xstream_get(int stream_id)
+{
+	struct dss_xstream *dx = NULL;
+	struct dss_xstream *tmp;
 
-	return ABT_UNIT_NULL;
+	if (stream_id == DSS_XS_SELF || stream_id == DSS_XS_ANY)
+		return dss_get_module_info()->dmi_xstream;
+
+	d_list_for_each_entry(tmp, &xstream_data.xd_list, dx_list) {
+		if (tmp->dx_idx == stream_id) {
+			dx = tmp;
+			break;
+		}
+	}
+	return dx;
 }
 
+/** max number of other xstreams to try in one steal attempt */
+#define SCHED_STEAL_TRIES	2
+
+/**
+ * Pop a ULT from DSS_POOL_STEAL of another xstream. The ULT runs on this
+ * xstream until it yields or blocks, then it goes back to the pool of its
+ * owner, where it can be picked up by the owner or stolen again.
+ */
 static ABT_unit
-rebuild_unit_pop(ABT_pool *pools, ABT_pool *pool)
+dss_sched_steal(struct sched_data *data, ABT_pool *pools, ABT_pool *pool)
 {
-	ABT_unit unit;
+	struct dss_xstream	*dx;
+	ABT_unit		 unit;
+	unsigned int		 start;
+	unsigned int		 tries = 0;
+	unsigned int		 i;
+	size_t			 size;
 
-	ABT_pool_pop(pools[DSS_POOL_REBUILD], &unit);
-	if (unit != ABT_UNIT_NULL) {
-		*pool = pools[DSS_POOL_REBUILD];
+	if (dss_nxstreams < 2)
+		return ABT_UNIT_NULL;
+
+	/* rotate the first victim, so we don't always hit the same xstream */
+	start = data->sd_steal_next++ % dss_nxstreams;
+	data->sd_steal_tries++;
+	for (i = 0; i < dss_nxstreams && tries < SCHED_STEAL_TRIES; i++) {
+		dx = dss_xstream_get((start + i) % dss_nxstreams);
+		if (dx == NULL ||
+		    dx->dx_pools[DSS_POOL_STEAL] == pools[DSS_POOL_STEAL])
+			continue;
+
+		tries++;
+
+		if (ABT_pool_get_size(dx->dx_pools[DSS_POOL_STEAL], &size) !=
+		    ABT_SUCCESS || size == 0)
+			continue;
+
+		ABT_pool_pop(dx->dx_pools[DSS_POOL_STEAL], &unit);
+		if (unit == ABT_UNIT_NULL)
+			continue;
+
+		data->sd_steals++;
+		*pool = dx->dx_pools[DSS_POOL_STEAL];
 		return unit;
 	}
 
@@ -130,29 +187,71 @@ rebuild_unit_pop(ABT_pool *pools, ABT_pool *pool)
 }
 
 /**
- * Choose ULT from the pool. Note: the rebuild ULT will be
- * be choosen by dss_rebuild_res_percentage.
- *
- * XXX we may change the sequence later once we have more cases.
+ * The xstream is idle if nothing else than its progress ULT, which always
+ * sits in the shared pool, is runnable.
+ */
+static bool
+dss_sched_is_idle(size_t *sizes)
+{
+	int	i;
+
+	for (i = 0; i < DSS_POOL_CNT; i++) {
+		if (i == DSS_POOL_SCRUB)
+			continue;
+		if (sizes[i] > (i == DSS_POOL_SHARE ? 1 : 0))
+			return false;
+	}
+	return true;
+}
+
+/**
+ * Choose ULT from the pools by the current scheduling policy, and account the
+ * latency of the class being served. If the xstream is idle and work stealing
+ * is enabled, try to steal a ULT from other xstreams first.
  */
 static ABT_unit
-dss_sched_unit_pop(ABT_pool *pools, ABT_pool *pool)
+dss_sched_unit_pop(struct sched_data *data, ABT_pool *pools, ABT_pool *pool)
 {
-	size_t	 rebuild_cnt;
-	int	 rc;
+	ABT_unit	unit;
+	size_t		sizes[DSS_POOL_CNT];
+	double		now = 0;
+	int		cls;
+	int		i;
 
-	rc = ABT_pool_get_total_size(pools[DSS_POOL_REBUILD],
-				     &rebuild_cnt);
-	if (rc != ABT_SUCCESS)
+	for (i = 0; i < DSS_POOL_CNT; i++) {
+		if (ABT_pool_get_size(pools[i], &sizes[i]) != ABT_SUCCESS)
+			sizes[i] = 0;
+
+		if (sizes[i] == 0) {
+			data->sd_wait_since[i] = 0;
+		} else if (data->sd_wait_since[i] == 0) {
+			if (now == 0)
+				now = ABT_get_wtime();
+			data->sd_wait_since[i] = now;
+		}
+	}
+
+	if (dss_work_steal && dss_sched_is_idle(sizes)) {
+		unit = dss_sched_steal(data, pools, pool);
+		if (unit != ABT_UNIT_NULL)
+			return unit;
+	}
+
+	cls = dss_sched_policies[dss_sched_policy].so_class_pick(data, sizes);
+	if (cls < 0)
 		return ABT_UNIT_NULL;
 
-	if (rebuild_cnt == 0 ||
-	    rand() % 100 > dss_rebuild_res_percentage)
-		return normal_unit_pop(pools, pool);
-	else
-		return rebuild_unit_pop(pools, pool);
+	ABT_pool_pop(pools[cls], &unit);
+	if (unit == ABT_UNIT_NULL)
+		return ABT_UNIT_NULL;
 
-	return ABT_UNIT_NULL;
+	now = ABT_get_wtime();
+	dss_sched_lat_record(data, cls, now);
+	/* the next ULT of this class starts waiting from now */
+	data->sd_wait_since[cls] = sizes[cls] > 1 ? now : 0;
+
+	*pool = pools[cls];
+	return unit;
 }
 
 static void
@@ -175,7 +274,7 @@ dss_sched_run(ABT_sched sched)
 
 	while (1) {
 		/* Execute one work unit from the scheduler's pool */
-		unit = dss_sched_unit_pop(pools, &pool);
+		unit = dss_sched_unit_pop(p_data, pools, &pool);
 		if (unit != ABT_UNIT_NULL && pool != ABT_UNIT_NULL)
 			ABT_xstream_run_unit(unit, pool);
 
@@ -186,12 +285,36 @@ dss_sched_run(ABT_sched sched)
 	}
 }
 
+/** Print the latency histograms of the classes which have been served */
+static void
+dss_sched_lat_dump(struct sched_data *data)
+{
+	char	buf[SCHED_LAT_BUCKETS * 21];
+	int	len;
+	int	i;
+	int	j;
+
+	for (i = 0; i < DSS_POOL_CNT; i++) {
+		len = 0;
+		for (j = 0; j < SCHED_LAT_BUCKETS; j++)
+			len += snprintf(&buf[len], sizeof(buf) - len, " "DF_U64,
+					data->sd_lat_hist[i][j]);
+
+		D_DEBUG(DB_TRACE, "%s latency (log2 usecs):%s\n",
+			dss_sched_class_names[i], buf);
+	}
+
+	D_DEBUG(DB_TRACE, "stole "DF_U64" ULTs in "DF_U64" attempts\n",
+		data->sd_steals, data->sd_steal_tries);
+}
+
 static int
 dss_sched_free(ABT_sched sched)
 {
 	struct sched_data *p_data;
 
 	ABT_sched_get_data(sched, (void **)&p_data);
+	dss_sched_lat_dump(p_data);
 	D_FREE_PTR(p_data);
 
 	return ABT_SUCCESS;
@@ -331,8 +454,9 @@ dss_srv_handler(void *arg)
 		goto crt_destroy;
 	}
 
-	/* Prepare the scheduler */
-	rc = tse_sched_init(&dmi->dmi_sched, NULL, dmi->dmi_ctx);
+	/* Prepare the scheduler, it's only used by ULTs of this xstream */
+	rc = tse_sched_init_ext(&dmi->dmi_sched, NULL, dmi->dmi_ctx,
+				TSE_SCHED_F_SINGLE);
 	if (rc != 0) {
 		D_ERROR("failed to init the scheduler\n");
 		goto crt_destroy;
@@ -481,8 +605,12 @@ dss_start_one_xstream(hwloc_cpuset_t cpus, int idx)
 	for (i = 0; i < DSS_POOL_CNT; i++) {
 		ABT_pool_access access;
 
-		access = i == DSS_POOL_SHARE ?
-			 ABT_POOL_ACCESS_MPSC : ABT_POOL_ACCESS_PRIV;
+		if (i == DSS_POOL_STEAL)
+			access = ABT_POOL_ACCESS_MPMC;
+		else if (i == DSS_POOL_SHARE || i == DSS_POOL_AGGREGATE)
+			access = ABT_POOL_ACCESS_MPSC;
+		else
+			access = ABT_POOL_ACCESS_PRIV;
 
 		rc = ABT_pool_create_basic(ABT_POOL_FIFO, access, ABT_TRUE,
 					   &dx->dx_pools[i]);
@@ -551,6 +679,8 @@ dss_xstreams_fini(bool force)
 	int			 rc;
 
 	D_DEBUG(DB_TRACE, "Stopping execution streams\n");
+	/* xstreams are going to be freed, don't steal from each other */
+	dss_work_steal = false;
 
 	/** Stop & free progress ULTs */
 	d_list_for_each_entry(dx, &xstream_data.xd_list, dx_list)
@@ -682,31 +812,18 @@ struct dss_module_key daos_srv_modkey = {
 	.dmk_fini = dss_srv_tls_fini,
 };
 
-static struct dss_xstream *
-dss_xstream_get(int stream_id)
-{
-	struct dss_xstream *dx = NULL;
-	struct dss_xstream *tmp;
-
-	if (stream_id == -1)
-		return dss_get_module_info()->dmi_xstream;
-
-	d_list_for_each_entry(tmp, &xstream_data.xd_list, dx_list) {
-		if (tmp->dx_idx == stream_id) {
-			dx = tmp;
-			break;
-		}
-	}
-	return dx;
-}
-
 /**
  * Create a ULT to execute \a func(\a arg). If \a ult is not NULL, the caller
  * is responsible for freeing the ULT handle with ABT_thread_free().
  *
- * \param[in]	func	function to execute
- * \param[in]	arg	argument for \a func
- * \param[out]	ult	ULT handle if not NULL
+ * If \a stream_id is DSS_XS_ANY, the ULT is queued on the current xstream but
+ * can be run by any other xstream when work stealing is enabled, so \a func
+ * must not depend on the xstream-local storage or the xstream it runs on.
+ *
+ * \param[in]	func		function to execute
+ * \param[in]	arg		argument for \a func
+ * \param[in]	stream_id	xstream index, DSS_XS_SELF or DSS_XS_ANY
+ * \param[out]	ult		ULT handle if not NULL
  */
 int
 dss_ult_create(void (*func)(void *), void *arg, int stream_id, ABT_thread *ult)
@@ -718,8 +835,33 @@ dss_ult_create(void (*func)(void *), void *arg, int stream_id, ABT_thread *ult)
 	if (dx == NULL)
 		return -DER_NONEXIST;
 
-	rc = ABT_thread_create(dx->dx_pools[DSS_POOL_SHARE], func, arg,
-			       ABT_THREAD_ATTR_NULL, ult);
+	rc = ABT_thread_create(dx->dx_pools[stream_id == DSS_XS_ANY ?
+					    DSS_POOL_STEAL : DSS_POOL_SHARE],
+			       func, arg, ABT_THREAD_ATTR_NULL, ult);
+
+	return dss_abterr2der(rc);
+}
+
+/**
+ * Create a ULT in the ES pool \a pool_type (DSS_POOL_*) of the current
+ * xstream. If \a ult is not NULL, the caller is responsible for freeing the
+ * ULT handle with ABT_thread_free().
+ *
+ * \param[in]	func		function to execute
+ * \param[in]	arg		argument for \a func
+ * \param[in]	pool_type	ES pool to run the ULT
+ * \param[out]	ult		ULT handle if not NULL
+ */
+int
+dss_ult_create_pool(void (*func)(void *), void *arg, unsigned int pool_type,
+		    ABT_thread *ult)
+{
+	struct dss_module_info	*dmi = dss_get_module_info();
+	int			 rc;
+
+	D_ASSERT(pool_type < DSS_POOL_CNT);
+	rc = ABT_thread_create(dmi->dmi_xstream->dx_pools[pool_type], func,
+			       arg, ABT_THREAD_ATTR_NULL, ult);
 
 	return dss_abterr2der(rc);
 }
@@ -899,7 +1041,8 @@ collective_reduce(void **arg)
 
 static int
 dss_collective_reduce_internal(struct dss_coll_ops *ops,
-			       struct dss_coll_args *args, bool create_ult)
+			       struct dss_coll_args *args, bool create_ult,
+			       unsigned int pool_type)
 {
 	struct collective_arg		carg;
 	struct dss_coll_stream_args	*stream_args;
@@ -969,11 +1112,11 @@ dss_collective_reduce_internal(struct dss_coll_ops *ops,
 		stream->st_coll_args	= &carg;
 
 		if (create_ult)
-			rc = ABT_thread_create(dx->dx_pools[DSS_POOL_SHARE],
+			rc = ABT_thread_create(dx->dx_pools[pool_type],
 					       collective_func, stream,
 					       ABT_THREAD_ATTR_NULL, NULL);
 		else
-			rc = ABT_task_create(dx->dx_pools[DSS_POOL_SHARE],
+			rc = ABT_task_create(dx->dx_pools[pool_type],
 					     collective_func, stream, NULL);
 
 		if (rc != ABT_SUCCESS) {
@@ -1019,7 +1162,8 @@ int
 dss_task_collective_reduce(struct dss_coll_ops *ops,
 			   struct dss_coll_args *args)
 {
-	return dss_collective_reduce_internal(ops, args, false);
+	return dss_collective_reduce_internal(ops, args, false,
+					      DSS_POOL_SHARE);
 }
 
 /**
@@ -1040,13 +1184,14 @@ int
 dss_thread_collective_reduce(struct dss_coll_ops *ops,
 			     struct dss_coll_args *args)
 {
-	return dss_collective_reduce_internal(ops, args, true);
+	return dss_collective_reduce_internal(ops, args, true,
+					      DSS_POOL_SHARE);
 }
 
 static int
-dss_collective_internal(int (*func)(void *), void *arg, bool thread)
+dss_collective_internal(int (*func)(void *), void *arg, bool thread,
+			unsigned int pool_type)
 {
-	int				rc;
 	struct dss_coll_ops		coll_ops;
 	struct dss_coll_args		coll_args;
 
@@ -1057,26 +1202,33 @@ dss_collective_internal(int (*func)(void *), void *arg, bool thread)
 	coll_ops.co_func	= func;
 	coll_args.ca_func_args	= arg;
 
-	if (thread)
-		rc = dss_thread_collective_reduce(&coll_ops, &coll_args);
-	else
-		rc = dss_task_collective_reduce(&coll_ops, &coll_args);
-
-	return rc;
+	return dss_collective_reduce_internal(&coll_ops, &coll_args, thread,
+					      pool_type);
 }
 
-/** TODO: use daos checksum library to offload checksum calculation */
 static int
 compute_checksum_ult(void *args)
 {
-	return 0;
+	struct dss_acc_csum	*ac = args;
+
+	if (ac->ac_lens != NULL)
+		return daos_csum_compute_ranges(ac->ac_csum, ac->ac_sgl,
+						ac->ac_nr, ac->ac_lens,
+						ac->ac_csums);
+
+	if (ac->ac_csums != NULL)
+		return daos_csum_compute_iovs(ac->ac_csum, ac->ac_sgl,
+					      ac->ac_csums);
+
+	return daos_csum_compute(ac->ac_csum, ac->ac_sgl);
 }
 
 /** TODO: use OFI calls to calculate checksum on FPGA */
 static int
 compute_checksum_acc(void *args)
 {
-	return 0;
+	/* no accelerator yet, use the vectorized CPU kernels */
+	return compute_checksum_ult(args);
 }
 
 /**
@@ -1089,19 +1241,17 @@ dss_acc_offload(struct dss_acc_task *at_args)
 {
 
 	int		rc = 0;
-	int		tid;
-
 
-	/**
-	 * Currently just launching it in this stream,
-	 * ideally will move to a separate exclusive xstream
-	 */
-	tid = dss_get_module_info()->dmi_tid;
-	if (at_args == NULL) {
+	if (at_args == NULL || at_args->at_params == NULL) {
 		D_ERROR("missing arguments for acc_offload\n");
 		return -DER_INVAL;
 	}
 
+	if (at_args->at_opcode != DSS_ACC_OP_CSUM) {
+		D_ERROR("Unknown opcode of offload %d\n", at_args->at_opcode);
+		return -DER_NOSYS;
+	}
+
 	if (at_args->at_offload_type <= DSS_OFFLOAD_MIN ||
 	    at_args->at_offload_type >= DSS_OFFLOAD_MAX) {
 		D_ERROR("Unknown type of offload\n");
@@ -1110,11 +1260,17 @@ dss_acc_offload(struct dss_acc_task *at_args)
 
 	switch (at_args->at_offload_type) {
 	case DSS_OFFLOAD_ULT:
+		/* There is no dedicated helper xstream, the ULT is queued to
+		 * the steal pool of the caller xstream, an idle xstream can
+		 * take it over, otherwise the caller xstream runs it after
+		 * other ULTs while the caller waits for the checksum. It is
+		 * never pushed to the main pool of another target.
+		 */
 		rc = dss_ult_create_execute(compute_checksum_ult,
 					    at_args->at_params,
 					    NULL /* user-cb */,
 					    NULL /* user-cb args */,
-					    tid);
+					    DSS_XS_ANY);
 		break;
 	case DSS_OFFLOAD_ACC:
 		/** calls to offload to FPGA*/
@@ -1136,7 +1292,7 @@ dss_acc_offload(struct dss_acc_task *at_args)
 int
 dss_task_collective(int (*func)(void *), void *arg)
 {
-	return dss_collective_internal(func, arg, false);
+	return dss_collective_internal(func, arg, false, DSS_POOL_SHARE);
 }
 
 /**
@@ -1151,7 +1307,25 @@ dss_task_collective(int (*func)(void *), void *arg)
 int
 dss_thread_collective(int (*func)(void *), void *arg)
 {
-	return dss_collective_internal(func, arg, true);
+	return dss_collective_internal(func, arg, true, DSS_POOL_SHARE);
+}
+
+/**
+ * Same as dss_thread_collective(), but the ULTs are scheduled in the ES pool
+ * \a pool_type (DSS_POOL_*) of each xstream, so they are accounted to that
+ * scheduling class.
+ *
+ * \param[in] func	function to be executed
+ * \param[in] arg	argument to be passed to \a func
+ * \param[in] pool_type	ES pool to run the ULTs
+ * \return		number of failed xstreams or error code
+ */
+int
+dss_thread_collective_pool(int (*func)(void *), void *arg,
+			   unsigned int pool_type)
+{
+	D_ASSERT(pool_type < DSS_POOL_CNT);
+	return dss_collective_internal(func, arg, true, pool_type);
 }
 
 static void
@@ -1267,6 +1441,46 @@ dss_parameters_set(unsigned int key_id, uint64_t value)
 		}
 		dss_rebuild_res_percentage = value;
 		break;
+	case DSS_SCRUB_RES_PERCENTAGE:
+		if (value >= 100) {
+			D_ERROR("invalid value "DF_U64"\n", value);
+			rc = -DER_INVAL;
+			break;
+		}
+		dss_scrub_res_percentage = value;
+		break;
+	case DSS_SCHED_POLICY:
+		if (value >= DSS_SCHED_MAX) {
+			D_ERROR("invalid scheduling policy "DF_U64"\n", value);
+			rc = -DER_INVAL;
+			break;
+		}
+		D_DEBUG(DB_TRACE, "scheduling policy %s\n",
+			dss_sched_policies[value].so_name);
+		dss_sched_policy = value;
+		break;
+	case DSS_WORK_STEAL:
+		dss_work_steal = value != 0;
+		break;
+	case DSS_SCHED_WEIGHT_IO:
+	case DSS_SCHED_WEIGHT_META:
+		/* the progress ULT is in the shared pool, can't be idle */
+		if (value > 100 || value == 0) {
+			D_ERROR("invalid value "DF_U64"\n", value);
+			rc = -DER_INVAL;
+			break;
+		}
+		dss_sched_weights[key_id == DSS_SCHED_WEIGHT_IO ?
+				  DSS_POOL_PRIV : DSS_POOL_SHARE] = value;
+		break;
+	case DSS_SCHED_WEIGHT_AGGREGATE:
+		if (value > 100) {
+			D_ERROR("invalid value "DF_U64"\n", value);
+			rc = -DER_INVAL;
+			break;
+		}
+		dss_sched_weights[DSS_POOL_AGGREGATE] = value;
+		break;
 	default:
 		D_ERROR("invalid key_id %d\n", key_id);
 		rc = -DER_INVAL;
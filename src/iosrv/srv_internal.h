@@ -35,9 +35,41 @@ int dss_module_setup_all(void);
 int dss_module_cleanup_all(void);
 
 /* srv.c */
+extern unsigned int dss_rebuild_res_percentage;
 int dss_srv_init(int);
 int dss_srv_fini(bool force);
 
+/* sched.c */
+/** log2 buckets of scheduling latency in microseconds */
+#define SCHED_LAT_BUCKETS	20
+
+struct sched_data {
+	uint32_t	event_freq;
+	/** credits of each class for DSS_SCHED_WFQ */
+	int64_t		sd_credits[DSS_POOL_CNT];
+	/** since when the class has been waiting for the xstream, 0 if empty */
+	double		sd_wait_since[DSS_POOL_CNT];
+	/** histogram of how long each class waited before being served */
+	uint64_t	sd_lat_hist[DSS_POOL_CNT][SCHED_LAT_BUCKETS];
+	/** index of the next xstream to steal from */
+	unsigned int	sd_steal_next;
+	/** number of steal attempts and ULTs stolen from other xstreams */
+	uint64_t	sd_steal_tries;
+	uint64_t	sd_steals;
+	/** idle classes and the progress ULT take turns, see sched_idle_turn */
+	bool		sd_idle_turn;
+};
+
+struct dss_sched_policy_ops {
+	const char	*so_name;
+	/** choose the class (DSS_POOL_*) to serve, -1 if nothing to run */
+	int		(*so_class_pick)(struct sched_data *data,
+					 size_t *sizes);
+};
+
+extern unsigned int dss_sched_weights[DSS_POOL_CNT];
+extern struct dss_sched_policy_ops dss_sched_policies[DSS_SCHED_MAX];
+
 /* tls.c */
 void dss_tls_fini(struct dss_thread_local_storage *dtls);
 struct dss_thread_local_storage *dss_tls_init(int tag);
@@ -720,3 +720,280 @@ out:
 		dss_nvme_ctxt_fini(ctxt);
 	return rc;
 }
+
+struct dss_nvme_blob {
+	struct spdk_blob	*dnb_blob;
+	/* NVMe context of the xstream which opened the blob */
+	struct dss_nvme_context	*dnb_ctxt;
+};
+
+/*
+ * Completion argument of blob operations. Unlike the init/fini code which
+ * busy polls for completion, blob operations are issued by ULTs, so the
+ * issuer waits on an eventual and yields, the completion callback will be
+ * called by dss_nvme_poll() in the progress loop of the same xstream.
+ */
+struct blob_cp_arg {
+	ABT_eventual		 bca_eventual;
+	struct spdk_blob	*bca_blob;
+	spdk_blob_id		 bca_id;
+	int			 bca_rc;
+};
+
+static void blob_common_cb(void *arg, int rc)
+{
+	struct blob_cp_arg *ba = arg;
+
+	ba->bca_rc = rc;
+	ABT_eventual_set(ba->bca_eventual, NULL, 0);
+}
+
+static void blob_id_cb(void *arg, spdk_blob_id id, int rc)
+{
+	struct blob_cp_arg *ba = arg;
+
+	ba->bca_id = id;
+	blob_common_cb(arg, rc);
+}
+
+static void blob_open_cb(void *arg, struct spdk_blob *blob, int rc)
+{
+	struct blob_cp_arg *ba = arg;
+
+	ba->bca_blob = blob;
+	blob_common_cb(arg, rc);
+}
+
+static struct dss_nvme_context *blob_ctxt_get(void)
+{
+	struct dss_nvme_context *ctxt = &dss_get_module_info()->dmi_nvme_ctxt;
+
+	if (skip_nvme_setup || ctxt->dnc_blobstore == NULL ||
+	    ctxt->dnc_io_channel == NULL)
+		return NULL;
+	return ctxt;
+}
+
+static int blob_cp_arg_init(struct blob_cp_arg *ba)
+{
+	int rc;
+
+	memset(ba, 0, sizeof(*ba));
+	rc = ABT_eventual_create(0, &ba->bca_eventual);
+	if (rc != ABT_SUCCESS)
+		return dss_abterr2der(rc);
+	return 0;
+}
+
+/* Wait for the completion, returns the SPDK error converted to DER */
+static int blob_wait_completion(struct blob_cp_arg *ba)
+{
+	int rc;
+
+	rc = ABT_eventual_wait(ba->bca_eventual, NULL);
+	ABT_eventual_free(&ba->bca_eventual);
+	if (rc != ABT_SUCCESS)
+		return dss_abterr2der(rc);
+
+	/* SPDK returns negative errno */
+	return ba->bca_rc == 0 ? 0 : daos_errno2der(-ba->bca_rc);
+}
+
+/*
+ * Create a blob with at least @size bytes on the blobstore of the calling
+ * xstream.
+ *
+ * \param[IN] size	Blob size in bytes
+ * \param[OUT] blob_id	ID of the created blob
+ *
+ * \returns		Zero on success, negative value on error
+ */
+int dss_nvme_blob_create(daos_size_t size, uint64_t *blob_id)
+{
+	struct dss_nvme_context *ctxt = blob_ctxt_get();
+	struct spdk_blob_opts opts;
+	struct blob_cp_arg ba;
+	uint64_t cluster_sz;
+	int rc;
+
+	if (ctxt == NULL)
+		return -DER_UNINIT;
+
+	rc = blob_cp_arg_init(&ba);
+	if (rc != 0)
+		return rc;
+
+	cluster_sz = spdk_bs_get_cluster_size(ctxt->dnc_blobstore);
+	spdk_blob_opts_init(&opts);
+	opts.num_clusters = (size + cluster_sz - 1) / cluster_sz;
+
+	spdk_bs_create_blob_ext(ctxt->dnc_blobstore, &opts, blob_id_cb, &ba);
+	rc = blob_wait_completion(&ba);
+	if (rc != 0) {
+		D_ERROR("failed to create blob, size:"DF_U64", rc:%d\n",
+			size, rc);
+		return rc;
+	}
+
+	D_DEBUG(DB_MGMT, "created blob "DF_X64", clusters:"DF_U64"\n",
+		ba.bca_id, opts.num_clusters);
+	*blob_id = ba.bca_id;
+	return 0;
+}
+
+/*
+ * Delete a blob from the blobstore of the calling xstream.
+ *
+ * \param[IN] blob_id	ID of the blob
+ *
+ * \returns		Zero on success, negative value on error
+ */
+int dss_nvme_blob_delete(uint64_t blob_id)
+{
+	struct dss_nvme_context *ctxt = blob_ctxt_get();
+	struct blob_cp_arg ba;
+	int rc;
+
+	if (ctxt == NULL)
+		return -DER_UNINIT;
+
+	rc = blob_cp_arg_init(&ba);
+	if (rc != 0)
+		return rc;
+
+	spdk_bs_delete_blob(ctxt->dnc_blobstore, blob_id, blob_common_cb, &ba);
+	rc = blob_wait_completion(&ba);
+	if (rc != 0)
+		D_ERROR("failed to delete blob "DF_X64", rc:%d\n", blob_id, rc);
+	return rc;
+}
+
+/*
+ * Open a blob on the blobstore of the calling xstream.
+ *
+ * \param[IN] blob_id	ID of the blob
+ * \param[OUT] blob	Returned blob
+ *
+ * \returns		Zero on success, negative value on error
+ */
+int dss_nvme_blob_open(uint64_t blob_id, struct dss_nvme_blob **blob)
+{
+	struct dss_nvme_context *ctxt = blob_ctxt_get();
+	struct dss_nvme_blob *d_blob;
+	struct blob_cp_arg ba;
+	int rc;
+
+	if (ctxt == NULL)
+		return -DER_UNINIT;
+
+	D_ALLOC_PTR(d_blob);
+	if (d_blob == NULL)
+		return -DER_NOMEM;
+
+	rc = blob_cp_arg_init(&ba);
+	if (rc != 0)
+		goto failed;
+
+	spdk_bs_open_blob(ctxt->dnc_blobstore, blob_id, blob_open_cb, &ba);
+	rc = blob_wait_completion(&ba);
+	if (rc != 0) {
+		D_ERROR("failed to open blob "DF_X64", rc:%d\n", blob_id, rc);
+		goto failed;
+	}
+
+	d_blob->dnb_blob = ba.bca_blob;
+	d_blob->dnb_ctxt = ctxt;
+	*blob = d_blob;
+	return 0;
+failed:
+	D_FREE_PTR(d_blob);
+	return rc;
+}
+
+/*
+ * Close a blob opened by dss_nvme_blob_open().
+ *
+ * \param[IN] blob	The opened blob
+ *
+ * \returns		Zero on success, negative value on error
+ */
+int dss_nvme_blob_close(struct dss_nvme_blob *blob)
+{
+	struct blob_cp_arg ba;
+	int rc;
+
+	D_ASSERT(blob->dnb_ctxt == &dss_get_module_info()->dmi_nvme_ctxt);
+	rc = blob_cp_arg_init(&ba);
+	if (rc != 0)
+		return rc;
+
+	spdk_blob_close(blob->dnb_blob, blob_common_cb, &ba);
+	rc = blob_wait_completion(&ba);
+	if (rc != 0)
+		D_ERROR("failed to close blob, rc:%d\n", rc);
+
+	D_FREE_PTR(blob);
+	return rc;
+}
+
+/*
+ * Read/write @len bytes at @off of the blob, both of them should be aligned
+ * to DSS_NVME_BLK_SZ, @buf should be allocated by dss_nvme_dma_alloc().
+ *
+ * The calling ULT yields until the I/O completion is reaped by dss_nvme_poll()
+ * so other ULTs on the xstream can run meanwhile.
+ *
+ * \param[IN] blob	The opened blob
+ * \param[IN] off	Offset in bytes
+ * \param[IN] buf	DMA buffer
+ * \param[IN] len	Length in bytes
+ * \param[IN] update	Write or read
+ *
+ * \returns		Zero on success, negative value on error
+ */
+int dss_nvme_blob_rw(struct dss_nvme_blob *blob, daos_off_t off, void *buf,
+		     daos_size_t len, bool update)
+{
+	struct dss_nvme_context *ctxt = blob->dnb_ctxt;
+	struct blob_cp_arg ba;
+	uint64_t page_sz;
+	int rc;
+
+	D_ASSERT(ctxt == &dss_get_module_info()->dmi_nvme_ctxt);
+	page_sz = spdk_bs_get_page_size(ctxt->dnc_blobstore);
+	D_ASSERT(DSS_NVME_BLK_SZ % page_sz == 0);
+
+	if (off % DSS_NVME_BLK_SZ || len % DSS_NVME_BLK_SZ || len == 0) {
+		D_ERROR("unaligned blob I/O "DF_U64"/"DF_U64"\n", off, len);
+		return -DER_INVAL;
+	}
+
+	rc = blob_cp_arg_init(&ba);
+	if (rc != 0)
+		return rc;
+
+	if (update)
+		spdk_bs_io_write_blob(blob->dnb_blob, ctxt->dnc_io_channel,
+				      buf, off / page_sz, len / page_sz,
+				      blob_common_cb, &ba);
+	else
+		spdk_bs_io_read_blob(blob->dnb_blob, ctxt->dnc_io_channel,
+				     buf, off / page_sz, len / page_sz,
+				     blob_common_cb, &ba);
+
+	rc = blob_wait_completion(&ba);
+	if (rc != 0)
+		D_ERROR("blob %s failed, off:"DF_U64", len:"DF_U64", rc:%d\n",
+			update ? "write" : "read", off, len, rc);
+	return rc;
+}
+
+void *dss_nvme_dma_alloc(daos_size_t size)
+{
+	return spdk_dma_malloc(size, DSS_NVME_BLK_SZ, NULL);
+}
+
+void dss_nvme_dma_free(void *buf)
+{
+	spdk_dma_free(buf);
+}
@@ -0,0 +1,147 @@
+/**
+ * (C) Copyright 2016 Intel Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * GOVERNMENT LICENSE RIGHTS-OPEN SOURCE SOFTWARE
+ * The Government's rights to use, modify, reproduce, release, perform, display,
+ * or disclose this software are subject to the terms of the Apache License as
+ * provided in Contract No. B609815.
+ * Any reproduction of computer software, computer software documentation, or
+ * portions thereof marked with this legend must also reproduce the markings.
+ */
+/**
+ * This file is for testing the scheduling policies of server xstreams
+ *
+ * iosrv/tests/sched.c
+ */
+#define D_LOGFAC	DD_FAC(tests)
+
+#include <stdarg.h>
+#include <stdlib.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <daos/common.h>
+#include "../srv_internal.h"
+
+/* defined by srv.c, which isn't linked */
+unsigned int	dss_rebuild_res_percentage = 30;
+unsigned int	dss_scrub_res_percentage = 10;
+
+#define PICK_ROUNDS	1000
+
+/**
+ * Run \a rounds picks of \a policy with constant pool sizes, the served ULT
+ * yields and goes back to its pool, so the sizes don't change. Count how
+ * many times each class was served in \a served.
+ */
+static void
+sched_picks(int policy, size_t *sizes, int rounds, int *served)
+{
+	struct sched_data	data;
+	int			cls;
+	int			i;
+
+	memset(&data, 0, sizeof(data));
+	memset(served, 0, sizeof(*served) * DSS_POOL_CNT);
+	for (i = 0; i < rounds; i++) {
+		cls = dss_sched_policies[policy].so_class_pick(&data, sizes);
+		assert_true(cls >= 0 && cls < DSS_POOL_CNT);
+		assert_true(sizes[cls] != 0);
+		served[cls]++;
+	}
+}
+
+static void
+wfq_weights(void **state)
+{
+	size_t	sizes[DSS_POOL_CNT] = { 0 };
+	int	served[DSS_POOL_CNT];
+
+	sizes[DSS_POOL_PRIV] = 8;
+	sizes[DSS_POOL_SHARE] = 8;
+	sizes[DSS_POOL_AGGREGATE] = 8;
+	/* 60:20:10 */
+	sched_picks(DSS_SCHED_WFQ, sizes, 90, served);
+	assert_int_equal(served[DSS_POOL_PRIV], 60);
+	assert_int_equal(served[DSS_POOL_SHARE], 20);
+	assert_int_equal(served[DSS_POOL_AGGREGATE], 10);
+}
+
+static void
+wfq_zero_weight(void **state)
+{
+	size_t	sizes[DSS_POOL_CNT] = { 0 };
+	int	served[DSS_POOL_CNT];
+
+	dss_sched_weights[DSS_POOL_AGGREGATE] = 0;
+
+	/* nothing but the aggregation ULT */
+	sizes[DSS_POOL_AGGREGATE] = 1;
+	sched_picks(DSS_SCHED_WFQ, sizes, PICK_ROUNDS, served);
+	assert_int_equal(served[DSS_POOL_AGGREGATE], PICK_ROUNDS);
+
+	/* idle, it takes turns with the progress ULT */
+	sizes[DSS_POOL_SHARE] = 1;
+	sched_picks(DSS_SCHED_WFQ, sizes, PICK_ROUNDS, served);
+	assert_int_equal(served[DSS_POOL_AGGREGATE], PICK_ROUNDS / 2);
+	assert_int_equal(served[DSS_POOL_SHARE], PICK_ROUNDS / 2);
+
+	/* busy with other requests */
+	sizes[DSS_POOL_SHARE] = 2;
+	sched_picks(DSS_SCHED_WFQ, sizes, PICK_ROUNDS, served);
+	assert_int_equal(served[DSS_POOL_AGGREGATE], 0);
+
+	sizes[DSS_POOL_SHARE] = 1;
+	sizes[DSS_POOL_PRIV] = 1;
+	sched_picks(DSS_SCHED_WFQ, sizes, PICK_ROUNDS, served);
+	assert_int_equal(served[DSS_POOL_AGGREGATE], 0);
+
+	dss_sched_weights[DSS_POOL_AGGREGATE] = 10;
+}
+
+static void
+prio_zero_scrub(void **state)
+{
+	size_t		sizes[DSS_POOL_CNT] = { 0 };
+	int		served[DSS_POOL_CNT];
+	unsigned int	pct = dss_scrub_res_percentage;
+
+	dss_scrub_res_percentage = 0;
+
+	sizes[DSS_POOL_SHARE] = 1;
+	sizes[DSS_POOL_SCRUB] = 1;
+	sched_picks(DSS_SCHED_PRIO, sizes, PICK_ROUNDS, served);
+	assert_int_equal(served[DSS_POOL_SCRUB], PICK_ROUNDS / 2);
+
+	sizes[DSS_POOL_PRIV] = 1;
+	sched_picks(DSS_SCHED_PRIO, sizes, PICK_ROUNDS, served);
+	assert_int_equal(served[DSS_POOL_SCRUB], 0);
+
+	dss_scrub_res_percentage = pct;
+}
+
+static const struct CMUnitTest sched_tests[] = {
+	{ "SCHED01: WFQ serves classes by weight", wfq_weights, NULL, NULL},
+	{ "SCHED02: WFQ zero weight runs on idle xstream",
+	  wfq_zero_weight, NULL, NULL},
+	{ "SCHED03: PRIO zero scrub runs on idle xstream",
+	  prio_zero_scrub, NULL, NULL},
+};
+
+int
+main(int argc, char **argv)
+{
+	return cmocka_run_group_tests_name("I/O server scheduling tests",
+					   sched_tests, NULL, NULL);
+}
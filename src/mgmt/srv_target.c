@@ -271,6 +271,8 @@ static int
 tgt_vos_create(uuid_t uuid, daos_size_t tgt_size)
 {
 	daos_size_t	 size;
+	daos_size_t	 nvme_size = 0;
+	char		*env;
 	int		 i;
 	char		*path = NULL;
 	int		 fd = -1;
@@ -281,6 +283,15 @@ tgt_vos_create(uuid_t uuid, daos_size_t tgt_size)
 	 * 16MB minimum per file
 	 */
 	size = max(tgt_size / dss_nxstreams, 1 << 24);
+
+	/**
+	 * NVMe space of the target for large records, it is also evenly
+	 * split between execution streams. The NVMe size isn't carried by
+	 * the create request yet, so it's configured by environment.
+	 */
+	env = getenv("DAOS_NVME_TGT_SIZE_MB");
+	if (env != NULL)
+		nvme_size = (strtoull(env, NULL, 10) << 20) / dss_nxstreams;
 	/** tc_in->tc_tgt_dev is assumed to point at PMEM for now */
 
 	for (i = 0; i < dss_nxstreams; i++) {
@@ -317,7 +328,8 @@ tgt_vos_create(uuid_t uuid, daos_size_t tgt_size)
 		}
 
 		/* A zero size accommodates the existing file */
-		rc = vos_pool_create(path, (unsigned char *)uuid, 0 /* size */);
+		rc = vos_pool_create(path, (unsigned char *)uuid, 0 /* size */,
+				     nvme_size);
 		if (rc) {
 			D_ERROR(DF_UUID": failed to init vos pool %s: %d\n",
 				DP_UUID(uuid), path, rc);
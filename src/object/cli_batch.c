@@ -0,0 +1,370 @@
+/**
+ * (C) Copyright 2018 Intel Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * GOVERNMENT LICENSE RIGHTS-OPEN SOURCE SOFTWARE
+ * The Government's rights to use, modify, reproduce, release, perform, display,
+ * or disclose this software are subject to the terms of the Apache License as
+ * provided in Contract No. B609815.
+ * Any reproduction of computer software, computer software documentation, or
+ * portions thereof marked with this legend must also reproduce the markings.
+ */
+/**
+ * Batching of small updates.
+ *
+ * Applications issuing many small updates pay the cost of a RPC for each of
+ * them. Updates whose data is sent inline are queued in a batch of their
+ * target instead, and all updates of a batch are sent by one RPC. Batches
+ * are flushed at the end of the progress window of the scheduler, see
+ * tse_sched_defer(), or as soon as they are full, so batching never delays
+ * an update beyond the progress call which issues it.
+ *
+ * Updates of a batch have the same target, container handle and pool map
+ * version, and are issued by tasks of the same scheduler. Each update is
+ * completed with its own result.
+ *
+ * object/cli_batch.c
+ */
+#define D_LOGFAC	DD_FAC(object)
+
+#include <daos/common.h>
+#include <daos/event.h>
+#include <daos/object.h>
+#include <daos/pool.h>
+#include "obj_rpc.h"
+#include "obj_internal.h"
+
+/** updates to the same target queued by the tasks of a scheduler */
+struct obj_batch {
+	d_list_t		 ob_link;
+	tse_sched_t		*ob_sched;
+	crt_context_t		 ob_ctx;
+	crt_endpoint_t		 ob_ep;
+	uuid_t			 ob_co_hdl;
+	uuid_t			 ob_co_uuid;
+	uint32_t		 ob_map_ver;
+	/** list of obj_batch_req */
+	d_list_t		 ob_reqs;
+	unsigned int		 ob_nr;
+	unsigned int		 ob_iod_nr;
+	daos_size_t		 ob_size;
+	/** flattened arrays of the RPC */
+	daos_unit_oid_t		*ob_oids;
+	uint64_t		*ob_epochs;
+	daos_key_t		*ob_dkeys;
+	uint32_t		*ob_nrs;
+	daos_iod_t		*ob_iods;
+	daos_sg_list_t		*ob_sgls;
+};
+
+/** batches being filled, of all schedulers */
+static D_LIST_HEAD(obj_batch_list);
+static pthread_mutex_t	obj_batch_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/** # batch RPCs sent and # updates they carried */
+static uint64_t		obj_batch_rpcs;
+static uint64_t		obj_batch_reqs;
+
+/**
+ * Find the batch being filled for an update.
+ *
+ * The batch is keyed by the rank and the tag of the endpoint, not the rank
+ * only: the server runs all updates of a batch on the xstream selected by the
+ * tag, and writes them to the VOS target of that xstream, see
+ * ds_obj_batch_handler(). Shards of different targets of a rank can't share a
+ * batch without forwarding updates between xstreams of the server.
+ *
+ * The scheduler is part of the key because a batch is flushed by the
+ * progress of the scheduler of its tasks, and the container handle and pool
+ * map version because they are carried once per RPC.
+ */
+static struct obj_batch *
+obj_batch_lookup(tse_sched_t *sched, crt_endpoint_t *tgt_ep, uuid_t co_hdl,
+		 uint32_t map_ver)
+{
+	struct obj_batch	*batch;
+
+	d_list_for_each_entry(batch, &obj_batch_list, ob_link) {
+		if (batch->ob_sched == sched &&
+		    batch->ob_ep.ep_grp == tgt_ep->ep_grp &&
+		    batch->ob_ep.ep_rank == tgt_ep->ep_rank &&
+		    batch->ob_ep.ep_tag == tgt_ep->ep_tag &&
+		    batch->ob_map_ver == map_ver &&
+		    !uuid_compare(batch->ob_co_hdl, co_hdl))
+			return batch;
+	}
+	return NULL;
+}
+
+static void
+obj_batch_free(struct obj_batch *batch)
+{
+	D_FREE(batch->ob_oids);
+	D_FREE(batch->ob_epochs);
+	D_FREE(batch->ob_dkeys);
+	D_FREE(batch->ob_nrs);
+	D_FREE(batch->ob_iods);
+	D_FREE(batch->ob_sgls);
+	D_FREE_PTR(batch);
+}
+
+/** Complete the \a idx-th update of the batch */
+static void
+obj_batch_req_complete(struct obj_batch_req *req, crt_rpc_t *rpc, int rc,
+		       unsigned int idx)
+{
+	struct obj_batch_out	*obo;
+
+	if (DAOS_FAIL_CHECK(DAOS_SHARD_OBJ_UPDATE_TIMEOUT)) {
+		D_ERROR("Inducing -DER_TIMEDOUT error on shard I/O update\n");
+		rc = -DER_TIMEDOUT;
+	} else if (DAOS_FAIL_CHECK(DAOS_OBJ_UPDATE_NOSPACE)) {
+		D_ERROR("Inducing -DER_NOSPACE error on shard I/O update\n");
+		rc = -DER_NOSPACE;
+	}
+
+	if (rc == 0) {
+		obo = crt_reply_get(rpc);
+		*req->br_map_ver = obj_reply_map_version_get(rpc);
+		req->br_shard->do_md.smd_attr =
+			((uint64_t *)obo->obo_attrs.ca_arrays)[idx];
+	}
+
+	tse_task_complete(req->br_task, rc);
+	tse_task_decref(req->br_task);
+	D_FREE(req->br_csum_iods);
+	obj_shard_decref(req->br_shard);
+	dc_pool_put(req->br_pool);
+	D_FREE_PTR(req);
+}
+
+static void
+obj_batch_cb(const struct crt_cb_info *cb_info)
+{
+	struct obj_batch	*batch = cb_info->cci_arg;
+	crt_rpc_t		*rpc = cb_info->cci_rpc;
+	struct obj_batch_req	*req;
+	struct obj_batch_out	*obo = NULL;
+	uint32_t		*rets = NULL;
+	unsigned int		 i = 0;
+	int			 rc = cb_info->cci_rc;
+
+	if (rc != 0) {
+		D_ERROR("batch RPC of %u updates failed: %d\n", batch->ob_nr,
+			rc);
+	} else {
+		rc = obj_reply_get_status(rpc);
+		obo = crt_reply_get(rpc);
+		if (rc == 0 && (obo->obo_rets.ca_count != batch->ob_nr ||
+				obo->obo_attrs.ca_count != batch->ob_nr)) {
+			D_ERROR("Invalid batch reply %u/%u != %u\n",
+				(unsigned int)obo->obo_rets.ca_count,
+				(unsigned int)obo->obo_attrs.ca_count,
+				batch->ob_nr);
+			rc = -DER_PROTO;
+		}
+		if (rc == 0)
+			rets = obo->obo_rets.ca_arrays;
+	}
+
+	while (!d_list_empty(&batch->ob_reqs)) {
+		req = d_list_entry(batch->ob_reqs.next, struct obj_batch_req,
+				   br_link);
+		d_list_del(&req->br_link);
+		obj_batch_req_complete(req, rpc, rets != NULL ?
+				       (int)rets[i] : rc, i);
+		i++;
+	}
+	obj_batch_free(batch);
+}
+
+/** Fail all updates of a batch which can't be sent */
+static void
+obj_batch_abort(struct obj_batch *batch, int rc)
+{
+	struct crt_cb_info	cb_info;
+
+	memset(&cb_info, 0, sizeof(cb_info));
+	cb_info.cci_arg = batch;
+	cb_info.cci_rc = rc;
+	obj_batch_cb(&cb_info);
+}
+
+static void
+obj_batch_send(struct obj_batch *batch)
+{
+	struct obj_batch_req	*req;
+	struct obj_batch_in	*obi;
+	crt_rpc_t		*rpc;
+	unsigned int		 i = 0;
+	unsigned int		 iod_idx = 0;
+	int			 rc;
+
+	D_ALLOC(batch->ob_oids, batch->ob_nr * sizeof(*batch->ob_oids));
+	D_ALLOC(batch->ob_epochs, batch->ob_nr * sizeof(*batch->ob_epochs));
+	D_ALLOC(batch->ob_dkeys, batch->ob_nr * sizeof(*batch->ob_dkeys));
+	D_ALLOC(batch->ob_nrs, batch->ob_nr * sizeof(*batch->ob_nrs));
+	D_ALLOC(batch->ob_iods, batch->ob_iod_nr * sizeof(*batch->ob_iods));
+	D_ALLOC(batch->ob_sgls, batch->ob_iod_nr * sizeof(*batch->ob_sgls));
+	if (batch->ob_oids == NULL || batch->ob_epochs == NULL ||
+	    batch->ob_dkeys == NULL || batch->ob_nrs == NULL ||
+	    batch->ob_iods == NULL || batch->ob_sgls == NULL)
+		D_GOTO(failed, rc = -DER_NOMEM);
+
+	d_list_for_each_entry(req, &batch->ob_reqs, br_link) {
+		batch->ob_oids[i] = req->br_shard->do_id;
+		batch->ob_epochs[i] = req->br_epoch;
+		/** FIXME: large dkey should be transferred via bulk */
+		batch->ob_dkeys[i] = *req->br_dkey;
+		batch->ob_nrs[i] = req->br_nr;
+		memcpy(&batch->ob_iods[iod_idx], req->br_csum_iods != NULL ?
+		       req->br_csum_iods : req->br_iods,
+		       req->br_nr * sizeof(*batch->ob_iods));
+		memcpy(&batch->ob_sgls[iod_idx], req->br_sgls,
+		       req->br_nr * sizeof(*batch->ob_sgls));
+		iod_idx += req->br_nr;
+		i++;
+	}
+
+	rc = obj_req_create(batch->ob_ctx, &batch->ob_ep,
+			    DAOS_OBJ_RPC_UPDATE_BATCH, &rpc);
+	if (rc != 0)
+		D_GOTO(failed, rc);
+
+	obi = crt_req_get(rpc);
+	D_ASSERT(obi != NULL);
+	uuid_copy(obi->obi_co_hdl, batch->ob_co_hdl);
+	uuid_copy(obi->obi_co_uuid, batch->ob_co_uuid);
+	obi->obi_map_ver = batch->ob_map_ver;
+	obi->obi_oids.ca_count = batch->ob_nr;
+	obi->obi_oids.ca_arrays = batch->ob_oids;
+	obi->obi_epochs.ca_count = batch->ob_nr;
+	obi->obi_epochs.ca_arrays = batch->ob_epochs;
+	obi->obi_dkeys.ca_count = batch->ob_nr;
+	obi->obi_dkeys.ca_arrays = batch->ob_dkeys;
+	obi->obi_nrs.ca_count = batch->ob_nr;
+	obi->obi_nrs.ca_arrays = batch->ob_nrs;
+	obi->obi_iods.ca_count = batch->ob_iod_nr;
+	obi->obi_iods.ca_arrays = batch->ob_iods;
+	obi->obi_sgls.ca_count = batch->ob_iod_nr;
+	obi->obi_sgls.ca_arrays = batch->ob_sgls;
+
+	D_DEBUG(DB_IO, "batch of %u updates, "DF_U64" bytes, rank %d tag %d\n",
+		batch->ob_nr, batch->ob_size, batch->ob_ep.ep_rank,
+		batch->ob_ep.ep_tag);
+	__atomic_fetch_add(&obj_batch_rpcs, 1, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&obj_batch_reqs, batch->ob_nr, __ATOMIC_RELAXED);
+
+	/* NB: obj_batch_cb is called even if it fails */
+	rc = crt_req_send(rpc, obj_batch_cb, batch);
+	if (rc != 0)
+		D_ERROR("batch rpc failed rc %d\n", rc);
+	return;
+failed:
+	obj_batch_abort(batch, rc);
+}
+
+/** Send all batches of \a sched at the end of its progress window */
+static void
+obj_batch_flush_cb(tse_sched_t *sched, void *arg)
+{
+	struct obj_batch	*batch;
+	struct obj_batch	*tmp;
+	d_list_t		 list;
+
+	D_INIT_LIST_HEAD(&list);
+	D_MUTEX_LOCK(&obj_batch_lock);
+	d_list_for_each_entry_safe(batch, tmp, &obj_batch_list, ob_link) {
+		if (batch->ob_sched == sched)
+			d_list_move_tail(&batch->ob_link, &list);
+	}
+	D_MUTEX_UNLOCK(&obj_batch_lock);
+
+	while (!d_list_empty(&list)) {
+		batch = d_list_entry(list.next, struct obj_batch, ob_link);
+		d_list_del_init(&batch->ob_link);
+		obj_batch_send(batch);
+	}
+}
+
+/**
+ * Queue an inline update in the batch of its target. The batch owns \a req
+ * and the shard, pool and checksum references of it once this succeeds, and
+ * completes the task of the update when the batch RPC completes.
+ */
+int
+obj_batch_add(crt_endpoint_t *tgt_ep, uuid_t co_hdl, uuid_t co_uuid,
+	      struct obj_batch_req *req)
+{
+	tse_sched_t		*sched = tse_task2sched(req->br_task);
+	struct obj_batch	*batch;
+	struct obj_batch	*full = NULL;
+	int			 rc;
+
+	rc = tse_sched_defer(sched, obj_batch_flush_cb, NULL);
+	if (rc != 0)
+		return rc;
+
+	D_MUTEX_LOCK(&obj_batch_lock);
+	batch = obj_batch_lookup(sched, tgt_ep, co_hdl, *req->br_map_ver);
+	if (batch != NULL &&
+	    batch->ob_size + req->br_size > OBJ_BATCH_SIZE_MAX) {
+		/* no room for this one, send it and start a new batch */
+		d_list_del_init(&batch->ob_link);
+		full = batch;
+		batch = NULL;
+	}
+
+	if (batch == NULL) {
+		D_ALLOC_PTR(batch);
+		if (batch == NULL)
+			D_GOTO(out, rc = -DER_NOMEM);
+
+		batch->ob_sched = sched;
+		batch->ob_ctx = daos_task2ctx(req->br_task);
+		batch->ob_ep = *tgt_ep;
+		uuid_copy(batch->ob_co_hdl, co_hdl);
+		uuid_copy(batch->ob_co_uuid, co_uuid);
+		batch->ob_map_ver = *req->br_map_ver;
+		D_INIT_LIST_HEAD(&batch->ob_reqs);
+		d_list_add_tail(&batch->ob_link, &obj_batch_list);
+	}
+
+	tse_task_addref(req->br_task);
+	d_list_add_tail(&req->br_link, &batch->ob_reqs);
+	batch->ob_nr++;
+	batch->ob_iod_nr += req->br_nr;
+	batch->ob_size += req->br_size;
+	if (batch->ob_nr == OBJ_BATCH_MAX) {
+		D_ASSERT(full == NULL);
+		d_list_del_init(&batch->ob_link);
+		full = batch;
+	}
+out:
+	D_MUTEX_UNLOCK(&obj_batch_lock);
+	if (full != NULL)
+		obj_batch_send(full);
+	return rc;
+}
+
+int
+dc_obj_batch_query(daos_obj_batch_stat_t *stat)
+{
+	if (!cli_batch)
+		return -DER_UNINIT;
+
+	stat->bs_rpcs = __atomic_load_n(&obj_batch_rpcs, __ATOMIC_RELAXED);
+	stat->bs_updates = __atomic_load_n(&obj_batch_reqs, __ATOMIC_RELAXED);
+	return 0;
+}
@@ -0,0 +1,272 @@
+/**
+ * (C) Copyright 2018 Intel Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * GOVERNMENT LICENSE RIGHTS-OPEN SOURCE SOFTWARE
+ * The Government's rights to use, modify, reproduce, release, perform, display,
+ * or disclose this software are subject to the terms of the Apache License as
+ * provided in Contract No. B609815.
+ * Any reproduction of computer software, computer software documentation, or
+ * portions thereof marked with this legend must also reproduce the markings.
+ */
+/**
+ * Registration cache of client bulk buffers.
+ *
+ * Creating a bulk handle registers the memory of the buffer with the network,
+ * which is expensive and on the critical path of every large I/O. Bulk
+ * handles of single-iov buffers are kept in a shared LRU cache keyed by the
+ * address range and permission of the buffer, so I/O from the same buffers
+ * again skips the registration. Idle handles are released once registered
+ * bytes exceed the budget of the cache.
+ *
+ * The cache can't see the application freeing a buffer, so it is only
+ * enabled by BULK_CACHE_ENV, and the application should call
+ * daos_obj_buf_invalidate() before freeing or remapping a buffer.
+ *
+ * object/cli_bulk.c
+ */
+#define D_LOGFAC	DD_FAC(object)
+
+#include <daos/common.h>
+#include <daos/lru.h>
+#include <daos/object.h>
+#include "obj_rpc.h"
+#include "obj_internal.h"
+
+/** power2 of max number of cached handles */
+#define OBJ_BULK_CACHE_BITS	10
+/** power2 of number of shards */
+#define OBJ_BULK_CACHE_SHARDS	3
+
+/** key of a cached bulk handle */
+struct obj_bulk_key {
+	void		*bk_buf;
+	daos_size_t	 bk_len;
+	daos_size_t	 bk_data_len;
+	crt_context_t	 bk_ctx;
+	crt_bulk_perm_t	 bk_perm;
+};
+
+/** cached bulk handle */
+struct obj_bulk_ent {
+	struct daos_llink	be_llink;
+	struct obj_bulk_key	be_key;
+	crt_bulk_t		be_bulk;
+};
+
+static struct daos_lru_cache	*obj_bulk_cache;
+/** # cached handles dropped by dc_obj_buf_invalidate() */
+static uint64_t			 obj_bulk_invalidated;
+
+static inline struct obj_bulk_ent *
+obj_bulk_link2ent(struct daos_llink *llink)
+{
+	return container_of(llink, struct obj_bulk_ent, be_llink);
+}
+
+static int
+obj_bulk_lop_alloc(void *key, unsigned int ksize, void *args,
+		   struct daos_llink **llink_p)
+{
+	struct obj_bulk_key	*bkey = key;
+	struct obj_bulk_ent	*ent;
+	daos_sg_list_t		*sgl = args;
+	int			 rc;
+
+	D_ALLOC_PTR(ent);
+	if (ent == NULL)
+		return -DER_NOMEM;
+
+	rc = crt_bulk_create(bkey->bk_ctx, daos2crt_sg(sgl), bkey->bk_perm,
+			     &ent->be_bulk);
+	if (rc != 0) {
+		D_FREE_PTR(ent);
+		return rc;
+	}
+
+	ent->be_key = *bkey;
+	ent->be_llink.ll_cost = min(bkey->bk_len, (daos_size_t)UINT32_MAX);
+	*llink_p = &ent->be_llink;
+	return 0;
+}
+
+static bool
+obj_bulk_lop_cmp_keys(const void *key, unsigned int ksize,
+		      struct daos_llink *llink)
+{
+	struct obj_bulk_ent	*ent = obj_bulk_link2ent(llink);
+
+	D_ASSERT(ksize == sizeof(struct obj_bulk_key));
+	return !memcmp(key, &ent->be_key, sizeof(ent->be_key));
+}
+
+static void
+obj_bulk_lop_free(struct daos_llink *llink)
+{
+	struct obj_bulk_ent	*ent = obj_bulk_link2ent(llink);
+
+	crt_bulk_free(ent->be_bulk);
+	D_FREE_PTR(ent);
+}
+
+static struct daos_llink_ops obj_bulk_lru_ops = {
+	.lop_free_ref	= obj_bulk_lop_free,
+	.lop_alloc_ref	= obj_bulk_lop_alloc,
+	.lop_cmp_keys	= obj_bulk_lop_cmp_keys,
+};
+
+int
+obj_bulk_cache_init(void)
+{
+	char		*env;
+	uint64_t	 budget;
+	int		 rc;
+
+	env = getenv(BULK_CACHE_ENV);
+	if (env == NULL)
+		return 0;
+
+	budget = strtoull(env, NULL, 10) << 20;
+	if (budget == 0)
+		return 0;
+
+	obj_bulk_invalidated = 0;
+	rc = daos_lru_cache_create_shared(OBJ_BULK_CACHE_BITS,
+					  OBJ_BULK_CACHE_SHARDS,
+					  &obj_bulk_lru_ops, &obj_bulk_cache);
+	if (rc) {
+		D_ERROR("Failed to create bulk cache: %d\n", rc);
+		return rc;
+	}
+
+	rc = daos_lru_cache_config(obj_bulk_cache, budget, DAOS_LRU_POL_LRU);
+	if (rc) {
+		daos_lru_cache_destroy(obj_bulk_cache);
+		obj_bulk_cache = NULL;
+		return rc;
+	}
+	D_DEBUG(DB_IO, "Cache bulk handles of up to "DF_U64" MB buffers\n",
+		budget >> 20);
+	return 0;
+}
+
+void
+obj_bulk_cache_fini(void)
+{
+	struct daos_lru_stat	stat;
+
+	if (obj_bulk_cache == NULL)
+		return;
+
+	daos_lru_cache_stat(obj_bulk_cache, &stat);
+	D_DEBUG(DB_IO, "bulk cache hits "DF_U64", misses "DF_U64
+		", evictions "DF_U64", invalidated "DF_U64"\n", stat.ls_hits,
+		stat.ls_misses, stat.ls_evictions, obj_bulk_invalidated);
+
+	daos_lru_cache_destroy(obj_bulk_cache);
+	obj_bulk_cache = NULL;
+}
+
+int
+dc_obj_buf_query(daos_obj_buf_stat_t *stat)
+{
+	struct daos_lru_stat	ls;
+
+	if (obj_bulk_cache == NULL)
+		return -DER_UNINIT;
+
+	daos_lru_cache_stat(obj_bulk_cache, &ls);
+	stat->bs_hits		= ls.ls_hits;
+	stat->bs_misses		= ls.ls_misses;
+	stat->bs_evictions	= ls.ls_evictions;
+	stat->bs_invalidated	= __atomic_load_n(&obj_bulk_invalidated,
+						  __ATOMIC_RELAXED);
+	stat->bs_nr		= ls.ls_nr;
+	stat->bs_bytes		= ls.ls_cost;
+	return 0;
+}
+
+int
+obj_bulk_create(crt_context_t ctx, daos_sg_list_t *sgl, crt_bulk_perm_t perm,
+		crt_bulk_t *bulk, struct obj_bulk_ent **entp)
+{
+	struct obj_bulk_key	 key;
+	struct daos_llink	*llink;
+	int			 rc;
+
+	*entp = NULL;
+	if (obj_bulk_cache == NULL || sgl->sg_nr != 1)
+		return crt_bulk_create(ctx, daos2crt_sg(sgl), perm, bulk);
+
+	/* NB: zero the padding, the key is compared by memcmp */
+	memset(&key, 0, sizeof(key));
+	key.bk_buf	= sgl->sg_iovs[0].iov_buf;
+	key.bk_len	= sgl->sg_iovs[0].iov_buf_len;
+	key.bk_data_len	= sgl->sg_iovs[0].iov_len;
+	key.bk_ctx	= ctx;
+	key.bk_perm	= perm;
+
+	rc = daos_lru_ref_hold(obj_bulk_cache, &key, sizeof(key), sgl,
+			       &llink);
+	if (rc)
+		return rc;
+
+	*entp = obj_bulk_link2ent(llink);
+	*bulk = (*entp)->be_bulk;
+	return 0;
+}
+
+void
+obj_bulk_free(crt_bulk_t bulk, struct obj_bulk_ent *ent)
+{
+	if (ent == NULL) {
+		crt_bulk_free(bulk);
+		return;
+	}
+
+	D_ASSERT(ent->be_bulk == bulk);
+	daos_lru_ref_release(obj_bulk_cache, &ent->be_llink);
+}
+
+static bool
+obj_bulk_overlap_cond(struct daos_llink *llink, void *args)
+{
+	struct obj_bulk_key	*range = args;
+	struct obj_bulk_key	*key = &obj_bulk_link2ent(llink)->be_key;
+
+	if ((char *)key->bk_buf >= (char *)range->bk_buf + range->bk_len ||
+	    (char *)range->bk_buf >= (char *)key->bk_buf + key->bk_len)
+		return false;
+
+	/* in use and invalidated already, it's freed on release */
+	if (daos_lru_ref_evicted(llink))
+		return false;
+
+	__atomic_fetch_add(&obj_bulk_invalidated, 1, __ATOMIC_RELAXED);
+	return true;
+}
+
+void
+dc_obj_buf_invalidate(void *buf, daos_size_t len)
+{
+	struct obj_bulk_key	range;
+
+	if (obj_bulk_cache == NULL)
+		return;
+
+	range.bk_buf = buf;
+	range.bk_len = len;
+	/* handles being used by in-flight I/O are freed on release */
+	daos_lru_cache_evict(obj_bulk_cache, obj_bulk_overlap_cond, &range);
+}
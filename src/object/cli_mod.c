@@ -32,7 +32,12 @@
 #include "obj_rpc.h"
 #include "obj_internal.h"
 
-bool	cli_bypass_rpc;
+bool		cli_bypass_rpc;
+unsigned int	cli_csum_type = DAOS_CS_CRC32C;
+daos_size_t	cli_bulk_limit = OBJ_BULK_LIMIT;
+bool		cli_bulk_adaptive;
+bool		cli_bulk_pack;
+bool		cli_batch;
 
 /**
  * Initialize object interface
@@ -49,7 +54,55 @@ dc_obj_init(void)
 		cli_bypass_rpc = true;
 	}
 
+	env = getenv(CSUM_TYPE_ENV);
+	if (env) {
+		unsigned int	type;
+
+		for (type = 0; type < DAOS_CS_MAX; type++) {
+			if (!strcasecmp(daos_csum_type2name(type), env))
+				break;
+		}
+
+		if (type == DAOS_CS_MAX) {
+			D_ERROR("Unsupported checksum type %s\n", env);
+			return -DER_INVAL;
+		}
+		cli_csum_type = type;
+	}
+
+	env = getenv(BULK_LIMIT_ENV);
+	if (env && !strcasecmp(env, "auto")) {
+		cli_bulk_adaptive = true;
+	} else if (env) {
+		cli_bulk_limit = strtoull(env, NULL, 0);
+		if (cli_bulk_limit < OBJ_BULK_LIMIT_MIN ||
+		    cli_bulk_limit > OBJ_BULK_LIMIT_MAX) {
+			D_ERROR("Invalid bulk limit %s, range is [%d, %d]\n",
+				env, OBJ_BULK_LIMIT_MIN, OBJ_BULK_LIMIT_MAX);
+			return -DER_INVAL;
+		}
+	}
+
+	env = getenv(BULK_PACK_ENV);
+	if (env && atoi(env) != 0)
+		cli_bulk_pack = true;
+
+	env = getenv(BATCH_ENV);
+	if (env && atoi(env) != 0 && !cli_bypass_rpc)
+		cli_batch = true;
+
+	D_DEBUG(DB_IO, "bulk limit %s%lu, packing %s, batching %s\n",
+		cli_bulk_adaptive ? "adaptive from " : "",
+		(unsigned long)cli_bulk_limit, cli_bulk_pack ? "on" : "off",
+		cli_batch ? "on" : "off");
+
+	rc = obj_bulk_cache_init();
+	if (rc)
+		return rc;
+
 	rc = daos_rpc_register(daos_obj_rpcs, NULL, DAOS_OBJ_MODULE);
+	if (rc)
+		obj_bulk_cache_fini();
 	return rc;
 }
 
@@ -60,4 +113,5 @@ void
 dc_obj_fini(void)
 {
 	daos_rpc_unregister(daos_obj_rpcs);
+	obj_bulk_cache_fini();
 }
@@ -112,10 +112,30 @@ dc_obj_shard_close(struct dc_obj_shard *shard)
 	obj_shard_decref(shard);
 }
 
+/**
+ * Allocate array of \a nr bulk handles, which is followed by \a nr pointers
+ * of cache entries of these handles, see obj_bulk_create().
+ */
+static crt_bulk_t *
+obj_shard_bulks_alloc(unsigned int nr)
+{
+	crt_bulk_t	*bulks;
+
+	D_ALLOC(bulks, nr * (sizeof(*bulks) + sizeof(struct obj_bulk_ent *)));
+	return bulks;
+}
+
+static inline struct obj_bulk_ent **
+obj_shard_bulks2ents(crt_bulk_t *bulks, unsigned int nr)
+{
+	return (struct obj_bulk_ent **)&bulks[nr];
+}
+
 static void
 obj_shard_rw_bulk_fini(crt_rpc_t *rpc)
 {
 	struct obj_rw_in	*orw;
+	struct obj_bulk_ent	**ents;
 	crt_bulk_t		*bulks;
 	unsigned int		nr;
 	int			i;
@@ -126,12 +146,21 @@ obj_shard_rw_bulk_fini(crt_rpc_t *rpc)
 		return;
 
 	nr = orw->orw_bulks.ca_count;
-	for (i = 0; i < nr; i++)
-		crt_bulk_free(bulks[i]);
+	ents = obj_shard_bulks2ents(bulks, nr);
+	for (i = 0; i < nr; i++) {
+		if (bulks[i] != NULL)
+			obj_bulk_free(bulks[i], ents[i]);
+	}
 
 	D_FREE(bulks);
 	orw->orw_bulks.ca_arrays = NULL;
 	orw->orw_bulks.ca_count = 0;
+
+	if (orw->orw_bulk_offs.ca_arrays != NULL) {
+		D_FREE(orw->orw_bulk_offs.ca_arrays);
+		orw->orw_bulk_offs.ca_arrays = NULL;
+		orw->orw_bulk_offs.ca_count = 0;
+	}
 }
 
 struct obj_rw_args {
@@ -141,8 +170,232 @@ struct obj_rw_args {
 	struct dc_obj_shard	*dobj;
 	unsigned int	*map_ver;
 	uint32_t	 rwaa_nr;
+	/** I/O descriptors of the caller */
+	daos_iod_t	*rwaa_iods;
+	/** duplicated descriptors with checksums, see obj_shard_csum_prep */
+	daos_iod_t	*rwaa_csum_iods;
+	/** buffer of the packed bulk, see obj_shard_rw_bulk_pack */
+	void		*rwaa_pack_buf;
+	/** start time (us) of the RPC, for adapting the bulk limit */
+	uint64_t	 rwaa_start;
+	/** data size of the RPC */
+	daos_size_t	 rwaa_size;
+	/** data is transferred by bulk */
+	bool		 rwaa_bulk;
 };
 
+/** number of samples on each side of the limit before adapting it */
+#define OBJ_BULK_ADAPT_SAMPLES	32
+
+/** per-thread latency statistics of I/O around the bulk limit */
+struct obj_bulk_stats {
+	uint64_t	bs_inline_us;
+	uint64_t	bs_bulk_us;
+	unsigned int	bs_inline_nr;
+	unsigned int	bs_bulk_nr;
+};
+
+static __thread struct obj_bulk_stats	obj_bulk_stats;
+
+static inline uint64_t
+obj_now_us(void)
+{
+	struct timespec	now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec * 1000000ULL + now.tv_nsec / 1000;
+}
+
+static inline daos_size_t
+obj_bulk_limit(void)
+{
+	return __atomic_load_n(&cli_bulk_limit, __ATOMIC_RELAXED);
+}
+
+/**
+ * Feed latency of an I/O to the adaptive bulk limit. Inline I/O in
+ * [limit/2, limit) and bulk I/O in [limit, limit * 2) are sampled, once
+ * there are enough samples on both sides, the limit is lowered if bulk I/O
+ * is not slower than the smaller inline I/O, or raised if inline I/O is
+ * clearly cheaper.
+ */
+static void
+obj_bulk_limit_adapt(daos_size_t size, bool bulk, uint64_t lat)
+{
+	struct obj_bulk_stats	*bs = &obj_bulk_stats;
+	daos_size_t		 limit = obj_bulk_limit();
+	uint64_t		 inline_avg;
+	uint64_t		 bulk_avg;
+
+	if (bulk) {
+		if (size >= limit * 2 ||
+		    bs->bs_bulk_nr >= OBJ_BULK_ADAPT_SAMPLES)
+			return;
+		bs->bs_bulk_us += lat;
+		bs->bs_bulk_nr++;
+	} else {
+		if (size < limit / 2 ||
+		    bs->bs_inline_nr >= OBJ_BULK_ADAPT_SAMPLES)
+			return;
+		bs->bs_inline_us += lat;
+		bs->bs_inline_nr++;
+	}
+
+	if (bs->bs_inline_nr < OBJ_BULK_ADAPT_SAMPLES ||
+	    bs->bs_bulk_nr < OBJ_BULK_ADAPT_SAMPLES)
+		return;
+
+	inline_avg = bs->bs_inline_us / bs->bs_inline_nr;
+	bulk_avg = bs->bs_bulk_us / bs->bs_bulk_nr;
+	memset(bs, 0, sizeof(*bs));
+
+	if (inline_avg >= bulk_avg)
+		limit = max(limit * 3 / 4, (daos_size_t)OBJ_BULK_LIMIT_MIN);
+	else if (inline_avg * 4 < bulk_avg * 3)
+		limit = min(limit * 5 / 4, (daos_size_t)OBJ_BULK_LIMIT_MAX);
+	else
+		return;
+
+	D_DEBUG(DB_IO, "inline %lu us, bulk %lu us, bulk limit %lu\n",
+		(unsigned long)inline_avg, (unsigned long)bulk_avg,
+		(unsigned long)limit);
+	/* other threads may race to adapt it, the last one wins */
+	__atomic_store_n(&cli_bulk_limit, limit, __ATOMIC_RELAXED);
+}
+
+/**
+ * Duplicate I/O descriptors \a iods and attach a checksum buffer for each of
+ * their extents, so descriptors of the caller are untouched. Checksums are
+ * computed from \a sgls for update, for fetch the buffers carry the stored
+ * checksums back from the server.
+ *
+ * The duplicated descriptors and checksum buffers are in the same allocation
+ * which should be released by D_FREE.
+ */
+static int
+obj_shard_csum_prep(enum obj_rpc_opc opc, unsigned int nr, daos_iod_t *iods,
+		    daos_sg_list_t *sgls, daos_iod_t **iods_p)
+{
+	daos_iod_t	*dups;
+	daos_csum_buf_t	*csums;
+	daos_csum_t	 csum;
+	daos_size_t	 size;
+	unsigned int	 total;
+	char		*buf;
+	int		 i;
+	int		 j;
+	int		 rc;
+
+	rc = obj_csum_init(cli_csum_type, &csum);
+	if (rc != 0)
+		return rc;
+
+	size = daos_csum_get_size(&csum);
+	for (i = total = 0; i < nr; i++)
+		total += obj_iod_csum_nr(&iods[i]);
+
+	D_ALLOC(dups, nr * sizeof(*dups) + total * (sizeof(*csums) + size));
+	if (dups == NULL)
+		D_GOTO(out, rc = -DER_NOMEM);
+
+	csums = (daos_csum_buf_t *)&dups[nr];
+	buf = (char *)&csums[total];
+	for (i = 0; i < nr; i++) {
+		bool	compute;
+
+		dups[i] = iods[i];
+		dups[i].iod_csums = csums;
+		compute = opc == DAOS_OBJ_RPC_UPDATE && sgls != NULL &&
+			  iods[i].iod_size != 0;
+
+		for (j = 0; j < obj_iod_csum_nr(&iods[i]); j++) {
+			daos_csum_set(&csums[j], buf, size);
+			csums[j].cs_type = cli_csum_type;
+			if (!compute)
+				csums[j].cs_len = 0;
+			buf += size;
+		}
+
+		if (compute) {
+			rc = obj_iod_csum_compute(&csum, cli_csum_type,
+						  &dups[i], &sgls[i], csums);
+			if (rc != 0) {
+				D_FREE(dups);
+				D_GOTO(out, rc);
+			}
+		}
+		csums += obj_iod_csum_nr(&iods[i]);
+	}
+	*iods_p = dups;
+out:
+	daos_csum_free(&csum);
+	return rc;
+}
+
+/**
+ * Verify fetched data against checksums returned by the server, and return
+ * these checksums to the caller if it has provided buffers in iod_csums.
+ */
+static int
+obj_shard_csum_check(struct obj_rw_args *rw_args, struct obj_rw_out *orwo)
+{
+	daos_csum_buf_t	*csums = orwo->orw_csums.ca_arrays;
+	unsigned int	 at = 0;
+	int		 i;
+	int		 j;
+	int		 rc;
+
+	for (i = 0; i < rw_args->rwaa_nr; i++) {
+		daos_iod_t	*iod = &rw_args->rwaa_csum_iods[i];
+		daos_iod_t	*uiod = &rw_args->rwaa_iods[i];
+		unsigned int	 nr = obj_iod_csum_nr(iod);
+
+		if (at + nr > orwo->orw_csums.ca_count) {
+			D_ERROR("Invalid csums %u/%u\n", at + nr,
+				(unsigned int)orwo->orw_csums.ca_count);
+			return -DER_PROTO;
+		}
+
+		for (j = 0; j < nr; j++, at++) {
+			daos_csum_buf_t *cs = &iod->iod_csums[j];
+
+			if (csums[at].cs_len > cs->cs_buf_len)
+				return -DER_PROTO;
+
+			cs->cs_type = csums[at].cs_type;
+			cs->cs_len = csums[at].cs_len;
+			if (cs->cs_len != 0)
+				memcpy(cs->cs_csum, csums[at].cs_csum,
+				       cs->cs_len);
+
+			if (uiod->iod_csums == NULL)
+				continue;
+
+			if (uiod->iod_csums[j].cs_buf_len < cs->cs_len) {
+				uiod->iod_csums[j].cs_len = 0;
+				continue;
+			}
+			uiod->iod_csums[j].cs_type = cs->cs_type;
+			uiod->iod_csums[j].cs_len = cs->cs_len;
+			if (cs->cs_len != 0)
+				memcpy(uiod->iod_csums[j].cs_csum, cs->cs_csum,
+				       cs->cs_len);
+		}
+
+		if (rw_args->rwaa_sgls == NULL)
+			continue;
+
+		iod->iod_size = uiod->iod_size;
+		rc = obj_iod_csum_verify(iod, &rw_args->rwaa_sgls[i], NULL);
+		if (rc != 0) {
+			D_ERROR("Fetched data of "DF_UOID" is corrupted: %d\n",
+				DP_UOID(rw_args->dobj->do_id), rc);
+			return rc;
+		}
+	}
+	return 0;
+}
+
 static int
 dc_rw_cb(tse_task_t *task, void *arg)
 {
@@ -197,7 +450,7 @@ dc_rw_cb(tse_task_t *task, void *arg)
 		uint64_t	*sizes;
 		int		 i;
 
-		iods = orw->orw_iods.ca_arrays;
+		iods = rw_args->rwaa_iods;
 		sizes = orwo->orw_sizes.ca_arrays;
 
 		if (orwo->orw_sizes.ca_count != orw->orw_nr) {
@@ -235,8 +488,17 @@ dc_rw_cb(tse_task_t *task, void *arg)
 			for (i = 0; i < nrs_count; i++)
 				sgls[i].sg_nr_out = nrs[i];
 		}
+
+		if (rc == 0 && rw_args->rwaa_csum_iods != NULL &&
+		    orwo->orw_csums.ca_count != 0)
+			rc = obj_shard_csum_check(rw_args, orwo);
 	}
+	if (rc == 0 && cli_bulk_adaptive)
+		obj_bulk_limit_adapt(rw_args->rwaa_size, rw_args->rwaa_bulk,
+				     obj_now_us() - rw_args->rwaa_start);
 out:
+	D_FREE(rw_args->rwaa_csum_iods);
+	D_FREE(rw_args->rwaa_pack_buf);
 	obj_shard_rw_bulk_fini(rw_args->rpc);
 	crt_req_decref(rw_args->rpc);
 	obj_shard_decref(rw_args->dobj);
@@ -297,6 +559,7 @@ obj_shard_rw_bulk_prep(crt_rpc_t *rpc, unsigned int nr, daos_sg_list_t *sgls,
 		       tse_task_t *task)
 {
 	struct obj_rw_in	*orw;
+	struct obj_bulk_ent	**ents;
 	crt_bulk_t		*bulks;
 	crt_bulk_perm_t		 bulk_perm;
 	int			 i;
@@ -304,22 +567,25 @@ obj_shard_rw_bulk_prep(crt_rpc_t *rpc, unsigned int nr, daos_sg_list_t *sgls,
 
 	bulk_perm = (opc_get(rpc->cr_opc) == DAOS_OBJ_RPC_UPDATE) ?
 		    CRT_BULK_RO : CRT_BULK_RW;
-	D_ALLOC(bulks, nr * sizeof(*bulks));
+	bulks = obj_shard_bulks_alloc(nr);
 	if (bulks == NULL)
 		D_GOTO(out, rc = -DER_NOMEM);
+	ents = obj_shard_bulks2ents(bulks, nr);
 
 	/* create bulk transfer for daos_sg_list */
 	for (i = 0; i < nr; i++) {
 		if (sgls != NULL && sgls[i].sg_iovs != NULL &&
 		    sgls[i].sg_iovs[0].iov_buf != NULL) {
-			rc = crt_bulk_create(daos_task2ctx(task),
-					     daos2crt_sg(&sgls[i]),
-					     bulk_perm, &bulks[i]);
+			rc = obj_bulk_create(daos_task2ctx(task), &sgls[i],
+					     bulk_perm, &bulks[i], &ents[i]);
 			if (rc < 0) {
 				int j;
 
-				for (j = 0; j < i; j++)
-					crt_bulk_free(bulks[j]);
+				for (j = 0; j < i; j++) {
+					if (bulks[j] != NULL)
+						obj_bulk_free(bulks[j],
+							      ents[j]);
+				}
 
 				D_GOTO(out, rc);
 			}
@@ -337,6 +603,95 @@ out:
 	return rc;
 }
 
+/**
+ * Copy data of all \a sgls of an update into one buffer and create a single
+ * bulk for it, the server finds each sgl by its offset in the buffer. The
+ * buffer is returned in \a pack_buf and should be released by D_FREE after
+ * the RPC completes.
+ */
+static int
+obj_shard_rw_bulk_pack(crt_rpc_t *rpc, unsigned int nr, daos_sg_list_t *sgls,
+		       tse_task_t *task, void **pack_buf)
+{
+	struct obj_rw_in	*orw;
+	crt_bulk_t		*bulk;
+	uint64_t		*offs;
+	daos_sg_list_t		 sgl;
+	daos_iov_t		 iov;
+	char			*buf;
+	daos_size_t		 size;
+	daos_size_t		 off;
+	int			 i;
+	int			 j;
+	int			 rc;
+
+	size = sgls_buf_len(sgls, nr);
+	D_ALLOC(buf, size);
+	if (buf == NULL)
+		return -DER_NOMEM;
+
+	D_ALLOC(offs, nr * sizeof(*offs));
+	if (offs == NULL)
+		D_GOTO(out_buf, rc = -DER_NOMEM);
+
+	bulk = obj_shard_bulks_alloc(1);
+	if (bulk == NULL)
+		D_GOTO(out_offs, rc = -DER_NOMEM);
+
+	for (i = 0, off = 0; i < nr; i++) {
+		offs[i] = off;
+		for (j = 0; j < sgls[i].sg_nr; j++) {
+			daos_iov_t *src = &sgls[i].sg_iovs[j];
+
+			memcpy(buf + off, src->iov_buf, src->iov_len);
+			off += src->iov_len;
+		}
+	}
+
+	daos_iov_set(&iov, buf, off);
+	sgl.sg_nr = 1;
+	sgl.sg_nr_out = 0;
+	sgl.sg_iovs = &iov;
+	rc = crt_bulk_create(daos_task2ctx(task), daos2crt_sg(&sgl),
+			     CRT_BULK_RO, bulk);
+	if (rc != 0)
+		D_GOTO(out_bulk, rc);
+
+	orw = crt_req_get(rpc);
+	D_ASSERT(orw != NULL);
+	orw->orw_bulks.ca_count = 1;
+	orw->orw_bulks.ca_arrays = bulk;
+	orw->orw_bulk_offs.ca_count = nr;
+	orw->orw_bulk_offs.ca_arrays = offs;
+	*pack_buf = buf;
+	return 0;
+out_bulk:
+	D_FREE(bulk);
+out_offs:
+	D_FREE(offs);
+out_buf:
+	D_FREE(buf);
+	return rc;
+}
+
+/** data of the update can be packed by obj_shard_rw_bulk_pack */
+static bool
+obj_shard_rw_packable(enum obj_rpc_opc opc, unsigned int nr,
+		      daos_sg_list_t *sgls, daos_size_t size)
+{
+	int	i;
+
+	if (!cli_bulk_pack || opc != DAOS_OBJ_RPC_UPDATE || nr < 2 ||
+	    sgls == NULL || size > OBJ_BULK_PACK_MAX)
+		return false;
+
+	for (i = 0; i < nr; i++) {
+		if (sgls[i].sg_iovs == NULL)
+			return false;
+	}
+	return sgls_buf_len(sgls, nr) <= OBJ_BULK_PACK_MAX;
+}
+
 static struct dc_pool *
 obj_shard_ptr2pool(struct dc_obj_shard *shard)
 {
@@ -349,6 +704,66 @@ obj_shard_ptr2pool(struct dc_obj_shard *shard)
 	return dc_hdl2pool(poh);
 }
 
+/**
+ * Queue an inline update in the batch of its target instead of sending it,
+ * see cli_batch.c. Updates of echo objects aren't batched, they are not
+ * stored by the server.
+ */
+static bool
+obj_shard_rw_batchable(struct dc_obj_shard *shard, enum obj_rpc_opc opc,
+		       daos_size_t total_len)
+{
+	return cli_batch && opc == DAOS_OBJ_RPC_UPDATE &&
+	       total_len < obj_bulk_limit() &&
+	       daos_obj_id2class(shard->do_id.id_pub) != DAOS_OC_ECHO_RW;
+}
+
+static int
+obj_shard_rw_batch(struct dc_obj_shard *shard, struct dc_pool *pool,
+		   crt_endpoint_t *tgt_ep, uuid_t cont_hdl_uuid,
+		   uuid_t cont_uuid, daos_epoch_t epoch, daos_key_t *dkey,
+		   unsigned int nr, daos_iod_t *iods, daos_sg_list_t *sgls,
+		   unsigned int *map_ver, daos_size_t total_len,
+		   tse_task_t *task)
+{
+	struct obj_batch_req	*req;
+	int			 rc;
+
+	if (DAOS_FAIL_CHECK(DAOS_SHARD_OBJ_FAIL))
+		return -DER_INVAL;
+
+	D_ALLOC_PTR(req);
+	if (req == NULL)
+		return -DER_NOMEM;
+
+	if (dc_cont_csum_enabled(shard->do_co_hdl)) {
+		rc = obj_shard_csum_prep(DAOS_OBJ_RPC_UPDATE, nr, iods, sgls,
+					 &req->br_csum_iods);
+		if (rc != 0)
+			D_GOTO(failed, rc);
+	}
+
+	req->br_task = task;
+	req->br_shard = shard;
+	req->br_pool = pool;
+	req->br_map_ver = map_ver;
+	req->br_epoch = epoch;
+	req->br_dkey = dkey;
+	req->br_nr = nr;
+	req->br_iods = iods;
+	req->br_sgls = sgls;
+	req->br_size = total_len;
+
+	rc = obj_batch_add(tgt_ep, cont_hdl_uuid, cont_uuid, req);
+	if (rc != 0)
+		D_GOTO(failed, rc);
+	return 0;
+failed:
+	D_FREE(req->br_csum_iods);
+	D_FREE_PTR(req);
+	return rc;
+}
+
 static int
 obj_shard_rw(struct dc_obj_shard *shard, enum obj_rpc_opc opc,
 	     daos_epoch_t epoch, daos_key_t *dkey, unsigned int nr,
@@ -363,7 +778,10 @@ obj_shard_rw(struct dc_obj_shard *shard, enum obj_rpc_opc opc,
 	uuid_t			cont_hdl_uuid;
 	uuid_t			cont_uuid;
 	daos_size_t		total_len;
+	daos_iod_t		*csum_iods = NULL;
+	void			*pack_buf = NULL;
 	uint64_t		dkey_hash;
+	bool			bulk;
 	int			rc;
 
 	tse_task_stack_pop_data(task, &dkey_hash, sizeof(dkey_hash));
@@ -383,6 +801,18 @@ obj_shard_rw(struct dc_obj_shard *shard, enum obj_rpc_opc opc,
 	D_DEBUG(DB_TRACE, "opc %d "DF_UOID" %.*s rank %d tag %d\n",
 		opc, DP_UOID(shard->do_id), (int)dkey->iov_len,
 		(char *)dkey->iov_buf, tgt_ep.ep_rank, tgt_ep.ep_tag);
+
+	total_len = iods_data_len(iods, nr);
+	if (obj_shard_rw_batchable(shard, opc, total_len)) {
+		/* the batch releases the shard and pool from now on */
+		rc = obj_shard_rw_batch(shard, pool, &tgt_ep, cont_hdl_uuid,
+					cont_uuid, epoch, dkey, nr, iods, sgls,
+					map_ver, total_len, task);
+		if (rc != 0)
+			D_GOTO(out_pool, rc);
+		return 0;
+	}
+
 	rc = obj_req_create(daos_task2ctx(task), &tgt_ep, opc, &req);
 	if (rc != 0)
 		D_GOTO(out_pool, rc);
@@ -400,13 +830,18 @@ obj_shard_rw(struct dc_obj_shard *shard, enum obj_rpc_opc opc,
 	/** FIXME: large dkey should be transferred via bulk */
 	orw->orw_dkey = *dkey;
 
+	if (dc_cont_csum_enabled(shard->do_co_hdl)) {
+		rc = obj_shard_csum_prep(opc, nr, iods, sgls, &csum_iods);
+		if (rc != 0)
+			D_GOTO(out_req, rc);
+	}
+
 	/* FIXME: if iods is too long, then we needs to do bulk transfer
 	 * as well, but then we also needs to serialize the iods
 	 **/
 	orw->orw_iods.ca_count = nr;
-	orw->orw_iods.ca_arrays = iods;
+	orw->orw_iods.ca_arrays = csum_iods != NULL ? csum_iods : iods;
 
-	total_len = iods_data_len(iods, nr);
 	/* If it is read, let's try to get the size from sg list */
 	if (total_len == 0 && opc == DAOS_OBJ_RPC_FETCH)
 		total_len = sgls_buf_len(sgls, nr);
@@ -414,9 +849,16 @@ obj_shard_rw(struct dc_obj_shard *shard, enum obj_rpc_opc opc,
 	if (DAOS_FAIL_CHECK(DAOS_SHARD_OBJ_FAIL))
 		D_GOTO(out_req, rc = -DER_INVAL);
 
-	if (total_len >= OBJ_BULK_LIMIT) {
+	orw->orw_bulk_offs.ca_count = 0;
+	orw->orw_bulk_offs.ca_arrays = NULL;
+	bulk = total_len >= obj_bulk_limit();
+	if (bulk) {
 		/* Transfer data by bulk */
-		rc = obj_shard_rw_bulk_prep(req, nr, sgls, task);
+		if (obj_shard_rw_packable(opc, nr, sgls, total_len))
+			rc = obj_shard_rw_bulk_pack(req, nr, sgls, task,
+						    &pack_buf);
+		else
+			rc = obj_shard_rw_bulk_prep(req, nr, sgls, task);
 		if (rc != 0)
 			D_GOTO(out_req, rc);
 		orw->orw_sgls.ca_count = 0;
@@ -437,6 +879,12 @@ obj_shard_rw(struct dc_obj_shard *shard, enum obj_rpc_opc opc,
 	rw_args.hdlp = (daos_handle_t *)pool;
 	rw_args.map_ver = map_ver;
 	rw_args.dobj = shard;
+	rw_args.rwaa_iods = iods;
+	rw_args.rwaa_csum_iods = csum_iods;
+	rw_args.rwaa_pack_buf = pack_buf;
+	rw_args.rwaa_start = cli_bulk_adaptive ? obj_now_us() : 0;
+	rw_args.rwaa_size = total_len;
+	rw_args.rwaa_bulk = bulk;
 
 	if (opc == DAOS_OBJ_RPC_FETCH) {
 		/* remember the sgl to copyout the data inline for fetch */
@@ -454,6 +902,8 @@ obj_shard_rw(struct dc_obj_shard *shard, enum obj_rpc_opc opc,
 				       sizeof(rw_args));
 	if (rc != 0)
 		D_GOTO(out_args, rc);
+	/* released by dc_rw_cb from now on */
+	pack_buf = NULL;
 
 	if (cli_bypass_rpc) {
 		rc = daos_rpc_complete(req, task);
@@ -468,9 +918,11 @@ obj_shard_rw(struct dc_obj_shard *shard, enum obj_rpc_opc opc,
 
 out_args:
 	crt_req_decref(req);
-	if (total_len >= OBJ_BULK_LIMIT)
+	D_FREE(pack_buf);
+	if (bulk)
 		obj_shard_rw_bulk_fini(req);
 out_req:
+	D_FREE(csum_iods);
 	crt_req_decref(req);
 out_pool:
 	dc_pool_put(pool);
@@ -770,7 +1222,7 @@ dc_obj_shard_list_internal(struct dc_obj_shard *obj_shard, enum obj_rpc_opc opc,
 	if (sgl != NULL) {
 		oei->oei_sgl = *sgl;
 		sgl_len = sgls_buf_len(sgl, 1);
-		if (sgl_len >= OBJ_BULK_LIMIT) {
+		if (sgl_len >= obj_bulk_limit()) {
 			/* Create bulk */
 			rc = crt_bulk_create(daos_task2ctx(task),
 					     daos2crt_sg(sgl), CRT_BULK_RW,
@@ -810,7 +1262,7 @@ dc_obj_shard_list_internal(struct dc_obj_shard *obj_shard, enum obj_rpc_opc opc,
 
 out_eaa:
 	crt_req_decref(req);
-	if (sgl != NULL && sgl_len >= OBJ_BULK_LIMIT)
+	if (oei->oei_bulk != NULL)
 		crt_bulk_free(oei->oei_bulk);
 out_req:
 	crt_req_decref(req);
@@ -0,0 +1,159 @@
+/**
+ * (C) Copyright 2018 Intel Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * GOVERNMENT LICENSE RIGHTS-OPEN SOURCE SOFTWARE
+ * The Government's rights to use, modify, reproduce, release, perform, display,
+ * or disclose this software are subject to the terms of the Apache License as
+ * provided in Contract No. B609815.
+ * Any reproduction of computer software, computer software documentation, or
+ * portions thereof marked with this legend must also reproduce the markings.
+ */
+/**
+ * End-to-end checksum of object I/O, it is shared by client and server.
+ *
+ * Each extent of an array I/O descriptor (or the single value) has its own
+ * checksum in iod_csums, which is computed by client, verified by server
+ * before the update is submitted to VOS, stored together with the extent and
+ * returned by fetch as is.
+ */
+#define DDSUBSYS	DDFAC(object)
+
+#include <daos/common.h>
+#include "obj_internal.h"
+
+/** Initialize \a csum for the checksum type \a type */
+int
+obj_csum_init(unsigned int type, daos_csum_t *csum)
+{
+	const char *name;
+
+	name = daos_csum_type2name(type);
+	if (name == NULL) {
+		D_ERROR("Unsupported checksum type %u\n", type);
+		return -DER_NOSYS;
+	}
+	return daos_csum_init(name, csum);
+}
+
+static int
+iod_csum_compute(daos_csum_t *csum, unsigned int type, daos_iod_t *iod,
+		 daos_sg_list_t *sgl, daos_csum_buf_t *csums,
+		 obj_csum_ranges_t compute)
+{
+	daos_size_t	*lens;
+	unsigned int	 nr = obj_iod_csum_nr(iod);
+	int		 i;
+	int		 rc;
+
+	D_ALLOC(lens, nr * sizeof(*lens));
+	if (lens == NULL)
+		return -DER_NOMEM;
+
+	for (i = 0; i < nr; i++) {
+		if (iod->iod_type == DAOS_IOD_SINGLE)
+			lens[i] = iod->iod_size;
+		else
+			lens[i] = iod->iod_recxs[i].rx_nr * iod->iod_size;
+		csums[i].cs_type = type;
+	}
+
+	rc = compute(csum, sgl, nr, lens, csums);
+	D_FREE(lens);
+	return rc;
+}
+
+/**
+ * Compute checksum of each extent of \a iod from its data in \a sgl, the
+ * results are returned in \a csums, which should have one buffer for each
+ * extent.
+ */
+int
+obj_iod_csum_compute(daos_csum_t *csum, unsigned int type, daos_iod_t *iod,
+		     daos_sg_list_t *sgl, daos_csum_buf_t *csums)
+{
+	return iod_csum_compute(csum, type, iod, sgl, csums,
+				daos_csum_compute_ranges);
+}
+
+/**
+ * Verify data in \a sgl against checksums carried by \a iod, extents without
+ * checksum are skipped. Checksums of data are computed by \a compute, or by
+ * daos_csum_compute_ranges() if it is NULL.
+ *
+ * \return	0 if all checksums match, -DER_IO if any of them mismatches.
+ */
+int
+obj_iod_csum_verify(daos_iod_t *iod, daos_sg_list_t *sgl,
+		    obj_csum_ranges_t compute)
+{
+	daos_csum_buf_t	*csums;
+	daos_csum_t	 csum;
+	daos_size_t	 size;
+	unsigned int	 nr = obj_iod_csum_nr(iod);
+	unsigned int	 type;
+	char		*buf;
+	int		 i;
+	int		 rc;
+
+	if (iod->iod_csums == NULL || iod->iod_size == 0 ||
+	    iod->iod_size == DAOS_REC_ANY)
+		return 0;
+
+	for (i = 0; i < nr; i++) {
+		if (iod->iod_csums[i].cs_len != 0)
+			break;
+	}
+	if (i == nr) /* nothing to verify */
+		return 0;
+
+	type = iod->iod_csums[i].cs_type;
+	rc = obj_csum_init(type, &csum);
+	if (rc != 0)
+		return rc;
+
+	size = daos_csum_get_size(&csum);
+	D_ALLOC(csums, nr * (sizeof(*csums) + size));
+	if (csums == NULL)
+		D_GOTO(out, rc = -DER_NOMEM);
+
+	buf = (char *)&csums[nr];
+	for (i = 0; i < nr; i++)
+		daos_csum_set(&csums[i], &buf[i * size], size);
+
+	rc = iod_csum_compute(&csum, type, iod, sgl, csums,
+			      compute ?: daos_csum_compute_ranges);
+	if (rc != 0)
+		D_GOTO(out_free, rc);
+
+	for (i = 0; i < nr; i++) {
+		daos_csum_buf_t *cs = &iod->iod_csums[i];
+
+		if (cs->cs_len == 0)
+			continue;
+
+		if (cs->cs_type != type || cs->cs_len != size ||
+		    memcmp(cs->cs_csum, csums[i].cs_csum, size) != 0) {
+			D_ERROR("Checksum mismatch on extent %d of akey %.*s\n",
+				i, (int)iod->iod_name.iov_len,
+				(char *)iod->iod_name.iov_buf);
+			D_GOTO(out_free, rc = -DER_IO);
+		}
+	}
+out_free:
+	D_FREE(csums);
+out:
+	daos_csum_free(&csum);
+	return rc;
+}
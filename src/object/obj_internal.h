@@ -55,6 +55,60 @@ extern bool	cli_bypass_rpc;
  */
 extern bool	srv_bypass_bulk;
 
+/**
+ * Checksum type of containers opened with DAOS_COO_CSUM, it can be chosen by
+ * this environment variable, e.g. "crc32c" (default), "crc64" or "xxh64".
+ */
+#define CSUM_TYPE_ENV	"DAOS_CSUM_TYPE"
+extern unsigned int	cli_csum_type;
+/**
+ * Server only verifies checksums of one in every \a srv_csum_sample updates,
+ * which can be changed by this environment variable. The default value 1
+ * means verifying all updates, and zero means no verification at all.
+ */
+#define CSUM_SAMPLE_ENV	"DAOS_CSUM_SAMPLE"
+extern unsigned int	srv_csum_sample;
+/**
+ * Bulk updates larger than \a srv_bulk_chunk are transferred in chunks of
+ * this size, records are persisted as soon as their chunks land, while the
+ * following chunks are in flight. It can be changed by this environment
+ * variable (in KiB), zero disables the pipeline.
+ */
+#define BULK_CHUNK_ENV	"DAOS_BULK_CHUNK_KB"
+extern daos_size_t	srv_bulk_chunk;
+/**
+ * Max bytes of pipelined bulk transfers in flight per xstream, it can be
+ * changed by this environment variable (in MiB).
+ */
+#define BULK_INFLIGHT_ENV "DAOS_BULK_INFLIGHT_MB"
+extern daos_size_t	srv_bulk_inflight_max;
+/**
+ * Client transfers data of I/O larger than \a cli_bulk_limit by bulk, and
+ * inline otherwise. It can be set by this environment variable in bytes, or
+ * "auto" to let the client adapt it between OBJ_BULK_LIMIT_MIN and
+ * OBJ_BULK_LIMIT_MAX by comparing latencies of I/O just below and above it.
+ */
+#define BULK_LIMIT_ENV	"DAOS_OBJ_BULK_LIMIT"
+extern daos_size_t	cli_bulk_limit;
+extern bool		cli_bulk_adaptive;
+/**
+ * Pack data of all sgls of a bulk update into one buffer, so the server
+ * pulls it with a single bulk transfer instead of one per sgl.
+ */
+#define BULK_PACK_ENV	"DAOS_OBJ_BULK_PACK"
+extern bool		cli_bulk_pack;
+/**
+ * Budget (in MiB) of the registration cache of client bulk buffers, see
+ * cli_bulk.c. Zero (default) disables the cache.
+ */
+#define BULK_CACHE_ENV	"DAOS_OBJ_BULK_CACHE_MB"
+/**
+ * Batch inline updates to the same target within a progress window of the
+ * scheduler into one RPC, see cli_batch.c.
+ */
+#define BATCH_ENV	"DAOS_OBJ_BATCH"
+extern bool		cli_batch;
+
 /** client object shard */
 struct dc_obj_shard {
 	/** rank of the target this object belongs to */
@@ -158,6 +212,10 @@ enum_anchor_set_tag(daos_hash_out_t *anchor, uint32_t tag)
 extern struct dss_module_key obj_module_key;
 struct obj_tls {
 	d_sg_list_t	ot_echo_sgl;
+	/** number of updates with checksum, for sampling verification */
+	unsigned int	ot_csum_count;
+	/** bytes of pipelined bulk transfers in flight on this xstream */
+	daos_size_t	ot_bulk_inflight;
 };
 
 int dc_obj_shard_open(struct dc_object *obj, uint32_t tgt, daos_unit_oid_t id,
@@ -199,6 +257,53 @@ obj_retry_error(int err)
 	       daos_crt_network_error(err);
 }
 
+/* obj_csum.c */
+/** Number of checksums of \a iod, which is one per extent */
+static inline unsigned int
+obj_iod_csum_nr(daos_iod_t *iod)
+{
+	return iod->iod_type == DAOS_IOD_SINGLE ? 1 : iod->iod_nr;
+}
+
+int obj_csum_init(unsigned int type, daos_csum_t *csum);
+int obj_iod_csum_compute(daos_csum_t *csum, unsigned int type, daos_iod_t *iod,
+			 daos_sg_list_t *sgl, daos_csum_buf_t *csums);
+/** compute checksum of each range of sgl, see daos_csum_compute_ranges() */
+typedef int (*obj_csum_ranges_t)(daos_csum_t *csum, daos_sg_list_t *sgl,
+				 unsigned int nr, daos_size_t *lens,
+				 daos_csum_buf_t *csums);
+int obj_iod_csum_verify(daos_iod_t *iod, daos_sg_list_t *sgl,
+			obj_csum_ranges_t compute);
+
+struct obj_bulk_ent;
+int obj_bulk_cache_init(void);
+void obj_bulk_cache_fini(void);
+int obj_bulk_create(crt_context_t ctx, daos_sg_list_t *sgl,
+		    crt_bulk_perm_t perm, crt_bulk_t *bulk,
+		    struct obj_bulk_ent **entp);
+void obj_bulk_free(crt_bulk_t bulk, struct obj_bulk_ent *ent);
+
+/** an update of shard queued in a batch, see cli_batch.c */
+struct obj_batch_req {
+	d_list_t		 br_link;
+	tse_task_t		*br_task;
+	struct dc_obj_shard	*br_shard;
+	struct dc_pool		*br_pool;
+	unsigned int		*br_map_ver;
+	daos_epoch_t		 br_epoch;
+	daos_key_t		*br_dkey;
+	unsigned int		 br_nr;
+	daos_iod_t		*br_iods;
+	/** duplicated descriptors with checksums, sent instead of br_iods */
+	daos_iod_t		*br_csum_iods;
+	daos_sg_list_t		*br_sgls;
+	/** data size of the update */
+	daos_size_t		 br_size;
+};
+
+int obj_batch_add(crt_endpoint_t *tgt_ep, uuid_t co_hdl, uuid_t co_uuid,
+		  struct obj_batch_req *req);
+
 void obj_shard_decref(struct dc_obj_shard *shard);
 void obj_shard_addref(struct dc_obj_shard *shard);
 void obj_addref(struct dc_object *obj);
@@ -208,6 +313,7 @@ void obj_decref(struct dc_object *obj);
 void ds_obj_rw_handler(crt_rpc_t *rpc);
 void ds_obj_enum_handler(crt_rpc_t *rpc);
 void ds_obj_punch_handler(crt_rpc_t *rpc);
+void ds_obj_batch_handler(crt_rpc_t *rpc);
 
 ABT_pool
 ds_obj_abt_pool_choose_cb(crt_rpc_t *rpc, ABT_pool *pools);
@@ -41,6 +41,7 @@ static struct crt_msg_field *obj_rw_in_fields[] = {
 	&DMF_IOD_ARRAY, /* I/O descriptor array */
 	&DMF_SGL_ARRAY, /* scatter/gather array */
 	&CMF_BULK_ARRAY,    /* BULK ARRAY */
+	&DMF_REC_SIZE_ARRAY, /* offsets of sgls in packed bulk */
 };
 
 static struct crt_msg_field *obj_rw_out_fields[] = {
@@ -50,6 +51,27 @@ static struct crt_msg_field *obj_rw_out_fields[] = {
 	&DMF_REC_SIZE_ARRAY, /* actual size of records */
 	&DMF_NR_ARRAY, /* array of sgl nr */
 	&DMF_SGL_ARRAY, /* return buffer */
+	&DMF_CSUM_ARRAY, /* stored checksums */
+};
+
+static struct crt_msg_field *obj_batch_in_fields[] = {
+	&CMF_UUID,	/* container handle uuid */
+	&CMF_UUID,	/* container uuid */
+	&CMF_UINT32,	/* map_version */
+	&CMF_UINT32,	/* pad */
+	&DMF_OID_ARRAY,	/* object IDs */
+	&DMF_REC_SIZE_ARRAY, /* epochs */
+	&DMF_KEY_ARRAY,	/* dkeys */
+	&DMF_UINT32_ARRAY, /* number of iods of each update */
+	&DMF_IOD_ARRAY, /* I/O descriptors of all updates */
+	&DMF_SGL_ARRAY, /* sgls of all updates */
+};
+
+static struct crt_msg_field *obj_batch_out_fields[] = {
+	&CMF_INT,	/* status */
+	&CMF_UINT32,	/* map version */
+	&DMF_UINT32_ARRAY, /* status of each update */
+	&DMF_REC_SIZE_ARRAY, /* object attribute of each update */
 };
 
 static struct crt_msg_field *obj_key_enum_in_fields[] = {
@@ -137,6 +159,11 @@ static struct crt_req_format DQF_OBJ_PUNCH_AKEYS =
 			   obj_punch_in_fields,
 			   obj_punch_out_fields);
 
+static struct crt_req_format DQF_OBJ_UPDATE_BATCH =
+	DEFINE_CRT_REQ_FMT("DAOS_OBJ_UPDATE_BATCH",
+			   obj_batch_in_fields,
+			   obj_batch_out_fields);
+
 struct daos_rpc daos_obj_rpcs[] = {
 	{
 		.dr_name	= "DAOS_OBJ_UPDATE",
@@ -186,6 +213,12 @@ struct daos_rpc daos_obj_rpcs[] = {
 		.dr_ver		= 1,
 		.dr_flags	= 0,
 		.dr_req_fmt	= &DQF_OBJ_PUNCH_AKEYS,
+	}, {
+		.dr_name	= "DAOS_OBJ_UPDATE_BATCH",
+		.dr_opc		= DAOS_OBJ_RPC_UPDATE_BATCH,
+		.dr_ver		= 1,
+		.dr_flags	= 0,
+		.dr_req_fmt	= &DQF_OBJ_UPDATE_BATCH,
 	}, {
 		.dr_opc		= 0
 	}
@@ -225,6 +258,9 @@ obj_reply_set_status(crt_rpc_t *rpc, int status)
 	case DAOS_OBJ_RPC_PUNCH_AKEYS:
 		((struct obj_punch_out *)reply)->opo_ret = status;
 		break;
+	case DAOS_OBJ_RPC_UPDATE_BATCH:
+		((struct obj_batch_out *)reply)->obo_ret = status;
+		break;
 	default:
 		D_ASSERT(0);
 	}
@@ -247,6 +283,8 @@ obj_reply_get_status(crt_rpc_t *rpc)
 	case DAOS_OBJ_RPC_PUNCH_DKEYS:
 	case DAOS_OBJ_RPC_PUNCH_AKEYS:
 		return ((struct obj_punch_out *)reply)->opo_ret;
+	case DAOS_OBJ_RPC_UPDATE_BATCH:
+		return ((struct obj_batch_out *)reply)->obo_ret;
 	default:
 		D_ASSERT(0);
 	}
@@ -274,6 +312,10 @@ obj_reply_map_version_set(crt_rpc_t *rpc, uint32_t map_version)
 	case DAOS_OBJ_RPC_PUNCH_AKEYS:
 		((struct obj_punch_out *)reply)->opo_map_version = map_version;
 		break;
+	case DAOS_OBJ_RPC_UPDATE_BATCH:
+		((struct obj_batch_out *)reply)->obo_map_version =
+								map_version;
+		break;
 	default:
 		D_ASSERT(0);
 	}
@@ -296,6 +338,8 @@ obj_reply_map_version_get(crt_rpc_t *rpc)
 	case DAOS_OBJ_RPC_PUNCH_DKEYS:
 	case DAOS_OBJ_RPC_PUNCH_AKEYS:
 		return ((struct obj_punch_out *)reply)->opo_map_version;
+	case DAOS_OBJ_RPC_UPDATE_BATCH:
+		return ((struct obj_batch_out *)reply)->obo_map_version;
 	default:
 		D_ASSERT(0);
 	}
@@ -38,6 +38,15 @@
 #include <daos/rpc.h>
 
 #define OBJ_BULK_LIMIT	(4 * 1024) /* 4KB bytes */
+/** range of the adaptive threshold, see cli_bulk_adaptive */
+#define OBJ_BULK_LIMIT_MIN	(1 * 1024)
+#define OBJ_BULK_LIMIT_MAX	(64 * 1024)
+/** max size of an update whose sgls are packed into one bulk buffer */
+#define OBJ_BULK_PACK_MAX	(1024 * 1024)
+/** max number of updates in a batch, see cli_batch.c */
+#define OBJ_BATCH_MAX		64
+/** max size of inline data of a batch */
+#define OBJ_BATCH_SIZE_MAX	OBJ_BULK_LIMIT_MAX
 
 /*
  * RPC operation codes
@@ -54,6 +63,7 @@ enum obj_rpc_opc {
 	DAOS_OBJ_RPC_PUNCH		= 6,
 	DAOS_OBJ_RPC_PUNCH_DKEYS	= 7,
 	DAOS_OBJ_RPC_PUNCH_AKEYS	= 8,
+	DAOS_OBJ_RPC_UPDATE_BATCH	= 9,
 };
 
 struct obj_rw_in {
@@ -67,6 +77,11 @@ struct obj_rw_in {
 	struct crt_array	orw_iods;
 	struct crt_array	orw_sgls;
 	struct crt_array	orw_bulks;
+	/**
+	 * Offsets of sgls in the only bulk of \a orw_bulks if data of all
+	 * sgls are packed in one buffer, it is empty otherwise.
+	 */
+	struct crt_array	orw_bulk_offs;
 };
 
 /* reply for update/fetch */
@@ -77,6 +92,36 @@ struct obj_rw_out {
 	struct crt_array	orw_sizes;
 	struct crt_array	orw_nrs;
 	struct crt_array	orw_sgls;
+	/** stored checksums of all extents of all iods, for fetch only */
+	struct crt_array	orw_csums;
+};
+
+/**
+ * Batch of inline updates to the same target, which can be of different
+ * objects and dkeys of the container. The n-th update has the n-th element
+ * of \a obi_oids, \a obi_epochs, \a obi_dkeys and \a obi_nrs, its I/O
+ * descriptors and sgls are the next obi_nrs[n] elements of \a obi_iods and
+ * \a obi_sgls.
+ */
+struct obj_batch_in {
+	uuid_t			obi_co_hdl;
+	uuid_t			obi_co_uuid;
+	uint32_t		obi_map_ver;
+	uint32_t		obi_pad;
+	struct crt_array	obi_oids;
+	struct crt_array	obi_epochs;
+	struct crt_array	obi_dkeys;
+	struct crt_array	obi_nrs;
+	struct crt_array	obi_iods;
+	struct crt_array	obi_sgls;
+};
+
+/* reply for batch, with result and object attribute of each update */
+struct obj_batch_out {
+	int32_t			obo_ret;
+	uint32_t		obo_map_version;
+	struct crt_array	obo_rets;
+	struct crt_array	obo_attrs;
 };
 
 /* object Enumerate in/out */
@@ -31,6 +31,9 @@
 #include "obj_internal.h"
 
 bool srv_bypass_bulk;
+unsigned int srv_csum_sample = 1;
+daos_size_t srv_bulk_chunk = 1 << 20;
+daos_size_t srv_bulk_inflight_max = 16 << 20;
 
 static int
 obj_mod_init(void)
@@ -43,6 +46,26 @@ obj_mod_init(void)
 		srv_bypass_bulk = true;
 	}
 
+	env = getenv(CSUM_SAMPLE_ENV);
+	if (env) {
+		srv_csum_sample = atoi(env);
+		D_DEBUG(DB_IO, "Verify checksum of 1/%u updates\n",
+			srv_csum_sample);
+	}
+
+	env = getenv(BULK_CHUNK_ENV);
+	if (env) {
+		srv_bulk_chunk = (daos_size_t)atoi(env) << 10;
+		D_DEBUG(DB_IO, "Bulk chunk size "DF_U64"\n", srv_bulk_chunk);
+	}
+
+	env = getenv(BULK_INFLIGHT_ENV);
+	if (env) {
+		srv_bulk_inflight_max = (daos_size_t)atoi(env) << 20;
+		D_DEBUG(DB_IO, "Max in-flight bulk "DF_U64"\n",
+			srv_bulk_inflight_max);
+	}
+
 	dss_abt_pool_choose_cb_register(DAOS_OBJ_MODULE,
 					ds_obj_abt_pool_choose_cb);
 	return 0;
@@ -88,6 +111,10 @@ static struct daos_rpc_handler obj_handlers[] = {
 		.dr_opc		= DAOS_OBJ_RPC_PUNCH_AKEYS,
 		.dr_hdlr	= ds_obj_punch_handler,
 	},
+	{
+		.dr_opc		= DAOS_OBJ_RPC_UPDATE_BATCH,
+		.dr_hdlr	= ds_obj_batch_handler,
+	},
 	{
 		.dr_opc		= 0
 	}
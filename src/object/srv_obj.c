@@ -113,6 +113,11 @@ ds_obj_rw_complete(crt_rpc_t *rpc, struct ds_cont_hdl *cont_hdl,
 			D_FREE(orwo->orw_nrs.ca_arrays);
 			orwo->orw_nrs.ca_count = 0;
 		}
+
+		if (orwo->orw_csums.ca_arrays != NULL) {
+			D_FREE(orwo->orw_csums.ca_arrays);
+			orwo->orw_csums.ca_count = 0;
+		}
 	}
 }
 
@@ -197,10 +202,293 @@ bulk_bypass(daos_sg_list_t *sgl, crt_bulk_op_t bulk_op)
 	return 0;
 }
 
+/**
+ * Return the remote bulk handle of sgl \a idx and offset of the sgl in it,
+ * data of all sgls are in the first bulk if \a remote_offs is not NULL.
+ */
+static inline crt_bulk_t
+ds_bulk_remote(crt_bulk_t *remote_bulks, uint64_t *remote_offs,
+	       unsigned int idx, daos_size_t *offset)
+{
+	if (remote_offs == NULL) {
+		*offset = 0;
+		return remote_bulks[idx];
+	}
+	*offset = remote_offs[idx];
+	return remote_bulks[0];
+}
+
+/** max number of chunks in flight of a pipelined bulk transfer */
+#define DS_BULK_WINDOW		8
+
+/** a chunk of pipelined bulk transfer */
+struct ds_bulk_chunk {
+	ABT_eventual		 bc_eventual;
+	/** local bulk handle of the run of iovs this chunk belongs to */
+	crt_bulk_t		 bc_local_hdl;
+	/** it is the last chunk of the run, the handle is freed with it */
+	bool			 bc_hdl_last;
+	daos_size_t		 bc_len;
+	int			 bc_result;
+	/** records [bc_rec, bc_rec + bc_rec_nr) of sgl completed by it */
+	unsigned int		 bc_sgl_idx;
+	unsigned int		 bc_rec;
+	unsigned int		 bc_rec_nr;
+};
+
+struct ds_bulk_pipeline {
+	struct ds_bulk_chunk	 bp_chunks[DS_BULK_WINDOW];
+	daos_handle_t		 bp_ioh;
+	/** the oldest chunk in flight */
+	unsigned int		 bp_head;
+	/** number of chunks in flight */
+	unsigned int		 bp_nr;
+	int			 bp_result;
+};
+
+static int
+bulk_chunk_complete_cb(const struct crt_bulk_cb_info *cb_info)
+{
+	struct ds_bulk_chunk	*chunk = cb_info->bci_arg;
+	int			 rc = cb_info->bci_rc;
+
+	if (rc != 0)
+		D_ERROR("bulk transfer failed: rc = %d\n", rc);
+
+	chunk->bc_result = rc;
+	ABT_eventual_set(chunk->bc_eventual, NULL, 0);
+	crt_req_decref(cb_info->bci_bulk_desc->bd_rpc);
+	return rc;
+}
+
+/**
+ * Wait for the oldest chunk in flight, then flush records completed by it,
+ * which can yield, so it overlaps with transferring the following chunks.
+ */
+static int
+ds_bulk_chunk_wait(struct ds_bulk_pipeline *bp)
+{
+	struct ds_bulk_chunk	*chunk = &bp->bp_chunks[bp->bp_head];
+	int			 rc;
+
+	D_ASSERT(bp->bp_nr > 0);
+	rc = ABT_eventual_wait(chunk->bc_eventual, NULL);
+	if (rc != ABT_SUCCESS)
+		rc = dss_abterr2der(rc);
+	else
+		rc = chunk->bc_result;
+	ABT_eventual_free(&chunk->bc_eventual);
+
+	if (chunk->bc_hdl_last)
+		crt_bulk_free(chunk->bc_local_hdl);
+	obj_tls_get()->ot_bulk_inflight -= chunk->bc_len;
+	bp->bp_head = (bp->bp_head + 1) % DS_BULK_WINDOW;
+	bp->bp_nr--;
+
+	if (rc == 0 && bp->bp_result == 0 && chunk->bc_rec_nr != 0)
+		rc = vos_obj_zc_flush(bp->bp_ioh, chunk->bc_sgl_idx,
+				      chunk->bc_rec, chunk->bc_rec_nr);
+	if (bp->bp_result == 0)
+		bp->bp_result = rc;
+	return rc;
+}
+
+/**
+ * Make room for a chunk of \a len bytes: the window of this transfer must
+ * not be full, and bytes in flight on this xstream must be under the limit
+ * unless nothing is in flight.
+ */
+static void
+ds_bulk_chunk_throttle(struct ds_bulk_pipeline *bp, daos_size_t len)
+{
+	struct obj_tls	*tls = obj_tls_get();
+
+	while (bp->bp_nr == DS_BULK_WINDOW ||
+	       (bp->bp_nr > 0 &&
+		tls->ot_bulk_inflight + len > srv_bulk_inflight_max))
+		ds_bulk_chunk_wait(bp);
+
+	/* chunks of other ULTs on this xstream */
+	while (tls->ot_bulk_inflight != 0 &&
+	       tls->ot_bulk_inflight + len > srv_bulk_inflight_max)
+		ABT_thread_yield();
+}
+
+/**
+ * Pull data of a zero-copy update in chunks of \a srv_bulk_chunk, records
+ * are flushed to SCM or written to NVMe as soon as all their data landed,
+ * so persisting data overlaps with the network transfer.
+ */
+static int
+ds_bulk_transfer_pipeline(crt_rpc_t *rpc, crt_bulk_t *remote_bulks,
+			  uint64_t *remote_offs, daos_handle_t ioh, int sgl_nr)
+{
+	struct ds_bulk_pipeline	 bp;
+	struct obj_tls		*tls = obj_tls_get();
+	crt_bulk_opid_t		 bulk_opid;
+	int			 i;
+	int			 rc;
+
+	memset(&bp, 0, sizeof(bp));
+	bp.bp_ioh = ioh;
+
+	for (i = 0; i < sgl_nr && bp.bp_result == 0; i++) {
+		daos_sg_list_t	*sgl;
+		crt_bulk_t	 remote_bulk;
+		daos_size_t	 offset;
+		unsigned int	 idx = 0;
+
+		remote_bulk = ds_bulk_remote(remote_bulks, remote_offs, i,
+					     &offset);
+		if (remote_bulk == NULL)
+			continue;
+
+		rc = vos_obj_zc_sgl_at(ioh, i, &sgl);
+		if (rc) {
+			bp.bp_result = rc;
+			break;
+		}
+
+		while (idx < sgl->sg_nr_out && bp.bp_result == 0) {
+			daos_sg_list_t	 sgl_sent;
+			crt_bulk_t	 local_bulk_hdl;
+			daos_size_t	 length = 0;
+			daos_size_t	 coff;
+			daos_size_t	 rec_end;
+			unsigned int	 start;
+			unsigned int	 rec;
+
+			while (idx < sgl->sg_nr_out &&
+			       sgl->sg_iovs[idx].iov_buf == NULL) {
+				offset += sgl->sg_iovs[idx].iov_len;
+				idx++;
+			}
+
+			if (idx == sgl->sg_nr_out)
+				break;
+
+			start = idx;
+			while (idx < sgl->sg_nr_out &&
+			       sgl->sg_iovs[idx].iov_buf != NULL) {
+				length += sgl->sg_iovs[idx].iov_len;
+				idx++;
+			}
+
+			sgl_sent.sg_iovs = &sgl->sg_iovs[start];
+			sgl_sent.sg_nr = idx - start;
+			sgl_sent.sg_nr_out = idx - start;
+
+			rc = crt_bulk_create(rpc->cr_ctx,
+					     daos2crt_sg(&sgl_sent),
+					     CRT_BULK_RW, &local_bulk_hdl);
+			if (rc != 0) {
+				D_ERROR("crt_bulk_create %d failed;rc: %d\n",
+					i, rc);
+				bp.bp_result = rc;
+				break;
+			}
+
+			rec = start;
+			rec_end = sgl->sg_iovs[rec].iov_len;
+			for (coff = 0; coff < length; ) {
+				struct ds_bulk_chunk	*chunk;
+				struct crt_bulk_desc	 bulk_desc;
+				daos_size_t		 len;
+
+				len = min(length - coff, srv_bulk_chunk);
+				ds_bulk_chunk_throttle(&bp, len);
+				if (bp.bp_result != 0)
+					break;
+
+				chunk = &bp.bp_chunks[(bp.bp_head + bp.bp_nr) %
+						      DS_BULK_WINDOW];
+				chunk->bc_local_hdl = local_bulk_hdl;
+				chunk->bc_hdl_last = (coff + len == length);
+				chunk->bc_len = len;
+				chunk->bc_result = 0;
+				chunk->bc_sgl_idx = i;
+				chunk->bc_rec = rec;
+				while (rec < idx && rec_end <= coff + len) {
+					if (++rec < idx)
+						rec_end +=
+						    sgl->sg_iovs[rec].iov_len;
+				}
+				chunk->bc_rec_nr = rec - chunk->bc_rec;
+
+				rc = ABT_eventual_create(0, &chunk->bc_eventual);
+				if (rc != ABT_SUCCESS) {
+					bp.bp_result = dss_abterr2der(rc);
+					break;
+				}
+
+				crt_req_addref(rpc);
+				bulk_desc.bd_rpc	= rpc;
+				bulk_desc.bd_bulk_op	= CRT_BULK_GET;
+				bulk_desc.bd_remote_hdl	= remote_bulk;
+				bulk_desc.bd_local_hdl	= local_bulk_hdl;
+				bulk_desc.bd_len	= len;
+				bulk_desc.bd_remote_off	= offset + coff;
+				bulk_desc.bd_local_off	= coff;
+
+				rc = crt_bulk_transfer(&bulk_desc,
+						       bulk_chunk_complete_cb,
+						       chunk, &bulk_opid);
+				if (rc < 0) {
+					D_ERROR("crt_bulk_transfer failed, "
+						"rc: %d.\n", rc);
+					crt_req_decref(rpc);
+					ABT_eventual_free(&chunk->bc_eventual);
+					bp.bp_result = rc;
+					break;
+				}
+				tls->ot_bulk_inflight += len;
+				bp.bp_nr++;
+				coff += len;
+			}
+
+			/* failed, the last chunk of the run is not in flight,
+			 * drain the in-flight ones and free the handle.
+			 */
+			while (coff < length && bp.bp_nr > 0)
+				ds_bulk_chunk_wait(&bp);
+			if (coff < length || length == 0)
+				crt_bulk_free(local_bulk_hdl);
+			offset += length;
+		}
+	}
+
+	while (bp.bp_nr > 0)
+		ds_bulk_chunk_wait(&bp);
+	return bp.bp_result;
+}
+
+/** total size of the zero-copy buffers to be transferred */
+static daos_size_t
+ds_bulk_size(crt_bulk_t *remote_bulks, uint64_t *remote_offs,
+	     daos_handle_t ioh, int sgl_nr)
+{
+	daos_sg_list_t	*sgl;
+	daos_size_t	 size = 0;
+	daos_size_t	 offset;
+	int		 i;
+	int		 j;
+
+	for (i = 0; i < sgl_nr; i++) {
+		if (ds_bulk_remote(remote_bulks, remote_offs, i,
+				   &offset) == NULL ||
+		    vos_obj_zc_sgl_at(ioh, i, &sgl) != 0)
+			continue;
+
+		for (j = 0; j < sgl->sg_nr_out; j++)
+			size += sgl->sg_iovs[j].iov_len;
+	}
+	return size;
+}
+
 static int
 ds_bulk_transfer(crt_rpc_t *rpc, crt_bulk_op_t bulk_op,
-		 crt_bulk_t *remote_bulks, daos_handle_t ioh,
-		 daos_sg_list_t **sgls, int sgl_nr)
+		 crt_bulk_t *remote_bulks, uint64_t *remote_offs,
+		 daos_handle_t ioh, daos_sg_list_t **sgls, int sgl_nr)
 {
 	crt_bulk_opid_t		bulk_opid;
 	crt_bulk_perm_t		bulk_perm;
@@ -209,6 +497,13 @@ ds_bulk_transfer(crt_rpc_t *rpc, crt_bulk_op_t bulk_op,
 	int			rc;
 	int			*status;
 
+	if (bulk_op == CRT_BULK_GET && sgls == NULL && !srv_bypass_bulk &&
+	    srv_bulk_chunk != 0 &&
+	    ds_bulk_size(remote_bulks, remote_offs, ioh, sgl_nr) >
+	    srv_bulk_chunk)
+		return ds_bulk_transfer_pipeline(rpc, remote_bulks,
+						 remote_offs, ioh, sgl_nr);
+
 	bulk_perm = bulk_op == CRT_BULK_PUT ? CRT_BULK_RO : CRT_BULK_RW;
 	rc = ABT_eventual_create(sizeof(*status), &arg.eventual);
 	if (rc != 0)
@@ -218,11 +513,14 @@ ds_bulk_transfer(crt_rpc_t *rpc, crt_bulk_op_t bulk_op,
 		daos_sg_list_t		*sgl;
 		struct crt_bulk_desc	 bulk_desc;
 		crt_bulk_t		 local_bulk_hdl;
+		crt_bulk_t		 remote_bulk;
 		int			 ret = 0;
-		daos_size_t		 offset = 0;
+		daos_size_t		 offset;
 		unsigned int		 idx = 0;
 
-		if (remote_bulks[i] == NULL)
+		remote_bulk = ds_bulk_remote(remote_bulks, remote_offs, i,
+					     &offset);
+		if (remote_bulk == NULL)
 			continue;
 
 		if (sgls != NULL) {
@@ -303,7 +601,7 @@ ds_bulk_transfer(crt_rpc_t *rpc, crt_bulk_op_t bulk_op,
 
 			bulk_desc.bd_rpc	= rpc;
 			bulk_desc.bd_bulk_op	= bulk_op;
-			bulk_desc.bd_remote_hdl	= remote_bulks[i];
+			bulk_desc.bd_remote_hdl	= remote_bulk;
 			bulk_desc.bd_local_hdl	= local_bulk_hdl;
 			bulk_desc.bd_len	= length;
 			bulk_desc.bd_remote_off	= offset;
@@ -341,6 +639,18 @@ out_eventual:
 	return rc;
 }
 
+/** offsets of sgls in the packed bulk, or NULL if sgls have their own bulk */
+static uint64_t *
+ds_obj_bulk_offs(struct obj_rw_in *orw)
+{
+	if (orw->orw_bulk_offs.ca_count == 0 ||
+	    orw->orw_bulk_offs.ca_count != orw->orw_nr ||
+	    orw->orw_bulks.ca_count != 1)
+		return NULL;
+
+	return orw->orw_bulk_offs.ca_arrays;
+}
+
 static int
 ds_sgls_prep(daos_sg_list_t *dst_sgls, daos_sg_list_t *sgls, int number)
 {
@@ -447,18 +757,163 @@ out:
 	return rc;
 }
 
+/**
+ * Checksums are only stored and returned for container handles opened with
+ * DAOS_COO_CSUM, checksums sent through other handles are ignored.
+ */
+static void
+ds_obj_csums_ignore(struct obj_rw_in *orw)
+{
+	daos_iod_t	*iods = orw->orw_iods.ca_arrays;
+	int		 i;
+	int		 j;
+
+	for (i = 0; i < orw->orw_nr; i++) {
+		if (iods[i].iod_csums == NULL)
+			continue;
+
+		/* NB: keep the buffers, they are released with the RPC */
+		for (j = 0; j < obj_iod_csum_nr(&iods[i]); j++)
+			iods[i].iod_csums[j].cs_len = 0;
+	}
+}
+
+/** I/O descriptor with less data is checksummed by the RPC handler itself */
+#define SRV_CSUM_OFFLOAD_MIN	(64ULL << 10)
+
+/**
+ * Compute checksums of ranges of \a sgl for verification. Large ranges are
+ * offloaded by dss_acc_offload(), so the xstream can serve other requests
+ * meanwhile.
+ */
 static int
-ds_obj_rw_inline(crt_rpc_t *rpc, struct ds_cont *cont, uuid_t cookie,
-		 uint32_t pm_ver)
+ds_obj_csum_compute(daos_csum_t *csum, daos_sg_list_t *sgl, unsigned int nr,
+		    daos_size_t *lens, daos_csum_buf_t *csums)
+{
+	struct dss_acc_csum	ac;
+	struct dss_acc_task	at;
+	daos_size_t		total = 0;
+	int			i;
+
+	for (i = 0; i < nr; i++)
+		total += lens[i];
+
+	if (total < SRV_CSUM_OFFLOAD_MIN || dss_get_threads_number() < 2)
+		return daos_csum_compute_ranges(csum, sgl, nr, lens, csums);
+
+	memset(&ac, 0, sizeof(ac));
+	ac.ac_csum	= csum;
+	ac.ac_sgl	= sgl;
+	ac.ac_csums	= csums;
+	ac.ac_lens	= lens;
+	ac.ac_nr	= nr;
+
+	memset(&at, 0, sizeof(at));
+	at.at_offload_type	= DSS_OFFLOAD_ULT;
+	at.at_opcode		= DSS_ACC_OP_CSUM;
+	at.at_params		= &ac;
+	return dss_acc_offload(&at);
+}
+
+/**
+ * Verify checksums carried by I/O descriptors of an update against data in
+ * \a sgls for inline transfer, or in zero-copy buffers of \a ioh for bulk
+ * transfer, before the update is submitted to VOS. Only one in every
+ * srv_csum_sample updates is verified.
+ */
+static int
+ds_obj_csum_verify(struct obj_rw_in *orw, daos_handle_t ioh,
+		   daos_sg_list_t *sgls)
+{
+	struct obj_tls	*tls;
+	daos_iod_t	*iods = orw->orw_iods.ca_arrays;
+	daos_sg_list_t	*sgl;
+	int		 i;
+	int		 rc;
+
+	if (srv_csum_sample == 0 || srv_bypass_bulk)
+		return 0;
+
+	tls = obj_tls_get();
+	if (tls->ot_csum_count++ % srv_csum_sample != 0)
+		return 0;
+
+	for (i = 0; i < orw->orw_nr; i++) {
+		if (sgls != NULL) {
+			sgl = &sgls[i];
+		} else {
+			rc = vos_obj_zc_sgl_at(ioh, i, &sgl);
+			if (rc != 0)
+				return rc;
+		}
+
+		rc = obj_iod_csum_verify(&iods[i], sgl, ds_obj_csum_compute);
+		if (rc != 0) {
+			D_ERROR(DF_UOID" checksum verification failed: %d\n",
+				DP_UOID(orw->orw_oid), rc);
+			return rc;
+		}
+	}
+	return 0;
+}
+
+/**
+ * Return checksums fetched from VOS to client, checksums of all extents of
+ * all I/O descriptors are packed in one array.
+ */
+static int
+ds_obj_update_csums_in_reply(crt_rpc_t *rpc)
+{
+	struct obj_rw_in	*orw = crt_req_get(rpc);
+	struct obj_rw_out	*orwo = crt_reply_get(rpc);
+	daos_iod_t		*iods = orw->orw_iods.ca_arrays;
+	daos_csum_buf_t		*csums;
+	unsigned int		 total;
+	int			 i;
+
+	for (i = total = 0; i < orw->orw_nr; i++) {
+		if (iods[i].iod_csums == NULL)
+			return 0; /* client doesn't want checksums */
+		total += obj_iod_csum_nr(&iods[i]);
+	}
+
+	if (total == 0)
+		return 0;
+
+	D_ALLOC(csums, total * sizeof(*csums));
+	if (csums == NULL)
+		return -DER_NOMEM;
+
+	orwo->orw_csums.ca_count = total;
+	orwo->orw_csums.ca_arrays = csums;
+	for (i = 0; i < orw->orw_nr; i++) {
+		/* NB: checksum buffers of the request are referenced */
+		memcpy(csums, iods[i].iod_csums,
+		       obj_iod_csum_nr(&iods[i]) * sizeof(*csums));
+		csums += obj_iod_csum_nr(&iods[i]);
+	}
+	return 0;
+}
+
+static int
+ds_obj_rw_inline(crt_rpc_t *rpc, struct ds_cont_hdl *cont_hdl,
+		 struct ds_cont *cont, uint32_t pm_ver)
 {
 	struct obj_rw_in	*orw = crt_req_get(rpc);
 	daos_sg_list_t		*sgls = orw->orw_sgls.ca_arrays;
+	bool			csum = cont_hdl->sch_capas & DAOS_COO_CSUM;
 	int			rc;
 
 	if (opc_get(rpc->cr_opc) == DAOS_OBJ_RPC_UPDATE) {
+		if (csum) {
+			rc = ds_obj_csum_verify(orw, DAOS_HDL_INVAL, sgls);
+			if (rc != 0)
+				D_GOTO(out, rc);
+		}
+
 		rc = vos_obj_update(cont->sc_hdl, orw->orw_oid, orw->orw_epoch,
-				    cookie, pm_ver, &orw->orw_dkey, orw->orw_nr,
-				    orw->orw_iods.ca_arrays, sgls);
+				    cont_hdl->sch_uuid, pm_ver, &orw->orw_dkey,
+				    orw->orw_nr, orw->orw_iods.ca_arrays, sgls);
 	} else {
 		struct obj_rw_out *orwo;
 
@@ -479,6 +934,9 @@ ds_obj_rw_inline(crt_rpc_t *rpc, struct ds_cont *cont, uuid_t cookie,
 		rc = ds_obj_update_sizes_in_reply(rpc);
 		if (rc != 0)
 			D_GOTO(out, rc);
+
+		if (csum)
+			rc = ds_obj_update_csums_in_reply(rpc);
 	}
 out:
 	D_DEBUG(DB_IO, "obj"DF_OID" rw inline rc = %d\n",
@@ -623,7 +1081,8 @@ ds_obj_rw_echo_handler(crt_rpc_t *rpc)
 	}
 
 	rc = ds_bulk_transfer(rpc, bulk_op, orw->orw_bulks.ca_arrays,
-			      DAOS_HDL_INVAL, &p_sgl, orw->orw_nr);
+			      ds_obj_bulk_offs(orw), DAOS_HDL_INVAL, &p_sgl,
+			      orw->orw_nr);
 
 out:
 	orwo->orw_ret = rc;
@@ -668,10 +1127,12 @@ ds_obj_rw_handler(crt_rpc_t *rpc)
 
 	D_DEBUG(DB_TRACE, "opc %d "DF_UOID" tag %d\n", opc_get(rpc->cr_opc),
 		DP_UOID(orw->orw_oid), dss_get_module_info()->dmi_tid);
+	if (!(cont_hdl->sch_capas & DAOS_COO_CSUM))
+		ds_obj_csums_ignore(orw);
+
 	/* Inline update/fetch */
 	if (orw->orw_bulks.ca_arrays == NULL && orw->orw_bulks.ca_count == 0) {
-		rc = ds_obj_rw_inline(rpc, cont, cont_hdl->sch_uuid,
-				      map_version);
+		rc = ds_obj_rw_inline(rpc, cont_hdl, cont, map_version);
 		D_GOTO(out, rc);
 	}
 
@@ -716,10 +1177,21 @@ ds_obj_rw_handler(crt_rpc_t *rpc)
 		rc = ds_obj_update_nrs_in_reply(rpc, ioh, NULL);
 		if (rc != 0)
 			D_GOTO(out, rc);
+
+		if (cont_hdl->sch_capas & DAOS_COO_CSUM) {
+			rc = ds_obj_update_csums_in_reply(rpc);
+			if (rc != 0)
+				D_GOTO(out, rc);
+		}
 	}
 
 	rc = ds_bulk_transfer(rpc, bulk_op, orw->orw_bulks.ca_arrays,
-			      ioh, NULL, orw->orw_nr);
+			      ds_obj_bulk_offs(orw), ioh, NULL, orw->orw_nr);
+
+	/* verify data before submitting it by vos_obj_zc_update_end() */
+	if (rc == 0 && bulk_op == CRT_BULK_GET &&
+	    (cont_hdl->sch_capas & DAOS_COO_CSUM))
+		rc = ds_obj_csum_verify(orw, ioh, NULL);
 out:
 	ds_obj_rw_complete(rpc, cont_hdl, ioh, rc, map_version);
 	if (cont_hdl) {
@@ -729,6 +1201,127 @@ out:
 	}
 }
 
+/** Apply the \a idx-th update of a batch, whose iods start at \a iod_idx */
+static int
+ds_obj_batch_update(struct obj_batch_in *obi, struct ds_cont_hdl *cont_hdl,
+		    struct ds_cont *cont, uint32_t map_version,
+		    unsigned int idx, unsigned int iod_idx, uint64_t *attr)
+{
+	struct obj_rw_in	orw;
+	daos_unit_oid_t		*oids = obi->obi_oids.ca_arrays;
+	uint64_t		*epochs = obi->obi_epochs.ca_arrays;
+	daos_key_t		*dkeys = obi->obi_dkeys.ca_arrays;
+	uint32_t		*nrs = obi->obi_nrs.ca_arrays;
+	daos_iod_t		*iods = obi->obi_iods.ca_arrays;
+	daos_sg_list_t		*sgls = obi->obi_sgls.ca_arrays;
+	int			rc;
+
+	/* the checksum helpers take a regular update */
+	memset(&orw, 0, sizeof(orw));
+	orw.orw_oid = oids[idx];
+	orw.orw_epoch = epochs[idx];
+	orw.orw_nr = nrs[idx];
+	orw.orw_iods.ca_count = nrs[idx];
+	orw.orw_iods.ca_arrays = &iods[iod_idx];
+
+	if (!(cont_hdl->sch_capas & DAOS_COO_CSUM)) {
+		ds_obj_csums_ignore(&orw);
+	} else {
+		rc = ds_obj_csum_verify(&orw, DAOS_HDL_INVAL, &sgls[iod_idx]);
+		if (rc != 0)
+			return rc;
+	}
+
+	rc = vos_obj_update(cont->sc_hdl, orw.orw_oid, orw.orw_epoch,
+			    cont_hdl->sch_uuid, map_version, &dkeys[idx],
+			    orw.orw_nr, &iods[iod_idx], &sgls[iod_idx]);
+	if (rc != 0)
+		return rc;
+
+	return vos_oi_get_attr(cont->sc_hdl, orw.orw_oid, orw.orw_epoch, attr);
+}
+
+/**
+ * Handler of a batch of inline updates to this target, see obj_batch_in.
+ * A failed update doesn't stop the others, its own result is returned in
+ * \a obo_rets, while \a obo_ret is only set if the whole batch fails.
+ */
+void
+ds_obj_batch_handler(crt_rpc_t *rpc)
+{
+	struct obj_batch_in	*obi = crt_req_get(rpc);
+	struct obj_batch_out	*obo = crt_reply_get(rpc);
+	struct ds_cont_hdl	*cont_hdl = NULL;
+	struct ds_cont		*cont = NULL;
+	uint32_t		*nrs;
+	uint32_t		*rets = NULL;
+	uint64_t		*attrs = NULL;
+	uint32_t		map_version = 0;
+	unsigned int		nr;
+	unsigned int		iod_nr;
+	unsigned int		i;
+	int			rc;
+
+	nr = obi->obi_oids.ca_count;
+	nrs = obi->obi_nrs.ca_arrays;
+	if (obi->obi_epochs.ca_count != nr || obi->obi_dkeys.ca_count != nr ||
+	    obi->obi_nrs.ca_count != nr)
+		D_GOTO(out, rc = -DER_PROTO);
+
+	for (i = 0, iod_nr = 0; i < nr; i++)
+		iod_nr += nrs[i];
+	if (obi->obi_iods.ca_count != iod_nr ||
+	    obi->obi_sgls.ca_count != iod_nr)
+		D_GOTO(out, rc = -DER_PROTO);
+
+	rc = ds_check_container(obi->obi_co_hdl, obi->obi_co_uuid,
+				&cont_hdl, &cont);
+	if (rc)
+		D_GOTO(out, rc);
+
+	if (!(cont_hdl->sch_capas & DAOS_COO_RW))
+		D_GOTO(out, rc = -DER_NO_PERM);
+
+	D_ASSERT(cont_hdl->sch_pool != NULL);
+	map_version = cont_hdl->sch_pool->spc_map_version;
+	if (obi->obi_map_ver < map_version) {
+		D_DEBUG(DB_IO, "stale version req %d map_version %d\n",
+			obi->obi_map_ver, map_version);
+	}
+
+	D_ALLOC(rets, nr * sizeof(*rets));
+	D_ALLOC(attrs, nr * sizeof(*attrs));
+	if (rets == NULL || attrs == NULL)
+		D_GOTO(out, rc = -DER_NOMEM);
+
+	D_DEBUG(DB_TRACE, "batch of %u updates tag %d\n", nr,
+		dss_get_module_info()->dmi_tid);
+	for (i = 0, iod_nr = 0; i < nr; i++) {
+		rets[i] = ds_obj_batch_update(obi, cont_hdl, cont, map_version,
+					      i, iod_nr, &attrs[i]);
+		iod_nr += nrs[i];
+	}
+
+	obo->obo_rets.ca_count = nr;
+	obo->obo_rets.ca_arrays = rets;
+	obo->obo_attrs.ca_count = nr;
+	obo->obo_attrs.ca_arrays = attrs;
+out:
+	obj_reply_set_status(rpc, rc);
+	obj_reply_map_version_set(rpc, map_version);
+	rc = crt_reply_send(rpc);
+	if (rc != 0)
+		D_ERROR("send reply failed: %d\n", rc);
+
+	D_FREE(rets);
+	D_FREE(attrs);
+	if (cont_hdl) {
+		if (!cont_hdl->sch_cont)
+			ds_cont_put(cont); /* -1 for rebuild container */
+		ds_cont_hdl_put(cont_hdl);
+	}
+}
+
 static void
 ds_eu_complete(crt_rpc_t *rpc, int status, uint32_t map_version)
 {
@@ -1103,7 +1696,7 @@ ds_obj_enum_handler(crt_rpc_t *rpc)
 	if (oei->oei_bulk != NULL) {
 		daos_sg_list_t *sgl = &oeo->oeo_sgl;
 
-		rc = ds_bulk_transfer(rpc, CRT_BULK_PUT, &oei->oei_bulk,
+		rc = ds_bulk_transfer(rpc, CRT_BULK_PUT, &oei->oei_bulk, NULL,
 				      DAOS_HDL_INVAL, &sgl, 1);
 
 		/* If the keys will be replied by bulk, then let's empty
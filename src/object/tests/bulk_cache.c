@@ -0,0 +1,217 @@
+/**
+ * (C) Copyright 2018 Intel Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * GOVERNMENT LICENSE RIGHTS-OPEN SOURCE SOFTWARE
+ * The Government's rights to use, modify, reproduce, release, perform, display,
+ * or disclose this software are subject to the terms of the Apache License as
+ * provided in Contract No. B609815.
+ * Any reproduction of computer software, computer software documentation, or
+ * portions thereof marked with this legend must also reproduce the markings.
+ */
+/**
+ * Unit test of the registration cache of client bulk buffers, bulk handles
+ * are faked so the test doesn't need the network.
+ *
+ * object/tests/bulk_cache.c
+ */
+#define D_LOGFAC	DD_FAC(tests)
+
+#include <daos/common.h>
+#include <daos/object.h>
+#include "../obj_rpc.h"
+#include "../obj_internal.h"
+
+/** budget of the cache in MB */
+#define BC_BUDGET_MB	1
+#define BC_BUF_SIZE	(4 << 10)
+/** buffers cost twice of the budget */
+#define BC_BUF_NR	((BC_BUDGET_MB << 20) * 2 / BC_BUF_SIZE)
+
+/** number of registered and freed (faked) bulk handles */
+static int	bc_created;
+static int	bc_freed;
+
+int
+crt_bulk_create(crt_context_t crt_ctx, d_sg_list_t *sgl,
+		crt_bulk_perm_t bulk_perm, crt_bulk_t *bulk_hdl)
+{
+	bc_created++;
+	*bulk_hdl = (crt_bulk_t)(uintptr_t)bc_created;
+	return 0;
+}
+
+int
+crt_bulk_free(crt_bulk_t bulk_hdl)
+{
+	bc_freed++;
+	return 0;
+}
+
+static void
+bc_sgl_init(daos_sg_list_t *sgl, daos_iov_t *iov, char *buf)
+{
+	daos_iov_set(iov, buf, BC_BUF_SIZE);
+	sgl->sg_nr = sgl->sg_nr_out = 1;
+	sgl->sg_iovs = iov;
+}
+
+/** register \a buf, then release it if \a entp is NULL */
+static crt_bulk_t
+bc_bulk_get(char *buf, struct obj_bulk_ent **entp)
+{
+	struct obj_bulk_ent	*ent;
+	daos_sg_list_t		 sgl;
+	daos_iov_t		 iov;
+	crt_bulk_t		 bulk;
+	int			 rc;
+
+	bc_sgl_init(&sgl, &iov, buf);
+	rc = obj_bulk_create((crt_context_t)1, &sgl, CRT_BULK_RW, &bulk,
+			     &ent);
+	D_ASSERT(rc == 0);
+	D_ASSERT(ent != NULL);
+
+	if (entp != NULL)
+		*entp = ent;
+	else
+		obj_bulk_free(bulk, ent);
+	return bulk;
+}
+
+static void
+bc_stat(daos_obj_buf_stat_t *stat)
+{
+	int	rc;
+
+	rc = dc_obj_buf_query(stat);
+	D_ASSERT(rc == 0);
+	D_PRINT("hits "DF_U64", misses "DF_U64", evictions "DF_U64
+		", invalidated "DF_U64", cached "DF_U64"/"DF_U64" bytes\n",
+		stat->bs_hits, stat->bs_misses, stat->bs_evictions,
+		stat->bs_invalidated, stat->bs_nr, stat->bs_bytes);
+}
+
+/** the second I/O from the same buffer reuses the registration */
+static void
+bc_hit_test(char *buf)
+{
+	daos_obj_buf_stat_t	stat;
+	crt_bulk_t		bulk;
+
+	D_PRINT("Hit and miss\n");
+	bulk = bc_bulk_get(buf, NULL);
+	D_ASSERT(bc_bulk_get(buf, NULL) == bulk);
+
+	bc_stat(&stat);
+	D_ASSERT(stat.bs_misses == 1 && stat.bs_hits == 1);
+	D_ASSERT(stat.bs_nr == 1 && stat.bs_bytes == BC_BUF_SIZE);
+	D_ASSERT(bc_created == 1 && bc_freed == 0);
+}
+
+/** idle registrations are dropped once they exceed the budget */
+static void
+bc_evict_test(char *bufs)
+{
+	daos_obj_buf_stat_t	stat;
+	int			i;
+
+	D_PRINT("Eviction\n");
+	for (i = 0; i < BC_BUF_NR; i++)
+		bc_bulk_get(&bufs[i * BC_BUF_SIZE], NULL);
+
+	bc_stat(&stat);
+	D_ASSERT(stat.bs_evictions > 0);
+	D_ASSERT(stat.bs_bytes <= (BC_BUDGET_MB << 20));
+	D_ASSERT(bc_created - bc_freed == stat.bs_nr);
+}
+
+/**
+ * Invalidation drops idle registrations at once, and a registration in use
+ * when its buffer is released, it is freed once no reader can see it.
+ */
+static void
+bc_invalidate_test(char *idle, char *busy)
+{
+	daos_obj_buf_stat_t	 stat;
+	struct obj_bulk_ent	*ent;
+	crt_bulk_t		 bulk;
+	uint64_t		 misses;
+	uint64_t		 nr;
+	int			 freed;
+
+	D_PRINT("Invalidation\n");
+	bc_bulk_get(idle, NULL);
+	bulk = bc_bulk_get(busy, &ent);
+	bc_stat(&stat);
+	misses = stat.bs_misses;
+	nr = stat.bs_nr;
+
+	/* invalidate part of the idle buffer */
+	freed = bc_freed;
+	dc_obj_buf_invalidate(idle + BC_BUF_SIZE / 2, 1);
+	D_ASSERT(bc_freed == freed + 1);
+
+	dc_obj_buf_invalidate(busy, BC_BUF_SIZE);
+	D_ASSERT(bc_freed == freed + 1);
+	/* invalidating it again doesn't count twice */
+	dc_obj_buf_invalidate(busy, BC_BUF_SIZE);
+	obj_bulk_free(bulk, ent);
+
+	bc_stat(&stat);
+	D_ASSERT(stat.bs_invalidated == 2);
+	D_ASSERT(stat.bs_nr == nr - 2);
+
+	/* both of them are registered again */
+	bc_bulk_get(idle, NULL);
+	bc_bulk_get(busy, NULL);
+	bc_stat(&stat);
+	D_ASSERT(stat.bs_misses == misses + 2);
+}
+
+int
+main(int argc, char **argv)
+{
+	char	*bufs;
+	char	 budget[16];
+	int	 rc;
+
+	rc = daos_debug_init(NULL);
+	if (rc != 0)
+		return rc;
+
+	snprintf(budget, sizeof(budget), "%d", BC_BUDGET_MB);
+	setenv(BULK_CACHE_ENV, budget, 1);
+	rc = obj_bulk_cache_init();
+	D_ASSERT(rc == 0);
+
+	D_ALLOC(bufs, (BC_BUF_NR + 2) * BC_BUF_SIZE);
+	D_ASSERT(bufs != NULL);
+
+	/* a few registrations are far below the budget, nothing is evicted
+	 * before the eviction test
+	 */
+	bc_hit_test(bufs);
+	bc_invalidate_test(&bufs[BC_BUF_NR * BC_BUF_SIZE],
+			   &bufs[(BC_BUF_NR + 1) * BC_BUF_SIZE]);
+	bc_evict_test(bufs);
+
+	obj_bulk_cache_fini();
+	D_ASSERT(bc_created == bc_freed);
+	D_FREE(bufs);
+
+	D_PRINT("Bulk cache test passed\n");
+	daos_debug_fini();
+	return 0;
+}
@@ -25,11 +25,18 @@
 #include <daos/common.h>
 #include <daos/placement.h>
 #include <daos.h>
+#include <daos/tests_lib.h>
 
 #define DOM_NR		8
 #define	TARGET_PER_DOM	4
 #define VOS_PER_TARGET	8
 
+#define PERF_OBJ_NR	512
+#define PERF_LOOP	64
+
+#define CMP_OBJ_NR	8192
+#define CMP_FAIL_TGT	5
+
 static struct pool_map		*po_map;
 static struct pl_map		*pl_map;
 static struct pool_component	 comps[DOM_NR + DOM_NR * TARGET_PER_DOM];
@@ -59,6 +66,183 @@ plt_obj_place(daos_obj_id_t oid)
 	return 0;
 }
 
+static double
+plt_obj_place_loop(struct daos_obj_md *mds, struct pl_obj_layout **layouts,
+		   int loop)
+{
+	struct pl_obj_layout	*layout;
+	double			 then;
+	int			 i;
+	int			 j;
+	int			 rc;
+
+	then = dts_time_now();
+	for (i = 0; i < loop; i++) {
+		for (j = 0; j < PERF_OBJ_NR; j++) {
+			rc = pl_obj_place(pl_map, &mds[j], NULL, &layout);
+			D_ASSERT(rc == 0);
+
+			if (layouts[j] == NULL) { /* the first (cold) pass */
+				layouts[j] = layout;
+				continue;
+			}
+			/* cached layout must be the same as the computed one */
+			D_ASSERT(layout->ol_nr == layouts[j]->ol_nr);
+			D_ASSERT(memcmp(layout->ol_shards,
+					layouts[j]->ol_shards,
+					layout->ol_nr *
+					sizeof(*layout->ol_shards)) == 0);
+			pl_obj_layout_free(layout);
+		}
+	}
+	return (double)loop * PERF_OBJ_NR / (dts_time_now() - then);
+}
+
+/** placements per second of the first and repeated placements of objects */
+static void
+plt_obj_place_perf(void)
+{
+	struct daos_obj_md	*mds;
+	struct pl_obj_layout	**layouts;
+	double			 cold;
+	double			 warm;
+	int			 i;
+
+	D_ALLOC(mds, PERF_OBJ_NR * sizeof(*mds));
+	D_ALLOC(layouts, PERF_OBJ_NR * sizeof(*layouts));
+	D_ASSERT(mds != NULL && layouts != NULL);
+
+	for (i = 0; i < PERF_OBJ_NR; i++) {
+		mds[i].omd_id.lo = i + 1;
+		mds[i].omd_id.hi = 5;
+		mds[i].omd_ver	 = 1;
+		daos_obj_id_generate(&mds[i].omd_id, 0, DAOS_OC_SMALL_RW);
+	}
+
+	cold = plt_obj_place_loop(mds, layouts, 1);
+	warm = plt_obj_place_loop(mds, layouts, PERF_LOOP);
+	D_PRINT("Placement of %d objects: cold %.0f/sec, warm %.0f/sec\n",
+		PERF_OBJ_NR, cold, warm);
+
+	for (i = 0; i < PERF_OBJ_NR; i++)
+		pl_obj_layout_free(layouts[i]);
+	D_FREE(layouts);
+	D_FREE(mds);
+}
+
+/** place \a CMP_OBJ_NR objects, return placements per second */
+static double
+plt_map_place_all(struct pl_map *map, uint32_t *tgts, unsigned int *shard_nr)
+{
+	struct pl_obj_layout	*layout;
+	struct daos_obj_md	 md;
+	double			 then;
+	int			 i;
+	int			 j;
+	int			 rc;
+
+	memset(&md, 0, sizeof(md));
+	md.omd_ver = 1;
+
+	then = dts_time_now();
+	for (i = 0; i < CMP_OBJ_NR; i++) {
+		md.omd_id.lo = i + 1;
+		md.omd_id.hi = 7;
+		daos_obj_id_generate(&md.omd_id, 0, DAOS_OC_R3_RW);
+
+		rc = pl_obj_place(map, &md, NULL, &layout);
+		D_ASSERT(rc == 0);
+
+		*shard_nr = layout->ol_nr;
+		for (j = 0; j < layout->ol_nr; j++)
+			tgts[i * layout->ol_nr + j] =
+				layout->ol_shards[j].po_target;
+		pl_obj_layout_free(layout);
+	}
+	return CMP_OBJ_NR / (dts_time_now() - then);
+}
+
+/**
+ * Compare placement maps of type \a type: placement speed, balance of shards
+ * over targets, and shards moved by excluding one target.
+ */
+static void
+plt_map_compare(pl_map_type_t type, const char *name, uint32_t *version)
+{
+	struct pl_map_init_attr	 mia;
+	struct pl_map		*map;
+	struct pool_target	*tgt;
+	uint32_t		*before;
+	uint32_t		*after;
+	unsigned int		 counts[DOM_NR * TARGET_PER_DOM] = { 0 };
+	unsigned int		 shard_nr;
+	unsigned int		 max = 0;
+	unsigned int		 min = -1;
+	unsigned int		 moved = 0;
+	unsigned int		 on_failed = 0;
+	double			 rate;
+	double			 avg;
+	int			 i;
+	int			 rc;
+
+	D_ALLOC(before, CMP_OBJ_NR * DOM_NR * sizeof(*before));
+	D_ALLOC(after, CMP_OBJ_NR * DOM_NR * sizeof(*after));
+	D_ASSERT(before != NULL && after != NULL);
+
+	memset(&mia, 0, sizeof(mia));
+	mia.ia_type = type;
+	if (type == PL_TYPE_RING) {
+		mia.ia_ring.ring_nr = 1;
+		mia.ia_ring.domain  = PO_COMP_TP_RACK;
+	} else {
+		mia.ia_jump.domain  = PO_COMP_TP_RACK;
+	}
+
+	rc = pl_map_create(po_map, &mia, &map);
+	D_ASSERT(rc == 0);
+
+	rate = plt_map_place_all(map, before, &shard_nr);
+	for (i = 0; i < CMP_OBJ_NR * shard_nr; i++) {
+		counts[before[i]]++;
+		if (before[i] == CMP_FAIL_TGT)
+			on_failed++;
+	}
+
+	avg = (double)CMP_OBJ_NR * shard_nr / ARRAY_SIZE(counts);
+	for (i = 0; i < ARRAY_SIZE(counts); i++) {
+		if (counts[i] > max)
+			max = counts[i];
+		if (counts[i] < min)
+			min = counts[i];
+	}
+
+	/* exclude one target as if it has been rebuilt */
+	rc = pool_map_find_target(po_map, CMP_FAIL_TGT, &tgt);
+	D_ASSERT(rc == 1);
+	rc = pool_map_set_version(po_map, ++(*version));
+	D_ASSERT(rc == 0);
+	tgt->ta_comp.co_status = PO_COMP_ST_DOWNOUT;
+	tgt->ta_comp.co_fseq   = *version;
+
+	plt_map_place_all(map, after, &shard_nr);
+	for (i = 0; i < CMP_OBJ_NR * shard_nr; i++) {
+		if (before[i] != after[i])
+			moved++;
+	}
+
+	tgt->ta_comp.co_status = PO_COMP_ST_UP;
+	rc = pool_map_set_version(po_map, ++(*version));
+	D_ASSERT(rc == 0);
+
+	D_PRINT("%s map: %.0f placements/sec, shards per target avg %.1f "
+		"min %u max %u, moved %u shards for %u on the excluded "
+		"target\n", name, rate, avg, min, max, moved, on_failed);
+
+	pl_map_decref(map);
+	D_FREE(after);
+	D_FREE(before);
+}
+
 int
 main(int argc, char **argv)
 {
@@ -69,6 +253,7 @@ main(int argc, char **argv)
 	int			 rc;
 	struct pool_component	*comp;
 	daos_obj_id_t		 oid = {1, 5};
+	uint32_t		 version = 1;
 
 	rc = daos_debug_init(NULL);
 	if (rc != 0)
@@ -119,6 +304,11 @@ main(int argc, char **argv)
 	rc = plt_obj_place(oid);
 	D_ASSERT(rc == 0);
 
+	plt_obj_place_perf();
+
+	plt_map_compare(PL_TYPE_RING, "ring", &version);
+	plt_map_compare(PL_TYPE_JUMP, "jump", &version);
+
 	pl_map_decref(pl_map);
 
 	pool_map_decref(po_map);
@@ -0,0 +1,692 @@
+/**
+ * (C) Copyright 2018 Intel Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * GOVERNMENT LICENSE RIGHTS-OPEN SOURCE SOFTWARE
+ * The Government's rights to use, modify, reproduce, release, perform, display,
+ * or disclose this software are subject to the terms of the Apache License as
+ * provided in Contract No. B609815.
+ * Any reproduction of computer software, computer software documentation, or
+ * portions thereof marked with this legend must also reproduce the markings.
+ */
+/**
+ * Jump placement map.
+ *
+ * Each shard of an object is placed independently by hashing the object ID
+ * and the shard index: jump consistent hash selects a fault domain, then
+ * another jump hash selects a target within that domain. Adding a domain or
+ * appending targets to a domain only moves the shards which are placed onto
+ * the new ones, and excluding a target only moves the shards on it.
+ *
+ * A shard on a failed target is remapped by rehashing with an increasing
+ * attempt number, failed shards of a redundancy group are remapped in the
+ * order of their failure sequence, so a later failure never moves a shard
+ * which has already been rebuilt.
+ *
+ * src/placement/jump_map.c
+ */
+#define D_LOGFAC	DD_FAC(placement)
+
+#include "pl_map.h"
+#include <gurt/hash.h>
+
+/** seed of the shard hash */
+#define JUMP_HASH_SEED		2018U
+/** number of rehashes before probing for a domain not used by the group */
+#define JUMP_DOM_RETRY		4
+/** max attempts to find a spare target for a failed shard */
+#define JUMP_REMAP_MAX		64
+/** redundancy groups up to this size are placed without allocation */
+#define JUMP_GRP_ON_STACK	32
+
+/** fault domain of the jump map */
+struct jump_domain {
+	/** targets of this domain, see \a jmp_targets */
+	struct pool_target	**jd_targets;
+	unsigned int		  jd_target_nr;
+};
+
+/** jump placement map */
+struct pl_jump_map {
+	/** common body */
+	struct pl_map		 jmp_map;
+	/** type of fault domain */
+	pool_comp_type_t	 jmp_domain;
+	/** number of domains */
+	unsigned int		 jmp_domain_nr;
+	/** total number of targets */
+	unsigned int		 jmp_target_nr;
+	/** array of domains */
+	struct jump_domain	*jmp_domains;
+	/** targets of all domains, targets of a domain are contiguous */
+	struct pool_target	**jmp_targets;
+};
+
+/** placement of a redundancy group member */
+struct jump_shard {
+	/** the current target of the shard */
+	struct pool_target	*js_tgt;
+	/** index of the domain of \a js_tgt */
+	unsigned int		 js_dom;
+	/** failure sequence and status of the failed target being remapped */
+	uint32_t		 js_fseq;
+	uint8_t			 js_status;
+	/** the shard has no target */
+	bool			 js_lost;
+};
+
+struct jump_obj_placement {
+	unsigned int		 jop_grp_size;
+	unsigned int		 jop_grp_nr;
+	/** index of the first group */
+	unsigned int		 jop_grp_idx;
+	/** ID of the first shard */
+	unsigned int		 jop_shard_id;
+};
+
+static void jump_map_destroy(struct pl_map *map);
+
+static inline struct pl_jump_map *
+pl_map2jmap(struct pl_map *map)
+{
+	return container_of(map, struct pl_jump_map, jmp_map);
+}
+
+/**
+ * Jump consistent hash of Lamping and Veach, it maps \a key to a bucket
+ * within [0, \a nr), only 1/nr of keys move if a bucket is appended.
+ */
+static inline unsigned int
+jump_hash(uint64_t key, unsigned int nr)
+{
+	int64_t	b = -1;
+	int64_t	j = 0;
+
+	while (j < nr) {
+		b = j;
+		key = key * 2862933555777941757ULL + 1;
+		j = (b + 1) * ((double)(1LL << 31) / (double)((key >> 33) + 1));
+	}
+	return b;
+}
+
+/** hash key of the \a attempt placement of shard \a sid of object \a oid */
+static inline uint64_t
+jump_shard_key(daos_obj_id_t oid, unsigned int sid, unsigned int attempt)
+{
+	uint64_t key[3];
+
+	key[0] = oid.lo;
+	key[1] = oid.hi;
+	key[2] = ((uint64_t)attempt << 32) | sid;
+	return d_hash_murmur64((unsigned char *)key, sizeof(key),
+			       JUMP_HASH_SEED);
+}
+
+/** mix bits of a hash key to derive another one */
+static inline uint64_t
+jump_key_mix(uint64_t key)
+{
+	key ^= key >> 33;
+	key *= 0xff51afd7ed558ccdULL;
+	key ^= key >> 33;
+	return key;
+}
+
+/**
+ * Build domains of the jump map, domains and targets added after the version
+ * of the pool map are ignored, just like the ring map.
+ */
+static int
+jump_map_build(struct pl_jump_map *jmap, struct pl_map_init_attr *mia)
+{
+	struct pool_domain	*doms;
+	struct pool_target	**tgts;
+	struct jump_domain	*jdom;
+	unsigned int		 dom_nr;
+	unsigned int		 ver;
+	int			 i;
+	int			 j;
+	int			 rc;
+
+	jmap->jmp_domain = mia->ia_jump.domain;
+	rc = pool_map_find_domain(jmap->jmp_map.pl_poolmap, jmap->jmp_domain,
+				  PO_COMP_ID_ALL, &doms);
+	if (rc <= 0)
+		return rc == 0 ? -DER_INVAL : rc;
+
+	dom_nr = rc;
+	ver = pl_map_version(&jmap->jmp_map);
+	for (i = 0; i < dom_nr; i++) {
+		if (doms[i].do_comp.co_ver > ver)
+			continue;
+
+		jmap->jmp_domain_nr++;
+		for (j = 0; j < doms[i].do_target_nr; j++) {
+			if (doms[i].do_targets[j].ta_comp.co_ver <= ver)
+				jmap->jmp_target_nr++;
+		}
+	}
+
+	if (jmap->jmp_domain_nr == 0 || jmap->jmp_target_nr == 0)
+		return -DER_INVAL;
+
+	D_ALLOC(jmap->jmp_domains,
+		jmap->jmp_domain_nr * sizeof(*jmap->jmp_domains));
+	if (jmap->jmp_domains == NULL)
+		return -DER_NOMEM;
+
+	D_ALLOC(jmap->jmp_targets,
+		jmap->jmp_target_nr * sizeof(*jmap->jmp_targets));
+	if (jmap->jmp_targets == NULL)
+		return -DER_NOMEM;
+
+	jdom = &jmap->jmp_domains[0];
+	tgts = &jmap->jmp_targets[0];
+	for (i = 0; i < dom_nr; i++) {
+		if (doms[i].do_comp.co_ver > ver)
+			continue;
+
+		jdom->jd_targets = tgts;
+		for (j = 0; j < doms[i].do_target_nr; j++) {
+			if (doms[i].do_targets[j].ta_comp.co_ver > ver)
+				continue;
+			jdom->jd_targets[jdom->jd_target_nr++] =
+				&doms[i].do_targets[j];
+		}
+		tgts += jdom->jd_target_nr;
+
+		D_DEBUG(DB_PL, "Found %d targets for %s[%d]\n",
+			jdom->jd_target_nr, pool_domain_name(&doms[i]),
+			doms[i].do_comp.co_id);
+		jdom++;
+	}
+	return 0;
+}
+
+/**
+ * Create a jump placement map
+ */
+static int
+jump_map_create(struct pool_map *poolmap, struct pl_map_init_attr *mia,
+		struct pl_map **mapp)
+{
+	struct pl_jump_map	*jmap;
+	int			 rc;
+
+	D_DEBUG(DB_PL, "Create jump map: domain %s\n",
+		pool_comp_type2str(mia->ia_jump.domain));
+
+	D_ALLOC_PTR(jmap);
+	if (jmap == NULL)
+		return -DER_NOMEM;
+
+	pool_map_addref(poolmap);
+	jmap->jmp_map.pl_poolmap = poolmap;
+
+	rc = jump_map_build(jmap, mia);
+	if (rc != 0) {
+		jump_map_destroy(&jmap->jmp_map);
+		return rc;
+	}
+
+	*mapp = &jmap->jmp_map;
+	return 0;
+}
+
+static void
+jump_map_destroy(struct pl_map *map)
+{
+	struct pl_jump_map *jmap = pl_map2jmap(map);
+
+	if (jmap->jmp_domains != NULL)
+		D_FREE(jmap->jmp_domains);
+
+	if (jmap->jmp_targets != NULL)
+		D_FREE(jmap->jmp_targets);
+
+	if (jmap->jmp_map.pl_poolmap)
+		pool_map_decref(jmap->jmp_map.pl_poolmap);
+
+	D_FREE_PTR(jmap);
+}
+
+static void
+jump_map_print(struct pl_map *map)
+{
+	struct pl_jump_map *jmap = pl_map2jmap(map);
+	int		    i;
+	int		    j;
+
+	D_PRINT("jump map: ver %d, domain_nr %d, tgt_nr %d\n",
+		pl_map_version(map), jmap->jmp_domain_nr, jmap->jmp_target_nr);
+
+	for (i = 0; i < jmap->jmp_domain_nr; i++) {
+		struct jump_domain *jdom = &jmap->jmp_domains[i];
+
+		D_PRINT("domain[%d]: ", i);
+		for (j = 0; j < jdom->jd_target_nr; j++)
+			D_PRINT("%d ", jdom->jd_targets[j]->ta_comp.co_id);
+		D_PRINT("\n");
+	}
+}
+
+static int
+jump_obj_placement_get(struct pl_jump_map *jmap, struct daos_obj_md *md,
+		       struct daos_obj_shard_md *shard_md,
+		       struct jump_obj_placement *jop)
+{
+	struct daos_oclass_attr	*oc_attr;
+	daos_obj_id_t		 oid = md->omd_id;
+
+	oc_attr = daos_oclass_attr_find(oid);
+	if (oc_attr == NULL) {
+		D_ERROR("Can not find obj class, invlaid oid="DF_OID"\n",
+			DP_OID(oid));
+		return -DER_INVAL;
+	}
+
+	jop->jop_grp_size = daos_oclass_grp_size(oc_attr);
+	D_ASSERT(jop->jop_grp_size != 0);
+	if (jop->jop_grp_size == DAOS_OBJ_REPL_MAX)
+		jop->jop_grp_size = jmap->jmp_domain_nr;
+
+	if (jop->jop_grp_size > jmap->jmp_domain_nr) {
+		D_ERROR("obj="DF_OID": group size (%u) is larger than "
+			"domain nr (%u)\n", DP_OID(oid),
+			jop->jop_grp_size, jmap->jmp_domain_nr);
+		return -DER_INVAL;
+	}
+
+	if (shard_md == NULL) {
+		unsigned int grp_max = jmap->jmp_target_nr / jop->jop_grp_size;
+
+		if (grp_max == 0)
+			grp_max = 1;
+
+		jop->jop_grp_nr = daos_oclass_grp_nr(oc_attr, md);
+		if (jop->jop_grp_nr > grp_max)
+			jop->jop_grp_nr = grp_max;
+		jop->jop_grp_idx = 0;
+		jop->jop_shard_id = 0;
+	} else {
+		jop->jop_grp_nr = 1;
+		jop->jop_grp_idx = pl_obj_shard2grp_index(shard_md, oc_attr);
+		jop->jop_shard_id = pl_obj_shard2grp_head(shard_md, oc_attr);
+	}
+
+	D_DEBUG(DB_PL, "obj="DF_OID"/%u grp_size=%u grp_idx=%u grp_nr=%u\n",
+		DP_OID(oid), jop->jop_shard_id, jop->jop_grp_size,
+		jop->jop_grp_idx, jop->jop_grp_nr);
+	return 0;
+}
+
+/** Is domain \a dom used by any member of the group except \a skip */
+static bool
+jump_dom_used(struct jump_shard *shards, unsigned int nr, unsigned int skip,
+	      unsigned int dom)
+{
+	unsigned int i;
+
+	for (i = 0; i < nr; i++) {
+		if (i != skip && !shards[i].js_lost &&
+		    shards[i].js_dom == dom)
+			return true;
+	}
+	return false;
+}
+
+/** Is target \a tgt used by any member of the group except \a skip */
+static bool
+jump_tgt_used(struct jump_shard *shards, unsigned int nr, unsigned int skip,
+	      struct pool_target *tgt)
+{
+	unsigned int i;
+
+	for (i = 0; i < nr; i++) {
+		if (i != skip && !shards[i].js_lost && shards[i].js_tgt == tgt)
+			return true;
+	}
+	return false;
+}
+
+/**
+ * Select a target for member \a idx of a group, \a nr members of the group
+ * have been placed. The domain is selected by jump hash, it is rehashed a
+ * few times and then probed if it has been used by another member.
+ */
+static void
+jump_shard_select(struct pl_jump_map *jmap, daos_obj_id_t oid,
+		  unsigned int sid, unsigned int attempt,
+		  struct jump_shard *shards, unsigned int nr, unsigned int idx)
+{
+	struct jump_domain	*jdom;
+	uint64_t		 key;
+	unsigned int		 dom;
+	unsigned int		 i;
+
+	key = jump_shard_key(oid, sid, attempt);
+	dom = jump_hash(key, jmap->jmp_domain_nr);
+	for (i = 0; jump_dom_used(shards, nr, idx, dom); i++) {
+		if (i < JUMP_DOM_RETRY) {
+			key = jump_key_mix(key);
+			dom = jump_hash(key, jmap->jmp_domain_nr);
+		} else {
+			/* grp_size <= domain_nr, so there is always one */
+			dom = (dom + 1) % jmap->jmp_domain_nr;
+		}
+	}
+
+	jdom = &jmap->jmp_domains[dom];
+	shards[idx].js_dom = dom;
+	shards[idx].js_tgt = jdom->jd_targets[jump_hash(jump_key_mix(~key),
+						       jdom->jd_target_nr)];
+}
+
+/** find the target of object with specified rank */
+static int
+jump_shard_spec_rank(struct pl_jump_map *jmap, daos_obj_id_t oid,
+		     struct jump_shard *shard)
+{
+	d_rank_t	rank = daos_oclass_sr_get_rank(oid);
+	unsigned int	i;
+	unsigned int	j;
+
+	for (i = 0; i < jmap->jmp_domain_nr; i++) {
+		struct jump_domain *jdom = &jmap->jmp_domains[i];
+
+		for (j = 0; j < jdom->jd_target_nr; j++) {
+			if (jdom->jd_targets[j]->ta_comp.co_rank == rank) {
+				shard->js_dom = i;
+				shard->js_tgt = jdom->jd_targets[j];
+				return 0;
+			}
+		}
+	}
+	D_ERROR("Can't find rank %d for obj="DF_OID"\n", rank, DP_OID(oid));
+	return -DER_INVAL;
+}
+
+/**
+ * Place members of redundancy group \a grp and remap the failed ones.
+ *
+ * Return 1 and the spare rank of the shard being rebuilt for \a rebuild_ver,
+ * 0 if no shard of the group is rebuilt for this version, or -ve error.
+ */
+static int
+jump_grp_place(struct pl_jump_map *jmap, daos_obj_id_t oid,
+	       unsigned int grp, unsigned int grp_size,
+	       struct jump_shard *shards, uint32_t rebuild_ver,
+	       uint32_t *tgt_rank, unsigned int *rebuild_idx)
+{
+	unsigned int	failed[JUMP_GRP_ON_STACK];
+	unsigned int	*fails = failed;
+	unsigned int	fail_nr;
+	unsigned int	i;
+	unsigned int	j;
+	unsigned int	attempt;
+	bool		spare_avail = true;
+	bool		spec_rank;
+	int		rc = 0;
+
+	if (grp_size > JUMP_GRP_ON_STACK) {
+		D_ALLOC(fails, grp_size * sizeof(*fails));
+		if (fails == NULL)
+			return -DER_NOMEM;
+	}
+
+	spec_rank = daos_obj_id2class(oid) == DAOS_OC_R3S_SPEC_RANK ||
+		    daos_obj_id2class(oid) == DAOS_OC_R1S_SPEC_RANK;
+
+	for (i = fail_nr = 0; i < grp_size; i++) {
+		unsigned int sid = grp * grp_size + i;
+
+		shards[i].js_lost = false;
+		shards[i].js_fseq = 0;
+		shards[i].js_status = 0;
+		if (sid == 0 && spec_rank) {
+			rc = jump_shard_spec_rank(jmap, oid, &shards[i]);
+			if (rc)
+				goto out;
+		} else {
+			jump_shard_select(jmap, oid, sid, 0, shards, i, i);
+		}
+
+		if (!pool_target_unavail(shards[i].js_tgt))
+			continue;
+
+		shards[i].js_fseq = shards[i].js_tgt->ta_comp.co_fseq;
+		shards[i].js_status = shards[i].js_tgt->ta_comp.co_status;
+		/* failed members are sorted by fseq in ascending order */
+		for (j = fail_nr; j > 0; j--) {
+			D_ASSERTF(shards[fails[j - 1]].js_fseq !=
+				  shards[i].js_fseq, "same fseq %u!\n",
+				  shards[i].js_fseq);
+			if (shards[fails[j - 1]].js_fseq < shards[i].js_fseq)
+				break;
+			fails[j] = fails[j - 1];
+		}
+		fails[j] = i;
+		fail_nr++;
+	}
+
+	for (i = 0; i < fail_nr; i++) {
+		struct jump_shard	*shard = &shards[fails[i]];
+		struct pool_target	*spare = NULL;
+		unsigned int		 sid = grp * grp_size + fails[i];
+
+		/*
+		 * Shards which failed after a shard still being rebuilt are
+		 * inaccessible until their own rebuild, same as the ring map.
+		 */
+		if (!spare_avail) {
+			shard->js_lost = true;
+			continue;
+		}
+
+		for (attempt = 1; attempt <= JUMP_REMAP_MAX; attempt++) {
+			jump_shard_select(jmap, oid, sid, attempt, shards,
+					  grp_size, fails[i]);
+			spare = shard->js_tgt;
+			if (jump_tgt_used(shards, grp_size, fails[i], spare))
+				continue;
+
+			if (!pool_target_unavail(spare))
+				break;
+
+			D_ASSERTF(spare->ta_comp.co_fseq != shard->js_fseq,
+				  "same fseq %u!\n", shard->js_fseq);
+			/* the spare failed earlier, it can't be a spare */
+			if (spare->ta_comp.co_fseq < shard->js_fseq)
+				continue;
+
+			/*
+			 * The spare failed later, the rebuild of this shard
+			 * is deferred to the rebuild of the spare.
+			 */
+			if (shard->js_status == PO_COMP_ST_DOWN)
+				break;
+
+			/* the shard has been rebuilt onto the failed spare */
+			shard->js_fseq = spare->ta_comp.co_fseq;
+			shard->js_status = spare->ta_comp.co_status;
+		}
+
+		if (attempt > JUMP_REMAP_MAX || pool_target_unavail(spare)) {
+			shard->js_lost = true;
+			spare_avail = false;
+			continue;
+		}
+
+		if (shard->js_status == PO_COMP_ST_DOWN) {
+			spare_avail = false;
+			if (shard->js_fseq == rebuild_ver && rc == 0) {
+				*tgt_rank = spare->ta_comp.co_rank;
+				*rebuild_idx = fails[i];
+				rc = 1;
+			}
+		}
+	}
+out:
+	if (fails != failed)
+		D_FREE(fails);
+	return rc;
+}
+
+/**
+ * Generate the layout of object \a md, it also finds the shard being rebuilt
+ * for \a rebuild_ver if \a tgt_rank is not NULL, \a layout can be NULL if
+ * the caller only wants the latter.
+ */
+static int
+jump_obj_layout_fill(struct pl_jump_map *jmap, struct daos_obj_md *md,
+		     struct jump_obj_placement *jop,
+		     struct pl_obj_layout *layout, uint32_t rebuild_ver,
+		     uint32_t *tgt_rank, uint32_t *shard_id)
+{
+	struct jump_shard	 shards_on_stack[JUMP_GRP_ON_STACK];
+	struct jump_shard	*shards = shards_on_stack;
+	unsigned int		 rebuild_idx;
+	unsigned int		 i;
+	unsigned int		 j;
+	unsigned int		 k;
+	int			 rc = 0;
+
+	if (jop->jop_grp_size > JUMP_GRP_ON_STACK) {
+		D_ALLOC(shards, jop->jop_grp_size * sizeof(*shards));
+		if (shards == NULL)
+			return -DER_NOMEM;
+	}
+
+	for (i = k = 0; i < jop->jop_grp_nr; i++) {
+		rc = jump_grp_place(jmap, md->omd_id, jop->jop_grp_idx + i,
+				    jop->jop_grp_size, shards, rebuild_ver,
+				    tgt_rank, &rebuild_idx);
+		if (rc < 0)
+			goto out;
+
+		if (rc > 0 && tgt_rank != NULL) {
+			*shard_id = jop->jop_shard_id + k + rebuild_idx;
+			goto out;
+		}
+
+		if (layout == NULL) { /* only looking for rebuild */
+			k += jop->jop_grp_size;
+			continue;
+		}
+
+		for (j = 0; j < jop->jop_grp_size; j++, k++) {
+			struct pl_obj_shard *l_shard = &layout->ol_shards[k];
+
+			if (shards[j].js_lost) {
+				l_shard->po_shard = -1;
+				l_shard->po_target = -1;
+				continue;
+			}
+			l_shard->po_shard = jop->jop_shard_id + k;
+			l_shard->po_target = shards[j].js_tgt->ta_comp.co_id;
+			/* read should skip the shard being rebuilt */
+			l_shard->po_rebuilding =
+				shards[j].js_status == PO_COMP_ST_DOWN;
+		}
+	}
+	rc = 0;
+out:
+	if (shards != shards_on_stack)
+		D_FREE(shards);
+	return rc;
+}
+
+static int
+jump_obj_place(struct pl_map *map, struct daos_obj_md *md,
+	       struct daos_obj_shard_md *shard_md,
+	       struct pl_obj_layout **layout_pp)
+{
+	struct jump_obj_placement  jop;
+	struct pl_jump_map	  *jmap = pl_map2jmap(map);
+	struct pl_obj_layout	  *layout;
+	int			   rc;
+
+	rc = jump_obj_placement_get(jmap, md, shard_md, &jop);
+	if (rc)
+		return rc;
+
+	rc = pl_obj_layout_alloc(jop.jop_grp_size * jop.jop_grp_nr, &layout);
+	if (rc)
+		return rc;
+
+	layout->ol_ver = pl_map_version(map);
+	rc = jump_obj_layout_fill(jmap, md, &jop, layout, 0, NULL, NULL);
+	if (rc) {
+		pl_obj_layout_free(layout);
+		return rc;
+	}
+
+	*layout_pp = layout;
+	return 0;
+}
+
+/**
+ * See \a pl_obj_find_rebuild, it only places members of the redundancy
+ * groups, so it doesn't allocate or walk anything else.
+ */
+static int
+jump_obj_find_rebuild(struct pl_map *map, struct daos_obj_md *md,
+		      struct daos_obj_shard_md *shard_md,
+		      uint32_t rebuild_ver, uint32_t *tgt_rank,
+		      uint32_t *shard_id)
+{
+	struct jump_obj_placement  jop;
+	struct pl_jump_map	  *jmap = pl_map2jmap(map);
+	int			   rc;
+
+	/* Caller should guarantee the pl_map is uptodate */
+	if (pl_map_version(map) < rebuild_ver) {
+		D_ERROR("pl_map version(%u) < rebuild version(%u)\n",
+			pl_map_version(map), rebuild_ver);
+		return -DER_INVAL;
+	}
+
+	rc = jump_obj_placement_get(jmap, md, shard_md, &jop);
+	if (rc)
+		return rc;
+
+	if (jop.jop_grp_size == 1) {
+		D_DEBUG(DB_PL, "Not replicated object "DF_OID"\n",
+			DP_OID(md->omd_id));
+		return 0;
+	}
+
+	return jump_obj_layout_fill(jmap, md, &jop, NULL, rebuild_ver,
+				    tgt_rank, shard_id);
+}
+
+static int
+jump_obj_find_reint(struct pl_map *map, struct daos_obj_md *md,
+		    struct daos_obj_shard_md *shard_md,
+		    struct pl_target_grp *tgp_reint,
+		    uint32_t *tgt_reint)
+{
+	D_ERROR("Unsupported\n");
+	return -DER_NOSYS;
+}
+
+struct pl_map_ops	jump_map_ops = {
+	.o_create		= jump_map_create,
+	.o_destroy		= jump_map_destroy,
+	.o_print		= jump_map_print,
+	.o_obj_place		= jump_obj_place,
+	.o_obj_find_rebuild	= jump_obj_find_rebuild,
+	.o_obj_find_reint	= jump_obj_find_reint,
+};
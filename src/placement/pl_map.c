@@ -31,6 +31,7 @@
 #include <gurt/hash.h>
 
 extern struct pl_map_ops	ring_map_ops;
+extern struct pl_map_ops	jump_map_ops;
 
 /** dictionary for all unknown placement maps */
 struct pl_map_dict {
@@ -49,6 +50,11 @@ static struct pl_map_dict pl_maps[] = {
 		.pd_ops		= &ring_map_ops,
 		.pd_name	= "ring",
 	},
+	{
+		.pd_type	= PL_TYPE_JUMP,
+		.pd_ops		= &jump_map_ops,
+		.pd_name	= "jump",
+	},
 	{
 		.pd_type	= PL_TYPE_UNKNOWN,
 		.pd_ops		= NULL,
@@ -56,6 +62,108 @@ static struct pl_map_dict pl_maps[] = {
 	},
 };
 
+/** number of cached object layouts of each placement map, in bits */
+#define PL_CACHE_BITS		10
+/** layouts with more shards are not cached */
+#define PL_CACHE_SHARDS		8
+
+/**
+ * Cached layout of an object, it is found by hashing the object ID. Readers
+ * don't take any lock, the writer bumps \a ce_seq to an odd number before
+ * changing the entry and bumps it again after, readers never retry but
+ * just fall back to computing the layout if they see an odd or changed
+ * sequence number.
+ */
+struct pl_cache_ent {
+	/** sequence number, it is odd while the entry is being changed */
+	uint64_t		ce_seq;
+	daos_obj_id_t		ce_oid;
+	/** version of object metadata */
+	uint32_t		ce_md_ver;
+	/** version of the placement map which generated this layout */
+	uint32_t		ce_map_ver;
+	uint32_t		ce_shard_nr;
+	struct pl_obj_shard	ce_shards[PL_CACHE_SHARDS];
+};
+
+static inline struct pl_cache_ent *
+pl_cache_oid2ent(struct pl_map *map, daos_obj_id_t oid)
+{
+	return &map->pl_cache[daos_u64_hash(oid.lo ^ oid.hi, PL_CACHE_BITS)];
+}
+
+/**
+ * Look up the layout of object \a md in the cache, the returned layout is a
+ * copy of the cached one, so it has the same lifetime as a computed one.
+ */
+static bool
+pl_cache_lookup(struct pl_map *map, struct daos_obj_md *md,
+		struct pl_obj_layout **layout_pp)
+{
+	struct pl_cache_ent	*ent;
+	struct pl_cache_ent	 copy;
+	struct pl_obj_layout	*layout;
+	uint64_t		 seq;
+
+	if (map->pl_cache == NULL)
+		return false;
+
+	ent = pl_cache_oid2ent(map, md->omd_id);
+	seq = __atomic_load_n(&ent->ce_seq, __ATOMIC_ACQUIRE);
+	if (seq == 0 || (seq & 1))
+		return false; /* empty, or being changed */
+
+	copy = *ent;
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+	if (__atomic_load_n(&ent->ce_seq, __ATOMIC_RELAXED) != seq)
+		return false;
+
+	if (copy.ce_oid.lo != md->omd_id.lo ||
+	    copy.ce_oid.hi != md->omd_id.hi ||
+	    copy.ce_md_ver != md->omd_ver ||
+	    copy.ce_map_ver != pl_map_version(map))
+		return false;
+
+	if (pl_obj_layout_alloc(copy.ce_shard_nr, &layout) != 0)
+		return false;
+
+	layout->ol_ver = copy.ce_map_ver;
+	memcpy(layout->ol_shards, copy.ce_shards,
+	       copy.ce_shard_nr * sizeof(*layout->ol_shards));
+	*layout_pp = layout;
+	return true;
+}
+
+/** Store the computed layout of object \a md in the cache */
+static void
+pl_cache_store(struct pl_map *map, struct daos_obj_md *md,
+	       struct pl_obj_layout *layout)
+{
+	struct pl_cache_ent	*ent;
+	uint64_t		 seq;
+
+	if (map->pl_cache == NULL || layout->ol_nr > PL_CACHE_SHARDS)
+		return;
+
+	ent = pl_cache_oid2ent(map, md->omd_id);
+	seq = __atomic_load_n(&ent->ce_seq, __ATOMIC_RELAXED);
+	/* just skip if another thread is changing it */
+	if ((seq & 1) ||
+	    !__atomic_compare_exchange_n(&ent->ce_seq, &seq, seq + 1, false,
+					 __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+		return;
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+
+	ent->ce_oid	 = md->omd_id;
+	ent->ce_md_ver	 = md->omd_ver;
+	ent->ce_map_ver	 = layout->ol_ver;
+	ent->ce_shard_nr = layout->ol_nr;
+	memcpy(ent->ce_shards, layout->ol_shards,
+	       layout->ol_nr * sizeof(*layout->ol_shards));
+
+	__atomic_store_n(&ent->ce_seq, seq + 2, __ATOMIC_RELEASE);
+}
+
 /**
  * Create a placement map based on attributes in \a mia
  */
@@ -84,8 +192,15 @@ pl_map_create(struct pool_map *pool_map, struct pl_map_init_attr *mia,
 	if (rc != 0)
 		return rc;
 
+	D_ALLOC(map->pl_cache, sizeof(*map->pl_cache) << PL_CACHE_BITS);
+	if (map->pl_cache == NULL) {
+		dict->pd_ops->o_destroy(map);
+		return -DER_NOMEM;
+	}
+
 	rc = D_SPIN_INIT(&map->pl_lock, PTHREAD_PROCESS_PRIVATE);
 	if (rc != 0) {
+		D_FREE(map->pl_cache);
 		dict->pd_ops->o_destroy(map);
 		return rc;
 	}
@@ -110,6 +225,7 @@ pl_map_destroy(struct pl_map *map)
 	D_ASSERT(map->pl_ops->o_destroy != NULL);
 
 	D_SPIN_DESTROY(&map->pl_lock);
+	D_FREE(map->pl_cache);
 	map->pl_ops->o_destroy(map);
 }
 
@@ -126,16 +242,28 @@ void pl_map_print(struct pl_map *map)
  * Compute layout for the input object metadata @md. It only generates the
  * layout of the redundancy group that @shard_md belongs to if @shard_md
  * is not NULL.
+ *
+ * Full layouts are cached by object ID and versions of the object metadata
+ * and the pool map, repeated opens of an object copy the cached layout.
  */
 int
 pl_obj_place(struct pl_map *map, struct daos_obj_md *md,
 	     struct daos_obj_shard_md *shard_md,
 	     struct pl_obj_layout **layout_pp)
 {
+	int	rc;
+
 	D_ASSERT(map->pl_ops != NULL);
 	D_ASSERT(map->pl_ops->o_obj_place != NULL);
 
-	return map->pl_ops->o_obj_place(map, md, shard_md, layout_pp);
+	if (shard_md == NULL && pl_cache_lookup(map, md, layout_pp))
+		return 0;
+
+	rc = map->pl_ops->o_obj_place(map, md, shard_md, layout_pp);
+	if (rc == 0 && shard_md == NULL)
+		pl_cache_store(map, md, *layout_pp);
+
+	return rc;
 }
 
 /**
@@ -275,6 +403,8 @@ struct d_hash_table	pl_htable = {
 };
 
 #define DSR_RING_DOMAIN		PO_COMP_TP_RACK
+/** environment variable to select the type of placement maps */
+#define PL_TYPE_ENV		"DAOS_PL_TYPE"
 
 static void
 pl_map_attr_init(struct pool_map *po_map, pl_map_type_t type,
@@ -292,7 +422,46 @@ pl_map_attr_init(struct pool_map *po_map, pl_map_type_t type,
 		mia->ia_ring.domain  = DSR_RING_DOMAIN;
 		mia->ia_ring.ring_nr = 1;
 		break;
+
+	case PL_TYPE_JUMP:
+		mia->ia_type	     = PL_TYPE_JUMP;
+		mia->ia_jump.domain  = DSR_RING_DOMAIN;
+		break;
+	}
+}
+
+/**
+ * Type of placement maps generated by \a pl_map_update, it is the ring map
+ * unless the environment variable names another one. All clients and servers
+ * of a pool must use the same type.
+ */
+static pl_map_type_t
+pl_map_type_default(void)
+{
+	static pl_map_type_t	 type = PL_TYPE_UNKNOWN;
+	struct pl_map_dict	*dict;
+	char			*env;
+
+	if (type != PL_TYPE_UNKNOWN)
+		return type;
+
+	type = PL_TYPE_RING;
+	env = getenv(PL_TYPE_ENV);
+	if (env == NULL)
+		return type;
+
+	for (dict = &pl_maps[0]; dict->pd_type != PL_TYPE_UNKNOWN; dict++) {
+		if (strcasecmp(env, dict->pd_name) == 0) {
+			type = dict->pd_type;
+			break;
+		}
 	}
+
+	if (dict->pd_type == PL_TYPE_UNKNOWN)
+		D_ERROR("Unknown placement map type %s, use ring\n", env);
+	else
+		D_DEBUG(DB_PL, "Use %s placement map\n", dict->pd_name);
+	return type;
 }
 
 struct pl_map *
@@ -397,7 +566,7 @@ pl_map_update(uuid_t uuid, struct pool_map *pool_map, bool connect)
 	}
 
 	if (!link) {
-		pl_map_attr_init(pool_map, PL_TYPE_RING, &mia);
+		pl_map_attr_init(pool_map, pl_map_type_default(), &mia);
 		rc = pl_map_create(pool_map, &mia, &map);
 		if (rc != 0)
 			D_GOTO(out, rc);
@@ -412,7 +581,7 @@ pl_map_update(uuid_t uuid, struct pool_map *pool_map, bool connect)
 			D_GOTO(out, rc = 0);
 		}
 
-		pl_map_attr_init(pool_map, PL_TYPE_RING, &mia);
+		pl_map_attr_init(pool_map, pl_map_type_default(), &mia);
 		rc = pl_map_create(pool_map, &mia, &map);
 		if (rc != 0) {
 			d_hash_rec_decref(&pl_htable, link);
@@ -32,6 +32,7 @@
 #include <daos/placement.h>
 
 struct pl_map_ops;
+struct pl_cache_ent;
 
 /** common header of all placement map */
 struct pl_map {
@@ -51,6 +52,8 @@ struct pl_map {
 	struct pool_map		*pl_poolmap;
 	/** placement map operations */
 	struct pl_map_ops       *pl_ops;
+	/** cached object layouts, see \a pl_obj_place */
+	struct pl_cache_ent	*pl_cache;
 };
 
 /**
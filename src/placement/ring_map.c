@@ -31,8 +31,10 @@
 
 /** placement ring */
 struct pl_ring {
-	/** all targets on the ring */
+	/** positions in pool map of all targets on the ring */
 	struct pl_target	*ri_targets;
+	/** IDs of all targets on the ring */
+	uint32_t		*ri_tgt_ids;
 };
 
 /** ring placement map, it can have multiple rings */
@@ -53,6 +55,13 @@ struct pl_ring_map {
 	double			 rmp_stride;
 	/** array of rings */
 	struct pl_ring		*rmp_rings;
+	/**
+	 * Flat arrays of target positions and IDs of all rings, targets of
+	 * ring N start from N * rmp_target_nr, so a layout can be filled
+	 * without walking the pool map.
+	 */
+	struct pl_target	*rmp_ring_targets;
+	uint32_t		*rmp_ring_tgt_ids;
 	/** consistent hash ring of rings */
 	uint64_t		*rmp_ring_hashes;
 	/** consistent hash ring of targets */
@@ -490,11 +499,10 @@ ring_create(struct pl_ring_map *rimap, unsigned int index,
 	if (rc < 0)
 		return rc;
 
-	D_ALLOC(ring->ri_targets,
-		rimap->rmp_target_nr * sizeof(struct pl_target));
-	if (ring->ri_targets == NULL)
-		return -DER_NOMEM;
-
+	ring->ri_targets = &rimap->rmp_ring_targets[index *
+						    rimap->rmp_target_nr];
+	ring->ri_tgt_ids = &rimap->rmp_ring_tgt_ids[index *
+						    rimap->rmp_target_nr];
 	first = pool_map_targets(rimap->rmp_map.pl_poolmap);
 
 	for (plt = &ring->ri_targets[0], i = 0;
@@ -510,20 +518,14 @@ ring_create(struct pl_ring_map *rimap, unsigned int index,
 					      struct pool_target, ta_comp);
 			/* position (offset) of target in the pool map */
 			plt->pt_pos = target - first;
+			ring->ri_tgt_ids[plt - ring->ri_targets] =
+				target->ta_comp.co_id;
 			plt++;
 		}
 	}
 	return 0;
 }
 
-static void
-ring_free(struct pl_ring_map *rimap, struct pl_ring *ring)
-{
-	if (ring->ri_targets != NULL) {
-		D_FREE(ring->ri_targets);
-	}
-}
-
 static void
 ring_print(struct pl_ring_map *rimap, int index)
 {
@@ -572,6 +574,16 @@ ring_map_build(struct pl_ring_map *rimap, struct pl_map_init_attr *mia)
 	rimap->rmp_domain_nr = buf->rb_domain_nr;
 	rimap->rmp_target_nr = buf->rb_target_nr;
 
+	D_ALLOC(rimap->rmp_ring_targets, rimap->rmp_ring_nr *
+		rimap->rmp_target_nr * sizeof(*rimap->rmp_ring_targets));
+	if (rimap->rmp_ring_targets == NULL)
+		D_GOTO(out, rc = -DER_NOMEM);
+
+	D_ALLOC(rimap->rmp_ring_tgt_ids, rimap->rmp_ring_nr *
+		rimap->rmp_target_nr * sizeof(*rimap->rmp_ring_tgt_ids));
+	if (rimap->rmp_ring_tgt_ids == NULL)
+		D_GOTO(out, rc = -DER_NOMEM);
+
 	for (i = 0; i < rimap->rmp_ring_nr; i++) {
 		rc = ring_create(rimap, i, buf);
 		if (rc != 0)
@@ -698,7 +710,6 @@ static void
 ring_map_destroy(struct pl_map *map)
 {
 	struct pl_ring_map *rimap = pl_map2rimap(map);
-	int		    i;
 
 	if (rimap->rmp_ring_hashes != NULL) {
 		D_FREE(rimap->rmp_ring_hashes);
@@ -708,10 +719,15 @@ ring_map_destroy(struct pl_map *map)
 		D_FREE(rimap->rmp_target_hashes);
 	}
 
-	if (rimap->rmp_rings != NULL) {
-		for (i = 0; i < rimap->rmp_ring_nr; i++)
-			ring_free(rimap, &rimap->rmp_rings[i]);
+	if (rimap->rmp_ring_targets != NULL) {
+		D_FREE(rimap->rmp_ring_targets);
+	}
 
+	if (rimap->rmp_ring_tgt_ids != NULL) {
+		D_FREE(rimap->rmp_ring_tgt_ids);
+	}
+
+	if (rimap->rmp_rings != NULL) {
 		D_FREE(rimap->rmp_rings);
 	}
 	if (rimap->rmp_map.pl_poolmap)
@@ -743,6 +759,9 @@ ring_oid2ring(struct pl_ring_map *rimap, daos_obj_id_t id)
 {
 	uint64_t hash;
 
+	if (rimap->rmp_ring_nr == 1)
+		return &rimap->rmp_rings[0];
+
 	hash = pl_hash64(id.lo, RING_HASH_BITS);
 	hash = d_hash_srch_u64(rimap->rmp_ring_hashes,
 				rimap->rmp_ring_nr, hash);
@@ -1209,6 +1228,7 @@ ring_obj_layout_fill(struct pl_map *map, struct daos_obj_md *md,
 		     struct pl_obj_layout *layout, d_list_t *remap_list)
 {
 	struct pl_ring_map	*rimap = pl_map2rimap(map);
+	struct pl_ring		*ring;
 	struct pl_target	*plts;
 	struct pool_target	*tgts;
 	unsigned int		 plts_nr, grp_dist, grp_start;
@@ -1216,7 +1236,8 @@ ring_obj_layout_fill(struct pl_map *map, struct daos_obj_md *md,
 
 	layout->ol_ver = pl_map_version(map);
 
-	plts = ring_oid2ring(rimap, md->omd_id)->ri_targets;
+	ring = ring_oid2ring(rimap, md->omd_id);
+	plts = ring->ri_targets;
 	plts_nr = rimap->rmp_target_nr;
 	grp_dist = rop->rop_grp_size * rop->rop_dist;
 	grp_start = rop->rop_begin;
@@ -1241,8 +1262,7 @@ ring_obj_layout_fill(struct pl_map *map, struct daos_obj_md *md,
 
 			pos = plts[idx].pt_pos;
 			layout->ol_shards[k].po_shard  = rop->rop_shard_id + k;
-			layout->ol_shards[k].po_target =
-				tgts[pos].ta_comp.co_id;
+			layout->ol_shards[k].po_target = ring->ri_tgt_ids[idx];
 
 			if (pool_target_unavail(&tgts[pos])) {
 				rc = ring_remap_alloc_one(remap_list, k,
@@ -54,6 +54,8 @@ init(void)
 	rc = ds_pool_iv_init();
 	if (rc)
 		D_GOTO(err_hdl_hash, rc);
+
+	ds_pool_scrub_init();
 	return 0;
 err_hdl_hash:
 	ds_pool_hdl_hash_fini();
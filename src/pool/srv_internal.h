@@ -102,6 +102,13 @@ int ds_pool_group_destroy(const uuid_t pool_uuid, crt_group_t *group);
 int ds_pool_map_tgts_update(struct pool_map *map, d_rank_list_t *tgts,
 			    d_rank_list_t *tgts_failed, int opc);
 
+/*
+ * srv_scrub.c
+ */
+void ds_pool_scrub_init(void);
+int ds_pool_scrub_start(struct ds_pool_child *child);
+void ds_pool_scrub_stop(struct ds_pool_child *child);
+
 /*
  * srv_iv.c
  */
@@ -759,7 +759,7 @@ pool_svc_stop_cb(struct rdb *db, int err, void *arg)
 	int			rc;
 
 	pool_svc_get(svc);
-	rc = dss_ult_create(pool_svc_stopper, svc, -1, NULL);
+	rc = dss_ult_create(pool_svc_stopper, svc, DSS_XS_SELF, NULL);
 	if (rc != 0) {
 		D_ERROR(DF_UUID": failed to create pool service stopper: %d\n",
 			DP_UUID(svc->ps_uuid), rc);
@@ -0,0 +1,647 @@
+/**
+ * (C) Copyright 2018 Intel Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * GOVERNMENT LICENSE RIGHTS-OPEN SOURCE SOFTWARE
+ * The Government's rights to use, modify, reproduce, release, perform, display,
+ * or disclose this software are subject to the terms of the Apache License as
+ * provided in Contract No. B609815.
+ * Any reproduction of computer software, computer software documentation, or
+ * portions thereof marked with this legend must also reproduce the markings.
+ */
+/**
+ * ds_pool: Background Scrubber
+ *
+ * Each target of a pool has a scrubber ULT, which walks all containers,
+ * objects, keys and records of the VOS pool and verifies the checksum stored
+ * with each record against its data. It runs in the DSS_POOL_SCRUB ES pool,
+ * whose share of the xstream is bounded by dss_scrub_res_percentage, and it
+ * throttles itself by both a records/s and a bytes/s budget, and by the
+ * percentage of xstream time it has consumed.
+ *
+ * The scrubber checks its budgets after each record and object, and yields
+ * once it has run for SCRUB_RUN_MAX or a budget is exhausted. It also yields
+ * while reading extents stored on NVMe. The trees can change under its open
+ * iterators meanwhile, so after yielding each iterator is restarted from the
+ * anchor of its current entry, see scrub_iterate().
+ */
+#define D_LOGFAC	DD_FAC(pool)
+
+#include <daos_srv/pool.h>
+
+#include <daos_srv/vos.h>
+#include "srv_internal.h"
+
+/** seconds between the start of two scrub passes, 0 to disable scrubber */
+#define SCRUB_INTERVAL_ENV	"DAOS_SCRUB_INTERVAL"
+/** maximum records verified per second on each target, 0 for unlimited */
+#define SCRUB_IOPS_ENV		"DAOS_SCRUB_IOPS"
+/** maximum MB verified per second on each target, 0 for unlimited */
+#define SCRUB_BW_ENV		"DAOS_SCRUB_BW"
+
+/** length of the accounting window for rate limiting, in seconds */
+#define SCRUB_WINDOW		1.0
+/**
+ * the longest time the scrubber runs without yielding, in seconds. Each
+ * yield restarts the open iterators, so it doesn't yield for every record.
+ */
+#define SCRUB_RUN_MAX		0.001
+
+static unsigned int	scrub_interval;
+static unsigned int	scrub_iops = 1024;
+static daos_size_t	scrub_bw = (64ULL << 20);
+
+struct scrub_ctx {
+	struct ds_pool_child	*sc_child;
+	daos_csum_t		 sc_csum;
+	/** checksum type of \a sc_csum, DAOS_CS_UNKNOWN if not initialized */
+	unsigned int		 sc_csum_type;
+	/** start time of the current accounting window */
+	double			 sc_win_start;
+	/** time when the scrubber was resumed for the last time */
+	double			 sc_run_start;
+	/** time consumed by the scrubber in the current window */
+	double			 sc_win_busy;
+	/** records and bytes verified in the current window */
+	uint64_t		 sc_win_recs;
+	daos_size_t		 sc_win_bytes;
+	/** statistics of the current pass */
+	uint64_t		 sc_recs;
+	daos_size_t		 sc_bytes;
+	uint64_t		 sc_corrupted;
+	/** records read from NVMe, and records which can't be verified */
+	uint64_t		 sc_nvme_recs;
+	uint64_t		 sc_unverified;
+	/** number of times the scrubber yielded */
+	uint64_t		 sc_yields;
+	/** the NVMe extent just read mismatched, check it's still there */
+	bool			 sc_recheck;
+};
+
+void
+ds_pool_scrub_init(void)
+{
+	char	*env;
+
+	env = getenv(SCRUB_INTERVAL_ENV);
+	if (env)
+		scrub_interval = atoi(env);
+
+	env = getenv(SCRUB_IOPS_ENV);
+	if (env)
+		scrub_iops = atoi(env);
+
+	env = getenv(SCRUB_BW_ENV);
+	if (env)
+		scrub_bw = (daos_size_t)atoi(env) << 20;
+
+	D_DEBUG(DF_DSMS, "scrub interval %u secs, %u rec/s, "DF_U64" bytes/s\n",
+		scrub_interval, scrub_iops, scrub_bw);
+}
+
+/**
+ * Sleep for \a secs seconds, or until the scrubber is stopped. It waits on
+ * the condition variable, so the xstream can run other ULTs or idle.
+ *
+ * \return	1 if the scrubber should stop, 0 otherwise.
+ */
+static int
+scrub_sleep(struct ds_pool_child *child, double secs)
+{
+	struct timespec	abstime;
+	double		end;
+
+	if (secs <= 0)
+		return child->spc_scrub_stop ? 1 : 0;
+
+	/* ABT_cond_timedwait() compares with the clock of ABT_get_wtime() */
+	end = ABT_get_wtime() + secs;
+	abstime.tv_sec = (time_t)end;
+	abstime.tv_nsec = (long)((end - abstime.tv_sec) * 1e9);
+
+	ABT_mutex_lock(child->spc_scrub_lock);
+	while (!child->spc_scrub_stop && ABT_get_wtime() < end) {
+		if (ABT_cond_timedwait(child->spc_scrub_cv,
+				       child->spc_scrub_lock,
+				       &abstime) != ABT_SUCCESS)
+			break; /* timed out */
+	}
+	ABT_mutex_unlock(child->spc_scrub_lock);
+
+	return child->spc_scrub_stop ? 1 : 0;
+}
+
+/**
+ * Yield or sleep until records and bytes verified so far are within all of
+ * the budgets of the scrubber. It's called after each record and object, it
+ * returns without yielding if the scrubber has run for less than
+ * SCRUB_RUN_MAX, and it's ahead of the budgets or behind them by less than
+ * SCRUB_RUN_MAX. The caller restarts open iterators if it yielded,
+ * see scrub_iterate().
+ *
+ * \return	0 to continue, 1 if the scrubber should stop.
+ */
+static int
+scrub_throttle(struct scrub_ctx *ctx)
+{
+	unsigned int	pct = dss_scrub_res_percentage;
+	double		now = ABT_get_wtime();
+	double		busy;
+	double		elapsed;
+	double		wait = 0;
+	int		rc;
+
+	busy = ctx->sc_win_busy + now - ctx->sc_run_start;
+
+	elapsed = now - ctx->sc_win_start;
+	if (scrub_iops != 0)
+		wait = max(wait, (double)ctx->sc_win_recs / scrub_iops -
+				 elapsed);
+	if (scrub_bw != 0)
+		wait = max(wait, (double)ctx->sc_win_bytes / scrub_bw -
+				 elapsed);
+	/* busy time should be within pct% of the wall time */
+	if (pct != 0)
+		wait = max(wait, busy * 100 / pct - elapsed);
+
+	/* sleep for the accumulated debt instead of each record */
+	if (wait < SCRUB_RUN_MAX && now - ctx->sc_run_start < SCRUB_RUN_MAX)
+		return ctx->sc_child->spc_scrub_stop ? 1 : 0;
+
+	ctx->sc_win_busy = busy;
+	if (wait > 0) {
+		rc = scrub_sleep(ctx->sc_child, wait);
+	} else {
+		ABT_thread_yield();
+		rc = ctx->sc_child->spc_scrub_stop ? 1 : 0;
+	}
+	ctx->sc_yields++;
+
+	now = ABT_get_wtime();
+	if (now - ctx->sc_win_start >= SCRUB_WINDOW) {
+		ctx->sc_win_start = now;
+		ctx->sc_win_busy  = 0;
+		ctx->sc_win_recs  = 0;
+		ctx->sc_win_bytes = 0;
+	}
+	ctx->sc_run_start = now;
+	return rc;
+}
+
+static void
+scrub_report(struct scrub_ctx *ctx, vos_iter_type_t type,
+	     vos_iter_param_t *param, vos_iter_entry_t *ent)
+{
+	D_ERROR(DF_UUID": corrupted %s of "DF_UOID" akey %.*s, "
+		"recx "DF_U64"/"DF_U64" epoch "DF_U64"\n",
+		DP_UUID(ctx->sc_child->spc_uuid),
+		type == VOS_ITER_SINGLE ? "single value" : "extent",
+		DP_UOID(param->ip_oid), (int)param->ip_akey.iov_len,
+		(char *)param->ip_akey.iov_buf, ent->ie_recx.rx_idx,
+		ent->ie_recx.rx_nr, ent->ie_epr.epr_lo);
+	ctx->sc_corrupted++;
+	ctx->sc_child->spc_scrub_corrupted++;
+}
+
+/**
+ * Read an extent stored on NVMe to \a iov, which is allocated by this
+ * function. The read yields, so the scrubber restarts the iterator after it.
+ *
+ * \return	0 on success, 1 if the extent can't be verified.
+ */
+static int
+scrub_nvme_read(struct scrub_ctx *ctx, vos_iter_param_t *param,
+		daos_handle_t ih, vos_iter_entry_t *ent, daos_iov_t *iov)
+{
+	daos_size_t	len = ent->ie_recx.rx_nr * ent->ie_rsize;
+	int		rc;
+
+	D_ALLOC(iov->iov_buf, len);
+	if (iov->iov_buf == NULL)
+		return -DER_NOMEM;
+	iov->iov_buf_len = len;
+	iov->iov_len = 0;
+
+	rc = vos_iter_copy(ih, iov);
+	ctx->sc_yields++;
+	if (rc == 0)
+		return 0;
+
+	D_ERROR(DF_UUID": can't read extent of "DF_UOID" akey %.*s, recx "
+		DF_U64"/"DF_U64" epoch "DF_U64" from NVMe: %d\n",
+		DP_UUID(ctx->sc_child->spc_uuid), DP_UOID(param->ip_oid),
+		(int)param->ip_akey.iov_len, (char *)param->ip_akey.iov_buf,
+		ent->ie_recx.rx_idx, ent->ie_recx.rx_nr, ent->ie_epr.epr_lo,
+		rc);
+	ctx->sc_unverified++;
+	daos_iov_free(iov);
+	return rc == -DER_NOMEM ? rc : 1;
+}
+
+/**
+ * Verify checksum of a single value or an extent returned by iterator. Data
+ * of extents on NVMe is read from the device, because the tree may change
+ * while reading, a mismatch is only reported once the scrubber has checked
+ * the extent is still there, see scrub_iterate().
+ */
+static int
+scrub_verify(struct scrub_ctx *ctx, vos_iter_type_t type,
+	     vos_iter_param_t *param, daos_handle_t ih, vos_iter_entry_t *ent)
+{
+	daos_csum_buf_t	*cs = &ent->ie_csum;
+	daos_csum_buf_t	 result;
+	daos_sg_list_t	 sgl;
+	daos_iov_t	 iov;
+	const char	*name;
+	char		 buf[DAOS_CSUM_SIZE];
+	char		 stored[DAOS_CSUM_SIZE];
+	int		 rc;
+
+	/* punched record or no checksum */
+	if (cs->cs_len == 0 || cs->cs_csum == NULL)
+		return 0;
+
+	if (!ent->ie_nvme &&
+	    (ent->ie_iov.iov_buf == NULL || ent->ie_iov.iov_len == 0))
+		return 0;
+
+	if (ctx->sc_csum_type != cs->cs_type) {
+		name = daos_csum_type2name(cs->cs_type);
+		if (name == NULL) {
+			D_ERROR("Unknown checksum type %u\n", cs->cs_type);
+			return 0;
+		}
+
+		if (ctx->sc_csum_type != DAOS_CS_UNKNOWN)
+			daos_csum_free(&ctx->sc_csum);
+		ctx->sc_csum_type = DAOS_CS_UNKNOWN;
+
+		rc = daos_csum_init(name, &ctx->sc_csum);
+		if (rc != 0)
+			return rc;
+		ctx->sc_csum_type = cs->cs_type;
+	}
+
+	if (ent->ie_nvme) {
+		if (cs->cs_len > sizeof(stored)) {
+			ctx->sc_unverified++;
+			return 0;
+		}
+		/* the stored checksum is in the tree, save it before reading
+		 * the data, which yields
+		 */
+		memcpy(stored, cs->cs_csum, cs->cs_len);
+		cs->cs_csum = stored;
+
+		rc = scrub_nvme_read(ctx, param, ih, ent, &iov);
+		if (rc != 0)
+			return rc > 0 ? 0 : rc;
+		ctx->sc_nvme_recs++;
+	} else {
+		iov = ent->ie_iov;
+	}
+
+	rc = daos_csum_reset(&ctx->sc_csum);
+	if (rc != 0)
+		D_GOTO(out, rc);
+
+	sgl.sg_nr = sgl.sg_nr_out = 1;
+	sgl.sg_iovs = &iov;
+	rc = daos_csum_compute(&ctx->sc_csum, &sgl);
+	if (rc != 0)
+		D_GOTO(out, rc);
+
+	daos_csum_set(&result, buf, daos_csum_get_size(&ctx->sc_csum));
+	rc = daos_csum_get(&ctx->sc_csum, &result);
+	if (rc != 0)
+		D_GOTO(out, rc);
+
+	ctx->sc_recs++;
+	ctx->sc_bytes += iov.iov_len;
+	ctx->sc_win_recs++;
+	ctx->sc_win_bytes += iov.iov_len;
+
+	if (cs->cs_len != result.cs_buf_len ||
+	    memcmp(cs->cs_csum, result.cs_csum, cs->cs_len) != 0) {
+		if (ent->ie_nvme)
+			ctx->sc_recheck = true;
+		else
+			scrub_report(ctx, type, param, ent);
+	}
+out:
+	if (ent->ie_nvme)
+		daos_iov_free(&iov);
+	return rc;
+}
+
+static int scrub_iterate(struct scrub_ctx *ctx, vos_iter_type_t type,
+			 vos_iter_param_t *param);
+
+/** Descend into the entry \a ent returned by the iterator of \a type */
+static int
+scrub_entry(struct scrub_ctx *ctx, vos_iter_type_t type,
+	    vos_iter_param_t *param, daos_handle_t ih, vos_iter_entry_t *ent)
+{
+	vos_iter_param_t	sub = *param;
+	daos_handle_t		coh;
+	daos_key_t		key;
+	int			rc;
+
+	switch (type) {
+	default:
+		D_ASSERTF(0, "invalid iterator type %d\n", type);
+		return -DER_INVAL;
+
+	case VOS_ITER_COUUID:
+		if (uuid_is_null(ent->ie_couuid))
+			return 0;
+
+		rc = vos_cont_open(param->ip_hdl, ent->ie_couuid, &coh);
+		if (rc != 0) {
+			D_ERROR("Open container "DF_UUID" failed: rc = %d\n",
+				DP_UUID(ent->ie_couuid), rc);
+			return rc;
+		}
+
+		memset(&sub, 0, sizeof(sub));
+		sub.ip_hdl = coh;
+		sub.ip_epr.epr_lo = 0;
+		sub.ip_epr.epr_hi = DAOS_EPOCH_MAX;
+		rc = scrub_iterate(ctx, VOS_ITER_OBJ, &sub);
+		vos_cont_close(coh);
+		return rc;
+
+	case VOS_ITER_OBJ:
+		sub.ip_oid = ent->ie_oid;
+		rc = scrub_iterate(ctx, VOS_ITER_DKEY, &sub);
+		if (rc != 0)
+			return rc;
+		/* give the xstream back even if there is nothing to verify */
+		return scrub_throttle(ctx);
+
+	case VOS_ITER_DKEY:
+	case VOS_ITER_AKEY:
+		/* the returned key is in the tree, which may change once
+		 * the scrubber yields
+		 */
+		rc = daos_iov_copy(&key, &ent->ie_key);
+		if (rc != 0)
+			return rc;
+
+		if (type == VOS_ITER_DKEY) {
+			sub.ip_dkey = key;
+			rc = scrub_iterate(ctx, VOS_ITER_AKEY, &sub);
+		} else {
+			sub.ip_akey = key;
+			sub.ip_epc_expr = VOS_IT_EPC_RE;
+			rc = scrub_iterate(ctx, VOS_ITER_SINGLE, &sub);
+			if (rc == 0)
+				rc = scrub_iterate(ctx, VOS_ITER_RECX, &sub);
+		}
+		daos_iov_free(&key);
+		return rc;
+
+	case VOS_ITER_SINGLE:
+	case VOS_ITER_RECX:
+		rc = scrub_verify(ctx, type, param, ih, ent);
+		if (rc != 0)
+			return rc;
+		return scrub_throttle(ctx);
+	}
+}
+
+/**
+ * Restart the iterator of \a type from \a anchor, after the scrubber yielded
+ * while the iterator was open.
+ *
+ * \return	0 if the cursor is at the entry of \a anchor, 1 if the entry
+ *		is gone and the cursor is at the next one, or negative errno.
+ */
+static int
+scrub_iter_restart(vos_iter_type_t type, vos_iter_param_t *param,
+		   daos_handle_t *ih, daos_hash_out_t *anchor)
+{
+	vos_iter_entry_t	ent;
+	daos_hash_out_t		cur;
+	int			rc;
+
+	vos_iter_finish(*ih);
+	*ih = DAOS_HDL_INVAL;
+
+	rc = vos_iter_prepare(type, param, ih);
+	if (rc != 0) {
+		*ih = DAOS_HDL_INVAL;
+		return rc;
+	}
+
+	rc = vos_iter_probe(*ih, anchor);
+	if (rc != 0)
+		return rc;
+
+	memset(&cur, 0, sizeof(cur));
+	rc = vos_iter_fetch(*ih, &ent, &cur);
+	if (rc != 0)
+		return rc;
+
+	return memcmp(&cur, anchor, sizeof(cur)) == 0 ? 0 : 1;
+}
+
+/**
+ * Iterate all entries of \a type under \a param.
+ *
+ * \return	0 if all entries have been scrubbed, 1 if the scrubber should
+ *		stop, or negative errno.
+ */
+static int
+scrub_iterate(struct scrub_ctx *ctx, vos_iter_type_t type,
+	      vos_iter_param_t *param)
+{
+	vos_iter_entry_t	ent;
+	daos_hash_out_t		anchor;
+	daos_handle_t		ih;
+	uint64_t		yields;
+	int			rc;
+
+	rc = vos_iter_prepare(type, param, &ih);
+	if (rc != 0) {
+		if (rc == -DER_NONEXIST)
+			return 0;
+		D_ERROR("prepare iterator %d failed: %d\n", type, rc);
+		return rc;
+	}
+
+	rc = vos_iter_probe(ih, NULL);
+	if (rc != 0) {
+		if (rc == -DER_NONEXIST)
+			rc = 0;
+		else
+			D_ERROR("set iterator %d cursor failed: %d\n",
+				type, rc);
+		D_GOTO(out, rc);
+	}
+
+	while (1) {
+		memset(&anchor, 0, sizeof(anchor));
+		rc = vos_iter_fetch(ih, &ent, &anchor);
+		if (rc != 0) {
+			if (rc == -DER_NONEXIST)
+				rc = 0;
+			else
+				D_ERROR("fetch iterator %d failed: %d\n",
+					type, rc);
+			break;
+		}
+
+		yields = ctx->sc_yields;
+		rc = scrub_entry(ctx, type, param, ih, &ent);
+		if (rc != 0)
+			break;
+
+		if (ctx->sc_yields != yields) {
+			rc = scrub_iter_restart(type, param, &ih, &anchor);
+			/* the mismatched extent hasn't been replaced */
+			if (ctx->sc_recheck && rc == 0)
+				scrub_report(ctx, type, param, &ent);
+			ctx->sc_recheck = false;
+
+			if (rc == 1) /* the entry is gone, at the next one */
+				continue;
+
+			if (rc == -DER_NONEXIST) {
+				rc = 0;
+				break;
+			} else if (rc == -DER_AGAIN) {
+				/* extent has been changed, the rest of the
+				 * tree will be scrubbed by the next pass
+				 */
+				D_DEBUG(DF_DSMS, "iterator %d moved\n", type);
+				rc = 0;
+				break;
+			} else if (rc != 0) {
+				D_ERROR("restart iterator %d failed: %d\n",
+					type, rc);
+				break;
+			}
+		}
+
+		rc = vos_iter_next(ih);
+		if (rc != 0) {
+			if (rc == -DER_NONEXIST)
+				rc = 0;
+			break;
+		}
+	}
+out:
+	if (!daos_handle_is_inval(ih))
+		vos_iter_finish(ih);
+	return rc;
+}
+
+static void
+scrub_ult(void *arg)
+{
+	struct ds_pool_child	*child = arg;
+	struct scrub_ctx	 ctx;
+	vos_iter_param_t	 param;
+	double			 start;
+	double			 wait;
+	int			 rc;
+
+	while (!child->spc_scrub_stop) {
+		start = ABT_get_wtime();
+
+		memset(&ctx, 0, sizeof(ctx));
+		ctx.sc_child	 = child;
+		ctx.sc_csum_type = DAOS_CS_UNKNOWN;
+		ctx.sc_win_start = ctx.sc_run_start = start;
+
+		memset(&param, 0, sizeof(param));
+		param.ip_hdl = child->spc_hdl;
+
+		rc = scrub_iterate(&ctx, VOS_ITER_COUUID, &param);
+		if (ctx.sc_csum_type != DAOS_CS_UNKNOWN)
+			daos_csum_free(&ctx.sc_csum);
+
+		D_DEBUG(DF_DSMS, DF_UUID": scrubbed "DF_U64" records ("DF_U64
+			" on NVMe) "DF_U64" bytes in %.1f secs, "DF_U64
+			" corrupted, "DF_U64" unverified: %d\n",
+			DP_UUID(child->spc_uuid), ctx.sc_recs, ctx.sc_nvme_recs,
+			ctx.sc_bytes, ABT_get_wtime() - start,
+			ctx.sc_corrupted, ctx.sc_unverified, rc);
+
+		if (rc > 0) /* stopped */
+			break;
+
+		/* the pass could take longer than the interval */
+		wait = max(start + scrub_interval - ABT_get_wtime(), 0.0);
+		if (scrub_sleep(child, wait))
+			break;
+	}
+}
+
+/**
+ * Start the scrubber for \a child on the current xstream, it's a no-op
+ * if the scrubber is disabled.
+ */
+int
+ds_pool_scrub_start(struct ds_pool_child *child)
+{
+	int	rc;
+
+	child->spc_scrub_ult = ABT_THREAD_NULL;
+	child->spc_scrub_stop = false;
+	if (scrub_interval == 0)
+		return 0;
+
+	rc = ABT_mutex_create(&child->spc_scrub_lock);
+	if (rc != ABT_SUCCESS)
+		D_GOTO(out, rc = dss_abterr2der(rc));
+
+	rc = ABT_cond_create(&child->spc_scrub_cv);
+	if (rc != ABT_SUCCESS) {
+		ABT_mutex_free(&child->spc_scrub_lock);
+		D_GOTO(out, rc = dss_abterr2der(rc));
+	}
+
+	rc = dss_ult_create_pool(scrub_ult, child, DSS_POOL_SCRUB,
+				 &child->spc_scrub_ult);
+	if (rc != 0) {
+		ABT_cond_free(&child->spc_scrub_cv);
+		ABT_mutex_free(&child->spc_scrub_lock);
+	}
+out:
+	if (rc != 0)
+		D_ERROR(DF_UUID": failed to start scrubber: %d\n",
+			DP_UUID(child->spc_uuid), rc);
+	return rc;
+}
+
+/** Stop the scrubber of \a child and wait for its completion */
+void
+ds_pool_scrub_stop(struct ds_pool_child *child)
+{
+	if (child->spc_scrub_ult == ABT_THREAD_NULL)
+		return;
+
+	ABT_mutex_lock(child->spc_scrub_lock);
+	child->spc_scrub_stop = true;
+	ABT_cond_broadcast(child->spc_scrub_cv);
+	ABT_mutex_unlock(child->spc_scrub_lock);
+
+	ABT_thread_join(child->spc_scrub_ult);
+	ABT_thread_free(&child->spc_scrub_ult);
+	child->spc_scrub_ult = ABT_THREAD_NULL;
+	ABT_cond_free(&child->spc_scrub_cv);
+	ABT_mutex_free(&child->spc_scrub_lock);
+}
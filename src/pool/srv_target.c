@@ -89,6 +89,7 @@ ds_pool_child_purge(struct pool_tls *tls)
 	d_list_for_each_entry_safe(child, n, &tls->dt_pool_list, spc_list) {
 		D_ASSERTF(child->spc_ref == 1, DF_UUID": %d\n",
 			  DP_UUID(child->spc_uuid), child->spc_ref);
+		ds_pool_scrub_stop(child);
 		d_list_del_init(&child->spc_list);
 		ds_pool_child_put(child);
 	}
@@ -145,6 +146,8 @@ ds_pool_child_open(uuid_t uuid, unsigned int version)
 
 	d_list_add(&child->spc_list, &tls->dt_pool_list);
 
+	/* the pool is usable without scrubber, don't fail the open */
+	ds_pool_scrub_start(child);
 	return 0;
 }
 
@@ -169,6 +172,7 @@ ds_pool_child_close(uuid_t uuid)
 	if (child == NULL)
 		return 0;
 
+	ds_pool_scrub_stop(child);
 	d_list_del_init(&child->spc_list);
 	ds_pool_child_put(child); /* -1 for the list */
 	ds_pool_child_put(child); /* -1 for lookup */
@@ -142,6 +142,7 @@ rdb_kvs_alloc_ref(void *key, unsigned int ksize, void *varg,
 		D_GOTO(err_path, rc);
 
 	D_DEBUG(DB_ANY, DF_DB": created %p len %u\n", DP_DB(db), kvs, ksize);
+	kvs->de_entry.ll_cost = sizeof(*kvs) + ksize;
 	*link = &kvs->de_entry;
 	return 0;
 
@@ -186,8 +187,18 @@ static struct daos_llink_ops rdb_kvs_cache_ops = {
 int
 rdb_kvs_cache_create(struct daos_lru_cache **cache)
 {
-	return daos_lru_cache_create(5 /* bits */, D_HASH_FT_NOLOCK /* feats */,
-				     &rdb_kvs_cache_ops, cache);
+	int rc;
+
+	rc = daos_lru_cache_create(5 /* bits */, D_HASH_FT_NOLOCK /* feats */,
+				   &rdb_kvs_cache_ops, cache);
+	if (rc != 0)
+		return rc;
+
+	/* Keep KVSs looked up repeatedly over one-off ones. */
+	rc = daos_lru_cache_config(*cache, 0 /* budget */, DAOS_LRU_POL_2Q);
+	if (rc != 0)
+		daos_lru_cache_destroy(*cache);
+	return rc;
 }
 
 void
@@ -1090,16 +1090,17 @@ rdb_raft_start(struct rdb *db)
 	raft_set_election_timeout(db->d_raft, election_timeout);
 	raft_set_request_timeout(db->d_raft, request_timeout);
 
-	rc = dss_ult_create(rdb_applyd, db, -1, &db->d_applyd);
+	/* raft isn't locked, all daemons must run on this xstream */
+	rc = dss_ult_create(rdb_applyd, db, DSS_XS_SELF, &db->d_applyd);
 	if (rc != 0)
 		D_GOTO(err_nodes, rc);
-	rc = dss_ult_create(rdb_recvd, db, -1, &db->d_recvd);
+	rc = dss_ult_create(rdb_recvd, db, DSS_XS_SELF, &db->d_recvd);
 	if (rc != 0)
 		D_GOTO(err_applyd, rc);
-	rc = dss_ult_create(rdb_timerd, db, -1, &db->d_timerd);
+	rc = dss_ult_create(rdb_timerd, db, DSS_XS_SELF, &db->d_timerd);
 	if (rc != 0)
 		D_GOTO(err_recvd, rc);
-	rc = dss_ult_create(rdb_callbackd, db, -1, &db->d_callbackd);
+	rc = dss_ult_create(rdb_callbackd, db, DSS_XS_SELF, &db->d_callbackd);
 	if (rc != 0)
 		D_GOTO(err_timerd, rc);
 
@@ -813,6 +813,7 @@ rebuild_obj_handler(crt_rpc_t *rpc)
 	uint32_t			*shards;
 	unsigned int			shards_count;
 	daos_handle_t			btr_hdl;
+	unsigned int			nr;
 	unsigned int			i;
 	int				rc;
 
@@ -849,8 +850,30 @@ rebuild_obj_handler(crt_rpc_t *rpc)
 				      rpt->rt_rebuild_ver);
 	D_ASSERT(tls != NULL);
 
-	/* Insert these oids/conts into the local rebuild tree */
-	for (i = 0; i < oids_count; i++) {
+	/* Insert these oids/conts into the local rebuild tree, objects of
+	 * the same container are usually adjacent, insert them in bulk.
+	 */
+	for (i = 0; i < oids_count; i += nr) {
+		for (nr = 1; i + nr < oids_count; nr++) {
+			if (uuid_compare(co_uuids[i], co_uuids[i + nr]) != 0)
+				break;
+		}
+
+		if (nr > 1) {
+			rc = rebuild_cont_obj_bulk_insert(btr_hdl, co_uuids[i],
+							  &oids[i], &shards[i],
+							  nr);
+			if (rc < 0)
+				break;
+
+			tls->rebuild_pool_obj_count += rc;
+			D_DEBUG(DB_REBUILD, "insert %d/%u local objects "
+				DF_UUID" hdl %"PRIx64"\n", rc, nr,
+				DP_UUID(co_uuids[i]), btr_hdl.cookie);
+			rc = 0;
+			continue;
+		}
+
 		rc = rebuild_cont_obj_insert(btr_hdl, co_uuids[i],
 					     oids[i], shards[i]);
 		if (rc == 1) {
@@ -886,7 +909,7 @@ rebuild_obj_handler(crt_rpc_t *rpc)
 		arg->rpt = rpt;
 
 		D_ASSERT(rpt->rt_pullers != NULL);
-		rc = dss_ult_create(rebuild_puller, arg, -1, NULL);
+		rc = dss_ult_create(rebuild_puller, arg, DSS_XS_SELF, NULL);
 		if (rc) {
 			rpt_put(rpt);
 			D_FREE_PTR(arg);
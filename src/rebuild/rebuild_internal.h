@@ -264,6 +264,11 @@ int
 rebuild_cont_obj_insert(daos_handle_t toh, uuid_t co_uuid,
 			daos_unit_oid_t oid, unsigned int shard);
 
+int
+rebuild_cont_obj_bulk_insert(daos_handle_t toh, uuid_t co_uuid,
+			     daos_unit_oid_t *oids, uint32_t *shards,
+			     unsigned int nr);
+
 struct rebuild_tgt_pool_tracker *
 rpt_lookup(uuid_t pool_uuid, unsigned int ver);
 
@@ -443,6 +443,77 @@ out:
 	return rc;
 }
 
+/**
+ * Insert a batch of objects of the same container into the rebuild tree,
+ * the container tree is bulk loaded if it is empty.
+ *
+ * \return	number of new objects inserted, or negative error code.
+ */
+int
+rebuild_cont_obj_bulk_insert(daos_handle_t toh, uuid_t co_uuid,
+			     daos_unit_oid_t *oids, uint32_t *shards,
+			     unsigned int nr)
+{
+	struct rebuild_root	*cont_root;
+	daos_unit_oid_t		*keys = NULL;
+	daos_iov_t		*key_iovs = NULL;
+	daos_iov_t		*val_iovs = NULL;
+	daos_iov_t		key_iov;
+	daos_iov_t		val_iov;
+	unsigned int		new_nr = 0;
+	int			i;
+	int			rc;
+
+	daos_iov_set(&key_iov, co_uuid, sizeof(uuid_t));
+	daos_iov_set(&val_iov, NULL, 0);
+	rc = dbtree_lookup(toh, &key_iov, &val_iov);
+	if (rc < 0) {
+		if (rc != -DER_NONEXIST)
+			D_GOTO(out, rc);
+
+		rc = rebuild_uuid_tree_create(toh, co_uuid,
+					      &cont_root);
+		if (rc)
+			D_GOTO(out, rc);
+	} else {
+		cont_root = val_iov.iov_buf;
+	}
+
+	D_ALLOC(keys, nr * sizeof(*keys));
+	D_ALLOC(key_iovs, nr * sizeof(*key_iovs));
+	D_ALLOC(val_iovs, nr * sizeof(*val_iovs));
+	if (keys == NULL || key_iovs == NULL || val_iovs == NULL)
+		D_GOTO(out, rc = -DER_NOMEM);
+
+	for (i = 0; i < nr; i++) {
+		keys[i] = oids[i];
+		keys[i].id_shard = shards[i];
+		daos_iov_set(&key_iovs[i], &keys[i], sizeof(keys[i]));
+		daos_iov_set(&val_iovs[i], &shards[i], sizeof(shards[i]));
+	}
+
+	/* NB: the value of an existing object is its shard, which is
+	 * also part of the key, so overwriting it changes nothing.
+	 */
+	rc = dbtree_bulk_insert(cont_root->root_hdl, key_iovs, val_iovs, nr,
+				0, &new_nr);
+	if (rc < 0) {
+		D_ERROR("failed to insert %u objects in cont "DF_UUID
+			": rc %d\n", nr, DP_UUID(co_uuid), rc);
+		D_GOTO(out, rc);
+	}
+	cont_root->count += new_nr;
+	D_DEBUG(DB_REBUILD, "bulk insert %u/%u objects in cont "DF_UUID
+		" cont_root %p count %d\n", new_nr, nr, DP_UUID(co_uuid),
+		cont_root, cont_root->count);
+	rc = new_nr;
+out:
+	D_FREE(keys);
+	D_FREE(key_iovs);
+	D_FREE(val_iovs);
+	return rc;
+}
+
 /**
  * The rebuild objects will be gathered into a global objects arrary by
  * target id.
@@ -791,7 +862,7 @@ rebuild_tgt_scan_handler(crt_rpc_t *rpc)
 		D_GOTO(out, rc);
 
 	rpt_get(rpt);
-	rc = dss_ult_create(rebuild_tgt_status_check, rpt, -1, NULL);
+	rc = dss_ult_create(rebuild_tgt_status_check, rpt, DSS_XS_SELF, NULL);
 	if (rc) {
 		rpt_put(rpt);
 		D_GOTO(out, rc);
@@ -824,8 +895,10 @@ rebuild_tgt_scan_handler(crt_rpc_t *rpc)
 
 	rpt_get(rpt);
 	scan_arg->rpt = rpt;
-	/* step-3: start scann leader */
-	rc = dss_ult_create(rebuild_scan_leader, scan_arg, -1, NULL);
+	/* step-3: start scann leader, it only drives the collective scan and
+	 * sends RPCs, so any idle xstream can run it.
+	 */
+	rc = dss_ult_create(rebuild_scan_leader, scan_arg, DSS_XS_ANY, NULL);
 	if (rc != 0) {
 		rpt_put(rpt);
 		D_GOTO(out_f_rankfs, rc);
@@ -63,6 +63,8 @@ bool			 ts_single	= true;
 bool			 ts_overwrite;
 /* use zero-copy API for VOS, ignored for "echo" or "daos" */
 bool			 ts_zero_copy;
+/* value size of the running test */
+int			 ts_vsize;
 
 uuid_t			 ts_cookie;		/* update cookie for VOS */
 daos_handle_t		 ts_oh;			/* object open handle */
@@ -129,7 +131,7 @@ ts_key_insert(void)
 	int		*indices;
 	char		 dkey_buf[DTS_KEY_LEN];
 	char		 akey_buf[DTS_KEY_LEN];
-	int		 vsize = ts_ctx.tsc_cred_vsize;
+	int		 vsize = ts_vsize;
 	int		 i;
 	int		 j;
 	int		 rc = 0;
@@ -444,6 +446,11 @@ The options are as follows:\n\
 	Size of single value, or extent size of array value. The number can\n\
 	have 'K' or 'M' as postfix which stands for kilobyte or megabytes.\n\
 \n\
+-S number\n\
+	Sweep value size of the update test, it is doubled from the size of\n\
+	-s until this number, e.g. -s 1K -S 128K shows where the inline and\n\
+	bulk transfer cross over.\n\
+\n\
 -z	Use zero copy API, this option is only valid for 'vos'\n\
 \n\
 -t	Instead of using different indices and epochs, all I/Os land to the\n\
@@ -468,6 +475,7 @@ static struct option ts_ops[] = {
 	{ "recx",	required_argument,	NULL,	'r' },
 	{ "array",	no_argument,		NULL,	'A' },
 	{ "size",	required_argument,	NULL,	's' },
+	{ "sweep",	required_argument,	NULL,	'S' },
 	{ "zcopy",	no_argument,		NULL,	'z' },
 	{ "overwrite",	no_argument,		NULL,	't' },
 	{ "file",	required_argument,	NULL,	'f' },
@@ -563,6 +571,7 @@ main(int argc, char **argv)
 	daos_size_t	pool_size = (2ULL << 30); /* default pool size */
 	int		credits   = -1;	/* sync mode */
 	int		vsize	   = 32;	/* default value size */
+	int		sweep	   = 0;	/* max value size of sweep */
 	d_rank_t	svc_rank  = 0;	/* pool service rank */
 	double		then;
 	double		now;
@@ -574,7 +583,7 @@ main(int argc, char **argv)
 	MPI_Comm_size(MPI_COMM_WORLD, &ts_ctx.tsc_mpi_size);
 
 	memset(ts_pmem_file, 0, sizeof(ts_pmem_file));
-	while ((rc = getopt_long(argc, argv, "P:T:C:o:d:a:r:As:ztf:hUR",
+	while ((rc = getopt_long(argc, argv, "P:T:C:o:d:a:r:As:S:ztf:hUR",
 				 ts_ops, NULL)) != -1) {
 		char	*endp;
 
@@ -631,6 +640,10 @@ main(int argc, char **argv)
 			vsize = strtoul(optarg, &endp, 0);
 			vsize = ts_val_factor(vsize, *endp);
 			break;
+		case 'S':
+			sweep = strtoul(optarg, &endp, 0);
+			sweep = ts_val_factor(sweep, *endp);
+			break;
 		case 't':
 			ts_overwrite = true;
 			break;
@@ -694,7 +707,9 @@ main(int argc, char **argv)
 		ts_ctx.tsc_svc.rl_nr = 1;
 		ts_ctx.tsc_svc.rl_ranks  = &svc_rank;
 	}
-	ts_ctx.tsc_cred_vsize	= vsize;
+	/* buffers of credits are allocated for the largest value */
+	ts_ctx.tsc_cred_vsize	= max(vsize, sweep);
+	ts_vsize		= vsize;
 	ts_ctx.tsc_pool_size	= pool_size;
 
 	if (ts_ctx.tsc_mpi_rank == 0) {
@@ -737,24 +752,41 @@ main(int argc, char **argv)
 	MPI_Barrier(MPI_COMM_WORLD);
 
 	for (i = 0; i < TEST_SIZE; i++) {
+		char	name[64];
+
 		if (perf_tests[i] == NULL)
 			continue;
 
-		rc = perf_tests[i](&then, &now);
-		if (ts_ctx.tsc_mpi_size > 1) {
-			int rc_g;
+		ts_vsize = vsize;
+		do {
+			rc = perf_tests[i](&then, &now);
+			if (ts_ctx.tsc_mpi_size > 1) {
+				int rc_g;
 
-			MPI_Allreduce(&rc, &rc_g, 1, MPI_INT, MPI_MIN,
-				      MPI_COMM_WORLD);
-			rc = rc_g;
-		}
+				MPI_Allreduce(&rc, &rc_g, 1, MPI_INT, MPI_MIN,
+					      MPI_COMM_WORLD);
+				rc = rc_g;
+			}
+
+			if (rc != 0)
+				break;
+
+			if (i == UPDATE_TEST && sweep > vsize) {
+				snprintf(name, sizeof(name), "%s (%d bytes)",
+					 perf_tests_name[i], ts_vsize);
+				show_result(now, then, ts_vsize, name);
+			} else {
+				show_result(now, then, vsize,
+					    perf_tests_name[i]);
+			}
+			ts_vsize *= 2;
+		} while (i == UPDATE_TEST && ts_vsize <= sweep);
 
 		if (rc != 0) {
 			fprintf(stderr, "Failed: %d\n", rc);
 			break;
 		}
-
-		show_result(now, then, vsize, perf_tests_name[i]);
+		ts_vsize = vsize;
 	}
 
 	dts_ctx_fini(&ts_ctx);
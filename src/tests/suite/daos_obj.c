@@ -1737,6 +1737,225 @@ update_overlapped_recxs(void **state)
 	print_message("all good\n");
 }
 
+#define CSUM_ARRAY_LEN	8192	/* large enough for bulk transfer */
+#define CSUM_SINGLE_LEN	16
+
+/**
+ * Update an array extent and a single value through a container handle with
+ * end-to-end checksum, fetch them back and check stored checksums are
+ * returned for the whole extent but not for a partial one.
+ */
+static void
+io_csum(void **state)
+{
+	test_arg_t	*arg = *state;
+	daos_obj_id_t	 oid;
+	daos_handle_t	 coh;
+	daos_handle_t	 oh;
+	daos_epoch_t	 epoch = 3;
+	daos_iov_t	 dkey;
+	daos_sg_list_t	 sgls[2];
+	daos_iov_t	 sg_iovs[2];
+	daos_iod_t	 iods[2];
+	daos_recx_t	 recx;
+	daos_csum_buf_t	 csums[2];
+	uint64_t	 csum_vals[2];
+	char		*buf;
+	char		*buf_out;
+	char		 single[CSUM_SINGLE_LEN];
+	char		 single_out[CSUM_SINGLE_LEN];
+	int		 i;
+	int		 rc;
+
+	rc = daos_cont_open(arg->poh, arg->co_uuid,
+			    DAOS_COO_RW | DAOS_COO_CSUM, &coh, NULL, NULL);
+	assert_int_equal(rc, 0);
+
+	oid = dts_oid_gen(dts_obj_class, 0, arg->myrank);
+	rc = daos_obj_open(coh, oid, 0, 0, &oh, NULL);
+	assert_int_equal(rc, 0);
+
+	buf = malloc(CSUM_ARRAY_LEN);
+	buf_out = malloc(CSUM_ARRAY_LEN);
+	assert_non_null(buf);
+	assert_non_null(buf_out);
+	dts_buf_render(buf, CSUM_ARRAY_LEN);
+	dts_buf_render(single, CSUM_SINGLE_LEN);
+
+	daos_iov_set(&dkey, "csum_dkey", strlen("csum_dkey"));
+	for (i = 0; i < 2; i++) {
+		sgls[i].sg_nr	  = 1;
+		sgls[i].sg_nr_out = 0;
+		sgls[i].sg_iovs	  = &sg_iovs[i];
+		daos_csum_set(&iods[i].iod_kcsum, NULL, 0);
+		iods[i].iod_nr	  = 1;
+		iods[i].iod_eprs  = NULL;
+		iods[i].iod_csums = NULL;
+	}
+	daos_iov_set(&sg_iovs[0], buf, CSUM_ARRAY_LEN);
+	daos_iov_set(&sg_iovs[1], single, CSUM_SINGLE_LEN);
+
+	recx.rx_idx = 0;
+	recx.rx_nr  = CSUM_ARRAY_LEN;
+	daos_iov_set(&iods[0].iod_name, "array", strlen("array"));
+	iods[0].iod_type  = DAOS_IOD_ARRAY;
+	iods[0].iod_size  = 1;
+	iods[0].iod_recxs = &recx;
+
+	daos_iov_set(&iods[1].iod_name, "single", strlen("single"));
+	iods[1].iod_type  = DAOS_IOD_SINGLE;
+	iods[1].iod_size  = CSUM_SINGLE_LEN;
+	iods[1].iod_recxs = NULL;
+
+	print_message("update with checksum\n");
+	rc = daos_obj_update(oh, epoch, &dkey, 2, iods, sgls, NULL);
+	assert_int_equal(rc, 0);
+
+	print_message("fetch and get stored checksums\n");
+	daos_iov_set(&sg_iovs[0], buf_out, CSUM_ARRAY_LEN);
+	daos_iov_set(&sg_iovs[1], single_out, CSUM_SINGLE_LEN);
+	for (i = 0; i < 2; i++) {
+		csum_vals[i] = 0;
+		daos_csum_set(&csums[i], &csum_vals[i], sizeof(csum_vals[i]));
+		csums[i].cs_len = 0;
+		iods[i].iod_csums = &csums[i];
+	}
+	rc = daos_obj_fetch(oh, epoch, &dkey, 2, iods, sgls, NULL, NULL);
+	assert_int_equal(rc, 0);
+	assert_memory_equal(buf, buf_out, CSUM_ARRAY_LEN);
+	assert_memory_equal(single, single_out, CSUM_SINGLE_LEN);
+	for (i = 0; i < 2; i++) {
+		assert_int_not_equal(csums[i].cs_len, 0);
+		assert_int_equal(csums[i].cs_type, csums[0].cs_type);
+	}
+
+	print_message("fetch part of the extent, no checksum returned\n");
+	recx.rx_idx = 1;
+	recx.rx_nr  = CSUM_ARRAY_LEN / 2;
+	daos_iov_set(&sg_iovs[0], buf_out, CSUM_ARRAY_LEN / 2);
+	rc = daos_obj_fetch(oh, epoch, &dkey, 1, iods, sgls, NULL, NULL);
+	assert_int_equal(rc, 0);
+	assert_memory_equal(&buf[1], buf_out, CSUM_ARRAY_LEN / 2);
+	assert_int_equal(csums[0].cs_len, 0);
+
+	free(buf);
+	free(buf_out);
+	rc = daos_obj_close(oh, NULL);
+	assert_int_equal(rc, 0);
+	rc = daos_cont_close(coh, NULL);
+	assert_int_equal(rc, 0);
+	print_message("all good\n");
+}
+
+/** number of small updates issued at once by io_batch */
+#define BATCH_UPDATE_NR	8
+
+/**
+ * Small updates of one shard issued in the same progress window are sent by
+ * one batch RPC, and each of them is completed with its own result.
+ */
+static void
+io_batch(void **state)
+{
+	test_arg_t		*arg = *state;
+	daos_obj_batch_stat_t	 stat;
+	daos_obj_batch_stat_t	 stat_old;
+	daos_obj_id_t		 oid;
+	daos_handle_t		 oh;
+	daos_epoch_t		 epoch = 5;
+	daos_event_t		 evs[BATCH_UPDATE_NR];
+	daos_event_t		*evp;
+	daos_iov_t		 dkeys[BATCH_UPDATE_NR];
+	daos_sg_list_t		 sgls[BATCH_UPDATE_NR];
+	daos_iov_t		 sg_iovs[BATCH_UPDATE_NR];
+	daos_iod_t		 iods[BATCH_UPDATE_NR];
+	char			 keys[BATCH_UPDATE_NR][16];
+	char			 bufs[BATCH_UPDATE_NR][16];
+	char			 buf_out[16];
+	int			 failed = 0;
+	int			 i;
+	int			 rc;
+
+	rc = daos_obj_batch_query(&stat_old);
+	if (rc == -DER_UNINIT) {
+		print_message("batching is disabled, set DAOS_OBJ_BATCH\n");
+		skip();
+	}
+	assert_int_equal(rc, 0);
+
+	/** all updates go to the only shard of the object */
+	oid = dts_oid_gen(DAOS_OC_TINY_RW, 0, arg->myrank);
+	rc = daos_obj_open(arg->coh, oid, 0, 0, &oh, NULL);
+	assert_int_equal(rc, 0);
+
+	for (i = 0; i < BATCH_UPDATE_NR; i++) {
+		sprintf(keys[i], "batch_dkey%d", i);
+		sprintf(bufs[i], "batch_data%d", i);
+		daos_iov_set(&dkeys[i], keys[i], strlen(keys[i]));
+		daos_iov_set(&sg_iovs[i], bufs[i], strlen(bufs[i]) + 1);
+		sgls[i].sg_nr	  = 1;
+		sgls[i].sg_nr_out = 0;
+		sgls[i].sg_iovs	  = &sg_iovs[i];
+
+		memset(&iods[i], 0, sizeof(iods[i]));
+		daos_iov_set(&iods[i].iod_name, "akey", strlen("akey"));
+		daos_csum_set(&iods[i].iod_kcsum, NULL, 0);
+		iods[i].iod_type = DAOS_IOD_SINGLE;
+		iods[i].iod_size = strlen(bufs[i]) + 1;
+		iods[i].iod_nr	 = 1;
+
+		rc = daos_event_init(&evs[i], arg->eq, NULL);
+		assert_int_equal(rc, 0);
+	}
+
+	print_message("issue %d updates, the first completed one fails\n",
+		      BATCH_UPDATE_NR);
+	daos_fail_loc_set(DAOS_OBJ_UPDATE_NOSPACE | DAOS_FAIL_ONCE);
+	for (i = 0; i < BATCH_UPDATE_NR; i++) {
+		rc = daos_obj_update(oh, epoch, &dkeys[i], 1, &iods[i],
+				     &sgls[i], &evs[i]);
+		assert_int_equal(rc, 0);
+	}
+
+	for (i = 0; i < BATCH_UPDATE_NR; i++) {
+		rc = daos_eq_poll(arg->eq, 1, DAOS_EQ_WAIT, 1, &evp);
+		assert_int_equal(rc, 1);
+		if (evp->ev_error != 0) {
+			assert_int_equal(evp->ev_error, -DER_NOSPACE);
+			failed++;
+		}
+	}
+	daos_fail_loc_set(0);
+	assert_int_equal(failed, 1);
+
+	rc = daos_obj_batch_query(&stat);
+	assert_int_equal(rc, 0);
+	print_message("sent "DF_U64" batch RPCs of "DF_U64" updates\n",
+		      stat.bs_rpcs - stat_old.bs_rpcs,
+		      stat.bs_updates - stat_old.bs_updates);
+	assert_int_equal(stat.bs_rpcs - stat_old.bs_rpcs, 1);
+	assert_int_equal(stat.bs_updates - stat_old.bs_updates,
+			 BATCH_UPDATE_NR);
+
+	print_message("fetch the updates which succeeded\n");
+	for (i = 0; i < BATCH_UPDATE_NR; i++) {
+		if (evs[i].ev_error == 0) {
+			memset(buf_out, 0, sizeof(buf_out));
+			daos_iov_set(&sg_iovs[i], buf_out, sizeof(buf_out));
+			rc = daos_obj_fetch(oh, epoch, &dkeys[i], 1, &iods[i],
+					    &sgls[i], NULL, NULL);
+			assert_int_equal(rc, 0);
+			assert_string_equal(buf_out, bufs[i]);
+		}
+		rc = daos_event_fini(&evs[i]);
+		assert_int_equal(rc, 0);
+	}
+
+	rc = daos_obj_close(oh, NULL);
+	assert_int_equal(rc, 0);
+	print_message("all good\n");
+}
+
 static const struct CMUnitTest io_tests[] = {
 	{ "IO1: simple update/fetch/verify",
 	  io_simple, async_disable, test_case_teardown},
@@ -1795,6 +2014,10 @@ static const struct CMUnitTest io_tests[] = {
 	  async_enable, test_case_teardown},
 	{ "IO29: update with overlapped recxs", update_overlapped_recxs,
 	  async_enable, test_case_teardown},
+	{ "IO30: update/fetch with end-to-end checksum", io_csum,
+	  async_disable, test_case_teardown},
+	{ "IO31: batched small updates", io_batch,
+	  async_enable, test_case_teardown},
 };
 
 int
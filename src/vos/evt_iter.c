@@ -221,8 +221,7 @@ evt_iter_fetch(daos_handle_t ih, struct evt_entry *entry,
 {
 	struct evt_iterator	*iter;
 	struct evt_context	*tcx;
-	struct evt_rect		*rect;
-	struct evt_ptr_ref	*pref;
+	struct evt_rect		 rect;
 	struct evt_trace	*trace;
 	int			 rc;
 
@@ -236,18 +235,14 @@ evt_iter_fetch(daos_handle_t ih, struct evt_entry *entry,
 		D_GOTO(out, rc);
 
 	trace = &tcx->tc_trace[tcx->tc_depth - 1];
-	rect  = evt_node_rect_at(tcx, trace->tr_node, trace->tr_at);
-	pref  = evt_node_pref_at(tcx, trace->tr_node, trace->tr_at);
-	D_ASSERT(pref->pr_offset == 0); /* no clip so far */
+	evt_node_rect_read_at(tcx, trace->tr_node, trace->tr_at, &rect);
 
 	if (entry)
 		evt_fill_entry(tcx, trace->tr_node, trace->tr_at, NULL, entry);
 
 	if (anchor) {
-		struct evt_rect rtmp = *rect;
-
 		memset(anchor, 0, sizeof(*anchor));
-		memcpy(&anchor->body[0], &rtmp, sizeof(rtmp));
+		memcpy(&anchor->body[0], &rect, sizeof(rect));
 	}
 	rc = 0;
  out:
@@ -95,6 +95,8 @@ struct evt_context {
 	struct evt_trace		*tc_trace;
 	/** customized operation table for different tree policies */
 	struct evt_policy_ops		*tc_ops;
+	/** callbacks for NVMe extents, all zero if not provided */
+	struct evt_desc_cbs		 tc_desc_cbs;
 };
 
 #define EVT_NODE_NULL			TMMID_NULL(struct evt_node)
@@ -125,7 +127,7 @@ enum evt_find_opc {
 
 int evt_tcx_create(TMMID(struct evt_root) root_mmid, struct evt_root *root,
 		   uint64_t feats, unsigned int order, struct umem_attr *uma,
-		   struct evt_context **tcx_pp);
+		   struct evt_desc_cbs *cbs, struct evt_context **tcx_pp);
 int evt_tcx_clone(struct evt_context *tcx, struct evt_context **tcx_pp);
 
 #define EVT_HDL_ALIVE	0xbabecafe
@@ -152,9 +154,9 @@ daos_handle_t evt_tcx2hdl(struct evt_context *tcx);
 struct evt_context *evt_hdl2tcx(daos_handle_t toh);
 bool evt_move_trace(struct evt_context *tcx, bool forward);
 
-struct evt_rect *evt_node_rect_at(struct evt_context *tcx,
-				  TMMID(struct evt_node) nd_mmid,
-				  unsigned int at);
+void evt_node_rect_read_at(struct evt_context *tcx,
+			   TMMID(struct evt_node) nd_mmid, unsigned int at,
+			   struct evt_rect *rect);
 struct evt_ptr_ref *evt_node_pref_at(struct evt_context *tcx,
 				     TMMID(struct evt_node) nd_mmid,
 				     unsigned int at);
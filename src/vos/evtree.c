@@ -386,7 +386,9 @@ evt_split_entry(struct evt_entry *current, struct evt_entry *next,
 	diff = next->en_sel_rect.rc_off_hi + 1 - split->en_sel_rect.rc_off_lo;
 	split->en_sel_rect.rc_off_lo = next->en_sel_rect.rc_off_hi + 1;
 	split->en_offset += diff;
-	split->en_addr = (char *)split->en_addr + diff * split->en_inob;
+	if (split->en_addr != NULL) /* NULL for NVMe extent */
+		split->en_addr = (char *)split->en_addr +
+				 diff * split->en_inob;
 	/* Mark the split entry so we don't keep it in covered list */
 	split->en_inob |= EVT_PARTIAL_FLAG;
 
@@ -480,8 +482,9 @@ evt_uncover_entries(struct evt_entry_list *ent_list, d_list_t *covered)
 			diff = this_rect->rc_off_hi + 1 - next_rect->rc_off_lo;
 			next_rect->rc_off_lo = this_rect->rc_off_hi + 1;
 			next_ent->en_offset += diff;
-			next_ent->en_addr = (char *)next_ent->en_addr +
-				diff * next_ent->en_inob;
+			if (next_ent->en_addr != NULL)
+				next_ent->en_addr = (char *)next_ent->en_addr +
+					diff * next_ent->en_inob;
 			/* current now points at next_ent.  Remove it and
 			 * reinsert it in the list in case truncation moved
 			 * it to a new position
@@ -514,6 +517,21 @@ evt_uncover_entries(struct evt_entry_list *ent_list, d_list_t *covered)
 	return 0;
 }
 
+/** Are entries of \a ent_list sorted and not overlapped with each other? */
+static bool
+evt_ent_list_is_disjoint(struct evt_entry_list *ent_list)
+{
+	struct evt_entry	*ent;
+	daos_off_t		 next = 0;
+
+	evt_ent_list_for_each(ent, ent_list) {
+		if (ent->en_sel_rect.rc_off_lo < next)
+			return false;
+		next = ent->en_sel_rect.rc_off_hi + 1;
+	}
+	return true;
+}
+
 /** Place all entries into covered list in sorted order based on selected
  * range.   Then walk through the range to find only extents that are visible
  * and place them in the main list.   Update the selection bounds for visible
@@ -533,6 +551,12 @@ evt_ent_list_sort(struct evt_entry_list *ent_list, d_list_t *covered)
 	if (ent_list->el_ent_nr <= 1)
 		return 0;
 
+	/* The tree walk may have returned them in order and disjoint, e.g.
+	 * the range has never been overwritten, then all are visible.
+	 */
+	if (evt_ent_list_is_disjoint(ent_list))
+		return 0;
+
 	/* First, sort the entries and place all in covered list */
 	todo = ent_list->el_ent_nr;
 	ents = &ent_list->el_ents[0]; /* start with embedded pool */
@@ -554,6 +578,152 @@ evt_ent_list_sort(struct evt_entry_list *ent_list, d_list_t *covered)
 	return evt_uncover_entries(ent_list, covered);
 }
 
+/**
+ * Visibility cache.
+ *
+ * Sorting and clipping all versions of the queried range is expensive for
+ * heavily overwritten arrays, so visible rectangles of the latest queries are
+ * cached per thread, a tree is only accessed by the xstream owning its pool.
+ * A cached query is identified by the address of the tree root, the
+ * generation stamp of the root and the query rectangle. Any modification
+ * changes the stamp, so a stale result can never be matched.
+ */
+
+#define EVT_VIS_BITS		6
+/** number of cached queries of each thread */
+#define EVT_VIS_SLOTS		(1 << EVT_VIS_BITS)
+/** queries returning more visible rectangles are not cached */
+#define EVT_VIS_ENT_MAX		16
+
+struct evt_vis_slot {
+	/** address of the tree root, NULL for unused slot */
+	struct evt_root		*vs_root;
+	/** generation stamp of the tree */
+	uint64_t		 vs_gen;
+	/** the query rectangle */
+	struct evt_rect		 vs_rect;
+	/** number of visible rectangles */
+	unsigned int		 vs_ent_nr;
+	/** visible rectangles in order */
+	struct evt_entry	 vs_ents[EVT_VIS_ENT_MAX];
+};
+
+struct evt_vis_cache {
+	struct evt_vis_slot	 vc_slots[EVT_VIS_SLOTS];
+};
+
+static __thread struct evt_vis_cache	*evt_vis_cache;
+static __thread bool			 evt_vis_disabled;
+/** the last generation stamp of this process */
+static uint64_t				 evt_gen_last;
+
+/** Return a generation stamp which has never been used by this process */
+static uint64_t
+evt_gen_next(void)
+{
+	uint64_t	gen = __atomic_load_n(&evt_gen_last, __ATOMIC_RELAXED);
+
+	/* Start from the time in nanoseconds, so it's larger than stamps
+	 * stored by previous runs as well.
+	 */
+	if (gen == 0)
+		__atomic_compare_exchange_n(&evt_gen_last, &gen,
+					    d_timeus_secdiff(0) * 1000, false,
+					    __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+
+	return __atomic_add_fetch(&evt_gen_last, 1, __ATOMIC_RELAXED);
+}
+
+static struct evt_vis_slot *
+evt_vis_slot(struct evt_root *root, struct evt_rect *rect)
+{
+	uint64_t	key;
+
+	key = (uint64_t)root ^ rect->rc_off_lo ^ (rect->rc_off_hi << 21) ^
+	      (rect->rc_epc_lo << 42);
+	return &evt_vis_cache->vc_slots[daos_u64_hash(key, EVT_VIS_BITS)];
+}
+
+/** Fill \a ent_list with the cached result of query \a rect if there is */
+static bool
+evt_vis_cache_lookup(struct evt_context *tcx, struct evt_rect *rect,
+		     struct evt_entry_list *ent_list)
+{
+	struct evt_root		*root = tcx->tc_root;
+	struct evt_vis_slot	*slot;
+	struct evt_entry	*ent;
+	int			 i;
+
+	D_CASSERT(EVT_VIS_ENT_MAX <= ERT_ENT_EMBEDDED);
+
+	if (evt_vis_cache == NULL || evt_vis_disabled ||
+	    root == NULL || root->tr_gen == 0)
+		return false;
+
+	slot = evt_vis_slot(root, rect);
+	if (slot->vs_root != root || slot->vs_gen != root->tr_gen ||
+	    memcmp(&slot->vs_rect, rect, sizeof(*rect)) != 0)
+		return false;
+
+	for (i = 0; i < slot->vs_ent_nr; i++) {
+		/* NB: always an embedded entry */
+		ent = evt_ent_list_alloc(ent_list, false);
+		*ent = slot->vs_ents[i];
+		d_list_add_tail(&ent->en_link, &ent_list->el_list);
+	}
+	D_DEBUG(DB_TRACE, "Found %d visible rects of "DF_RECT" in cache\n",
+		slot->vs_ent_nr, DP_RECT(rect));
+	return true;
+}
+
+/** Cache visible rectangles \a ent_list of the query \a rect */
+static void
+evt_vis_cache_store(struct evt_context *tcx, struct evt_rect *rect,
+		    struct evt_entry_list *ent_list)
+{
+	struct evt_root		*root = tcx->tc_root;
+	struct evt_vis_slot	*slot;
+	struct evt_entry	*ent;
+	unsigned int		 nr = 0;
+
+	if (evt_vis_disabled || root == NULL || root->tr_gen == 0)
+		return;
+
+	if (evt_vis_cache == NULL) {
+		D_ALLOC_PTR(evt_vis_cache);
+		if (evt_vis_cache == NULL)
+			return; /* not fatal */
+	}
+
+	slot = evt_vis_slot(root, rect);
+	slot->vs_root = NULL;
+	evt_ent_list_for_each(ent, ent_list) {
+		if (nr == EVT_VIS_ENT_MAX)
+			return; /* too many to cache */
+		slot->vs_ents[nr++] = *ent;
+	}
+
+	slot->vs_root	= root;
+	slot->vs_gen	= root->tr_gen;
+	slot->vs_rect	= *rect;
+	slot->vs_ent_nr	= nr;
+}
+
+void
+evt_vis_cache_set(bool enable)
+{
+	evt_vis_disabled = !enable;
+}
+
+void
+evt_vis_cache_fini(void)
+{
+	if (evt_vis_cache != NULL) {
+		D_FREE_PTR(evt_vis_cache);
+		evt_vis_cache = NULL;
+	}
+}
+
 daos_handle_t
 evt_tcx2hdl(struct evt_context *tcx)
 {
@@ -628,12 +798,13 @@ evt_tcx_reset_trace(struct evt_context *tcx)
  * \param feats		[IN]	Optional, feature bits for create
  * \param order		[IN]	Optional, tree order for create
  * \param uma		[IN]	Memory attribute for the tree
+ * \param cbs		[IN]	Optional, callbacks for NVMe extents
  * \param tcx_pp	[OUT]	The returned tree context
  */
 int
 evt_tcx_create(TMMID(struct evt_root) root_mmid, struct evt_root *root,
 	       uint64_t feats, unsigned int order, struct umem_attr *uma,
-	       struct evt_context **tcx_pp)
+	       struct evt_desc_cbs *cbs, struct evt_context **tcx_pp)
 {
 	struct evt_context	*tcx;
 	int			 depth;
@@ -653,6 +824,8 @@ evt_tcx_create(TMMID(struct evt_root) root_mmid, struct evt_root *root,
 	D_INIT_LIST_HEAD(&tcx->tc_ent_clipping);
 	D_INIT_LIST_HEAD(&tcx->tc_ent_inserting);
 	D_INIT_LIST_HEAD(&tcx->tc_ent_dropping);
+	if (cbs != NULL)
+		tcx->tc_desc_cbs = *cbs;
 
 	rc = umem_class_init(uma, &tcx->tc_umm);
 	if (rc != 0) {
@@ -702,28 +875,36 @@ evt_tcx_clone(struct evt_context *tcx, struct evt_context **tcx_pp)
 		return -DER_INVAL;
 
 	rc = evt_tcx_create(tcx->tc_root_mmid, tcx->tc_root, -1, -1, &uma,
-			    tcx_pp);
+			    &tcx->tc_desc_cbs, tcx_pp);
 	return rc;
 }
 
 /**
  * Create a data pointer for extent address @mmid. It allocates buffer
- * if @mmid is NULL.
+ * if @mmid is NULL and @blk_off is not provided.
  *
  * \param mmid		[IN]	Optional, memory ID of the external buffer
+ * \param blk_off	[IN]	Optional, NVMe block offset of the extent
  * \param idx_nob	[IN]	Number Of Bytes per index
  * \param idx_num	[IN]	Indicies within the extent
+ * \param csum		[IN]	Optional, checksum of the extent
  * \param ptr_mmid_p	[OUT]	The returned memory ID of extent pointer.
  */
 static int
 evt_ptr_create(struct evt_context *tcx, uuid_t cookie, uint32_t pm_ver,
-	       umem_id_t mmid, uint32_t idx_nob, uint64_t idx_num,
+	       umem_id_t mmid, uint64_t *blk_off, uint32_t idx_nob,
+	       uint64_t idx_num, daos_csum_buf_t *csum,
 	       TMMID(struct evt_ptr) *ptr_mmid_p)
 {
 	struct evt_ptr		*ptr;
 	TMMID(struct evt_ptr)	 ptr_mmid;
 	int			 rc;
 
+	if (csum != NULL && csum->cs_len > sizeof(ptr->pt_csum)) {
+		D_ERROR("Checksum is too large: %d\n", csum->cs_len);
+		return -DER_INVAL;
+	}
+
 	ptr_mmid = umem_znew_typed(evt_umm(tcx), struct evt_ptr);
 	if (TMMID_IS_NULL(ptr_mmid))
 		return -DER_NOMEM;
@@ -733,8 +914,18 @@ evt_ptr_create(struct evt_context *tcx, uuid_t cookie, uint32_t pm_ver,
 	ptr->pt_inum = idx_num;
 	uuid_copy(ptr->pt_cookie, cookie);
 	ptr->pt_ver = pm_ver;
+	if (csum != NULL && csum->cs_len != 0) {
+		memcpy(&ptr->pt_csum, csum->cs_csum, csum->cs_len);
+		ptr->pt_cs_len = csum->cs_len;
+		ptr->pt_cs_type = csum->cs_type;
+	}
 
-	if (UMMID_IS_NULL(mmid) && idx_nob * idx_num > EVT_PTR_PAYLOAD) {
+	if (blk_off != NULL) {
+		D_ASSERT(UMMID_IS_NULL(mmid));
+		ptr->pt_flags |= EVT_PTR_NVME;
+		ptr->pt_blk_off = *blk_off;
+
+	} else if (UMMID_IS_NULL(mmid) && idx_nob * idx_num > EVT_PTR_PAYLOAD) {
 		mmid = umem_alloc(evt_umm(tcx), idx_nob * idx_num);
 		if (UMMID_IS_NULL(mmid))
 			D_GOTO(failed, rc = -DER_NOMEM);
@@ -748,6 +939,30 @@ evt_ptr_create(struct evt_context *tcx, uuid_t cookie, uint32_t pm_ver,
 	return rc;
 }
 
+/** Release the data buffer of \a ptr, either on pmem or on NVMe */
+static void
+evt_ptr_free_data(struct evt_context *tcx, struct evt_ptr *ptr)
+{
+	struct evt_desc_cbs *cbs = &tcx->tc_desc_cbs;
+	uint64_t	     nob;
+	int		     rc;
+
+	if (!(ptr->pt_flags & EVT_PTR_NVME)) {
+		if (!UMMID_IS_NULL(ptr->pt_mmid))
+			umem_free(evt_umm(tcx), ptr->pt_mmid);
+		return;
+	}
+
+	D_ASSERT(cbs->dc_nvme_free_cb != NULL && cbs->dc_blk_sz != 0);
+	nob = ptr->pt_inob * ptr->pt_inum;
+	rc = cbs->dc_nvme_free_cb(evt_umm(tcx), ptr->pt_blk_off,
+				  (nob + cbs->dc_blk_sz - 1) / cbs->dc_blk_sz,
+				  cbs->dc_nvme_free_args);
+	if (rc != 0) /* leak the blocks, nothing else we can do */
+		D_ERROR("Failed to free NVMe extent "DF_U64"/"DF_U64": %d\n",
+			ptr->pt_blk_off, nob, rc);
+}
+
 /**
  * Free a data pointer. It also frees the data buffer if \a free_data is true.
  */
@@ -758,10 +973,8 @@ evt_ptr_free(struct evt_context *tcx, TMMID(struct evt_ptr) ptr_mmid,
 	struct evt_ptr	*ptr = evt_tmmid2ptr(tcx, ptr_mmid);
 
 	D_ASSERT(ptr->pt_ref == 0);
-	if (free_data) {
-		if (!UMMID_IS_NULL(ptr->pt_mmid))
-			umem_free(evt_umm(tcx), ptr->pt_mmid);
-	}
+	if (free_data)
+		evt_ptr_free_data(tcx, ptr);
 	umem_free_typed(evt_umm(tcx), ptr_mmid);
 }
 
@@ -781,6 +994,9 @@ evt_ptr_payload(struct evt_context *tcx, TMMID(struct evt_ptr) ptr_mmid,
 	if (idx_num != NULL)
 		*idx_num = ptr->pt_inum;
 
+	if (ptr->pt_flags & EVT_PTR_NVME)
+		return NULL; /* not addressable, see evt_fill_entry() */
+
 	if (!UMMID_IS_NULL(ptr->pt_mmid))
 		return evt_mmid2ptr(tcx, ptr->pt_mmid);
 
@@ -912,16 +1128,203 @@ evt_node_is_root(struct evt_context *tcx, TMMID(struct evt_node) nd_mmid)
 	return evt_node_is_set(tcx, nd_mmid, EVT_NODE_ROOT);
 }
 
-/** Return the rectangle at the offset of @at */
-struct evt_rect *
-evt_node_rect_at(struct evt_context *tcx, TMMID(struct evt_node) nd_mmid,
-		 unsigned int at)
+static inline bool
+evt_node_is_soa(struct evt_context *tcx)
 {
-	struct evt_node		*nd = evt_tmmid2ptr(tcx, nd_mmid);
-	struct evt_rect		*rects;
+	return tcx->tc_feats & EVT_FEAT_NODE_SOA;
+}
+
+/** Rectangles of the node, only for nodes without EVT_FEAT_NODE_SOA */
+static inline struct evt_rect *
+evt_node_rects(struct evt_context *tcx, TMMID(struct evt_node) nd_mmid)
+{
+	struct evt_node	*nd = evt_tmmid2ptr(tcx, nd_mmid);
+
+	D_ASSERT(!evt_node_is_soa(tcx));
+	return (struct evt_rect *)(&nd[1]);
+}
+
+/**
+ * Arrays of low offsets, high offsets and low epochs of the node, only for
+ * nodes with EVT_FEAT_NODE_SOA. They take the same space as the rectangle
+ * array of the other format.
+ */
+static inline void
+evt_node_soa(struct evt_context *tcx, TMMID(struct evt_node) nd_mmid,
+	     daos_off_t **off_lo, daos_off_t **off_hi, daos_epoch_t **epc_lo)
+{
+	struct evt_node	*nd = evt_tmmid2ptr(tcx, nd_mmid);
+	daos_off_t	*base = (daos_off_t *)(&nd[1]);
+
+	D_ASSERT(evt_node_is_soa(tcx));
+	D_CASSERT(sizeof(struct evt_rect) == 3 * sizeof(daos_off_t));
+	*off_lo = base;
+	*off_hi = base + tcx->tc_order;
+	*epc_lo = (daos_epoch_t *)(base + 2 * tcx->tc_order);
+}
+
+/** Read the rectangle at the offset of @at */
+void
+evt_node_rect_read_at(struct evt_context *tcx, TMMID(struct evt_node) nd_mmid,
+		      unsigned int at, struct evt_rect *rect)
+{
+	daos_off_t	*off_lo;
+	daos_off_t	*off_hi;
+	daos_epoch_t	*epc_lo;
+
+	if (!evt_node_is_soa(tcx)) {
+		*rect = evt_node_rects(tcx, nd_mmid)[at];
+		return;
+	}
+
+	evt_node_soa(tcx, nd_mmid, &off_lo, &off_hi, &epc_lo);
+	rect->rc_off_lo = off_lo[at];
+	rect->rc_off_hi = off_hi[at];
+	rect->rc_epc_lo = epc_lo[at];
+}
 
-	rects = (struct evt_rect *)(&nd[1]);
-	return &rects[at];
+/** Store the rectangle \a rect at the offset of @at */
+static void
+evt_node_rect_write_at(struct evt_context *tcx, TMMID(struct evt_node) nd_mmid,
+		       unsigned int at, const struct evt_rect *rect)
+{
+	daos_off_t	*off_lo;
+	daos_off_t	*off_hi;
+	daos_epoch_t	*epc_lo;
+
+	if (!evt_node_is_soa(tcx)) {
+		evt_node_rects(tcx, nd_mmid)[at] = *rect;
+		return;
+	}
+
+	evt_node_soa(tcx, nd_mmid, &off_lo, &off_hi, &epc_lo);
+	off_lo[at] = rect->rc_off_lo;
+	off_hi[at] = rect->rc_off_hi;
+	epc_lo[at] = rect->rc_epc_lo;
+}
+
+/**
+ * Move \a nr rectangles starting from \a src_at of \a src_mmid to \a dst_at
+ * of \a dst_mmid, source and destination can be the same node and overlap.
+ */
+static void
+evt_node_rect_move(struct evt_context *tcx, TMMID(struct evt_node) dst_mmid,
+		   unsigned int dst_at, TMMID(struct evt_node) src_mmid,
+		   unsigned int src_at, unsigned int nr)
+{
+	daos_off_t	*src_lo, *src_hi;
+	daos_off_t	*dst_lo, *dst_hi;
+	daos_epoch_t	*src_epc, *dst_epc;
+
+	if (!evt_node_is_soa(tcx)) {
+		memmove(&evt_node_rects(tcx, dst_mmid)[dst_at],
+			&evt_node_rects(tcx, src_mmid)[src_at],
+			nr * sizeof(struct evt_rect));
+		return;
+	}
+
+	evt_node_soa(tcx, src_mmid, &src_lo, &src_hi, &src_epc);
+	evt_node_soa(tcx, dst_mmid, &dst_lo, &dst_hi, &dst_epc);
+	memmove(&dst_lo[dst_at], &src_lo[src_at], nr * sizeof(*dst_lo));
+	memmove(&dst_hi[dst_at], &src_hi[src_at], nr * sizeof(*dst_hi));
+	memmove(&dst_epc[dst_at], &src_epc[src_at], nr * sizeof(*dst_epc));
+}
+
+/** Vector of offsets or epochs, GCC/clang lower it to the native SIMD */
+typedef uint64_t evt_vec_t __attribute__((vector_size(32)));
+/** Result of comparing two \a evt_vec_t, a lane is -1 if true, or 0 */
+typedef int64_t evt_vmask_t __attribute__((vector_size(32)));
+
+#define EVT_VEC_LANES	(sizeof(evt_vec_t) / sizeof(uint64_t))
+/** number of words of the bitmask for all rectangles of a node */
+#define EVT_MASK_WORDS	((EVT_ORDER_MAX + 63) / 64)
+
+static inline void
+evt_mask_set(uint64_t *mask, unsigned int at)
+{
+	mask[at >> 6] |= 1ULL << (at & 63);
+}
+
+static inline bool
+evt_mask_is_set(const uint64_t *mask, unsigned int at)
+{
+	return mask[at >> 6] & (1ULL << (at & 63));
+}
+
+/** Returns the first bit set in \a mask from \a at, or \a nr if none */
+static inline unsigned int
+evt_mask_next(const uint64_t *mask, unsigned int at, unsigned int nr)
+{
+	uint64_t	bits;
+
+	while (at < nr) {
+		bits = mask[at >> 6] >> (at & 63);
+		if (bits != 0)
+			return min(at + __builtin_ctzll(bits), nr);
+		at = (at | 63) + 1;
+	}
+	return nr;
+}
+
+/**
+ * Set bits in \a mask for all rectangles of the node which overlap with
+ * \a rect in offset, and are visible to it in epoch, i.e. rectangles which
+ * are RT_OVERLAP_OVER or RT_OVERLAP_SAME in time.
+ *
+ * For SoA node, each round compares EVT_VEC_LANES rectangles.
+ */
+static void
+evt_node_overlap_mask(struct evt_context *tcx, TMMID(struct evt_node) nd_mmid,
+		      const struct evt_rect *rect, uint64_t *mask)
+{
+	struct evt_node	*nd = evt_tmmid2ptr(tcx, nd_mmid);
+	daos_off_t	*off_lo;
+	daos_off_t	*off_hi;
+	daos_epoch_t	*epc_lo;
+	evt_vec_t	 v_lo, v_hi, v_epc;
+	evt_vec_t	 q_lo, q_hi, q_epc;
+	evt_vmask_t	 v_match;
+	unsigned int	 i;
+	unsigned int	 j;
+
+	memset(mask, 0, sizeof(uint64_t) * EVT_MASK_WORDS);
+
+	if (!evt_node_is_soa(tcx)) {
+		struct evt_rect	*rects = evt_node_rects(tcx, nd_mmid);
+
+		for (i = 0; i < nd->tn_nr; i++) {
+			if (rects[i].rc_off_lo <= rect->rc_off_hi &&
+			    rects[i].rc_off_hi >= rect->rc_off_lo &&
+			    rects[i].rc_epc_lo <= rect->rc_epc_lo)
+				evt_mask_set(mask, i);
+		}
+		return;
+	}
+
+	evt_node_soa(tcx, nd_mmid, &off_lo, &off_hi, &epc_lo);
+	/* broadcast the searching rectangle to all lanes */
+	q_lo = (evt_vec_t){0} + rect->rc_off_lo;
+	q_hi = (evt_vec_t){0} + rect->rc_off_hi;
+	q_epc = (evt_vec_t){0} + rect->rc_epc_lo;
+
+	for (i = 0; i + EVT_VEC_LANES <= nd->tn_nr; i += EVT_VEC_LANES) {
+		/* NB: node arrays are not necessarily aligned to vector */
+		memcpy(&v_lo, &off_lo[i], sizeof(v_lo));
+		memcpy(&v_hi, &off_hi[i], sizeof(v_hi));
+		memcpy(&v_epc, &epc_lo[i], sizeof(v_epc));
+
+		v_match = (v_lo <= q_hi) & (v_hi >= q_lo) & (v_epc <= q_epc);
+		for (j = 0; j < EVT_VEC_LANES; j++)
+			mask[(i + j) >> 6] |= (uint64_t)(v_match[j] & 1) <<
+					      ((i + j) & 63);
+	}
+
+	for (; i < nd->tn_nr; i++) {
+		if (off_lo[i] <= rect->rc_off_hi &&
+		    off_hi[i] >= rect->rc_off_lo &&
+		    epc_lo[i] <= rect->rc_epc_lo)
+			evt_mask_set(mask, i);
+	}
 }
 
 /**
@@ -945,8 +1348,7 @@ evt_node_rect_update(struct evt_context *tcx, TMMID(struct evt_node) tn_mmid,
 	bool		 changed;
 
 	/* update the rectangle at the specified position */
-	rtmp = evt_node_rect_at(tcx, tn_mmid, at);
-	*rtmp = *rect;
+	evt_node_rect_write_at(tcx, tn_mmid, at, rect);
 
 	/* merge the rectangle with the current node */
 	rtmp = evt_node_mbr_get(tcx, tn_mmid);
@@ -955,17 +1357,24 @@ evt_node_rect_update(struct evt_context *tcx, TMMID(struct evt_node) tn_mmid,
 	return changed;
 }
 
+/** Return the address right after rectangles of the node */
+static inline void *
+evt_node_rects_end(struct evt_context *tcx, TMMID(struct evt_node) nd_mmid)
+{
+	struct evt_node	*nd = evt_tmmid2ptr(tcx, nd_mmid);
+
+	return (char *)(&nd[1]) + sizeof(struct evt_rect) * tcx->tc_order;
+}
+
 /** Return the adress of child mmid at the offset of @at */
 TMMID(struct evt_node) *
 evt_node_child_at(struct evt_context *tcx, TMMID(struct evt_node) nd_mmid,
 		  unsigned int at)
 {
-	struct evt_rect		*rects;
 	TMMID(struct evt_node)	*mmids;
 
 	D_ASSERT(!evt_node_is_leaf(tcx, nd_mmid));
-	rects = evt_node_rect_at(tcx, nd_mmid, tcx->tc_order);
-	mmids = (TMMID(struct evt_node) *)rects;
+	mmids = evt_node_rects_end(tcx, nd_mmid);
 
 	return &mmids[at];
 }
@@ -975,12 +1384,10 @@ struct evt_ptr_ref *
 evt_node_pref_at(struct evt_context *tcx, TMMID(struct evt_node) nd_mmid,
 		 unsigned int at)
 {
-	struct evt_rect		*rects;
 	struct evt_ptr_ref	*prefs;
 
 	D_ASSERT(evt_node_is_leaf(tcx, nd_mmid));
-	rects = evt_node_rect_at(tcx, nd_mmid, tcx->tc_order);
-	prefs = (struct evt_ptr_ref *)rects;
+	prefs = evt_node_rects_end(tcx, nd_mmid);
 
 	return &prefs[at];
 }
@@ -1067,7 +1474,7 @@ evt_node_destroy(struct evt_context *tcx, TMMID(struct evt_node) nd_mmid,
 	evt_node_free(tcx, nd_mmid);
 }
 
-#if 0
+/** Add the whole tree node to the transaction */
 static inline int
 evt_node_tx_add(struct evt_context *tcx, TMMID(struct evt_node) nd_mmid)
 {
@@ -1079,7 +1486,6 @@ evt_node_tx_add(struct evt_context *tcx, TMMID(struct evt_node) nd_mmid)
 			       evt_node_size(tcx, nd->tn_flags));
 	return rc;
 }
-#endif
 
 /** Return the MBR of a node */
 static struct evt_rect *
@@ -1097,19 +1503,33 @@ evt_node_mbr_cal(struct evt_context *tcx, TMMID(struct evt_node) nd_mmid)
 {
 	struct evt_node	*node;
 	struct evt_rect *mbr;
+	daos_off_t	*off_lo;
+	daos_off_t	*off_hi;
+	daos_epoch_t	*epc_lo;
 	int		 i;
 
 	node = evt_tmmid2ptr(tcx, nd_mmid);
 	D_ASSERT(node->tn_nr != 0);
 
 	mbr = &node->tn_mbr;
-	*mbr = *evt_node_rect_at(tcx, nd_mmid, 0);
-	for (i = 1; i < node->tn_nr; i++) {
-		struct evt_rect *rect;
+	evt_node_rect_read_at(tcx, nd_mmid, 0, mbr);
+
+	if (!evt_node_is_soa(tcx)) {
+		struct evt_rect *rects = evt_node_rects(tcx, nd_mmid);
+
+		for (i = 1; i < node->tn_nr; i++)
+			evt_rect_merge(mbr, &rects[i]);
+		goto out;
+	}
 
-		rect = evt_node_rect_at(tcx, nd_mmid, i);
-		evt_rect_merge(mbr, rect);
+	/* three independent min/max reductions, which can be vectorized */
+	evt_node_soa(tcx, nd_mmid, &off_lo, &off_hi, &epc_lo);
+	for (i = 1; i < node->tn_nr; i++) {
+		mbr->rc_off_lo = min(mbr->rc_off_lo, off_lo[i]);
+		mbr->rc_off_hi = max(mbr->rc_off_hi, off_hi[i]);
+		mbr->rc_epc_lo = min(mbr->rc_epc_lo, epc_lo[i]);
 	}
+out:
 	D_DEBUG(DB_TRACE, "Compute out MBR "DF_RECT"("TMMID_PF"), nr=%d\n",
 		DP_RECT(mbr), TMMID_P(nd_mmid), node->tn_nr);
 }
@@ -1240,6 +1660,21 @@ evt_root_tx_add(struct evt_context *tcx)
 	return rc;
 }
 
+/** Change the generation stamp of the tree after modifying it */
+static int
+evt_root_stamp(struct evt_context *tcx)
+{
+	int	rc;
+
+	if (evt_has_tx(tcx)) {
+		rc = evt_root_tx_add(tcx);
+		if (rc != 0)
+			return rc;
+	}
+	tcx->tc_root->tr_gen = evt_gen_next();
+	return 0;
+}
+
 /** Free the tree root, or reset it if it's been created inplace */
 void
 evt_root_fini(struct evt_context *tcx)
@@ -1280,6 +1715,7 @@ evt_root_init(struct evt_context *tcx)
 	tcx->tc_root->tr_feats = tcx->tc_feats;
 	tcx->tc_root->tr_order = tcx->tc_order;
 	tcx->tc_root->tr_node  = EVT_NODE_NULL;
+	tcx->tc_root->tr_gen   = evt_gen_next();
 	return 0;
 }
 
@@ -1571,9 +2007,8 @@ evt_ptr_copy(struct evt_context *tcx, TMMID(struct evt_ptr) dst_mmid,
 		dst_ptr->pt_ref, (int)dst_ptr->pt_inum, dst_ptr->pt_inob,
 		src_ptr->pt_ref, (int)src_ptr->pt_inum, src_ptr->pt_inob);
 
-	/* Free the pmem that dst_ptr references */
-	if (!UMMID_IS_NULL(dst_ptr->pt_mmid))
-		umem_free(evt_umm(tcx), dst_ptr->pt_mmid);
+	/* Free the pmem or NVMe blocks that dst_ptr references */
+	evt_ptr_free_data(tcx, dst_ptr);
 
 	memcpy(dst_ptr, src_ptr, sizeof(*dst_ptr));
 	dst_ptr->pt_ref = ref;
@@ -1636,6 +2071,8 @@ evt_insert_ptr(struct evt_context *tcx, struct evt_rect *rect,
 	/* Phase-2: Inserting */
 	rc = evt_insert_entry(tcx, &ent);
 out:
+	if (rc == 0)
+		rc = evt_root_stamp(tcx);
 	evt_ent_list_fini(&tcx->tc_ent_list);
 	return rc;
 }
@@ -1647,7 +2084,8 @@ out:
  */
 int
 evt_insert(daos_handle_t toh, uuid_t cookie, uint32_t pm_ver,
-	   struct evt_rect *rect, uint32_t inob, umem_id_t mmid)
+	   struct evt_rect *rect, uint32_t inob, daos_csum_buf_t *csum,
+	   umem_id_t mmid)
 {
 	struct evt_context	*tcx;
 	TMMID(struct evt_ptr)	 ptr_mmid;
@@ -1657,8 +2095,8 @@ evt_insert(daos_handle_t toh, uuid_t cookie, uint32_t pm_ver,
 	if (tcx == NULL)
 		return -DER_NO_HDL;
 
-	rc = evt_ptr_create(tcx, cookie, pm_ver, mmid, inob,
-			    evt_rect_width(rect), &ptr_mmid);
+	rc = evt_ptr_create(tcx, cookie, pm_ver, mmid, NULL, inob,
+			    evt_rect_width(rect), csum, &ptr_mmid);
 	if (rc != 0)
 		return rc;
 
@@ -1672,6 +2110,50 @@ evt_insert(daos_handle_t toh, uuid_t cookie, uint32_t pm_ver,
 	return rc;
 }
 
+/**
+ * Insert a versioned extent \a rect whose data is stored on NVMe.
+ *
+ * Please check API comment in evtree.h for the details.
+ */
+int
+evt_insert_nvme(daos_handle_t toh, uuid_t cookie, uint32_t pm_ver,
+		struct evt_rect *rect, uint32_t inob, daos_csum_buf_t *csum,
+		uint64_t blk_off)
+{
+	struct evt_context	*tcx;
+	TMMID(struct evt_ptr)	 ptr_mmid;
+	TMMID(struct evt_ptr)	 out_mmid;
+	int			 rc;
+
+	tcx = evt_hdl2tcx(toh);
+	if (tcx == NULL)
+		return -DER_NO_HDL;
+
+	if (tcx->tc_desc_cbs.dc_nvme_free_cb == NULL || inob == 0) {
+		D_DEBUG(DB_IO, "No NVMe callbacks or punch\n");
+		return -DER_INVAL;
+	}
+
+	rc = evt_ptr_create(tcx, cookie, pm_ver, UMMID_NULL, &blk_off, inob,
+			    evt_rect_width(rect), csum, &ptr_mmid);
+	if (rc != 0)
+		return rc;
+
+	rc = evt_insert_ptr(tcx, rect, ptr_mmid, &out_mmid);
+	if (rc != 0)
+		D_GOTO(failed, rc);
+
+	/* overwrite: data address has been copied to the existing pointer */
+	if (!umem_id_equal_typed(evt_umm(tcx), ptr_mmid, out_mmid))
+		evt_ptr_free(tcx, ptr_mmid, false);
+
+	return 0;
+ failed:
+	/* NB: the caller owns the NVMe blocks until the insert succeeds */
+	evt_ptr_free(tcx, ptr_mmid, false);
+	return rc;
+}
+
 /**
  * Insert a versioned extent \a rect to the evtree and copy its data from the
  * scatter/gather list \a sgl.
@@ -1680,7 +2162,8 @@ evt_insert(daos_handle_t toh, uuid_t cookie, uint32_t pm_ver,
  */
 int
 evt_insert_sgl(daos_handle_t toh, uuid_t cookie, uint32_t pm_ver,
-	       struct evt_rect *rect, uint32_t inob, daos_sg_list_t *sgl)
+	       struct evt_rect *rect, uint32_t inob, daos_csum_buf_t *csum,
+	       daos_sg_list_t *sgl)
 {
 	struct evt_context	*tcx;
 	TMMID(struct evt_ptr)	 ptr_mmid;
@@ -1691,8 +2174,8 @@ evt_insert_sgl(daos_handle_t toh, uuid_t cookie, uint32_t pm_ver,
 	if (tcx == NULL)
 		return -DER_NO_HDL;
 
-	rc = evt_ptr_create(tcx, cookie, pm_ver, UMMID_NULL, inob,
-			    evt_rect_width(rect), &ptr_mmid);
+	rc = evt_ptr_create(tcx, cookie, pm_ver, UMMID_NULL, NULL, inob,
+			    evt_rect_width(rect), csum, &ptr_mmid);
 	if (rc != 0)
 		return rc;
 
@@ -1726,6 +2209,556 @@ failed:
 	return rc;
 }
 
+/** An extent or a child node being packed by bulk load */
+struct evt_bulk_slot {
+	struct evt_rect		bs_rect;
+	/** index of the input entry, for extent only */
+	unsigned int		bs_idx;
+	/** evt_ptr of extent, or evt_node of child node */
+	umem_id_t		bs_mmid;
+};
+
+/** Sort by epoch then start offset, so extents of a version are adjacent */
+static int
+evt_bulk_cmp_epc(const void *p1, const void *p2)
+{
+	const struct evt_rect *rt1 = &((struct evt_bulk_slot *)p1)->bs_rect;
+	const struct evt_rect *rt2 = &((struct evt_bulk_slot *)p2)->bs_rect;
+
+	if (rt1->rc_epc_lo != rt2->rc_epc_lo)
+		return rt1->rc_epc_lo < rt2->rc_epc_lo ? -1 : 1;
+
+	return evt_cmp_rect_helper(rt1, rt2);
+}
+
+/** Sort entries of a node in the order of the tree policy */
+static int
+evt_bulk_cmp_ssof(const void *p1, const void *p2)
+{
+	return evt_cmp_rect_helper(&((struct evt_bulk_slot *)p1)->bs_rect,
+				   &((struct evt_bulk_slot *)p2)->bs_rect);
+}
+
+/**
+ * Sort \a slots for bulk load, returns false if any two extents overlap in
+ * the same epoch, which requires the overwrite check of the normal insert.
+ */
+static bool
+evt_bulk_sort(struct evt_bulk_slot *slots, unsigned int nr)
+{
+	struct evt_rect	*prev;
+	struct evt_rect	*rect;
+	unsigned int	 i;
+
+	qsort(slots, nr, sizeof(*slots), evt_bulk_cmp_epc);
+	for (i = 1; i < nr; i++) {
+		prev = &slots[i - 1].bs_rect;
+		rect = &slots[i].bs_rect;
+		/* NB: extents of the same epoch are sorted by start offset */
+		if (prev->rc_epc_lo == rect->rc_epc_lo &&
+		    prev->rc_off_hi >= rect->rc_off_lo)
+			return false;
+	}
+	return true;
+}
+
+/** Number of nodes of each level when packing \a nr extents */
+static unsigned int
+evt_bulk_node_nr(struct evt_context *tcx, unsigned int nr,
+		 unsigned int *depth)
+{
+	unsigned int	total = 0;
+
+	*depth = 0;
+	do {
+		nr = (nr + tcx->tc_order - 1) / tcx->tc_order;
+		total += nr;
+		(*depth)++;
+	} while (nr > 1);
+
+	return total;
+}
+
+/**
+ * Pack \a nr sorted extents of \a slots to full leaves, then pack the leaves
+ * to full nodes level by level until there is only one node, which becomes
+ * the root. Nodes have been allocated in \a nodes.
+ */
+static void
+evt_bulk_pack(struct evt_context *tcx, struct evt_bulk_slot *slots,
+	      unsigned int nr, TMMID(struct evt_node) *nodes)
+{
+	struct evt_bulk_slot	*group;
+	struct evt_node		*nd;
+	struct evt_ptr_ref	*pref;
+	TMMID(struct evt_node)	 nd_mmid;
+	unsigned int		 node_nr;
+	unsigned int		 cnt;
+	unsigned int		 i;
+	unsigned int		 j;
+	bool			 leaf = true;
+
+	do {
+		node_nr = (nr + tcx->tc_order - 1) / tcx->tc_order;
+		for (i = 0; i < node_nr; i++) {
+			group = &slots[i * tcx->tc_order];
+			cnt = min(tcx->tc_order, nr - i * tcx->tc_order);
+			qsort(group, cnt, sizeof(*group), evt_bulk_cmp_ssof);
+
+			nd_mmid = *nodes++;
+			nd = evt_tmmid2ptr(tcx, nd_mmid);
+			for (j = 0; j < cnt; j++) {
+				evt_node_rect_write_at(tcx, nd_mmid, j,
+						       &group[j].bs_rect);
+				if (!leaf) {
+					*evt_node_child_at(tcx, nd_mmid, j) =
+					umem_id_u2t(group[j].bs_mmid,
+						    struct evt_node);
+					continue;
+				}
+
+				pref = evt_node_pref_at(tcx, nd_mmid, j);
+				pref->pr_offset	  = 0;
+				pref->pr_inum	  =
+					evt_rect_width(&group[j].bs_rect);
+				pref->pr_ptr_mmid =
+					umem_id_u2t(group[j].bs_mmid,
+						    struct evt_ptr);
+				evt_ptr_addref(tcx, pref->pr_ptr_mmid);
+			}
+			nd->tn_nr = cnt;
+			evt_node_mbr_cal(tcx, nd_mmid);
+
+			/* NB: slot i has been consumed by group i / order */
+			slots[i].bs_rect = nd->tn_mbr;
+			slots[i].bs_mmid = umem_id_t2u(nd_mmid);
+		}
+		nr = node_nr;
+		leaf = false;
+	} while (nr > 1);
+}
+
+/** Insert entries one by one, for non-empty tree or overlapped input */
+static int
+evt_insert_bulk_slow(daos_handle_t toh, uuid_t cookie, uint32_t pm_ver,
+		     struct evt_entry *ents, unsigned int nr)
+{
+	struct evt_entry	*ent;
+	daos_csum_buf_t		*csum;
+	unsigned int		 i;
+	int			 rc = 0;
+
+	for (i = 0; i < nr && rc == 0; i++) {
+		ent = &ents[i];
+		csum = ent->en_csum.cs_len != 0 ? &ent->en_csum : NULL;
+		if (ent->en_flags & EVT_PTR_NVME)
+			rc = evt_insert_nvme(toh, cookie, pm_ver,
+					     &ent->en_rect, ent->en_inob, csum,
+					     ent->en_blk_off);
+		else
+			rc = evt_insert(toh, cookie, pm_ver, &ent->en_rect,
+					ent->en_inob, csum, ent->en_mmid);
+	}
+	return rc;
+}
+
+/**
+ * Bulk load extents to an empty tree.
+ *
+ * Please check API comment in evtree.h for the details.
+ */
+int
+evt_insert_bulk(daos_handle_t toh, uuid_t cookie, uint32_t pm_ver,
+		struct evt_entry *ents, unsigned int nr)
+{
+	struct evt_context	*tcx;
+	struct evt_bulk_slot	*slots = NULL;
+	struct evt_entry	*ent;
+	TMMID(struct evt_node)	*nodes = NULL;
+	TMMID(struct evt_ptr)	 ptr_mmid;
+	unsigned int		 node_nr;
+	unsigned int		 depth;
+	unsigned int		 ptr_nr = 0;
+	unsigned int		 i;
+	int			 rc;
+
+	tcx = evt_hdl2tcx(toh);
+	if (tcx == NULL)
+		return -DER_NO_HDL;
+
+	if (nr == 0)
+		return 0;
+
+	if (!evt_root_empty(tcx) || nr == 1)
+		goto slow;
+
+	for (i = 0; i < nr; i++) {
+		if (!(ents[i].en_flags & EVT_PTR_NVME))
+			continue;
+
+		if (tcx->tc_desc_cbs.dc_nvme_free_cb == NULL ||
+		    ents[i].en_inob == 0) {
+			D_DEBUG(DB_IO, "No NVMe callbacks or punch\n");
+			return -DER_INVAL;
+		}
+	}
+
+	D_ALLOC(slots, nr * sizeof(*slots));
+	if (slots == NULL)
+		return -DER_NOMEM;
+
+	for (i = 0; i < nr; i++) {
+		slots[i].bs_rect = ents[i].en_rect;
+		slots[i].bs_idx	 = i;
+	}
+
+	if (!evt_bulk_sort(slots, nr)) {
+		D_DEBUG(DB_TRACE, "Overlapped extents in the same epoch\n");
+		D_FREE(slots);
+		goto slow;
+	}
+
+	node_nr = evt_bulk_node_nr(tcx, nr, &depth);
+	D_ALLOC(nodes, node_nr * sizeof(*nodes));
+	if (nodes == NULL)
+		D_GOTO(out, rc = -DER_NOMEM);
+
+	rc = umem_tx_begin(evt_umm(tcx));
+	if (rc != 0)
+		D_GOTO(out, rc);
+
+	for (i = ptr_nr = 0; ptr_nr < nr; ptr_nr++) {
+		ent = &ents[slots[ptr_nr].bs_idx];
+		rc = evt_ptr_create(tcx, cookie, pm_ver,
+				    (ent->en_flags & EVT_PTR_NVME) ?
+				    UMMID_NULL : ent->en_mmid,
+				    (ent->en_flags & EVT_PTR_NVME) ?
+				    &ent->en_blk_off : NULL, ent->en_inob,
+				    evt_rect_width(&ent->en_rect),
+				    ent->en_csum.cs_len != 0 ?
+				    &ent->en_csum : NULL, &ptr_mmid);
+		if (rc != 0)
+			D_GOTO(failed, rc);
+		slots[ptr_nr].bs_mmid = umem_id_t2u(ptr_mmid);
+	}
+
+	/* allocate all nodes in advance, packing cannot fail then */
+	for (i = 0; i < node_nr; i++) {
+		unsigned int	flags = 0;
+
+		if (i < (nr + tcx->tc_order - 1) / tcx->tc_order)
+			flags |= EVT_NODE_LEAF;
+		if (i == node_nr - 1)
+			flags |= EVT_NODE_ROOT;
+
+		rc = evt_node_alloc(tcx, flags, &nodes[i]);
+		if (rc != 0)
+			D_GOTO(failed, rc);
+	}
+
+	evt_bulk_pack(tcx, slots, nr, nodes);
+
+	if (evt_has_tx(tcx)) {
+		rc = evt_root_tx_add(tcx);
+		if (rc != 0)
+			D_GOTO(failed_tx, rc);
+	}
+	tcx->tc_root->tr_node  = nodes[node_nr - 1];
+	tcx->tc_root->tr_depth = depth;
+	evt_tcx_set_dep(tcx, depth);
+
+	rc = evt_root_stamp(tcx);
+	if (rc != 0)
+		D_GOTO(failed_tx, rc);
+
+	D_DEBUG(DB_TRACE, "Bulk loaded %u extents, %u nodes, depth %u\n",
+		nr, node_nr, depth);
+	rc = umem_tx_commit(evt_umm(tcx));
+	D_GOTO(out, rc);
+
+failed:
+	/* NB: the caller owns the data until the insert succeeds */
+	while (i-- > 0)
+		evt_node_free(tcx, nodes[i]);
+	while (ptr_nr-- > 0)
+		evt_ptr_free(tcx, umem_id_u2t(slots[ptr_nr].bs_mmid,
+					      struct evt_ptr), false);
+failed_tx:
+	umem_tx_abort(evt_umm(tcx), rc);
+out:
+	D_FREE(nodes);
+	D_FREE(slots);
+	return rc;
+slow:
+	return evt_insert_bulk_slow(toh, cookie, pm_ver, ents, nr);
+}
+
+/**
+ * Add refcount of an extent pointer to the transaction, the last release of
+ * the refcount frees the pointer and its data.
+ */
+static int
+evt_ptr_ref_tx_add(struct evt_context *tcx, TMMID(struct evt_ptr) ptr_mmid)
+{
+	struct evt_ptr	*ptr = evt_tmmid2ptr(tcx, ptr_mmid);
+
+	if (!evt_has_tx(tcx))
+		return 0;
+
+	return umem_tx_add_ptr(evt_umm(tcx), &ptr->pt_ref, sizeof(ptr->pt_ref));
+}
+
+/** Release refcount of an extent pointer being deleted from the tree */
+static int
+evt_ptr_tx_decref(struct evt_context *tcx, TMMID(struct evt_ptr) ptr_mmid)
+{
+	int	rc;
+
+	rc = evt_ptr_ref_tx_add(tcx, ptr_mmid);
+	if (rc == 0)
+		evt_ptr_decref(tcx, ptr_mmid);
+	return rc;
+}
+
+/**
+ * Queue the part [\a off_lo, rc_off_hi] of the leaf extent \a rect at \a at
+ * for re-insertion, the queued entry inherits the refcount of the extent.
+ */
+static int
+evt_del_queue_tail(struct evt_context *tcx, TMMID(struct evt_node) nd_mmid,
+		   unsigned int at, struct evt_rect *rect, daos_off_t off_lo,
+		   struct evt_entry_list *ent_list)
+{
+	struct evt_ptr_ref	*pref = evt_node_pref_at(tcx, nd_mmid, at);
+	struct evt_entry	*ent;
+
+	ent = evt_ent_list_alloc(ent_list, true);
+	if (ent == NULL)
+		return -DER_NOMEM;
+
+	ent->en_rect	     = *rect;
+	ent->en_rect.rc_off_lo = off_lo;
+	ent->en_offset	     = pref->pr_offset + off_lo - rect->rc_off_lo;
+	ent->en_mmid	     = umem_id_t2u(pref->pr_ptr_mmid);
+	return 0;
+}
+
+/**
+ * Delete or trim extents of a leaf node which overlap with \a rect in offset
+ * and are lower than or equal to it in epoch, \a mask has a bit set for each
+ * of them.
+ *
+ * - an extent within the offset range is removed
+ * - an extent covering the low end of the range is trimmed in place
+ * - an extent covering the high end of the range is removed and its tail is
+ *   queued on \a ent_list, it is re-inserted after the scan because trimming
+ *   its start offset breaks the order of the node.
+ * - an extent covering the whole range does both of above.
+ */
+static int
+evt_leaf_delete_range(struct evt_context *tcx, TMMID(struct evt_node) nd_mmid,
+		      struct evt_rect *rect, uint64_t *mask,
+		      struct evt_entry_list *ent_list, unsigned int *del_nr)
+{
+	struct evt_node		*nd = evt_tmmid2ptr(tcx, nd_mmid);
+	struct evt_ptr_ref	*pref;
+	struct evt_rect		 rtmp;
+	unsigned int		 i;
+	unsigned int		 j;
+	int			 rc;
+
+	for (i = j = 0; i < nd->tn_nr; i++) {
+		pref = evt_node_pref_at(tcx, nd_mmid, i);
+		if (!evt_mask_is_set(mask, i))
+			goto keep;
+
+		evt_node_rect_read_at(tcx, nd_mmid, i, &rtmp);
+		if (rtmp.rc_off_hi > rect->rc_off_hi) {
+			if (rtmp.rc_off_lo < rect->rc_off_lo) {
+				/* both head and tail survive */
+				rc = evt_ptr_ref_tx_add(tcx, pref->pr_ptr_mmid);
+				if (rc != 0)
+					return rc;
+				evt_ptr_addref(tcx, pref->pr_ptr_mmid);
+			}
+
+			rc = evt_del_queue_tail(tcx, nd_mmid, i, &rtmp,
+						rect->rc_off_hi + 1, ent_list);
+			if (rc != 0)
+				return rc;
+		}
+
+		if (rtmp.rc_off_lo < rect->rc_off_lo) {
+			rtmp.rc_off_hi = rect->rc_off_lo - 1;
+			evt_node_rect_write_at(tcx, nd_mmid, i, &rtmp);
+			pref->pr_inum = evt_rect_width(&rtmp);
+			goto keep;
+		}
+
+		if (rtmp.rc_off_hi > rect->rc_off_hi)
+			continue; /* refcount is taken by the queued tail */
+
+		D_DEBUG(DB_TRACE, "Delete "DF_RECT" from "TMMID_PF"\n",
+			DP_RECT(&rtmp), TMMID_P(nd_mmid));
+		rc = evt_ptr_tx_decref(tcx, pref->pr_ptr_mmid);
+		if (rc != 0)
+			return rc;
+		(*del_nr)++;
+		continue;
+keep:
+		if (j != i) {
+			evt_node_rect_move(tcx, nd_mmid, j, nd_mmid, i, 1);
+			*evt_node_pref_at(tcx, nd_mmid, j) = *pref;
+		}
+		j++;
+	}
+	nd->tn_nr = j;
+	return 0;
+}
+
+/**
+ * Scan the subtree of \a nd_mmid in one pass, delete or trim all extents
+ * which overlap with \a rect in offset and are lower than or equal to it in
+ * epoch. Children being emptied are freed, MBR of each visited node is
+ * recomputed on the way back.
+ */
+static int
+evt_node_delete_range(struct evt_context *tcx, TMMID(struct evt_node) nd_mmid,
+		      struct evt_rect *rect, struct evt_entry_list *ent_list,
+		      unsigned int *del_nr)
+{
+	struct evt_node		*nd = evt_tmmid2ptr(tcx, nd_mmid);
+	TMMID(struct evt_node)	 child_mmid;
+	uint64_t		 mask[EVT_MASK_WORDS];
+	unsigned int		 i;
+	unsigned int		 j;
+	int			 rc;
+
+	evt_node_overlap_mask(tcx, nd_mmid, rect, mask);
+	if (evt_mask_next(mask, 0, nd->tn_nr) == nd->tn_nr)
+		return 0; /* no overlapped extent in this subtree */
+
+	if (evt_has_tx(tcx)) {
+		rc = evt_node_tx_add(tcx, nd_mmid);
+		if (rc != 0)
+			return rc;
+	}
+
+	if (evt_node_is_leaf(tcx, nd_mmid)) {
+		rc = evt_leaf_delete_range(tcx, nd_mmid, rect, mask, ent_list,
+					   del_nr);
+		goto out;
+	}
+
+	for (i = j = 0; i < nd->tn_nr; i++) {
+		child_mmid = *evt_node_child_at(tcx, nd_mmid, i);
+		if (evt_mask_is_set(mask, i)) {
+			rc = evt_node_delete_range(tcx, child_mmid, rect,
+						   ent_list, del_nr);
+			if (rc != 0)
+				return rc;
+
+			if (evt_tmmid2ptr(tcx, child_mmid)->tn_nr == 0) {
+				evt_node_free(tcx, child_mmid);
+				continue;
+			}
+			evt_node_rect_write_at(tcx, nd_mmid, i,
+					       evt_node_mbr_get(tcx,
+								child_mmid));
+		}
+
+		if (j != i) {
+			evt_node_rect_move(tcx, nd_mmid, j, nd_mmid, i, 1);
+			*evt_node_child_at(tcx, nd_mmid, j) = child_mmid;
+		}
+		j++;
+	}
+	nd->tn_nr = j;
+	rc = 0;
+out:
+	if (rc == 0 && nd->tn_nr != 0)
+		evt_node_mbr_cal(tcx, nd_mmid);
+	return rc;
+}
+
+/**
+ * Delete or trim all versioned extents which overlap with \a rect in offset
+ * and are lower than or equal to it in epoch.
+ *
+ * Please check API comment in evtree.h for the details.
+ */
+int
+evt_delete_range(daos_handle_t toh, struct evt_rect *rect)
+{
+	struct evt_context	*tcx;
+	struct evt_entry_list	 ent_list;
+	struct evt_entry	*ent;
+	struct evt_root		*root;
+	unsigned int		 del_nr = 0;
+	int			 rc;
+
+	tcx = evt_hdl2tcx(toh);
+	if (tcx == NULL)
+		return -DER_NO_HDL;
+
+	if (evt_root_empty(tcx))
+		return 0;
+
+	evt_ent_list_init(&ent_list);
+	rc = umem_tx_begin(evt_umm(tcx));
+	if (rc != 0)
+		return rc;
+
+	root = tcx->tc_root;
+	rc = evt_node_delete_range(tcx, root->tr_node, rect, &ent_list,
+				   &del_nr);
+	if (rc != 0)
+		D_GOTO(out, rc);
+
+	if (evt_tmmid2ptr(tcx, root->tr_node)->tn_nr == 0) {
+		D_DEBUG(DB_TRACE, "All extents are deleted, tree is empty\n");
+		if (evt_has_tx(tcx)) {
+			rc = evt_root_tx_add(tcx);
+			if (rc != 0)
+				D_GOTO(out, rc);
+		}
+		evt_node_free(tcx, root->tr_node);
+		root->tr_node = EVT_NODE_NULL;
+		root->tr_depth = 0;
+		evt_tcx_set_dep(tcx, 0);
+	}
+
+	/* re-insert tails of the extents crossing the high end of range */
+	evt_ent_list_for_each(ent, &ent_list) {
+		if (tcx->tc_depth == 0) {
+			rc = evt_root_activate(tcx);
+			if (rc != 0)
+				D_GOTO(out, rc);
+		}
+
+		rc = evt_insert_entry(tcx, ent);
+		if (rc != 0)
+			D_GOTO(out, rc);
+
+		/* release the refcount inherited from the original extent */
+		rc = evt_ptr_tx_decref(tcx, umem_id_u2t(ent->en_mmid,
+							struct evt_ptr));
+		if (rc != 0)
+			D_GOTO(out, rc);
+	}
+
+	rc = evt_root_stamp(tcx);
+out:
+	D_DEBUG(DB_TRACE, "Deleted %u extents, re-inserted %d tails, range "
+		DF_RECT": %d\n", del_nr, ent_list.el_ent_nr, DP_RECT(rect), rc);
+	evt_ent_list_fini(&ent_list);
+	if (rc != 0) {
+		umem_tx_abort(evt_umm(tcx), rc);
+		return rc;
+	}
+	return umem_tx_commit(evt_umm(tcx));
+}
+
 /** Fill the entry with the extent at the specified position of \a nd_mmid */
 void
 evt_fill_entry(struct evt_context *tcx, TMMID(struct evt_node) nd_mmid,
@@ -1734,14 +2767,15 @@ evt_fill_entry(struct evt_context *tcx, TMMID(struct evt_node) nd_mmid,
 {
 	struct evt_ptr_ref *pref;
 	struct evt_ptr	   *ptr;
-	struct evt_rect	   *rect;
+	struct evt_rect	    rtmp;
+	struct evt_rect	   *rect = &rtmp;
 	void		   *addr;
 	daos_off_t	    offset;
 	daos_size_t	    width;
 	daos_size_t	    nr;
 
 	pref = evt_node_pref_at(tcx, nd_mmid, at);
-	rect = evt_node_rect_at(tcx, nd_mmid, at);
+	evt_node_rect_read_at(tcx, nd_mmid, at, rect);
 	ptr  = evt_tmmid2ptr(tcx, pref->pr_ptr_mmid);
 
 	offset = 0;
@@ -1766,9 +2800,28 @@ evt_fill_entry(struct evt_context *tcx, TMMID(struct evt_node) nd_mmid,
 	entry->en_mmid = umem_id_t2u(pref->pr_ptr_mmid);
 	uuid_copy(entry->en_cookie, ptr->pt_cookie);
 	entry->en_ver = ptr->pt_ver;
+	/* The checksum covers the whole extent as it was written, it can't
+	 * verify an extent which has been trimmed by evt_delete_range.
+	 */
+	if (ptr->pt_cs_len == 0 || pref->pr_offset != 0 ||
+	    evt_rect_width(rect) != ptr->pt_inum) {
+		daos_csum_set(&entry->en_csum, NULL, 0);
+		entry->en_csum.cs_type = 0;
+	} else {
+		daos_csum_set(&entry->en_csum, &ptr->pt_csum, ptr->pt_cs_len);
+		entry->en_csum.cs_type = ptr->pt_cs_type;
+	}
+	entry->en_flags = ptr->pt_flags;
+	entry->en_blk_off = 0;
 
 	addr = evt_ptr_payload(tcx, pref->pr_ptr_mmid, &entry->en_inob, NULL);
-	if (addr == NULL) { /* punched */
+	if (ptr->pt_flags & EVT_PTR_NVME) {
+		/* NB: en_offset is relative to the whole extent on NVMe */
+		entry->en_addr    = NULL;
+		entry->en_blk_off = ptr->pt_blk_off;
+		entry->en_offset  = pref->pr_offset + offset;
+
+	} else if (addr == NULL) { /* punched */
 		entry->en_addr   = NULL;
 		entry->en_offset = 0;
 
@@ -1795,6 +2848,7 @@ evt_find_ent_list(struct evt_context *tcx, enum evt_find_opc find_opc,
 		  struct evt_rect *rect, struct evt_entry_list *ent_list)
 {
 	TMMID(struct evt_node)	 nd_mmid;
+	uint64_t		 mask[EVT_MASK_WORDS];
 	int			 level;
 	int			 at;
 	int			 i;
@@ -1823,41 +2877,27 @@ evt_find_ent_list(struct evt_context *tcx, enum evt_find_opc find_opc,
 			"Checking "DF_RECT"("TMMID_PF"), l=%d, a=%d, f=%d\n",
 			DP_RECT(mbr), TMMID_P(nd_mmid), level, at, leaf);
 
-		for (i = at; i < node->tn_nr; i++) {
+		/* test all rectangles of the node in one pass, then only
+		 * check the overlapped ones.
+		 */
+		evt_node_overlap_mask(tcx, nd_mmid, rect, mask);
+		for (i = evt_mask_next(mask, at, node->tn_nr);
+		     i < node->tn_nr;
+		     i = evt_mask_next(mask, i + 1, node->tn_nr)) {
 			struct evt_entry	*ent;
-			struct evt_rect		*rtmp;
+			struct evt_rect		 rtmp;
 			int			 time_overlap;
 			int			 range_overlap;
 
-			rtmp = evt_node_rect_at(tcx, nd_mmid, i);
+			evt_node_rect_read_at(tcx, nd_mmid, i, &rtmp);
 			D_DEBUG(DB_TRACE, " rect[%d]="DF_RECT"\n",
-				i, DP_RECT(rtmp));
+				i, DP_RECT(&rtmp));
 
-			evt_rect_overlap(rtmp, rect, &range_overlap,
+			evt_rect_overlap(&rtmp, rect, &range_overlap,
 					 &time_overlap);
-			switch (range_overlap) {
-			default:
-				D_ASSERT(0);
-			case RT_OVERLAP_NO:
-				continue; /* skip, no overlap */
-
-			case RT_OVERLAP_SAME:
-			case RT_OVERLAP_INCLUDED:
-			case RT_OVERLAP_INCLUDES:
-			case RT_OVERLAP_PARTIAL:
-				break; /* overlapped */
-			}
-
-			switch (time_overlap) {
-			default:
-				D_ASSERT(0);
-			case RT_OVERLAP_NO:
-			case RT_OVERLAP_UNDER:
-				continue; /* skip, no overlap */
-			case RT_OVERLAP_OVER:
-			case RT_OVERLAP_SAME:
-				break; /* overlapped */
-			}
+			D_ASSERT(range_overlap != RT_OVERLAP_NO);
+			D_ASSERT(time_overlap == RT_OVERLAP_OVER ||
+				 time_overlap == RT_OVERLAP_SAME);
 
 			if (!leaf) {
 				/* break the internal loop and enter the
@@ -1891,7 +2931,7 @@ evt_find_ent_list(struct evt_context *tcx, enum evt_find_opc find_opc,
 						"overwrite not supported:"
 						DF_RECT" overlaps with "DF_RECT
 						"\n", DP_RECT(rect),
-						DP_RECT(rtmp));
+						DP_RECT(&rtmp));
 					rc = -DER_NO_PERM;
 					goto out;
 				}
@@ -1977,9 +3017,17 @@ evt_find(daos_handle_t toh, struct evt_rect *rect,
 		return -DER_NO_HDL;
 
 	evt_ent_list_init(ent_list);
+	if (covered != NULL && evt_vis_cache_lookup(tcx, rect, ent_list)) {
+		D_INIT_LIST_HEAD(covered);
+		return 0;
+	}
+
 	rc = evt_find_ent_list(tcx, EVT_FIND_ALL, rect, ent_list);
-	if (rc == 0 && covered != NULL)
+	if (rc == 0 && covered != NULL) {
 		rc = evt_ent_list_sort(ent_list, covered);
+		if (rc == 0)
+			evt_vis_cache_store(tcx, rect, ent_list);
+	}
 	if (rc != 0)
 		evt_ent_list_fini(ent_list);
 	return rc;
@@ -2043,12 +3091,12 @@ evt_move_trace(struct evt_context *tcx, bool forward)
  */
 int
 evt_open(TMMID(struct evt_root) root_mmid, struct umem_attr *uma,
-	 daos_handle_t *toh)
+	 struct evt_desc_cbs *cbs, daos_handle_t *toh)
 {
 	struct evt_context *tcx;
 	int		    rc;
 
-	rc = evt_tcx_create(root_mmid, NULL, -1, -1, uma, &tcx);
+	rc = evt_tcx_create(root_mmid, NULL, -1, -1, uma, cbs, &tcx);
 	if (rc != 0)
 		return rc;
 
@@ -2063,7 +3111,7 @@ evt_open(TMMID(struct evt_root) root_mmid, struct umem_attr *uma,
  */
 int
 evt_open_inplace(struct evt_root *root, struct umem_attr *uma,
-		 daos_handle_t *toh)
+		 struct evt_desc_cbs *cbs, daos_handle_t *toh)
 {
 	struct evt_context *tcx;
 	int		    rc;
@@ -2073,7 +3121,7 @@ evt_open_inplace(struct evt_root *root, struct umem_attr *uma,
 		return -DER_INVAL;
 	}
 
-	rc = evt_tcx_create(EVT_ROOT_NULL, root, -1, -1, uma, &tcx);
+	rc = evt_tcx_create(EVT_ROOT_NULL, root, -1, -1, uma, cbs, &tcx);
 	if (rc != 0)
 		return rc;
 
@@ -2105,7 +3153,8 @@ evt_close(daos_handle_t toh)
  */
 int
 evt_create(uint64_t feats, unsigned int order, struct umem_attr *uma,
-	   TMMID(struct evt_root) *root_mmid_p, daos_handle_t *toh)
+	   struct evt_desc_cbs *cbs, TMMID(struct evt_root) *root_mmid_p,
+	   daos_handle_t *toh)
 {
 	struct evt_context *tcx;
 	int		    rc;
@@ -2120,7 +3169,8 @@ evt_create(uint64_t feats, unsigned int order, struct umem_attr *uma,
 		return -DER_INVAL;
 	}
 
-	rc = evt_tcx_create(EVT_ROOT_NULL, NULL, feats, order, uma, &tcx);
+	rc = evt_tcx_create(EVT_ROOT_NULL, NULL, feats, order, uma, cbs,
+			    &tcx);
 	if (rc != 0)
 		return rc;
 
@@ -2141,7 +3191,8 @@ evt_create(uint64_t feats, unsigned int order, struct umem_attr *uma,
  */
 int
 evt_create_inplace(uint64_t feats, unsigned int order, struct umem_attr *uma,
-		   struct evt_root *root, daos_handle_t *toh)
+		   struct evt_desc_cbs *cbs, struct evt_root *root,
+		   daos_handle_t *toh)
 {
 	struct evt_context *tcx;
 	int		    rc;
@@ -2156,7 +3207,8 @@ evt_create_inplace(uint64_t feats, unsigned int order, struct umem_attr *uma,
 		return -DER_INVAL;
 	}
 
-	rc = evt_tcx_create(EVT_ROOT_NULL, root, feats, order, uma, &tcx);
+	rc = evt_tcx_create(EVT_ROOT_NULL, root, feats, order, uma, cbs,
+			    &tcx);
 	if (rc != 0)
 		return rc;
 
@@ -2273,7 +3325,7 @@ evt_ssof_insert(struct evt_context *tcx, TMMID(struct evt_node) nd_mmid,
 		struct evt_entry *ent)
 {
 	struct evt_node		*nd   = evt_tmmid2ptr(tcx, nd_mmid);
-	struct evt_rect		*rect = NULL;
+	struct evt_rect		 rect;
 	struct evt_ptr_ref	*pref = NULL;
 	TMMID(struct evt_node)	*nmid = NULL;
 	int			 i;
@@ -2288,13 +3340,13 @@ evt_ssof_insert(struct evt_context *tcx, TMMID(struct evt_node) nd_mmid,
 	for (i = 0; i < nd->tn_nr; i++) {
 		int	nr;
 
-		rect = evt_node_rect_at(tcx, nd_mmid, i);
-		rc = evt_ssof_cmp_rect(tcx, rect, &ent->en_rect);
+		evt_node_rect_read_at(tcx, nd_mmid, i, &rect);
+		rc = evt_ssof_cmp_rect(tcx, &rect, &ent->en_rect);
 		if (rc < 0)
 			continue;
 
 		nr = nd->tn_nr - i;
-		memmove(rect + 1, rect, nr * sizeof(*rect));
+		evt_node_rect_move(tcx, nd_mmid, i + 1, nd_mmid, i, nr);
 		if (leaf) {
 			pref = evt_node_pref_at(tcx, nd_mmid, i);
 			memmove(pref + 1, pref, nr * sizeof(*pref));
@@ -2306,14 +3358,13 @@ evt_ssof_insert(struct evt_context *tcx, TMMID(struct evt_node) nd_mmid,
 	}
 
 	if (i == nd->tn_nr) { /* attach at the end */
-		rect = evt_node_rect_at(tcx, nd_mmid, nd->tn_nr);
 		if (leaf)
 			pref = evt_node_pref_at(tcx, nd_mmid, nd->tn_nr);
 		else
 			nmid = evt_node_child_at(tcx, nd_mmid, nd->tn_nr);
 	}
 
-	*rect = ent->en_rect;
+	evt_node_rect_write_at(tcx, nd_mmid, i, &ent->en_rect);
 	if (leaf) {
 		pref->pr_offset   = ent->en_offset;
 		pref->pr_inum	  = evt_rect_width(&ent->en_rect);
@@ -2334,8 +3385,6 @@ evt_ssof_split(struct evt_context *tcx, bool leaf,
 {
 	struct evt_node	   *nd_src = evt_tmmid2ptr(tcx, src_mmid);
 	struct evt_node	   *nd_dst = evt_tmmid2ptr(tcx, dst_mmid);
-	struct evt_rect	   *rt_src;
-	struct evt_rect	   *rt_dst;
 	int		    nr;
 
 	D_ASSERT(nd_src->tn_nr == tcx->tc_order);
@@ -2347,9 +3396,8 @@ evt_ssof_split(struct evt_context *tcx, bool leaf,
 	 */
 	nr += (nd_src->tn_nr % 2 != 0);
 
-	rt_src = evt_node_rect_at(tcx, src_mmid, nr);
-	rt_dst = evt_node_rect_at(tcx, dst_mmid, 0);
-	memcpy(rt_dst, rt_src, sizeof(*rt_dst) * (nd_src->tn_nr - nr));
+	evt_node_rect_move(tcx, dst_mmid, 0, src_mmid, nr,
+			   nd_src->tn_nr - nr);
 
 	if (leaf) {
 		struct evt_ptr_ref	*src;
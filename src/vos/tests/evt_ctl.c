@@ -106,17 +106,19 @@ ts_open_create(bool create, char *args)
 			ts_order, inplace ? " inplace" : "");
 		if (inplace) {
 			rc = evt_create_inplace(EVT_FEAT_DEFAULT, ts_order,
-						&ts_uma, &ts_root, &ts_toh);
+						&ts_uma, NULL, &ts_root,
+						&ts_toh);
 		} else {
 			rc = evt_create(EVT_FEAT_DEFAULT, ts_order, &ts_uma,
-					&ts_root_mmid, &ts_toh);
+					NULL, &ts_root_mmid, &ts_toh);
 		}
 	} else {
 		D_PRINT("Open evtree %s\n", inplace ? " inplace" : "");
 		if (inplace)
-			rc = evt_open_inplace(&ts_root, &ts_uma, &ts_toh);
+			rc = evt_open_inplace(&ts_root, &ts_uma, NULL,
+					      &ts_toh);
 		else
-			rc = evt_open(ts_root_mmid, &ts_uma, &ts_toh);
+			rc = evt_open(ts_root_mmid, &ts_uma, NULL, &ts_toh);
 	}
 
 	if (rc != 0) {
@@ -230,7 +232,8 @@ ts_add_rect(char *args)
 	sgl.sg_nr = 1;
 	sgl.sg_iovs = &iov;
 
-	rc = evt_insert_sgl(ts_toh, ts_uuid, 0, &rect, val ? 1 : 0, &sgl);
+	rc = evt_insert_sgl(ts_toh, ts_uuid, 0, &rect, val ? 1 : 0, NULL,
+			    &sgl);
 	if (rc == 0)
 		total_added++;
 	if (should_pass) {
@@ -283,6 +286,45 @@ ts_find_rect(char *args)
 	return rc;
 }
 
+static int
+ts_delete_rect(char *args)
+{
+	struct evt_entry_list	 enlist;
+	struct evt_rect		 rect;
+	int			 rc;
+	bool			 should_pass;
+
+	if (args == NULL)
+		return -1;
+
+	rc = ts_parse_rect(args, &rect, NULL, &should_pass);
+	if (rc != 0)
+		return -1;
+
+	D_PRINT("Delete rectangle "DF_RECT"\n", DP_RECT(&rect));
+
+	rc = evt_delete_range(ts_toh, &rect);
+	if (rc != 0) {
+		D_FATAL("Delete rect failed %d\n", rc);
+		return rc;
+	}
+
+	/* nothing should be left in the range */
+	rc = evt_find(ts_toh, &rect, &enlist, NULL);
+	if (rc != 0) {
+		D_FATAL("Find rect failed %d\n", rc);
+		return rc;
+	}
+
+	if (enlist.el_ent_nr != 0) {
+		D_FATAL("Found %d rects after deleting "DF_RECT"\n",
+			enlist.el_ent_nr, DP_RECT(&rect));
+		rc = -1;
+	}
+	evt_ent_list_fini(&enlist);
+	return rc;
+}
+
 static int
 ts_list_rect(void)
 {
@@ -419,7 +461,7 @@ ts_many_add(char *args)
 		sgl.sg_nr = 1;
 		sgl.sg_iovs = &iov;
 
-		rc = evt_insert_sgl(ts_toh, ts_uuid, 0, &rect, 1, &sgl);
+		rc = evt_insert_sgl(ts_toh, ts_uuid, 0, &rect, 1, NULL, &sgl);
 		if (rc != 0) {
 			D_FATAL("Add rect %d failed %d\n", i, rc);
 			break;
@@ -431,6 +473,403 @@ ts_many_add(char *args)
 	return rc;
 }
 
+#define TS_PERF_EXT_SIZE	4
+
+/** parse arguments in format "K1:NUM,K2:NUM" */
+static int
+ts_perf_parse(char *args, char key1, int *val1, char key2, int *val2)
+{
+	char	*tmp;
+
+	if (args[0] != key1 || args[1] != EVT_SEP_VAL)
+		goto failed;
+
+	*val1 = strtol(&args[2], &tmp, 0);
+	if (*val1 <= 0 || *tmp != EVT_SEP)
+		goto failed;
+	args = tmp + 1;
+
+	if (args[0] != key2 || args[1] != EVT_SEP_VAL)
+		goto failed;
+
+	*val2 = strtol(&args[2], &tmp, 0);
+	if (*val2 <= 0)
+		goto failed;
+	return 0;
+failed:
+	D_PRINT("Invalid parameter %s\n", args);
+	return -1;
+}
+
+/**
+ * Insert \a ext_nr extents to a new tree of order \a order and node format
+ * \a feats, then measure \a srch_nr random searches.
+ */
+static int
+ts_perf_order(uint64_t feats, int order, int *seq, int ext_nr, int srch_nr)
+{
+	TMMID(struct evt_root)	 root_mmid;
+	struct evt_entry_list	 enlist;
+	struct evt_rect		 rect;
+	daos_handle_t		 toh;
+	daos_sg_list_t		 sgl;
+	daos_iov_t		 iov;
+	char			 buf[TS_PERF_EXT_SIZE];
+	double			 then;
+	double			 ins_us;
+	double			 srch_us;
+	long			 found = 0;
+	int			 i;
+	int			 rc;
+
+	rc = evt_create(feats, order, &ts_uma, NULL, &root_mmid, &toh);
+	if (rc != 0) {
+		D_PRINT("Failed to create tree: %d\n", rc);
+		return rc;
+	}
+
+	memset(buf, 'a', sizeof(buf));
+	then = dts_time_now();
+	for (i = 0; i < ext_nr; i++) {
+		rect.rc_off_lo = seq[i] * TS_PERF_EXT_SIZE;
+		rect.rc_off_hi = rect.rc_off_lo + TS_PERF_EXT_SIZE - 1;
+		rect.rc_epc_lo = (seq[i] % TS_VAL_CYCLE) + 1;
+
+		daos_iov_set(&iov, buf, sizeof(buf));
+		sgl.sg_nr = 1;
+		sgl.sg_iovs = &iov;
+
+		rc = evt_insert_sgl(toh, ts_uuid, 0, &rect, 1, NULL, &sgl);
+		if (rc != 0) {
+			D_PRINT("Add rect %d failed %d\n", i, rc);
+			D_GOTO(out, rc);
+		}
+	}
+	ins_us = (dts_time_now() - then) * 1000000.0 / ext_nr;
+
+	then = dts_time_now();
+	for (i = 0; i < srch_nr; i++) {
+		struct evt_entry *ent;
+
+		/* each search covers a few extents at a random position */
+		rect.rc_off_lo = (rand() % ext_nr) * TS_PERF_EXT_SIZE;
+		rect.rc_off_hi = rect.rc_off_lo + 4 * TS_PERF_EXT_SIZE - 1;
+		rect.rc_epc_lo = TS_VAL_CYCLE;
+
+		rc = evt_find(toh, &rect, &enlist, NULL);
+		if (rc != 0) {
+			D_PRINT("Find rect %d failed %d\n", i, rc);
+			D_GOTO(out, rc);
+		}
+
+		evt_ent_list_for_each(ent, &enlist)
+			found++;
+		evt_ent_list_fini(&enlist);
+	}
+	srch_us = (dts_time_now() - then) * 1000000.0 / srch_nr;
+
+	D_PRINT("order %3d, %s nodes: insert %7.3f us, search %7.3f us "
+		"(%.1f extents per search)\n", order,
+		(feats & EVT_FEAT_NODE_SOA) ? "SoA" : "AoS", ins_us, srch_us,
+		(double)found / srch_nr);
+ out:
+	evt_destroy(toh);
+	return rc;
+}
+
+/**
+ * Search latency versus tree order for both node formats.
+ * argument format: "n:NUM,q:NUM"
+ * n: number of extents
+ * q: number of searches
+ */
+static int
+ts_perf(char *args)
+{
+	uint64_t	feats;
+	int		ext_nr;
+	int		srch_nr;
+	int		order;
+	int		*seq;
+	int		rc;
+
+	rc = ts_perf_parse(args, 'n', &ext_nr, 'q', &srch_nr);
+	if (rc != 0)
+		return rc;
+
+	seq = dts_rand_iarr_alloc(ext_nr, 0);
+	if (!seq)
+		return -1;
+
+	D_PRINT("Insert %d extents, then search %d times\n", ext_nr, srch_nr);
+	for (order = EVT_ORDER_MIN; order <= EVT_ORDER_MAX; order *= 2) {
+		feats = EVT_FEAT_SORT_SOFF;
+		rc = ts_perf_order(feats, order, seq, ext_nr, srch_nr);
+		if (rc != 0)
+			break;
+
+		feats |= EVT_FEAT_NODE_SOA;
+		rc = ts_perf_order(feats, order, seq, ext_nr, srch_nr);
+		if (rc != 0)
+			break;
+	}
+
+	free(seq);
+	return rc;
+}
+
+/**
+ * Build a tree of \a ext_nr extents by inserting them one by one, or by bulk
+ * load if \a bulk is true, then measure \a srch_nr random searches.
+ */
+static int
+ts_bulk_perf_build(bool bulk, int *seq, int ext_nr, int srch_nr, long *found)
+{
+	TMMID(struct evt_root)	 root_mmid;
+	struct evt_entry_list	 enlist;
+	struct evt_entry	*ents;
+	struct evt_entry	*ent;
+	struct evt_rect		 rect;
+	daos_handle_t		 toh;
+	double			 then;
+	double			 build_us;
+	double			 srch_us;
+	int			 i;
+	int			 rc;
+
+	ents = calloc(ext_nr, sizeof(*ents));
+	if (ents == NULL)
+		return -1;
+
+	for (i = 0; i < ext_nr; i++) {
+		ent = &ents[i];
+		ent->en_rect.rc_off_lo = seq[i] * TS_PERF_EXT_SIZE;
+		ent->en_rect.rc_off_hi = ent->en_rect.rc_off_lo +
+					 TS_PERF_EXT_SIZE - 1;
+		ent->en_rect.rc_epc_lo = (seq[i] % TS_VAL_CYCLE) + 1;
+		ent->en_inob = 1;
+		ent->en_mmid = UMMID_NULL;
+	}
+
+	rc = evt_create(EVT_FEAT_SORT_SOFF, ts_order, &ts_uma, NULL,
+			&root_mmid, &toh);
+	if (rc != 0) {
+		D_PRINT("Failed to create tree: %d\n", rc);
+		free(ents);
+		return rc;
+	}
+
+	then = dts_time_now();
+	if (bulk) {
+		rc = evt_insert_bulk(toh, ts_uuid, 0, ents, ext_nr);
+	} else {
+		for (i = 0; i < ext_nr && rc == 0; i++)
+			rc = evt_insert(toh, ts_uuid, 0, &ents[i].en_rect, 1,
+					NULL, UMMID_NULL);
+	}
+	if (rc != 0) {
+		D_PRINT("Failed to build tree: %d\n", rc);
+		D_GOTO(out, rc);
+	}
+	build_us = (dts_time_now() - then) * 1000000.0 / ext_nr;
+
+	/* same searches for both trees */
+	srand(ext_nr);
+	*found = 0;
+	then = dts_time_now();
+	for (i = 0; i < srch_nr; i++) {
+		rect.rc_off_lo = (rand() % ext_nr) * TS_PERF_EXT_SIZE;
+		rect.rc_off_hi = rect.rc_off_lo + 4 * TS_PERF_EXT_SIZE - 1;
+		rect.rc_epc_lo = TS_VAL_CYCLE;
+
+		rc = evt_find(toh, &rect, &enlist, NULL);
+		if (rc != 0) {
+			D_PRINT("Find rect %d failed %d\n", i, rc);
+			D_GOTO(out, rc);
+		}
+
+		evt_ent_list_for_each(ent, &enlist)
+			(*found)++;
+		evt_ent_list_fini(&enlist);
+	}
+	srch_us = (dts_time_now() - then) * 1000000.0 / srch_nr;
+
+	D_PRINT("%s: build %7.3f us per extent, search %7.3f us\n",
+		bulk ? "bulk load  " : "one by one ", build_us, srch_us);
+ out:
+	evt_destroy(toh);
+	free(ents);
+	return rc;
+}
+
+/**
+ * Compare bulk load with inserting extents one by one.
+ * argument format: "n:NUM,q:NUM"
+ * n: number of extents
+ * q: number of searches
+ */
+static int
+ts_bulk_perf(char *args)
+{
+	long	found_one;
+	long	found_bulk;
+	int	ext_nr;
+	int	srch_nr;
+	int	*seq;
+	int	rc;
+
+	rc = ts_perf_parse(args, 'n', &ext_nr, 'q', &srch_nr);
+	if (rc != 0)
+		return rc;
+
+	seq = dts_rand_iarr_alloc(ext_nr, 0);
+	if (!seq)
+		return -1;
+
+	D_PRINT("Build tree of order %d with %d extents, search %d times\n",
+		ts_order, ext_nr, srch_nr);
+	rc = ts_bulk_perf_build(false, seq, ext_nr, srch_nr, &found_one);
+	if (rc != 0)
+		goto out;
+
+	rc = ts_bulk_perf_build(true, seq, ext_nr, srch_nr, &found_bulk);
+	if (rc != 0)
+		goto out;
+
+	if (found_one != found_bulk) {
+		D_FATAL("Bulk loaded tree found %ld extents, should be %ld\n",
+			found_bulk, found_one);
+		rc = -1;
+	}
+out:
+	free(seq);
+	return rc;
+}
+
+#define TS_VIS_EXT_NR		1024
+
+/** search the latest version of the overwritten range \a srch_nr times */
+static int
+ts_vis_search(daos_handle_t toh, int depth, int srch_nr, bool cached,
+	      double *srch_us, int *vis_nr)
+{
+	struct evt_entry_list	 enlist;
+	struct evt_entry	*ent;
+	struct evt_rect		 rect;
+	d_list_t		 covered;
+	double			 then;
+	int			 i;
+	int			 rc;
+
+	evt_vis_cache_set(cached);
+	rect.rc_off_lo = 0;
+	rect.rc_off_hi = 2 * TS_VIS_EXT_NR - 1;
+	rect.rc_epc_lo = depth;
+
+	then = dts_time_now();
+	for (i = 0; i < srch_nr; i++) {
+		rc = evt_find(toh, &rect, &enlist, &covered);
+		if (rc != 0) {
+			D_PRINT("Find rect %d failed %d\n", i, rc);
+			return rc;
+		}
+
+		*vis_nr = 0;
+		evt_ent_list_for_each(ent, &enlist)
+			(*vis_nr)++;
+		evt_ent_list_fini(&enlist);
+	}
+	*srch_us = (dts_time_now() - then) * 1000000.0 / srch_nr;
+	evt_vis_cache_set(true);
+	return 0;
+}
+
+/** overwrite the same range \a depth times, then measure searches */
+static int
+ts_vis_perf_depth(int depth, int srch_nr)
+{
+	TMMID(struct evt_root)	 root_mmid;
+	struct evt_rect		 rect;
+	daos_handle_t		 toh;
+	daos_sg_list_t		 sgl;
+	daos_iov_t		 iov;
+	char			 buf[TS_VIS_EXT_NR];
+	double			 sort_us;
+	double			 cache_us;
+	int			 vis_nr;
+	int			 i;
+	int			 rc;
+
+	rc = evt_create(EVT_FEAT_DEFAULT, ts_order, &ts_uma, NULL, &root_mmid,
+			&toh);
+	if (rc != 0) {
+		D_PRINT("Failed to create tree: %d\n", rc);
+		return rc;
+	}
+
+	/* each version overwrites the whole range with a shift, so only the
+	 * latest few versions are visible.
+	 */
+	memset(buf, 'v', sizeof(buf));
+	for (i = 0; i < depth; i++) {
+		rect.rc_off_lo = (i % 4) * (TS_VIS_EXT_NR / 8);
+		rect.rc_off_hi = rect.rc_off_lo + TS_VIS_EXT_NR - 1;
+		rect.rc_epc_lo = i + 1;
+
+		daos_iov_set(&iov, buf, sizeof(buf));
+		sgl.sg_nr = 1;
+		sgl.sg_iovs = &iov;
+
+		rc = evt_insert_sgl(toh, ts_uuid, 0, &rect, 1, NULL, &sgl);
+		if (rc != 0) {
+			D_PRINT("Add rect %d failed %d\n", i, rc);
+			D_GOTO(out, rc);
+		}
+	}
+
+	rc = ts_vis_search(toh, depth, srch_nr, false, &sort_us, &vis_nr);
+	if (rc != 0)
+		D_GOTO(out, rc);
+
+	rc = ts_vis_search(toh, depth, srch_nr, true, &cache_us, &vis_nr);
+	if (rc != 0)
+		D_GOTO(out, rc);
+
+	D_PRINT("depth %5d: sort/merge %9.3f us, cached %7.3f us "
+		"(%d visible extents)\n", depth, sort_us, cache_us, vis_nr);
+ out:
+	evt_destroy(toh);
+	return rc;
+}
+
+/**
+ * Latency of searching visible extents versus the overwrite depth.
+ * argument format: "d:NUM,q:NUM"
+ * d: the max overwrite depth, it's doubled in each round
+ * q: number of searches
+ */
+static int
+ts_vis_perf(char *args)
+{
+	int	max_depth;
+	int	srch_nr;
+	int	depth;
+	int	rc;
+
+	rc = ts_perf_parse(args, 'd', &max_depth, 'q', &srch_nr);
+	if (rc != 0)
+		return rc;
+
+	D_PRINT("Search the latest version of overwritten extents %d times\n",
+		srch_nr);
+	for (depth = 1; depth <= max_depth; depth *= 2) {
+		rc = ts_vis_perf_depth(depth, srch_nr);
+		if (rc != 0)
+			break;
+	}
+	return rc;
+}
+
 static int
 ts_tree_debug(char *args)
 {
@@ -452,6 +891,9 @@ static struct option ts_ops[] = {
 	{ "delete",	required_argument,	NULL,	'd'	},
 	{ "list",	no_argument,		NULL,	'l'	},
 	{ "debug",	required_argument,	NULL,	'b'	},
+	{ "perf",	required_argument,	NULL,	'p'	},
+	{ "vis_perf",	required_argument,	NULL,	'v'	},
+	{ "bulk_perf",	required_argument,	NULL,	'L'	},
 	{ NULL,		0,			NULL,	0	},
 };
 
@@ -482,12 +924,24 @@ ts_cmd_run(char opc, char *args)
 	case 'f':
 		rc = ts_find_rect(args);
 		break;
+	case 'd':
+		rc = ts_delete_rect(args);
+		break;
 	case 'l':
 		rc = ts_list_rect();
 		break;
 	case 'b':
 		rc = ts_tree_debug(args);
 		break;
+	case 'p':
+		rc = ts_perf(args);
+		break;
+	case 'v':
+		rc = ts_vis_perf(args);
+		break;
+	case 'L':
+		rc = ts_bulk_perf(args);
+		break;
 	default:
 		D_PRINT("Unsupported command %c\n", opc);
 		rc = 0;
@@ -519,7 +973,7 @@ main(int argc, char **argv)
 	}
 
 	optind = 0;
-	while ((rc = getopt_long(argc, argv, "C:a:m:f:d:b:Docl",
+	while ((rc = getopt_long(argc, argv, "C:a:m:f:d:b:p:v:L:Docl",
 				 ts_ops, NULL)) != -1) {
 		rc = ts_cmd_run(rc, optarg);
 		if (rc != 0)
@@ -527,6 +981,7 @@ main(int argc, char **argv)
 	}
 	rc = 0;
  out:
+	evt_vis_cache_fini();
 	daos_debug_fini();
 	return rc;
 }
@@ -63,6 +63,8 @@ EOF
  -a 3-28@$np4:abcdefghijklmnopqrstuvwxyz	\
  -a 31-56@$nm3:abcdefghijklmnopqrstuvwxyz	\
  -f 0-100@$np4			\
+ -d 22-52@$np1			\
+ -f 0-100@$np4			\
 EOF
 `
 }
@@ -77,6 +79,6 @@ done
 
 echo $cmd
 
-$cmd -b "-1" -a "20-25@60000:finish" -D
+$cmd -b "-1" -d "5-90@50000" -l -a "20-25@60000:finish" -D
 
 echo Test returned $?
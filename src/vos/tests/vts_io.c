@@ -292,9 +292,11 @@ io_recx_iterate(struct io_test_args *arg, vos_iter_param_t *param,
 					D_PRINT("akey[%d]: %s\n", akey_id, buf);
 			}
 
-			D_PRINT("\trecx %u : %s\n",
+			D_PRINT("\trecx %u : %.*s\n",
 				(unsigned int)ent.ie_recx.rx_idx,
 				ent.ie_iov.iov_len == 0 ?
+				(int)strlen("[NULL]") : (int)ent.ie_iov.iov_len,
+				ent.ie_iov.iov_len == 0 ?
 				"[NULL]" : (char *)ent.ie_iov.iov_buf);
 			D_PRINT("\tepoch: "DF_U64"\n",
 				ent.ie_epr.epr_lo);
@@ -753,6 +755,73 @@ io_obj_cache_test(void **state)
 	vos_obj_cache_destroy(occ);
 }
 
+static void
+ocache_stat_query(struct io_test_args *arg, struct vos_ocache_stat *stat)
+{
+	vos_pool_info_t	pinfo;
+	int		rc;
+
+	rc = vos_pool_query(arg->ctx.tc_po_hdl, &pinfo);
+	assert_int_equal(rc, 0);
+	*stat = pinfo.pif_ocache;
+}
+
+static void
+io_obj_cache_stat_test(void **state)
+{
+	struct io_test_args	*arg = *state;
+	struct vos_test_ctx	*ctx = &arg->ctx;
+	struct daos_lru_cache	*occ = NULL;
+	struct vos_object	*obj;
+	struct vos_ocache_stat	 base;
+	struct vos_ocache_stat	 stat;
+	daos_unit_oid_t		 oids[3];
+	int			 i;
+	int			 rc;
+
+	/* two objects at most */
+	rc = vos_obj_cache_create(1, &occ);
+	assert_int_equal(rc, 0);
+
+	for (i = 0; i < 3; i++)
+		oids[i] = gen_oid(arg->ofeat);
+
+	ocache_stat_query(arg, &base);
+
+	rc = hold_objects(&obj, occ, &ctx->tc_co_hdl, &oids[0], 0, 1);
+	assert_int_equal(rc, 0);
+	vos_obj_release(occ, obj);
+
+	rc = hold_objects(&obj, occ, &ctx->tc_co_hdl, &oids[0], 0, 1);
+	assert_int_equal(rc, 0);
+	vos_obj_release(occ, obj);
+
+	ocache_stat_query(arg, &stat);
+	assert_int_equal(stat.os_misses - base.os_misses, 1);
+	assert_int_equal(stat.os_hits - base.os_hits, 1);
+	assert_int_equal(stat.os_nr - base.os_nr, 1);
+	assert_true(stat.os_cost > base.os_cost);
+
+	/* the cache is full, idle objects are evicted */
+	for (i = 1; i < 3; i++) {
+		rc = hold_objects(&obj, occ, &ctx->tc_co_hdl, &oids[i], 0, 1);
+		assert_int_equal(rc, 0);
+		vos_obj_release(occ, obj);
+	}
+
+	ocache_stat_query(arg, &stat);
+	assert_int_equal(stat.os_misses - base.os_misses, 3);
+	assert_int_equal(stat.os_hits - base.os_hits, 1);
+	assert_true(stat.os_evictions > base.os_evictions);
+	assert_true(stat.os_nr - base.os_nr < 3);
+
+	vos_obj_cache_destroy(occ);
+
+	ocache_stat_query(arg, &stat);
+	assert_int_equal(stat.os_nr, base.os_nr);
+	assert_int_equal(stat.os_cost, base.os_cost);
+}
+
 static void
 io_multiple_dkey_test(void **state, unsigned int flags)
 {
@@ -1336,7 +1405,7 @@ pool_cont_same_uuid(void **state)
 	uuid_generate(pool_uuid);
 	uuid_copy(co_uuid, pool_uuid);
 
-	ret = vos_pool_create(arg->fname, pool_uuid, VPOOL_16M);
+	ret = vos_pool_create(arg->fname, pool_uuid, VPOOL_16M, 0);
 	assert_int_equal(ret, 0);
 
 	ret = vos_pool_open(arg->fname, pool_uuid, &poh);
@@ -1390,6 +1459,155 @@ pool_cont_same_uuid(void **state)
 	assert_int_equal(ret, 0);
 }
 
+#define NVME_TEST_NR	(64 << 10)
+
+static void
+io_nvme_fetch_verify(daos_handle_t coh, daos_unit_oid_t oid, daos_key_t *dkey,
+		     daos_iod_t *iod, char *expected, bool zc)
+{
+	daos_sg_list_t	*zc_sgl;
+	daos_sg_list_t	 sgl;
+	daos_iov_t	 iov;
+	daos_handle_t	 ioh;
+	daos_recx_t	*rex = iod->iod_recxs;
+	char		*buf;
+	unsigned int	 off;
+	int		 i;
+	int		 ret;
+
+	D_ALLOC(buf, rex->rx_nr);
+	assert_ptr_not_equal(buf, NULL);
+	iod->iod_size = 0;
+
+	if (!zc) {
+		daos_iov_set(&iov, buf, rex->rx_nr);
+		sgl.sg_nr = 1;
+		sgl.sg_iovs = &iov;
+		ret = vos_obj_fetch(coh, oid, 11, dkey, 1, iod, &sgl);
+		assert_int_equal(ret, 0);
+	} else {
+		ret = vos_obj_zc_fetch_begin(coh, oid, 11, dkey, 1, iod, &ioh);
+		assert_int_equal(ret, 0);
+
+		ret = vos_obj_zc_sgl_at(ioh, 0, &zc_sgl);
+		assert_int_equal(ret, 0);
+
+		for (i = off = 0; i < zc_sgl->sg_nr_out; i++) {
+			memcpy(buf + off, zc_sgl->sg_iovs[i].iov_buf,
+			       zc_sgl->sg_iovs[i].iov_len);
+			off += zc_sgl->sg_iovs[i].iov_len;
+		}
+		assert_int_equal(off, rex->rx_nr);
+
+		ret = vos_obj_zc_fetch_end(ioh, dkey, 1, iod, 0);
+		assert_int_equal(ret, 0);
+	}
+
+	assert_int_equal(iod->iod_size, 1);
+	assert_memory_equal(buf, expected + rex->rx_idx, rex->rx_nr);
+	D_FREE(buf);
+}
+
+/**
+ * Large extents go to the NVMe blob, which is a sparse file next to the pool
+ * file for standalone VOS, the small overwrite stays on SCM.
+ */
+static void
+io_nvme_update_fetch(void **state)
+{
+	struct io_test_args	*arg = *state;
+	uuid_t			 pool_uuid, co_uuid;
+	daos_handle_t		 poh, coh;
+	daos_iov_t		 val_iov;
+	daos_key_t		 dkey;
+	daos_key_t		 akey;
+	daos_recx_t		 rex;
+	char			 dkey_buf[UPDATE_DKEY_SIZE];
+	char			 akey_buf[UPDATE_AKEY_SIZE];
+	char			*update_buf;
+	daos_iod_t		 iod;
+	daos_sg_list_t		 sgl;
+	uuid_t			 cookie;
+	daos_unit_oid_t		 oid;
+	int			 ret;
+
+	uuid_generate(pool_uuid);
+	uuid_generate(co_uuid);
+
+	ret = vos_pool_create(arg->fname, pool_uuid, VPOOL_16M, VPOOL_16M);
+	assert_int_equal(ret, 0);
+
+	ret = vos_pool_open(arg->fname, pool_uuid, &poh);
+	assert_int_equal(ret, 0);
+
+	ret = vos_cont_create(poh, co_uuid);
+	assert_int_equal(ret, 0);
+
+	ret = vos_cont_open(poh, co_uuid, &coh);
+	assert_int_equal(ret, 0);
+
+	D_ALLOC(update_buf, NVME_TEST_NR);
+	assert_ptr_not_equal(update_buf, NULL);
+	dts_buf_render(update_buf, NVME_TEST_NR);
+
+	memset(&iod, 0, sizeof(iod));
+	memset(dkey_buf, 0, sizeof(dkey_buf));
+	memset(akey_buf, 0, sizeof(akey_buf));
+	dts_key_gen(&dkey_buf[0], arg->dkey_size, arg->dkey);
+	dts_key_gen(&akey_buf[0], arg->akey_size, arg->akey);
+	set_iov(&dkey, &dkey_buf[0], arg->ofeat & DAOS_OF_DKEY_UINT64);
+	set_iov(&akey, &akey_buf[0], arg->ofeat & DAOS_OF_AKEY_UINT64);
+
+	iod.iod_name	= akey;
+	iod.iod_recxs	= &rex;
+	iod.iod_nr	= 1;
+	iod.iod_type	= DAOS_IOD_ARRAY;
+	iod.iod_size	= 1;
+	rex.rx_idx	= 0;
+	rex.rx_nr	= NVME_TEST_NR;
+
+	daos_iov_set(&val_iov, update_buf, NVME_TEST_NR);
+	sgl.sg_nr = 1;
+	sgl.sg_iovs = &val_iov;
+
+	uuid_generate(cookie);
+	oid = gen_oid(arg->ofeat);
+	ret = vos_obj_update(coh, oid, 10, cookie, 0, &dkey, 1, &iod, &sgl);
+	assert_int_equal(ret, 0);
+
+	/* small overwrite in the middle splits the NVMe extent */
+	dts_buf_render(update_buf + 5000, 100);
+	daos_iov_set(&val_iov, update_buf + 5000, 100);
+	rex.rx_idx	= 5000;
+	rex.rx_nr	= 100;
+	ret = vos_obj_update(coh, oid, 11, cookie, 0, &dkey, 1, &iod, &sgl);
+	assert_int_equal(ret, 0);
+
+	rex.rx_idx	= 0;
+	rex.rx_nr	= NVME_TEST_NR;
+	io_nvme_fetch_verify(coh, oid, &dkey, &iod, update_buf, false);
+	io_nvme_fetch_verify(coh, oid, &dkey, &iod, update_buf, true);
+
+	/* unaligned partial fetch of the tail of the extent */
+	rex.rx_idx	= 6001;
+	rex.rx_nr	= NVME_TEST_NR - 6001;
+	io_nvme_fetch_verify(coh, oid, &dkey, &iod, update_buf, false);
+	io_nvme_fetch_verify(coh, oid, &dkey, &iod, update_buf, true);
+	D_FREE(update_buf);
+
+	ret = vos_cont_close(coh);
+	assert_int_equal(ret, 0);
+
+	ret = vos_cont_destroy(poh, co_uuid);
+	assert_int_equal(ret, 0);
+
+	ret = vos_pool_close(poh);
+	assert_int_equal(ret, 0);
+
+	ret = vos_pool_destroy(arg->fname, pool_uuid);
+	assert_int_equal(ret, 0);
+}
+
 static void
 io_fetch_no_exist_dkey_base(void **state, unsigned long flags)
 {
@@ -1698,6 +1916,8 @@ static const struct CMUnitTest io_tests[] = {
 		io_oi_test, NULL, NULL},
 	{ "VOS202: VOS object cache test",
 		io_obj_cache_test, NULL, NULL},
+	{ "VOS202.1: VOS object cache statistics of pool",
+		io_obj_cache_stat_test, NULL, NULL},
 	{ "VOS203: Simple update/fetch/verify test",
 		io_simple_one_key, NULL, NULL},
 	{ "VOS204: Simple Punch test",
@@ -1744,6 +1964,8 @@ static const struct CMUnitTest io_tests[] = {
 		io_fetch_no_exist_dkey_zc, NULL, NULL},
 	{ "VOS282.2: Accessing pool, container with same UUID",
 		pool_cont_same_uuid, NULL, NULL},
+	{ "VOS283: Update/fetch large extent on NVMe",
+		io_nvme_update_fetch, NULL, NULL},
 	{ "VOS299: Space overflow negative error test",
 		io_pool_overflow_test, NULL, io_pool_overflow_teardown},
 };
@@ -1305,6 +1305,125 @@ io_multi_recx_overwrite_test_with_credits(void **state)
 	io_multi_recx_overwrite_test(arg, MULTI_RECX_OVERWRITE_WITH_CREDITS);
 }
 
+/** aggregate \a range of the test object, return true if it is skipped */
+static bool
+aggregate_obj_skipped(struct io_test_args *arg, daos_epoch_range_t *range)
+{
+	vos_purge_anchor_t	vp_anchor;
+	unsigned int		credits = -1;
+	bool			finish;
+	int			rc;
+
+	memset(&vp_anchor, 0, sizeof(vp_anchor));
+	rc = vos_epoch_aggregate(arg->ctx.tc_co_hdl, arg->oid, range,
+				 &credits, &vp_anchor, &finish);
+	assert_int_equal(rc, 0);
+	assert_true(finish);
+	return vp_anchor.pa_skipped;
+}
+
+static void
+io_aggregate_skip_clean_test(void **state)
+{
+	struct io_test_args	*arg = *state;
+	int			 i;
+	int			 rc = 0;
+	daos_epoch_t		 epoch;
+	struct d_uuid		 cookie;
+	daos_epoch_range_t	 range;
+	struct vts_counter	 cntrs;
+	char			 dkey_buf[UPDATE_DKEY_SIZE];
+	char			 akey_buf[UPDATE_AKEY_SIZE];
+	int			 idx;
+	struct io_req		*req = NULL;
+
+	arg->ta_flags = 0;
+	cookie = gen_rand_cookie();
+	epoch = 2048;
+	set_key_and_index(&dkey_buf[0], &akey_buf[0], &idx);
+
+	for (i = 0; i < 5; i++) {
+		/* the last update is beyond the first aggregated range */
+		rc = io_update(arg, i < 4 ? epoch + i : epoch + 10, &cookie,
+			       &dkey_buf[0], &akey_buf[0], &cntrs, &req, idx,
+			       UPDATE_VERBOSE);
+		assert_int_equal(rc, 0);
+		d_list_add(&req->rlist, &arg->req_list);
+		set_key_and_index(&dkey_buf[0], NULL, NULL);
+	}
+
+	range.epr_lo = epoch;
+	range.epr_hi = epoch + 3;
+	assert_false(aggregate_obj_skipped(arg, &range));
+	/* nothing has changed in the range since the last aggregation */
+	assert_true(aggregate_obj_skipped(arg, &range));
+
+	/* only the update at epoch + 10 is left */
+	range.epr_lo = epoch + 11;
+	range.epr_hi = epoch + 20;
+	assert_true(aggregate_obj_skipped(arg, &range));
+
+	range.epr_lo = epoch + 4;
+	assert_false(aggregate_obj_skipped(arg, &range));
+	assert_true(aggregate_obj_skipped(arg, &range));
+
+	/* dirty again */
+	rc = io_update(arg, epoch + 30, &cookie, &dkey_buf[0], &akey_buf[0],
+		       &cntrs, &req, idx, UPDATE_VERBOSE);
+	assert_int_equal(rc, 0);
+	d_list_add(&req->rlist, &arg->req_list);
+	range.epr_hi = epoch + 30;
+	assert_false(aggregate_obj_skipped(arg, &range));
+
+	verify_io_fetch(arg);
+}
+
+static void
+io_array_overwrite_aggregate_test(void **state)
+{
+	struct io_test_args	*arg = *state;
+	int			 i;
+	int			 rc = 0;
+	daos_epoch_t		 epoch;
+	struct d_uuid		 cookie;
+	daos_epoch_range_t	 range;
+	struct vts_counter	 cntrs;
+	char			 dkey_buf[UPDATE_DKEY_SIZE];
+	char			 akey_buf[UPDATE_AKEY_SIZE];
+	int			 idx;
+	struct io_req		*once = NULL;
+	struct io_req		*req = NULL;
+
+	arg->ta_flags = TF_REC_EXT;
+	cookie = gen_rand_cookie();
+	epoch = 4096;
+	set_key_and_index(&dkey_buf[0], &akey_buf[0], &idx);
+
+	/* the akey only has an array, this record is never overwritten */
+	rc = io_update(arg, epoch, &cookie, &dkey_buf[0], &akey_buf[0],
+		       &cntrs, &once, idx + 1, UPDATE_VERBOSE);
+	assert_int_equal(rc, 0);
+	d_list_add(&once->rlist, &arg->req_list);
+
+	for (i = 0; i < 4; i++) {
+		rc = io_update(arg, epoch + i, &cookie, &dkey_buf[0],
+			       &akey_buf[0], &cntrs, &req, idx,
+			       UPDATE_VERBOSE);
+		assert_int_equal(rc, 0);
+		d_list_add(&req->rlist, &arg->req_list);
+	}
+
+	range.epr_lo = epoch;
+	range.epr_hi = epoch + 3;
+	assert_false(aggregate_obj_skipped(arg, &range));
+
+	/* the latest record and the one never overwritten are retained */
+	rc = io_fetch(arg, range.epr_hi, req, FETCH_VERBOSE);
+	assert_int_equal(rc, 0);
+	rc = io_fetch(arg, range.epr_hi, once, FETCH_VERBOSE);
+	assert_int_equal(rc, 0);
+}
+
 static const struct CMUnitTest discard_tests[] = {
 	{ "VOS301: VOS Simple discard test",
 		io_simple_one_key_discard, io_simple_discard_setup,
@@ -1371,6 +1490,12 @@ static const struct CMUnitTest aggregate_tests[] = {
 	{ "VOS403.3: VOS recx update aggregate test",
 		io_multi_recx_aggregate_test, io_multi_recx_discard_setup,
 		io_multikey_discard_teardown},
+	{ "VOS404: VOS aggregate skips clean objects",
+		io_aggregate_skip_clean_test, io_multikey_discard_setup,
+		io_multikey_discard_teardown},
+	{ "VOS405: VOS array overwrite aggregate test",
+		io_array_overwrite_aggregate_test, io_multikey_discard_setup,
+		io_multikey_discard_teardown},
 
 };
 
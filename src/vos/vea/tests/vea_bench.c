@@ -0,0 +1,355 @@
+/**
+ * (C) Copyright 2018 Intel Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * GOVERNMENT LICENSE RIGHTS-OPEN SOURCE SOFTWARE
+ * The Government's rights to use, modify, reproduce, release, perform, display,
+ * or disclose this software are subject to the terms of the Apache License as
+ * provided in Contract No. B609815.
+ * Any reproduction of computer software, computer software documentation, or
+ * portions thereof marked with this legend must also reproduce the markings.
+ */
+/**
+ * VEA allocation benchmark.
+ *
+ * Runs millions of random reserve/publish/free cycles against a VEA instance
+ * (on volatile memory by default), reports the latency of each operation and
+ * the fragmentation of the free space at the end of the run.
+ */
+#define D_LOGFAC	DD_FAC(tests)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <getopt.h>
+#include <daos/common.h>
+#include <daos/btree.h>
+#include <daos_srv/vea.h>
+
+#define VB_HDR_BLKS	1
+
+struct vb_ext {
+	uint64_t	ve_off;
+	uint32_t	ve_cnt;
+};
+
+struct vb_lat {
+	const char	*vl_name;
+	uint64_t	 vl_cnt;
+	uint64_t	 vl_tot;
+	uint64_t	 vl_max;
+};
+
+struct vb_frag {
+	uint64_t	vf_free;
+	uint64_t	vf_frags;
+	uint64_t	vf_largest;
+};
+
+static uint64_t	vb_capacity = 64ULL << 30;	/* 64GB */
+static uint64_t	vb_cycles = 4000000;
+static uint32_t	vb_blk_sz = 4096;
+static uint32_t	vb_max_blks = 256;		/* 1MB with 4k block */
+static int	vb_streams = 8;
+static int	vb_fill = 80;			/* percentage */
+static unsigned	vb_seed;
+
+static struct vb_lat vb_lat_reserve = { .vl_name = "reserve" };
+static struct vb_lat vb_lat_publish = { .vl_name = "publish" };
+static struct vb_lat vb_lat_free = { .vl_name = "free" };
+
+static inline uint64_t
+vb_now(void)
+{
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static inline void
+vb_lat_add(struct vb_lat *lat, uint64_t start)
+{
+	uint64_t	ns = vb_now() - start;
+
+	lat->vl_cnt++;
+	lat->vl_tot += ns;
+	if (ns > lat->vl_max)
+		lat->vl_max = ns;
+}
+
+static void
+vb_lat_print(struct vb_lat *lat)
+{
+	if (lat->vl_cnt == 0)
+		return;
+	printf("%-8s ops: "DF_U64", avg: "DF_U64" ns, max: "DF_U64" ns\n",
+	       lat->vl_name, lat->vl_cnt, lat->vl_tot / lat->vl_cnt,
+	       lat->vl_max);
+}
+
+static int
+vb_frag_cb(daos_handle_t ih, daos_iov_t *key, daos_iov_t *val, void *arg)
+{
+	struct vb_frag		*frag = arg;
+	struct vea_free_extent	*vfe = val->iov_buf;
+
+	frag->vf_free += vfe->vfe_blk_cnt;
+	frag->vf_frags++;
+	if (vfe->vfe_blk_cnt > frag->vf_largest)
+		frag->vf_largest = vfe->vfe_blk_cnt;
+	return 0;
+}
+
+/* Walk the persistent free extent tree to measure fragmentation */
+static int
+vb_frag_print(struct umem_instance *umm, struct vea_space_df *md)
+{
+	struct vb_frag		frag = { 0 };
+	struct umem_attr	uma;
+	daos_handle_t		toh;
+	int			rc;
+
+	umem_attr_get(umm, &uma);
+	rc = dbtree_open_inplace(&md->vsd_free_tree, &uma, &toh);
+	if (rc) {
+		fprintf(stderr, "Open free extent tree failed: %d\n", rc);
+		return rc;
+	}
+	rc = dbtree_iterate(toh, false, vb_frag_cb, &frag);
+	dbtree_close(toh);
+	if (rc) {
+		fprintf(stderr, "Iterate free extent tree failed: %d\n", rc);
+		return rc;
+	}
+
+	printf("Used blocks: "DF_U64"/"DF_U64", free blocks: "DF_U64"\n",
+	       md->vsd_tot_used, md->vsd_tot_blks - md->vsd_hdr_blks,
+	       frag.vf_free);
+	printf("Free fragments: "DF_U64" (md: "DF_U64"), largest free "
+	       "extent: "DF_U64" blocks, avg: "DF_U64" blocks\n",
+	       frag.vf_frags, md->vsd_free_frags, frag.vf_largest,
+	       frag.vf_frags ? frag.vf_free / frag.vf_frags : 0);
+	if (frag.vf_free != 0)
+		printf("Fragmentation: %.2f%%\n",
+		       100.0 * (frag.vf_free - frag.vf_largest) /
+		       frag.vf_free);
+	return 0;
+}
+
+static int
+vb_alloc(struct vea_space_info *vsi, struct vea_hint_context *hint,
+	 struct vb_ext *ext)
+{
+	struct vea_resrvd_ext	*resrvd;
+	d_list_t		 resrvd_list;
+	uint64_t		 start;
+	uint32_t		 blk_cnt = 1 + rand() % vb_max_blks;
+	int			 rc;
+
+	D_INIT_LIST_HEAD(&resrvd_list);
+
+	start = vb_now();
+	rc = vea_reserve(vsi, blk_cnt, hint, &resrvd_list);
+	if (rc)
+		return rc;
+	vb_lat_add(&vb_lat_reserve, start);
+
+	resrvd = d_list_entry(resrvd_list.next, struct vea_resrvd_ext,
+			      vre_link);
+	ext->ve_off = resrvd->vre_blk_off;
+	ext->ve_cnt = resrvd->vre_blk_cnt;
+
+	start = vb_now();
+	rc = vea_tx_publish(vsi, hint, &resrvd_list);
+	if (rc) {
+		fprintf(stderr, "Publish failed: %d\n", rc);
+		vea_cancel(vsi, hint, &resrvd_list);
+		return rc;
+	}
+	vb_lat_add(&vb_lat_publish, start);
+	return 0;
+}
+
+static int
+vb_run(void)
+{
+	struct umem_attr	  uma = { .uma_id = UMEM_CLASS_VMEM };
+	struct umem_instance	  umm;
+	struct vea_space_df	 *md = NULL;
+	struct vea_space_info	 *vsi = NULL;
+	struct vea_hint_df	 *hint_dfs = NULL;
+	struct vea_hint_context **hints = NULL;
+	struct vb_ext		 *exts = NULL;
+	uint64_t		  ext_cnt = 0, nospace = 0, i;
+	int			  s, rc;
+
+	rc = umem_class_init(&uma, &umm);
+	if (rc)
+		return rc;
+
+	D_ALLOC_PTR(md);
+	D_ALLOC(hint_dfs, sizeof(*hint_dfs) * vb_streams);
+	D_ALLOC(hints, sizeof(*hints) * vb_streams);
+	D_ALLOC(exts, sizeof(*exts) * vb_cycles);
+	if (md == NULL || hint_dfs == NULL || hints == NULL || exts == NULL)
+		D_GOTO(out, rc = -DER_NOMEM);
+
+	rc = vea_format(&umm, md, 0, vb_blk_sz, VB_HDR_BLKS, vb_capacity,
+			NULL, NULL, false);
+	if (rc) {
+		fprintf(stderr, "Format failed: %d\n", rc);
+		D_GOTO(out, rc);
+	}
+
+	rc = vea_load(&umm, md, NULL, &vsi);
+	if (rc) {
+		fprintf(stderr, "Load failed: %d\n", rc);
+		D_GOTO(out, rc);
+	}
+
+	for (s = 0; s < vb_streams; s++) {
+		rc = vea_hint_load(&hint_dfs[s], &hints[s]);
+		if (rc)
+			D_GOTO(out, rc);
+	}
+
+	printf("VEA bench: capacity "DF_U64" blocks, "DF_U64" cycles, "
+	       "max %u blocks, %d streams, %d%% fill, seed %u\n",
+	       md->vsd_tot_blks, vb_cycles, vb_max_blks, vb_streams, vb_fill,
+	       vb_seed);
+
+	for (i = 0; i < vb_cycles; i++) {
+		uint64_t	used = md->vsd_tot_used * 100 / md->vsd_tot_blks;
+		bool		alloc;
+
+		/* Grow to the fill level, then keep churning around it */
+		alloc = ext_cnt == 0 ||
+			(used < vb_fill && rand() % 100 < 60);
+
+		if (alloc) {
+			s = rand() % vb_streams;
+			rc = vb_alloc(vsi, hints[s], &exts[ext_cnt]);
+			if (rc == 0) {
+				ext_cnt++;
+				continue;
+			}
+			if (rc != -DER_NOSPACE)
+				D_GOTO(out, rc);
+			nospace++;
+		}
+
+		if (ext_cnt > 0) {
+			uint64_t	idx = rand() % ext_cnt;
+			uint64_t	start = vb_now();
+
+			rc = vea_tx_free(vsi, exts[idx].ve_off,
+					 exts[idx].ve_cnt);
+			if (rc) {
+				fprintf(stderr, "Free failed: %d\n", rc);
+				D_GOTO(out, rc);
+			}
+			vb_lat_add(&vb_lat_free, start);
+			exts[idx] = exts[--ext_cnt];
+		}
+	}
+
+	vb_lat_print(&vb_lat_reserve);
+	vb_lat_print(&vb_lat_publish);
+	vb_lat_print(&vb_lat_free);
+	printf("Allocated extents: "DF_U64", ENOSPACE: "DF_U64"\n",
+	       ext_cnt, nospace);
+	rc = vb_frag_print(&umm, md);
+out:
+	if (hints != NULL) {
+		for (s = 0; s < vb_streams; s++) {
+			if (hints[s] != NULL)
+				vea_hint_unload(hints[s]);
+		}
+		D_FREE(hints);
+	}
+	if (vsi != NULL)
+		vea_unload(vsi);
+	D_FREE(exts);
+	D_FREE(hint_dfs);
+	D_FREE_PTR(md);
+	return rc;
+}
+
+static struct option vb_ops[] = {
+	{ "capacity",	required_argument,	NULL,	'c'	},
+	{ "cycles",	required_argument,	NULL,	'n'	},
+	{ "max_blks",	required_argument,	NULL,	'm'	},
+	{ "streams",	required_argument,	NULL,	's'	},
+	{ "fill",	required_argument,	NULL,	'f'	},
+	{ "seed",	required_argument,	NULL,	'r'	},
+	{ NULL,		0,			NULL,	0	},
+};
+
+static void
+vb_usage(const char *prog)
+{
+	printf("Usage: %s [-c capacity_gb] [-n cycles] [-m max_blks] "
+	       "[-s streams] [-f fill_pct] [-r seed]\n", prog);
+}
+
+int
+main(int argc, char **argv)
+{
+	int	rc;
+
+	vb_seed = time(NULL);
+	while ((rc = getopt_long(argc, argv, "c:n:m:s:f:r:", vb_ops,
+				 NULL)) != -1) {
+		switch (rc) {
+		case 'c':
+			vb_capacity = strtoull(optarg, NULL, 0) << 30;
+			break;
+		case 'n':
+			vb_cycles = strtoull(optarg, NULL, 0);
+			break;
+		case 'm':
+			vb_max_blks = atoi(optarg);
+			break;
+		case 's':
+			vb_streams = atoi(optarg);
+			break;
+		case 'f':
+			vb_fill = atoi(optarg);
+			break;
+		case 'r':
+			vb_seed = atoi(optarg);
+			break;
+		default:
+			vb_usage(argv[0]);
+			return -1;
+		}
+	}
+
+	if (vb_cycles == 0 || vb_max_blks == 0 || vb_streams <= 0 ||
+	    vb_fill <= 0 || vb_fill > 100) {
+		vb_usage(argv[0]);
+		return -1;
+	}
+	srand(vb_seed);
+
+	rc = daos_debug_init(NULL);
+	if (rc != 0)
+		return rc;
+
+	rc = vb_run();
+	daos_debug_fini();
+	return rc;
+}
@@ -0,0 +1,240 @@
+/**
+ * (C) Copyright 2018 Intel Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * GOVERNMENT LICENSE RIGHTS-OPEN SOURCE SOFTWARE
+ * The Government's rights to use, modify, reproduce, release, perform, display,
+ * or disclose this software are subject to the terms of the Apache License as
+ * provided in Contract No. B609815.
+ * Any reproduction of computer software, computer software documentation, or
+ * portions thereof marked with this legend must also reproduce the markings.
+ */
+#define D_LOGFAC	DD_FAC(vos)
+
+#include <daos/common.h>
+#include <daos_srv/vea.h>
+#include "vea_internal.h"
+
+/*
+ * Carve [off, off + cnt) out of the free extent tracked by @entry in the
+ * compound index, the remaining head and tail (if any) stay free. The head
+ * keeps the original age, the tail is marked as active since the I/O stream
+ * is going to continue from there.
+ */
+static int
+compound_alloc(struct vea_space_info *vsi, struct vea_entry *entry,
+	       uint64_t off, uint32_t cnt)
+{
+	struct vea_free_extent	old = entry->ve_ext;
+	struct vea_free_extent	tail;
+	uint64_t		end = old.vfe_blk_off + old.vfe_blk_cnt;
+	int			rc;
+
+	D_ASSERT(off >= old.vfe_blk_off && off + cnt <= end);
+
+	if (off == old.vfe_blk_off) {
+		rc = delete_free_entry(vsi, &entry->ve_ext, VEA_TYPE_COMPOUND);
+	} else {
+		free_class_remove(&vsi->vsi_class, entry);
+		entry->ve_ext.vfe_blk_cnt = off - old.vfe_blk_off;
+		rc = free_class_add(&vsi->vsi_class, entry);
+	}
+	if (rc || off + cnt == end)
+		return rc;
+
+	tail.vfe_blk_off = off + cnt;
+	tail.vfe_blk_cnt = end - tail.vfe_blk_off;
+	tail.vfe_flags = 0;
+	tail.vfe_age = vea_get_age();
+
+	return insert_free_entry(vsi, &tail, VEA_TYPE_COMPOUND);
+}
+
+static inline int
+reserve_ext(struct vea_space_info *vsi, struct vea_entry *entry,
+	    uint64_t off, uint32_t blk_cnt, struct vea_resrvd_ext *resrvd)
+{
+	int	rc;
+
+	rc = compound_alloc(vsi, entry, off, blk_cnt);
+	if (rc == 0) {
+		resrvd->vre_blk_off = off;
+		resrvd->vre_blk_cnt = blk_cnt;
+	}
+	return rc;
+}
+
+/* Reserve from the free extent starting at the hint offset */
+static int
+reserve_hint(struct vea_space_info *vsi, uint32_t blk_cnt,
+	     struct vea_resrvd_ext *resrvd)
+{
+	struct vea_free_extent	*vfe;
+	uint64_t		 off = resrvd->vre_hint_off;
+	int			 rc;
+
+	/* Block offset 0 is always occupied by the device header */
+	if (off == 0)
+		return 0;
+
+	rc = fetch_free_entry(vsi, off, BTR_PROBE_EQ, VEA_TYPE_COMPOUND, &vfe);
+	if (rc == -DER_NONEXIST)
+		return 0;
+	else if (rc)
+		return rc;
+
+	if (vfe->vfe_blk_cnt < blk_cnt)
+		return 0;
+
+	return reserve_ext(vsi, container_of(vfe, struct vea_entry, ve_ext),
+			   off, blk_cnt, resrvd);
+}
+
+/*
+ * Reserve from the largest free extent. A non-active large extent is divided
+ * in half and the latter half is used, so that new I/O streams are spread
+ * over the device and each of them has space to grow sequentially.
+ */
+static int
+reserve_large(struct vea_space_info *vsi, uint32_t blk_cnt,
+	      struct vea_resrvd_ext *resrvd)
+{
+	struct vea_free_class	*vfc = &vsi->vsi_class;
+	struct d_binheap_node	*root;
+	struct vea_entry	*entry;
+	uint64_t		 off;
+	uint32_t		 half;
+
+	root = d_binheap_root(&vfc->vfc_heap);
+	if (root == NULL)
+		return 0;
+
+	entry = container_of(root, struct vea_entry, ve_node);
+	if (entry->ve_ext.vfe_blk_cnt < blk_cnt)
+		return 0;
+
+	off = entry->ve_ext.vfe_blk_off;
+	if (entry->ve_ext.vfe_age == VEA_EXT_AGE_MAX &&
+	    entry->ve_ext.vfe_blk_cnt > (uint64_t)vfc->vfc_large_thresh * 2) {
+		half = entry->ve_ext.vfe_blk_cnt / 2;
+		if (entry->ve_ext.vfe_blk_cnt - half >= blk_cnt)
+			off += half;
+	}
+
+	return reserve_ext(vsi, entry, off, blk_cnt, resrvd);
+}
+
+/*
+ * First fit search in the size classed LRUs, larger size class is searched
+ * first, and older free extent is preferred in each size class.
+ */
+static int
+reserve_small(struct vea_space_info *vsi, uint32_t blk_cnt,
+	      struct vea_resrvd_ext *resrvd)
+{
+	struct vea_free_class	*vfc = &vsi->vsi_class;
+	struct vea_entry	*entry;
+	int			 i;
+
+	for (i = 0; i < vfc->vfc_lru_cnt; i++) {
+		if (vfc->vfc_sizes[i] < blk_cnt)
+			break;
+
+		d_list_for_each_entry(entry, &vfc->vfc_lrus[i], ve_link) {
+			if (entry->ve_ext.vfe_blk_cnt < blk_cnt)
+				continue;
+			return reserve_ext(vsi, entry, entry->ve_ext.vfe_blk_off,
+					   blk_cnt, resrvd);
+		}
+	}
+	return 0;
+}
+
+/*
+ * Reserve a contiguous extent from the compound index, zero is returned
+ * with resrvd->vre_blk_cnt being zero when no free extent is large enough.
+ */
+int
+reserve_single(struct vea_space_info *vsi, uint32_t blk_cnt,
+	       struct vea_resrvd_ext *resrvd)
+{
+	int	rc;
+
+	resrvd->vre_blk_cnt = 0;
+
+	rc = reserve_hint(vsi, blk_cnt, resrvd);
+	if (rc || resrvd->vre_blk_cnt != 0)
+		return rc;
+
+	rc = reserve_large(vsi, blk_cnt, resrvd);
+	if (rc || resrvd->vre_blk_cnt != 0)
+		return rc;
+
+	return reserve_small(vsi, blk_cnt, resrvd);
+}
+
+/* Remove an allocated extent from the persistent free extent tree */
+int
+persistent_alloc(struct vea_space_info *vsi, struct vea_free_extent *vfe)
+{
+	struct vea_space_df	*md = vsi->vsi_md;
+	struct vea_free_extent	*found, tail;
+	uint64_t		 found_off, end;
+	int			 frags = 0;
+	int			 rc;
+
+	rc = fetch_free_entry(vsi, vfe->vfe_blk_off, BTR_PROBE_LE,
+			      VEA_TYPE_PERSIST, &found);
+	if (rc && rc != -DER_NONEXIST)
+		return rc;
+
+	if (rc == -DER_NONEXIST ||
+	    found->vfe_blk_off + found->vfe_blk_cnt <
+	    vfe->vfe_blk_off + vfe->vfe_blk_cnt) {
+		D_ERROR("Extent ["DF_U64", %u] isn't free\n",
+			vfe->vfe_blk_off, vfe->vfe_blk_cnt);
+		return -DER_INVAL;
+	}
+
+	found_off = found->vfe_blk_off;
+	end = found->vfe_blk_off + found->vfe_blk_cnt;
+	tail.vfe_age = found->vfe_age;
+
+	if (found_off == vfe->vfe_blk_off) {
+		rc = delete_free_entry(vsi, found, VEA_TYPE_PERSIST);
+		if (rc)
+			return rc;
+		frags--;
+	} else {
+		umem_tx_add_ptr(vsi->vsi_umem, found, sizeof(*found));
+		found->vfe_blk_cnt = vfe->vfe_blk_off - found_off;
+	}
+
+	if (vfe->vfe_blk_off + vfe->vfe_blk_cnt < end) {
+		tail.vfe_blk_off = vfe->vfe_blk_off + vfe->vfe_blk_cnt;
+		tail.vfe_blk_cnt = end - tail.vfe_blk_off;
+		tail.vfe_flags = 0;
+		rc = insert_free_entry(vsi, &tail, VEA_TYPE_PERSIST);
+		if (rc)
+			return rc;
+		frags++;
+	}
+
+	if (frags != 0) {
+		umem_tx_add_ptr(vsi->vsi_umem, &md->vsd_free_frags,
+				sizeof(md->vsd_free_frags));
+		md->vsd_free_frags += frags;
+	}
+	return 0;
+}
@@ -20,9 +20,9 @@
  * Any reproduction of computer software, computer software documentation, or
  * portions thereof marked with this legend must also reproduce the markings.
  */
+#define D_LOGFAC	DD_FAC(vos)
 
-#define DDSUBSYS	DDFAC(vos)
-
+#include <daos/common.h>
 #include <daos_srv/vea.h>
 #include "vea_internal.h"
 
@@ -35,7 +35,112 @@ int vea_format(struct umem_instance *umem, struct vea_space_df *md,
 	       uint64_t capacity, vea_format_callback_t cb, void *cb_data,
 	       bool force)
 {
-	return 0;
+	struct vea_free_extent	 vfe;
+	struct umem_attr	 uma;
+	daos_handle_t		 free_btr;
+	daos_iov_t		 key, val;
+	uint64_t		 tot_blks, off;
+	int			 rc;
+
+	D_ASSERT(umem != NULL && md != NULL);
+
+	blk_sz = blk_sz ? : VEA_BLK_SZ;
+	if (blk_sz % VEA_BLK_SZ != 0 || hdr_blks == 0) {
+		D_ERROR("Invalid blk_sz %u or hdr_blks %u\n", blk_sz,
+			hdr_blks);
+		return -DER_INVAL;
+	}
+
+	tot_blks = capacity / blk_sz;
+	if (tot_blks <= hdr_blks) {
+		D_ERROR("Capacity "DF_U64" is too small\n", capacity);
+		return -DER_INVAL;
+	}
+
+	if (md->vsd_magic == VEA_MAGIC && !force) {
+		D_ERROR("Device "DF_U64" is already formatted\n",
+			md->vsd_dev_id);
+		return -DER_EXIST;
+	}
+
+	rc = vea_register_classes();
+	if (rc)
+		return rc;
+
+	/* Initialize the block device header */
+	if (cb != NULL) {
+		rc = cb(cb_data);
+		if (rc)
+			return rc;
+	}
+
+	umem_attr_get(umem, &uma);
+
+	rc = umem_tx_begin(umem);
+	if (rc)
+		return rc;
+
+	umem_tx_add_ptr(umem, md, sizeof(*md));
+
+	/* Destroy the free extent tree left by previous format */
+	if (md->vsd_magic == VEA_MAGIC) {
+		rc = dbtree_open_inplace(&md->vsd_free_tree, &uma, &free_btr);
+		if (rc == 0)
+			rc = dbtree_destroy(free_btr);
+		if (rc)
+			D_GOTO(out, rc);
+	}
+
+	memset(md, 0, sizeof(*md));
+	md->vsd_blk_sz = blk_sz;
+	md->vsd_dev_id = dev_id;
+	md->vsd_tot_blks = tot_blks;
+	md->vsd_hdr_blks = hdr_blks;
+
+	rc = dbtree_create_inplace(DBTREE_CLASS_VEA, BTR_FEAT_UINT_KEY,
+				   VEA_TREE_ODR, &uma, &md->vsd_free_tree,
+				   &free_btr);
+	if (rc)
+		D_GOTO(out, rc);
+
+	/* The whole device except header is a non-active free extent */
+	for (off = hdr_blks; off < tot_blks; off += vfe.vfe_blk_cnt) {
+		vfe.vfe_blk_off = off;
+		vfe.vfe_blk_cnt = min(tot_blks - off, UINT32_MAX);
+		vfe.vfe_flags = 0;
+		vfe.vfe_age = VEA_EXT_AGE_MAX;
+
+		daos_iov_set(&key, &vfe.vfe_blk_off, sizeof(vfe.vfe_blk_off));
+		daos_iov_set(&val, &vfe, sizeof(vfe));
+		rc = dbtree_update(free_btr, &key, &val);
+		if (rc)
+			break;
+		md->vsd_free_frags++;
+	}
+	dbtree_close(free_btr);
+	if (rc)
+		D_GOTO(out, rc);
+
+	/* Non-contiguous allocation isn't supported, vsd_vec_tree stays empty */
+	md->vsd_magic = VEA_MAGIC;
+out:
+	if (rc)
+		umem_tx_abort(umem, rc);
+	else
+		rc = umem_tx_commit(umem);
+	return rc;
+}
+
+static int
+load_free_ext(daos_handle_t ih, daos_iov_t *key, daos_iov_t *val, void *arg)
+{
+	struct vea_space_info	*vsi = arg;
+	struct vea_free_extent	 vfe;
+
+	D_ASSERT(val->iov_len == sizeof(vfe));
+	memcpy(&vfe, val->iov_buf, sizeof(vfe));
+
+	return insert_free_entry(vsi, &vfe, VEA_TYPE_COMPOUND);
 }
 
 /*
@@ -46,12 +151,87 @@ int vea_load(struct umem_instance *umem, struct vea_space_df *md,
 	     struct vea_unmap_context *unmap_ctxt,
 	     struct vea_space_info **vsip)
 {
+	struct vea_space_info	*vsi;
+	struct umem_attr	 uma;
+	int			 rc;
+
+	D_ASSERT(umem != NULL && md != NULL && vsip != NULL);
+	if (md->vsd_magic != VEA_MAGIC) {
+		D_ERROR("Device isn't formatted, magic %x\n", md->vsd_magic);
+		return -DER_UNINIT;
+	}
+
+	rc = vea_register_classes();
+	if (rc)
+		return rc;
+
+	D_ALLOC_PTR(vsi);
+	if (vsi == NULL)
+		return -DER_NOMEM;
+
+	vsi->vsi_umem = umem;
+	vsi->vsi_md = md;
+	vsi->vsi_md_free_btr = DAOS_HDL_INVAL;
+	vsi->vsi_md_vec_btr = DAOS_HDL_INVAL;
+	vsi->vsi_free_btr = DAOS_HDL_INVAL;
+	vsi->vsi_vec_btr = DAOS_HDL_INVAL;
+	vsi->vsi_agg_btr = DAOS_HDL_INVAL;
+	D_INIT_LIST_HEAD(&vsi->vsi_agg_lru);
+	vsi->vsi_agg_time = vea_get_age();
+	if (unmap_ctxt != NULL)
+		vsi->vsi_unmap_ctxt = *unmap_ctxt;
+
+	rc = free_class_init(&vsi->vsi_class, md->vsd_blk_sz);
+	if (rc)
+		D_GOTO(error, rc);
+
+	umem_attr_get(umem, &uma);
+	rc = dbtree_open_inplace(&md->vsd_free_tree, &uma,
+				 &vsi->vsi_md_free_btr);
+	if (rc)
+		D_GOTO(error, rc);
+
+	memset(&uma, 0, sizeof(uma));
+	uma.uma_id = UMEM_CLASS_VMEM;
+
+	rc = dbtree_create_inplace(DBTREE_CLASS_VEA, BTR_FEAT_UINT_KEY,
+				   VEA_TREE_ODR, &uma, &vsi->vsi_free_root,
+				   &vsi->vsi_free_btr);
+	if (rc)
+		D_GOTO(error, rc);
+
+	rc = dbtree_create_inplace(DBTREE_CLASS_VEA, BTR_FEAT_UINT_KEY,
+				   VEA_TREE_ODR, &uma, &vsi->vsi_agg_root,
+				   &vsi->vsi_agg_btr);
+	if (rc)
+		D_GOTO(error, rc);
+
+	rc = dbtree_iterate(vsi->vsi_md_free_btr, false, load_free_ext, vsi);
+	if (rc)
+		D_GOTO(error, rc);
+
+	*vsip = vsi;
 	return 0;
+error:
+	vea_unload(vsi);
+	return rc;
 }
 
 /* Free the memory footprint created by vea_load(). */
 void vea_unload(struct vea_space_info *vsi)
 {
+	D_ASSERT(vsi != NULL);
+
+	/* Records in the in-memory trees are freed along with the trees */
+	if (!daos_handle_is_inval(vsi->vsi_free_btr))
+		dbtree_destroy(vsi->vsi_free_btr);
+	if (!daos_handle_is_inval(vsi->vsi_agg_btr))
+		dbtree_destroy(vsi->vsi_agg_btr);
+	if (!daos_handle_is_inval(vsi->vsi_md_free_btr))
+		dbtree_close(vsi->vsi_md_free_btr);
+
+	free_class_fini(&vsi->vsi_class);
+	D_FREE_PTR(vsi);
 }
 
 /*
@@ -72,11 +252,52 @@ void vea_unload(struct vea_space_info *vsi)
  *    policy, larger & older free extent has priority. (vfc_lrus)
  * 4. Repeat the search in 3rd step to reserve an extent vector. (vsi_vec_tree)
  * 5. Fail reserve with ENOMEM if all above attempts fail.
+ *
+ * Extent vector isn't supported yet, so the 4th step is replaced by migrating
+ * all the just recent freed extents to the compound index and retrying the
+ * contiguous reserve, -DER_NOSPACE is returned if it still fails.
  */
 int vea_reserve(struct vea_space_info *vsi, uint32_t blk_cnt,
 		struct vea_hint_context *hint,
 		d_list_t *resrvd_list)
 {
+	struct vea_resrvd_ext	*resrvd;
+	int			 rc;
+
+	D_ASSERT(vsi != NULL && resrvd_list != NULL);
+	if (blk_cnt == 0)
+		return -DER_INVAL;
+
+	D_ALLOC_PTR(resrvd);
+	if (resrvd == NULL)
+		return -DER_NOMEM;
+
+	D_INIT_LIST_HEAD(&resrvd->vre_link);
+	resrvd->vre_hint_off = hint != NULL ? hint->vhc_off : 0;
+
+	/* Make the expired recent frees visible for allocation */
+	migrate_free_exts(vsi, false);
+
+	rc = reserve_single(vsi, blk_cnt, resrvd);
+	if (rc == 0 && resrvd->vre_blk_cnt == 0 &&
+	    !d_list_empty(&vsi->vsi_agg_lru)) {
+		migrate_free_exts(vsi, true);
+		rc = reserve_single(vsi, blk_cnt, resrvd);
+	}
+
+	if (rc == 0 && resrvd->vre_blk_cnt == 0)
+		rc = -DER_NOSPACE;
+	if (rc) {
+		D_FREE_PTR(resrvd);
+		return rc;
+	}
+
+	vsi->vsi_tot_resrvd += resrvd->vre_blk_cnt;
+	if (hint != NULL) {
+		hint->vhc_off = resrvd->vre_blk_off + resrvd->vre_blk_cnt;
+		resrvd->vre_hint_seq = ++hint->vhc_seq;
+	}
+	d_list_add_tail(&resrvd->vre_link, resrvd_list);
 	return 0;
 }
 
@@ -84,16 +305,87 @@ int vea_reserve(struct vea_space_info *vsi, uint32_t blk_cnt,
 int vea_cancel(struct vea_space_info *vsi, struct vea_hint_context *hint,
 	       d_list_t *resrvd_list)
 {
-	return 0;
+	struct vea_resrvd_ext	*resrvd;
+	struct vea_free_extent	 vfe;
+	int			 rc = 0;
+
+	D_ASSERT(vsi != NULL && resrvd_list != NULL);
+
+	/* Cancel in reverse order to rewind the hint step by step */
+	while (!d_list_empty(resrvd_list)) {
+		resrvd = d_list_entry(resrvd_list->prev, struct vea_resrvd_ext,
+				      vre_link);
+
+		vfe.vfe_blk_off = resrvd->vre_blk_off;
+		vfe.vfe_blk_cnt = resrvd->vre_blk_cnt;
+		vfe.vfe_flags = 0;
+		vfe.vfe_age = vea_get_age();
+
+		rc = compound_free(vsi, &vfe);
+		if (rc)
+			break;
+
+		D_ASSERT(vsi->vsi_tot_resrvd >= resrvd->vre_blk_cnt);
+		vsi->vsi_tot_resrvd -= resrvd->vre_blk_cnt;
+
+		if (hint != NULL && hint->vhc_seq == resrvd->vre_hint_seq) {
+			hint->vhc_off = resrvd->vre_hint_off;
+			hint->vhc_seq--;
+		}
+
+		d_list_del(&resrvd->vre_link);
+		D_FREE_PTR(resrvd);
+	}
+	return rc;
 }
 
 /*
  * Make the reservation persistent. It should be part of transaction
  * manipulated by caller.
+ *
+ * The reserved extents are released on success, on failure the caller
+ * is expected to abort the transaction and cancel the reservation.
  */
 int vea_tx_publish(struct vea_space_info *vsi, struct vea_hint_context *hint,
 		   d_list_t *resrvd_list)
 {
+	struct vea_space_df	*md;
+	struct vea_resrvd_ext	*resrvd, *tmp;
+	struct vea_free_extent	 vfe;
+	uint64_t		 tot_blks = 0;
+	int			 rc;
+
+	D_ASSERT(vsi != NULL && resrvd_list != NULL);
+	md = vsi->vsi_md;
+
+	d_list_for_each_entry(resrvd, resrvd_list, vre_link) {
+		vfe.vfe_blk_off = resrvd->vre_blk_off;
+		vfe.vfe_blk_cnt = resrvd->vre_blk_cnt;
+
+		rc = persistent_alloc(vsi, &vfe);
+		if (rc)
+			return rc;
+		tot_blks += resrvd->vre_blk_cnt;
+	}
+
+	umem_tx_add_ptr(vsi->vsi_umem, &md->vsd_tot_used,
+			sizeof(md->vsd_tot_used));
+	md->vsd_tot_used += tot_blks;
+
+	if (hint != NULL) {
+		umem_tx_add_ptr(vsi->vsi_umem, hint->vhc_pd,
+				sizeof(*hint->vhc_pd));
+		hint->vhc_pd->vhd_off = hint->vhc_off;
+		hint->vhc_pd->vhd_seq = hint->vhc_seq;
+	}
+
+	D_ASSERT(vsi->vsi_tot_resrvd >= tot_blks);
+	vsi->vsi_tot_resrvd -= tot_blks;
+
+	d_list_for_each_entry_safe(resrvd, tmp, resrvd_list, vre_link) {
+		d_list_del(&resrvd->vre_link);
+		D_FREE_PTR(resrvd);
+	}
 	return 0;
 }
 
@@ -111,29 +403,106 @@ int vea_tx_publish(struct vea_space_info *vsi, struct vea_hint_context *hint,
  */
 int vea_tx_free(struct vea_space_info *vsi, uint64_t blk_off, uint32_t blk_cnt)
 {
+	struct vea_space_df	*md;
+	struct vea_free_extent	 vfe;
+	int			 rc;
+
+	D_ASSERT(vsi != NULL);
+	md = vsi->vsi_md;
+
+	if (blk_cnt == 0 || blk_off < md->vsd_hdr_blks ||
+	    blk_off + blk_cnt > md->vsd_tot_blks) {
+		D_ERROR("Invalid extent ["DF_U64", %u]\n", blk_off, blk_cnt);
+		return -DER_INVAL;
+	}
+
+	vfe.vfe_blk_off = blk_off;
+	vfe.vfe_blk_cnt = blk_cnt;
+	vfe.vfe_flags = 0;
+	vfe.vfe_age = vea_get_age();
+
+	/* Double free is detected by overlapping with persistent free extent */
+	rc = persistent_free(vsi, &vfe);
+	if (rc)
+		return rc;
+
+	D_ASSERT(md->vsd_tot_used >= blk_cnt);
+	umem_tx_add_ptr(vsi->vsi_umem, &md->vsd_tot_used,
+			sizeof(md->vsd_tot_used));
+	md->vsd_tot_used -= blk_cnt;
+
+	rc = aggregated_free(vsi, &vfe);
+	if (rc)
+		return rc;
+
+	migrate_free_exts(vsi, false);
 	return 0;
 }
 
 /* Set an arbitrary age to a free extent with specified start offset. */
 int vea_set_ext_age(struct vea_space_info *vsi, uint64_t blk_off, uint64_t age)
 {
-	return 0;
+	struct vea_free_extent	*vfe;
+	struct vea_entry	*entry;
+	int			 rc;
+
+	D_ASSERT(vsi != NULL);
+
+	rc = fetch_free_entry(vsi, blk_off, BTR_PROBE_EQ, VEA_TYPE_COMPOUND,
+			      &vfe);
+	if (rc == -DER_NONEXIST)
+		return -DER_ENOENT;
+	else if (rc)
+		return rc;
+
+	/* Re-link the extent, so it becomes the youngest in the LRU */
+	entry = container_of(vfe, struct vea_entry, ve_ext);
+	free_class_remove(&vsi->vsi_class, entry);
+	vfe->vfe_age = age;
+	return free_class_add(&vsi->vsi_class, entry);
 }
 
 /* Convert an extent into an allocated extent vector. */
 int vea_get_ext_vector(struct vea_space_info *vsi, uint64_t blk_off,
 		       uint32_t blk_cnt, struct vea_ext_vector *ext_vector)
 {
+	D_ASSERT(vsi != NULL && ext_vector != NULL);
+
+	if (blk_cnt == 0 || blk_off < vsi->vsi_md->vsd_hdr_blks ||
+	    blk_off + blk_cnt > vsi->vsi_md->vsd_tot_blks)
+		return -DER_INVAL;
+
+	/*
+	 * Non-contiguous allocation isn't supported yet, every allocated
+	 * extent is a single element vector.
+	 */
+	memset(ext_vector, 0, sizeof(*ext_vector));
+	ext_vector->vev_blk_off[0] = blk_off;
+	ext_vector->vev_blk_cnt[0] = blk_cnt;
+	ext_vector->vev_size = 1;
 	return 0;
 }
 
 /* Load persistent hint data and initialize in-memory hint context */
 int vea_hint_load(struct vea_hint_df *phd, struct vea_hint_context **thc)
 {
+	struct vea_hint_context	*hint;
+
+	D_ASSERT(phd != NULL && thc != NULL);
+
+	D_ALLOC_PTR(hint);
+	if (hint == NULL)
+		return -DER_NOMEM;
+
+	hint->vhc_pd = phd;
+	hint->vhc_off = phd->vhd_off;
+	hint->vhc_seq = phd->vhd_seq;
+	*thc = hint;
 	return 0;
 }
 
 /* Free memory foot-print created by vea_hint_load() */
 void vea_hint_unload(struct vea_hint_context *thc)
 {
+	D_FREE_PTR(thc);
 }
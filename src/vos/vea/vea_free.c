@@ -0,0 +1,110 @@
+/**
+ * (C) Copyright 2018 Intel Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * GOVERNMENT LICENSE RIGHTS-OPEN SOURCE SOFTWARE
+ * The Government's rights to use, modify, reproduce, release, perform, display,
+ * or disclose this software are subject to the terms of the Apache License as
+ * provided in Contract No. B609815.
+ * Any reproduction of computer software, computer software documentation, or
+ * portions thereof marked with this legend must also reproduce the markings.
+ */
+#define D_LOGFAC	DD_FAC(vos)
+
+#include <daos/common.h>
+#include <daos_srv/vea.h>
+#include "vea_internal.h"
+
+/* Return a free extent to the allocation visible compound index */
+int
+compound_free(struct vea_space_info *vsi, struct vea_free_extent *vfe)
+{
+	return merge_free_ext(vsi, vfe, VEA_TYPE_COMPOUND);
+}
+
+/* Return a free extent to the persistent free extent tree */
+int
+persistent_free(struct vea_space_info *vsi, struct vea_free_extent *vfe)
+{
+	return merge_free_ext(vsi, vfe, VEA_TYPE_PERSIST);
+}
+
+/*
+ * Park a just recent freed extent in the aggregation index, where it's
+ * coalesced with other recent frees before becoming visible for allocation.
+ */
+int
+aggregated_free(struct vea_space_info *vsi, struct vea_free_extent *vfe)
+{
+	vfe->vfe_age = vea_get_age();
+	return merge_free_ext(vsi, vfe, VEA_TYPE_AGGREGATE);
+}
+
+/*
+ * Migrate the expired free extents in vsi_agg_lru to the compound index, all
+ * extents are migrated regardless of age when @force is true.
+ *
+ * The extent is only migrated when it's still free in the persistent tree,
+ * so an extent freed by an aborted transaction is never handed out again.
+ */
+void
+migrate_free_exts(struct vea_space_info *vsi, bool force)
+{
+	struct vea_unmap_context	*unmap_ctxt = &vsi->vsi_unmap_ctxt;
+	struct vea_entry		*entry, *tmp;
+	struct vea_free_extent		 vfe;
+	uint32_t			 blk_sz = vsi->vsi_md->vsd_blk_sz;
+	uint64_t			 now;
+	int				 rc;
+
+	now = vea_get_age();
+	if (!force && now < vsi->vsi_agg_time + VEA_MIGRATE_INTVL)
+		return;
+
+	d_list_for_each_entry_safe(entry, tmp, &vsi->vsi_agg_lru, ve_link) {
+		vfe = entry->ve_ext;
+		if (!force && vfe.vfe_age + VEA_MIGRATE_INTVL > now)
+			break;
+
+		rc = delete_free_entry(vsi, &entry->ve_ext,
+				       VEA_TYPE_AGGREGATE);
+		if (rc) {
+			D_ERROR("Remove ["DF_U64", %u] from aggregation index "
+				"failed. %d\n", vfe.vfe_blk_off,
+				vfe.vfe_blk_cnt, rc);
+			continue;
+		}
+
+		if (!ext_is_free(vsi, &vfe, VEA_TYPE_PERSIST)) {
+			D_ERROR("Drop non-free extent ["DF_U64", %u]\n",
+				vfe.vfe_blk_off, vfe.vfe_blk_cnt);
+			continue;
+		}
+
+		if (unmap_ctxt->vnc_unmap != NULL) {
+			rc = unmap_ctxt->vnc_unmap(vfe.vfe_blk_off * blk_sz,
+						   (uint64_t)vfe.vfe_blk_cnt *
+						   blk_sz, unmap_ctxt->vnc_data);
+			if (rc)
+				D_ERROR("Unmap ["DF_U64", %u] failed. %d\n",
+					vfe.vfe_blk_off, vfe.vfe_blk_cnt, rc);
+		}
+
+		rc = compound_free(vsi, &vfe);
+		if (rc)
+			D_ERROR("Migrate ["DF_U64", %u] failed. %d\n",
+				vfe.vfe_blk_off, vfe.vfe_blk_cnt, rc);
+	}
+	vsi->vsi_agg_time = now;
+}
@@ -24,6 +24,7 @@
 #ifndef __VEA_INTERNAL_H__
 #define __VEA_INTERNAL_H__
 
+#include <time.h>
 #include <gurt/list.h>
 #include <gurt/heap.h>
 #include <daos/mem.h>
@@ -31,6 +32,29 @@
 
 #define VEA_MAGIC	(0xea201804)
 
+/* Btree class & order for both persistent & in-memory free extent trees */
+#define DBTREE_CLASS_VEA	(DBTREE_VOS_BEGIN + 9)
+#define VEA_TREE_ODR		20
+
+/* Default block size */
+#define VEA_BLK_SZ		(4 * 1024)
+
+/* Free extent type, indicating which index an extent is tracked in */
+enum vea_free_type {
+	/* Persistent free extent tree on SCM */
+	VEA_TYPE_PERSIST,
+	/* Allocation visible in-memory compound index */
+	VEA_TYPE_COMPOUND,
+	/* Just recent freed extents, not visible for allocation yet */
+	VEA_TYPE_AGGREGATE,
+};
+
+/*
+ * Minimum interval (in seconds) for the just recent freed extents staying
+ * in vsi_agg_lru before being migrated to the compound index.
+ */
+#define VEA_MIGRATE_INTVL	10
+
 /* Per I/O stream hint context */
 struct vea_hint_context {
 	struct vea_hint_df	*vhc_pd;
@@ -87,6 +111,8 @@ struct vea_space_info {
 	daos_handle_t		 vsi_md_vec_btr;
 	/* Free extent tree sorted by offset, for all free extents. */
 	daos_handle_t		 vsi_free_btr;
+	/* In-memory root of vsi_free_btr */
+	struct btr_root		 vsi_free_root;
 	/* Extent vector tree, for non-contiguous allocation */
 	daos_handle_t		 vsi_vec_btr;
 	/* Reserved blocks in total */
@@ -100,10 +126,51 @@ struct vea_space_info {
 	 * free extents.
 	 */
 	daos_handle_t		 vsi_agg_btr;
+	/* In-memory root of vsi_agg_btr */
+	struct btr_root		 vsi_agg_root;
 	/* Last aggregation time */
 	uint64_t		 vsi_agg_time;
 	/* Unmap context to performe unmap against freed extent */
 	struct vea_unmap_context	vsi_unmap_ctxt;
 };
 
+static inline uint64_t
+vea_get_age(void)
+{
+	struct timespec	now;
+
+	clock_gettime(CLOCK_MONOTONIC_COARSE, &now);
+	/* Never return VEA_EXT_AGE_MAX for an active extent */
+	return now.tv_sec + 1;
+}
+
+/* vea_util.c */
+int vea_register_classes(void);
+int free_class_add(struct vea_free_class *vfc, struct vea_entry *entry);
+void free_class_remove(struct vea_free_class *vfc, struct vea_entry *entry);
+int free_class_init(struct vea_free_class *vfc, uint32_t blk_sz);
+void free_class_fini(struct vea_free_class *vfc);
+int insert_free_entry(struct vea_space_info *vsi, struct vea_free_extent *vfe,
+		      unsigned int type);
+int delete_free_entry(struct vea_space_info *vsi, struct vea_free_extent *vfe,
+		      unsigned int type);
+int fetch_free_entry(struct vea_space_info *vsi, uint64_t off,
+		     dbtree_probe_opc_t opc, unsigned int type,
+		     struct vea_free_extent **vfe);
+int merge_free_ext(struct vea_space_info *vsi, struct vea_free_extent *ext_in,
+		   unsigned int type);
+bool ext_is_free(struct vea_space_info *vsi, struct vea_free_extent *vfe,
+		 unsigned int type);
+
+/* vea_alloc.c */
+int reserve_single(struct vea_space_info *vsi, uint32_t blk_cnt,
+		   struct vea_resrvd_ext *resrvd);
+int persistent_alloc(struct vea_space_info *vsi, struct vea_free_extent *vfe);
+
+/* vea_free.c */
+int compound_free(struct vea_space_info *vsi, struct vea_free_extent *vfe);
+int persistent_free(struct vea_space_info *vsi, struct vea_free_extent *vfe);
+int aggregated_free(struct vea_space_info *vsi, struct vea_free_extent *vfe);
+void migrate_free_exts(struct vea_space_info *vsi, bool force);
+
 #endif /* __VEA_INTERNAL_H__ */
@@ -0,0 +1,477 @@
+/**
+ * (C) Copyright 2018 Intel Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * GOVERNMENT LICENSE RIGHTS-OPEN SOURCE SOFTWARE
+ * The Government's rights to use, modify, reproduce, release, perform, display,
+ * or disclose this software are subject to the terms of the Apache License as
+ * provided in Contract No. B609815.
+ * Any reproduction of computer software, computer software documentation, or
+ * portions thereof marked with this legend must also reproduce the markings.
+ */
+#define D_LOGFAC	DD_FAC(vos)
+
+#include <daos/common.h>
+#include <daos_srv/vea.h>
+#include "vea_internal.h"
+
+/*
+ * Both the persistent free extent tree and the in-memory free extent trees
+ * are keyed by the start block offset, the record body is a vea_free_extent
+ * for persistent tree, and a vea_entry (which embeds the vea_free_extent as
+ * the first member) for the in-memory trees.
+ */
+static int
+vea_rec_alloc(struct btr_instance *tins, daos_iov_t *key, daos_iov_t *val,
+	      struct btr_record *rec)
+{
+	struct vea_free_extent	*vfe;
+	umem_id_t		 rid;
+	size_t			 size;
+
+	if (key->iov_len != sizeof(uint64_t) ||
+	    val->iov_len != sizeof(struct vea_free_extent))
+		return -DER_INVAL;
+
+	vfe = (struct vea_free_extent *)val->iov_buf;
+	D_ASSERT(vfe->vfe_blk_off == *(uint64_t *)key->iov_buf);
+
+	if (tins->ti_umm.umm_id == UMEM_CLASS_VMEM)
+		size = sizeof(struct vea_entry);
+	else
+		size = sizeof(struct vea_free_extent);
+
+	rid = umem_zalloc(&tins->ti_umm, size);
+	if (UMMID_IS_NULL(rid))
+		return -DER_NOMEM;
+
+	memcpy(umem_id2ptr(&tins->ti_umm, rid), vfe, sizeof(*vfe));
+	if (tins->ti_umm.umm_id == UMEM_CLASS_VMEM) {
+		struct vea_entry *entry = umem_id2ptr(&tins->ti_umm, rid);
+
+		D_INIT_LIST_HEAD(&entry->ve_link);
+	}
+
+	rec->rec_mmid = rid;
+	return 0;
+}
+
+static int
+vea_rec_free(struct btr_instance *tins, struct btr_record *rec, void *args)
+{
+	umem_free(&tins->ti_umm, rec->rec_mmid);
+	return 0;
+}
+
+static int
+vea_rec_fetch(struct btr_instance *tins, struct btr_record *rec,
+	      daos_iov_t *key, daos_iov_t *val)
+{
+	struct vea_free_extent *vfe = umem_id2ptr(&tins->ti_umm, rec->rec_mmid);
+
+	if (key != NULL) {
+		if (key->iov_buf == NULL)
+			key->iov_buf = &vfe->vfe_blk_off;
+		else if (key->iov_buf_len >= sizeof(vfe->vfe_blk_off))
+			memcpy(key->iov_buf, &vfe->vfe_blk_off,
+			       sizeof(vfe->vfe_blk_off));
+		key->iov_len = sizeof(vfe->vfe_blk_off);
+	}
+	if (val != NULL) {
+		if (val->iov_buf == NULL)
+			val->iov_buf = vfe;
+		else if (val->iov_buf_len >= sizeof(*vfe))
+			memcpy(val->iov_buf, vfe, sizeof(*vfe));
+		val->iov_len = sizeof(*vfe);
+	}
+	return 0;
+}
+
+static int
+vea_rec_update(struct btr_instance *tins, struct btr_record *rec,
+	       daos_iov_t *key, daos_iov_t *val)
+{
+	struct vea_free_extent *vfe = umem_id2ptr(&tins->ti_umm, rec->rec_mmid);
+
+	if (val->iov_len != sizeof(*vfe))
+		return -DER_INVAL;
+
+	umem_tx_add_ptr(&tins->ti_umm, vfe, sizeof(*vfe));
+	memcpy(vfe, val->iov_buf, sizeof(*vfe));
+	return 0;
+}
+
+static char *
+vea_rec_string(struct btr_instance *tins, struct btr_record *rec, bool leaf,
+	       char *buf, int buf_len)
+{
+	struct vea_free_extent	*vfe;
+	uint64_t		 off;
+
+	if (!leaf) {
+		memcpy(&off, rec->rec_hkey, sizeof(off));
+		snprintf(buf, buf_len, DF_U64, off);
+		return buf;
+	}
+
+	vfe = umem_id2ptr(&tins->ti_umm, rec->rec_mmid);
+	snprintf(buf, buf_len, "["DF_U64", %u] age:"DF_U64,
+		 vfe->vfe_blk_off, vfe->vfe_blk_cnt, vfe->vfe_age);
+	return buf;
+}
+
+static btr_ops_t vea_btr_ops = {
+	.to_rec_alloc	= vea_rec_alloc,
+	.to_rec_free	= vea_rec_free,
+	.to_rec_fetch	= vea_rec_fetch,
+	.to_rec_update	= vea_rec_update,
+	.to_rec_string	= vea_rec_string,
+};
+
+int
+vea_register_classes(void)
+{
+	int	rc;
+
+	rc = dbtree_class_register(DBTREE_CLASS_VEA, BTR_FEAT_UINT_KEY,
+				   &vea_btr_ops);
+	if (rc == -DER_EXIST)
+		rc = 0;
+	if (rc)
+		D_ERROR("Register VEA tree class failed. %d\n", rc);
+	return rc;
+}
+
+/* Max heap, the largest free extent is on top */
+static bool
+heap_node_cmp(struct d_binheap_node *a, struct d_binheap_node *b)
+{
+	struct vea_entry *nodea, *nodeb;
+
+	nodea = container_of(a, struct vea_entry, ve_node);
+	nodeb = container_of(b, struct vea_entry, ve_node);
+
+	return nodea->ve_ext.vfe_blk_cnt > nodeb->ve_ext.vfe_blk_cnt;
+}
+
+static struct d_binheap_ops vea_heap_ops = {
+	.hop_enter	= NULL,
+	.hop_exit	= NULL,
+	.hop_compare	= heap_node_cmp,
+};
+
+int
+free_class_init(struct vea_free_class *vfc, uint32_t blk_sz)
+{
+	uint32_t	thresh, lru_cnt;
+	int		i, rc;
+
+	thresh = ((uint64_t)VEA_LARGE_EXT_MB << 20) / blk_sz;
+	if (thresh < 2)
+		return -DER_INVAL;
+
+	/* One size class for each power of two below the large threshold */
+	for (lru_cnt = 1; (thresh >> lru_cnt) != 0; lru_cnt++)
+		;
+
+	D_ALLOC(vfc->vfc_lrus, sizeof(d_list_t) * lru_cnt);
+	if (vfc->vfc_lrus == NULL)
+		return -DER_NOMEM;
+
+	D_ALLOC(vfc->vfc_sizes, sizeof(uint32_t) * (lru_cnt + 1));
+	if (vfc->vfc_sizes == NULL) {
+		D_FREE(vfc->vfc_lrus);
+		return -DER_NOMEM;
+	}
+
+	for (i = 0; i < lru_cnt; i++) {
+		D_INIT_LIST_HEAD(&vfc->vfc_lrus[i]);
+		vfc->vfc_sizes[i] = i == 0 ? thresh - 1 : thresh >> i;
+	}
+	vfc->vfc_sizes[lru_cnt] = 0;
+	vfc->vfc_lru_cnt = lru_cnt;
+	vfc->vfc_large_thresh = thresh;
+
+	rc = d_binheap_create_inplace(DBH_FT_NOLOCK, 0, NULL, &vea_heap_ops,
+				      &vfc->vfc_heap);
+	if (rc) {
+		D_FREE(vfc->vfc_sizes);
+		D_FREE(vfc->vfc_lrus);
+		vfc->vfc_lru_cnt = 0;
+	}
+	return rc;
+}
+
+void
+free_class_fini(struct vea_free_class *vfc)
+{
+	if (vfc->vfc_lrus == NULL)
+		return;
+
+	d_binheap_destroy_inplace(&vfc->vfc_heap);
+	D_FREE(vfc->vfc_sizes);
+	D_FREE(vfc->vfc_lrus);
+	vfc->vfc_lru_cnt = 0;
+}
+
+static int
+free_class_idx(struct vea_free_class *vfc, uint32_t blk_cnt)
+{
+	int	i;
+
+	D_ASSERT(blk_cnt > 0 && blk_cnt <= vfc->vfc_sizes[0]);
+	for (i = 0; i < vfc->vfc_lru_cnt; i++) {
+		if (blk_cnt > vfc->vfc_sizes[i + 1])
+			break;
+	}
+	D_ASSERT(i < vfc->vfc_lru_cnt);
+	return i;
+}
+
+int
+free_class_add(struct vea_free_class *vfc, struct vea_entry *entry)
+{
+	int	rc;
+
+	D_ASSERT(!entry->ve_in_heap && d_list_empty(&entry->ve_link));
+
+	if (entry->ve_ext.vfe_blk_cnt >= vfc->vfc_large_thresh) {
+		rc = d_binheap_insert(&vfc->vfc_heap, &entry->ve_node);
+		if (rc)
+			return rc;
+		entry->ve_in_heap = 1;
+		return 0;
+	}
+
+	/* Append to LRU tail, the LRU head is the oldest free extent */
+	d_list_add_tail(&entry->ve_link,
+			&vfc->vfc_lrus[free_class_idx(vfc,
+					entry->ve_ext.vfe_blk_cnt)]);
+	return 0;
+}
+
+void
+free_class_remove(struct vea_free_class *vfc, struct vea_entry *entry)
+{
+	if (entry->ve_in_heap) {
+		d_binheap_remove(&vfc->vfc_heap, &entry->ve_node);
+		entry->ve_in_heap = 0;
+	} else {
+		d_list_del_init(&entry->ve_link);
+	}
+}
+
+static daos_handle_t
+free_type2hdl(struct vea_space_info *vsi, unsigned int type)
+{
+	switch (type) {
+	default:
+		D_ASSERTF(0, "Invalid free type %u\n", type);
+	case VEA_TYPE_PERSIST:
+		return vsi->vsi_md_free_btr;
+	case VEA_TYPE_COMPOUND:
+		return vsi->vsi_free_btr;
+	case VEA_TYPE_AGGREGATE:
+		return vsi->vsi_agg_btr;
+	}
+}
+
+static int
+free_entry_link(struct vea_space_info *vsi, struct vea_free_extent *vfe,
+		unsigned int type)
+{
+	struct vea_entry *entry = container_of(vfe, struct vea_entry, ve_ext);
+
+	switch (type) {
+	default:
+		return 0;
+	case VEA_TYPE_COMPOUND:
+		return free_class_add(&vsi->vsi_class, entry);
+	case VEA_TYPE_AGGREGATE:
+		d_list_add_tail(&entry->ve_link, &vsi->vsi_agg_lru);
+		return 0;
+	}
+}
+
+static void
+free_entry_unlink(struct vea_space_info *vsi, struct vea_free_extent *vfe,
+		  unsigned int type)
+{
+	struct vea_entry *entry = container_of(vfe, struct vea_entry, ve_ext);
+
+	switch (type) {
+	default:
+		break;
+	case VEA_TYPE_COMPOUND:
+		free_class_remove(&vsi->vsi_class, entry);
+		break;
+	case VEA_TYPE_AGGREGATE:
+		d_list_del_init(&entry->ve_link);
+		break;
+	}
+}
+
+/* Insert a free extent without coalescing */
+int
+insert_free_entry(struct vea_space_info *vsi, struct vea_free_extent *vfe,
+		  unsigned int type)
+{
+	daos_handle_t	 btr_hdl = free_type2hdl(vsi, type);
+	daos_iov_t	 key, val;
+	uint64_t	 off = vfe->vfe_blk_off;
+	int		 rc;
+
+	daos_iov_set(&key, &off, sizeof(off));
+	daos_iov_set(&val, vfe, sizeof(*vfe));
+	rc = dbtree_update(btr_hdl, &key, &val);
+	if (rc || type == VEA_TYPE_PERSIST)
+		return rc;
+
+	daos_iov_set(&val, NULL, 0);
+	rc = dbtree_lookup(btr_hdl, &key, &val);
+	if (rc)
+		return rc;
+
+	return free_entry_link(vsi, (struct vea_free_extent *)val.iov_buf,
+			       type);
+}
+
+/* Remove a free extent from the tree, the extent is freed on return */
+int
+delete_free_entry(struct vea_space_info *vsi, struct vea_free_extent *vfe,
+		  unsigned int type)
+{
+	daos_iov_t	 key;
+	uint64_t	 off = vfe->vfe_blk_off;
+
+	free_entry_unlink(vsi, vfe, type);
+	daos_iov_set(&key, &off, sizeof(off));
+	return dbtree_delete(free_type2hdl(vsi, type), &key, NULL);
+}
+
+/* Fetch the free extent at, before (BTR_PROBE_LE) or after (BTR_PROBE_GE) */
+int
+fetch_free_entry(struct vea_space_info *vsi, uint64_t off,
+		 dbtree_probe_opc_t opc, unsigned int type,
+		 struct vea_free_extent **vfe)
+{
+	daos_iov_t	 key, val;
+	int		 rc;
+
+	daos_iov_set(&key, &off, sizeof(off));
+	daos_iov_set(&val, NULL, 0);
+	rc = dbtree_fetch(free_type2hdl(vsi, type), opc, &key, NULL, &val);
+	if (rc == 0)
+		*vfe = (struct vea_free_extent *)val.iov_buf;
+	return rc;
+}
+
+static inline uint64_t
+ext_end(struct vea_free_extent *vfe)
+{
+	return vfe->vfe_blk_off + vfe->vfe_blk_cnt;
+}
+
+/*
+ * Insert a free extent into the index specified by @type, coalesce it with
+ * the adjacent free extents when possible. Overlapping with any existing
+ * free extent is treated as a double free.
+ */
+int
+merge_free_ext(struct vea_space_info *vsi, struct vea_free_extent *ext_in,
+	       unsigned int type)
+{
+	struct vea_free_extent	*prev = NULL, *next = NULL, *vfe;
+	struct vea_free_extent	 merged = *ext_in;
+	int			 frags = 1;
+	int			 rc;
+
+	D_ASSERT(merged.vfe_blk_cnt > 0);
+
+	rc = fetch_free_entry(vsi, merged.vfe_blk_off, BTR_PROBE_LE, type,
+			      &vfe);
+	if (rc == 0) {
+		if (ext_end(vfe) > merged.vfe_blk_off)
+			goto overlap;
+		if (ext_end(vfe) == merged.vfe_blk_off &&
+		    (uint64_t)vfe->vfe_blk_cnt + merged.vfe_blk_cnt <=
+		    UINT32_MAX)
+			prev = vfe;
+	} else if (rc != -DER_NONEXIST) {
+		return rc;
+	}
+
+	rc = fetch_free_entry(vsi, merged.vfe_blk_off, BTR_PROBE_GE, type,
+			      &vfe);
+	if (rc == 0) {
+		if (ext_end(&merged) > vfe->vfe_blk_off)
+			goto overlap;
+		if (ext_end(&merged) == vfe->vfe_blk_off &&
+		    (uint64_t)vfe->vfe_blk_cnt + merged.vfe_blk_cnt +
+		    (prev ? prev->vfe_blk_cnt : 0) <= UINT32_MAX)
+			next = vfe;
+	} else if (rc != -DER_NONEXIST) {
+		return rc;
+	}
+
+	if (next != NULL) {
+		merged.vfe_blk_cnt += next->vfe_blk_cnt;
+		rc = delete_free_entry(vsi, next, type);
+		if (rc)
+			return rc;
+		frags--;
+	}
+
+	if (prev != NULL) {
+		free_entry_unlink(vsi, prev, type);
+		if (type == VEA_TYPE_PERSIST)
+			umem_tx_add_ptr(vsi->vsi_umem, prev, sizeof(*prev));
+		prev->vfe_blk_cnt += merged.vfe_blk_cnt;
+		prev->vfe_age = merged.vfe_age;
+		rc = free_entry_link(vsi, prev, type);
+		frags--;
+	} else {
+		rc = insert_free_entry(vsi, &merged, type);
+	}
+
+	if (rc == 0 && type == VEA_TYPE_PERSIST && frags != 0) {
+		struct vea_space_df *md = vsi->vsi_md;
+
+		umem_tx_add_ptr(vsi->vsi_umem, &md->vsd_free_frags,
+				sizeof(md->vsd_free_frags));
+		md->vsd_free_frags += frags;
+	}
+	return rc;
+overlap:
+	D_ERROR("Extent ["DF_U64", %u] overlaps with free extent ["DF_U64
+		", %u], type:%u\n", ext_in->vfe_blk_off, ext_in->vfe_blk_cnt,
+		vfe->vfe_blk_off, vfe->vfe_blk_cnt, type);
+	return -DER_INVAL;
+}
+
+/* Check if the extent is entirely covered by a single free extent */
+bool
+ext_is_free(struct vea_space_info *vsi, struct vea_free_extent *vfe,
+	    unsigned int type)
+{
+	struct vea_free_extent	*found;
+	int			 rc;
+
+	rc = fetch_free_entry(vsi, vfe->vfe_blk_off, BTR_PROBE_LE, type,
+			      &found);
+	if (rc)
+		return false;
+
+	return ext_end(found) >= ext_end(vfe);
+}
@@ -182,6 +182,7 @@ vos_tls_fini(const struct dss_thread_local_storage *dtls,
 
 	vos_imem_strts_destroy(&tls->vtl_imems_inst);
 	D_FREE_PTR(tls);
+	evt_vis_cache_fini();
 }
 
 struct dss_module_key vos_module_key = {
@@ -206,6 +207,15 @@ vos_mod_init(void)
 		vos_mem_class = UMEM_CLASS_VMEM;
 	}
 
+	/* Records equal to or larger than this are stored on NVMe if the
+	 * pool has NVMe space, see vos_nvme.c.
+	 */
+	env = getenv("VOS_NVME_THRESH");
+	if (env != NULL) {
+		vos_nvme_thresh = strtoull(env, NULL, 10);
+		D_DEBUG(DB_IO, "NVMe threshold="DF_U64"\n", vos_nvme_thresh);
+	}
+
 	rc = vos_cont_tab_register();
 	if (rc) {
 		D_ERROR("VOS CI btree initialization error\n");
@@ -294,5 +304,6 @@ vos_fini(void)
 		vos_imem_strts_destroy(vsa_imems_inst);
 		D_FREE_PTR(vsa_imems_inst);
 	}
+	evt_vis_cache_fini();
 	D_MUTEX_UNLOCK(&mutex);
 }
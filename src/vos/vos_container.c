@@ -484,8 +484,9 @@ vos_cont_tab_create(struct umem_attr *p_umem_attr,
 	D_ASSERT(ctab_df->ctb_btree.tr_class == 0);
 	D_DEBUG(DB_DF, "Create container table, type=%d\n", VOS_BTR_CONT_TABLE);
 
-	rc = dbtree_create_inplace(VOS_BTR_CONT_TABLE, 0, CT_BTREE_ORDER,
-				   p_umem_attr, &ctab_df->ctb_btree, &btr_hdl);
+	rc = dbtree_create_inplace(VOS_BTR_CONT_TABLE, BTR_FEAT_KEY_ARRAY,
+				   CT_BTREE_ORDER, p_umem_attr,
+				   &ctab_df->ctb_btree, &btr_hdl);
 	if (rc) {
 		D_ERROR("DBtree create failed\n");
 		D_GOTO(exit, rc);
@@ -140,8 +140,12 @@ vos_cookie_tab_create(struct umem_attr *uma, struct vos_cookie_table *ctab,
 	D_ASSERT(ctab->cit_btr.tr_class == 0);
 	D_DEBUG(DB_MD, "Create cookie tree in-place :%d\n", VOS_BTR_COOKIE);
 
-	rc = dbtree_create_inplace(VOS_BTR_COOKIE, 0, COOKIE_BTREE_ORDER, uma,
-				   &ctab->cit_btr, cookie_handle);
+	/* cookies are looked up by every update, uuid hkeys are compared by
+	 * memcmp so they can be searched by the key array.
+	 */
+	rc = dbtree_create_inplace(VOS_BTR_COOKIE, BTR_FEAT_KEY_ARRAY,
+				   COOKIE_BTREE_ORDER, uma, &ctab->cit_btr,
+				   cookie_handle);
 	if (rc) {
 		D_ERROR("dbtree create failed: %d\n", rc);
 		D_GOTO(exit, rc);
@@ -74,6 +74,12 @@ struct vos_pool {
 	struct vos_cookie_table	vp_cookie_tab;
 	/** btr handle for the cookie table \a vp_cookie_tab */
 	daos_handle_t		vp_cookie_th;
+	/** NVMe blob for large records, NULL if the pool is SCM only */
+	struct vos_blob		*vp_blob;
+	/** in-memory free extent index of \a vp_blob */
+	struct vea_space_info	*vp_vea_info;
+	/** statistics of objects of this pool in the object cache */
+	struct vos_ocache_stat	vp_ocache_stat;
 };
 
 /**
@@ -272,6 +278,59 @@ int vos_csum_enabled(void);
  * compute checksum for a sgl using CRC64
  */
 int vos_csum_compute(daos_sg_list_t *sgl, daos_csum_buf_t *csum);
+
+/**
+ * Records (array extents) whose size is equal to or larger than this are
+ * stored on the NVMe blob of the pool if it has one, see vos_nvme.c.
+ */
+extern daos_size_t vos_nvme_thresh;
+
+/** Block size of the NVMe blob, VEA allocates space in this unit */
+#define VOS_NVME_BLK_SZ		(4UL << 10)
+
+/** evtree callbacks to free the NVMe extents of a VOS pool */
+extern struct evt_desc_cbs vos_evt_desc_cbs;
+
+/**
+ * Load the NVMe blob of the pool and its free space index, the blob is
+ * created and formatted on the first open. Nothing is done if the pool
+ * is SCM only, or the pool falls back to SCM only if there is no NVMe
+ * device for the current xstream.
+ */
+int vos_nvme_pool_open(struct vos_pool *pool, const char *path);
+
+/** Release the NVMe blob and free space index loaded by vos_nvme_pool_open */
+void vos_nvme_pool_close(struct vos_pool *pool);
+
+/** Delete the NVMe blob of a pool which is being destroyed */
+int vos_nvme_pool_destroy(const char *path);
+
+/** Allocate/free a buffer for NVMe I/O, \a size is rounded up to block */
+void *vos_nvme_buf_alloc(daos_size_t size);
+void vos_nvme_buf_free(void *buf);
+
+/**
+ * Read or write \a len bytes between \a buf and the NVMe blob of \a pool
+ * at block \a blk_off, \a buf should be allocated by vos_nvme_buf_alloc()
+ * and \a len is rounded up to block.
+ *
+ * NB: the calling ULT may yield, so it can't be called within a PMDK
+ * transaction.
+ */
+int vos_nvme_rw(struct vos_pool *pool, uint64_t blk_off, void *buf,
+		daos_size_t len, bool update);
+
+static inline bool
+vos_pool_has_nvme(struct vos_pool *pool)
+{
+	return pool->vp_vea_info != NULL;
+}
+
+static inline uint32_t
+vos_nvme_size2blks(daos_size_t size)
+{
+	return (size + VOS_NVME_BLK_SZ - 1) / VOS_NVME_BLK_SZ;
+}
 /**
  * Register btree class for container table, it is called within vos_init()
  *
@@ -421,6 +480,15 @@ int vos_obj_tree_init(struct vos_object *obj);
 int vos_obj_tree_fini(struct vos_object *obj);
 int vos_obj_tree_register(void);
 
+/**
+ * Delete array data of \a akey under \a dkey which is overwritten within
+ * the epoch range \a epr, \a credits is charged for the extents checked.
+ * \a empty returns true if the akey has no extent.
+ */
+int vos_obj_recx_aggregate(struct vos_object *obj, daos_epoch_range_t *epr,
+			   daos_key_t *dkey, daos_key_t *akey,
+			   unsigned int *credits, bool *empty);
+
 /**
  * Data structure which carries the keys, epoch ranges to the multi-nested
  * btree.
@@ -623,6 +691,12 @@ vos_obj2umm(struct vos_object *obj)
 	return &obj->obj_cont->vc_pool->vp_umm;
 }
 
+static inline struct vos_pool *
+vos_obj2pool(struct vos_object *obj)
+{
+	return obj->obj_cont->vc_pool;
+}
+
 static inline daos_handle_t
 vos_pool2hdl(struct vos_pool *pool)
 {
@@ -718,6 +792,8 @@ struct vos_iter_ops {
 	/** Delete the record that the cursor points to */
 	int	(*iop_delete)(struct vos_iterator *iter,
 			      void *args);
+	/** Optional, copy data of the record that the cursor points to */
+	int	(*iop_copy)(struct vos_iterator *iter, daos_iov_t *iov);
 	/**
 	 * Optional, the iterator has no element.
 	 *
@@ -232,6 +232,29 @@ vos_iter_delete(daos_handle_t ih, void *args)
 	return iter->it_ops->iop_delete(iter, args);
 }
 
+int
+vos_iter_copy(daos_handle_t ih, daos_iov_t *iov)
+{
+	struct vos_iterator *iter = vos_hdl2iter(ih);
+
+	if (iter->it_state == VOS_ITS_NONE) {
+		D_ERROR("Please call vos_iter_probe to initialize the cursor");
+		return -DER_NO_PERM;
+	}
+
+	if (iter->it_state == VOS_ITS_END) {
+		D_DEBUG(DB_TRACE, "The end of iteration\n");
+		return -DER_NONEXIST;
+	}
+
+	D_ASSERT(iter->it_ops != NULL);
+
+	if (iter->it_ops->iop_copy == NULL)
+		return -DER_NOSYS;
+
+	return iter->it_ops->iop_copy(iter, iov);
+}
+
 int
 vos_iter_empty(daos_handle_t ih)
 {
@@ -32,6 +32,7 @@
 #include <libpmemobj.h>
 #include <daos/btree.h>
 #include <daos_srv/evtree.h>
+#include <daos_srv/vea.h>
 #include <daos_srv/vos_types.h>
 
 /**
@@ -95,6 +96,16 @@ struct vos_cookie_rec_df {
 	daos_epoch_t		cr_max_epoch;
 };
 
+/** persistent part of vos_pool_info_t */
+struct vos_pool_info_df {
+	/** # of containers in this pool */
+	uint64_t				pif_cont_nr;
+	/** Total space available */
+	daos_size_t				pif_size;
+	/** Current vailable space */
+	daos_size_t				pif_avail;
+};
+
 struct vos_pool_df {
 	/* Structs stored in LE or BE representation */
 	uint32_t				pd_magic;
@@ -107,7 +118,13 @@ struct vos_pool_df {
 	/* Typed PMEMoid pointer for the container index table */
 	struct vos_cont_table_df		pd_ctab_df;
 	/* Pool info of objects, containers, space availability */
-	vos_pool_info_t				pd_pool_info;
+	struct vos_pool_info_df			pd_pool_info;
+	/* Size of the NVMe blob for large records, zero for SCM only pool */
+	uint64_t				pd_nvme_size;
+	/* ID of the NVMe blob, zero if it hasn't been created */
+	uint64_t				pd_nvme_blob_id;
+	/* Free space tracking information of the NVMe blob */
+	struct vea_space_df			pd_vea_df;
 };
 
 struct vos_epoch_index {
@@ -189,6 +206,11 @@ struct vos_obj_df {
 	daos_epoch_t			vo_epc_hi;
 	/** Attributes of object.  See vos_oi_attr */
 	uint64_t			vo_oi_attr;
+	/**
+	 * Epochs modified since the last aggregation of this object, both
+	 * ends are zero if aggregation has nothing to do for the object.
+	 */
+	daos_epoch_range_t		vo_dirty_epr;
 	/** VOS object btree root */
 	struct btr_root			vo_tree;
 };
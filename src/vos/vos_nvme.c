@@ -0,0 +1,410 @@
+/**
+ * (C) Copyright 2018 Intel Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * GOVERNMENT LICENSE RIGHTS-OPEN SOURCE SOFTWARE
+ * The Government's rights to use, modify, reproduce, release, perform, display,
+ * or disclose this software are subject to the terms of the Apache License as
+ * provided in Contract No. B609815.
+ * Any reproduction of computer software, computer software documentation, or
+ * portions thereof marked with this legend must also reproduce the markings.
+ */
+/**
+ * NVMe media of VOS pool.
+ *
+ * A VOS pool can have a NVMe blob to store large records, only the indices
+ * (btree/evtree) and the block address of the record live in SCM. Space of
+ * the blob is managed by VEA, whose metadata is also stored in the pool.
+ *
+ * The server VOS uses the blob on the blobstore of the xstream which opens the
+ * pool, standalone VOS has no NVMe context, so a sparse file next to the pool
+ * file stands in for the blob.
+ *
+ * vos/vos_nvme.c
+ */
+#define D_LOGFAC	DD_FAC(vos)
+
+#include <daos/common.h>
+#include <daos_srv/vea.h>
+#include <vos_layout.h>
+#include <vos_internal.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+/** one block, smaller records are not worth a NVMe I/O */
+daos_size_t	vos_nvme_thresh = VOS_NVME_BLK_SZ;
+
+/** number of blocks reserved for the blob header */
+#define VOS_NVME_HDR_BLKS	1
+
+/** DRAM handle of the NVMe blob */
+struct vos_blob {
+#ifdef VOS_STANDALONE
+	/** file which stands in for the blob */
+	int			 vb_fd;
+#else
+	struct dss_nvme_blob	*vb_blob;
+#endif
+};
+
+#ifdef VOS_STANDALONE
+
+static int
+blob_path(const char *path, char **blob_path)
+{
+	if (asprintf(blob_path, "%s.nvme", path) < 0)
+		return -DER_NOMEM;
+	return 0;
+}
+
+static int
+blob_create(const char *path, daos_size_t size, uint64_t *blob_id)
+{
+	char	*fpath;
+	int	 fd;
+	int	 rc;
+
+	rc = blob_path(path, &fpath);
+	if (rc)
+		return rc;
+
+	fd = open(fpath, O_CREAT | O_RDWR, 0600);
+	if (fd < 0) {
+		D_ERROR("Failed to create %s: %d\n", fpath, errno);
+		D_GOTO(out, rc = daos_errno2der(errno));
+	}
+
+	if (ftruncate(fd, size) != 0) {
+		D_ERROR("Failed to truncate %s: %d\n", fpath, errno);
+		rc = daos_errno2der(errno);
+	}
+	close(fd);
+	*blob_id = 1; /* only one blob per pool */
+out:
+	free(fpath);
+	return rc;
+}
+
+static int
+blob_delete(const char *path, uint64_t blob_id)
+{
+	char	*fpath;
+	int	 rc;
+
+	rc = blob_path(path, &fpath);
+	if (rc)
+		return rc;
+
+	if (unlink(fpath) != 0 && errno != ENOENT) {
+		D_ERROR("Failed to remove %s: %d\n", fpath, errno);
+		rc = daos_errno2der(errno);
+	}
+	free(fpath);
+	return rc;
+}
+
+static int
+blob_open(const char *path, uint64_t blob_id, struct vos_blob *blob)
+{
+	char	*fpath;
+	int	 rc;
+
+	rc = blob_path(path, &fpath);
+	if (rc)
+		return rc;
+
+	blob->vb_fd = open(fpath, O_RDWR);
+	if (blob->vb_fd < 0) {
+		D_ERROR("Failed to open %s: %d\n", fpath, errno);
+		rc = daos_errno2der(errno);
+	}
+	free(fpath);
+	return rc;
+}
+
+static void
+blob_close(struct vos_blob *blob)
+{
+	close(blob->vb_fd);
+}
+
+static int
+blob_rw(struct vos_blob *blob, daos_off_t off, void *buf, daos_size_t len,
+	bool update)
+{
+	ssize_t	nob;
+
+	while (len > 0) {
+		if (update)
+			nob = pwrite(blob->vb_fd, buf, len, off);
+		else
+			nob = pread(blob->vb_fd, buf, len, off);
+
+		if (nob < 0) {
+			if (errno == EINTR)
+				continue;
+			return daos_errno2der(errno);
+		}
+
+		if (nob == 0) /* read beyond EOF of a sparse file */
+			return -DER_IO;
+
+		buf += nob;
+		off += nob;
+		len -= nob;
+	}
+	return 0;
+}
+
+void *
+vos_nvme_buf_alloc(daos_size_t size)
+{
+	void	*buf;
+
+	size = vos_nvme_size2blks(size) * VOS_NVME_BLK_SZ;
+	if (posix_memalign(&buf, VOS_NVME_BLK_SZ, size) != 0)
+		return NULL;
+	return buf;
+}
+
+void
+vos_nvme_buf_free(void *buf)
+{
+	free(buf);
+}
+
+#else /* !VOS_STANDALONE */
+
+static int
+blob_create(const char *path, daos_size_t size, uint64_t *blob_id)
+{
+	return dss_nvme_blob_create(size, blob_id);
+}
+
+static int
+blob_delete(const char *path, uint64_t blob_id)
+{
+	return dss_nvme_blob_delete(blob_id);
+}
+
+static int
+blob_open(const char *path, uint64_t blob_id, struct vos_blob *blob)
+{
+	return dss_nvme_blob_open(blob_id, &blob->vb_blob);
+}
+
+static void
+blob_close(struct vos_blob *blob)
+{
+	dss_nvme_blob_close(blob->vb_blob);
+}
+
+static int
+blob_rw(struct vos_blob *blob, daos_off_t off, void *buf, daos_size_t len,
+	bool update)
+{
+	return dss_nvme_blob_rw(blob->vb_blob, off, buf, len, update);
+}
+
+void *
+vos_nvme_buf_alloc(daos_size_t size)
+{
+	return dss_nvme_dma_alloc(vos_nvme_size2blks(size) * VOS_NVME_BLK_SZ);
+}
+
+void
+vos_nvme_buf_free(void *buf)
+{
+	dss_nvme_dma_free(buf);
+}
+
+#endif /* VOS_STANDALONE */
+
+int
+vos_nvme_rw(struct vos_pool *pool, uint64_t blk_off, void *buf,
+	    daos_size_t len, bool update)
+{
+	D_ASSERT(pool->vp_blob != NULL);
+	return blob_rw(pool->vp_blob, blk_off * VOS_NVME_BLK_SZ, buf,
+		       vos_nvme_size2blks(len) * VOS_NVME_BLK_SZ, update);
+}
+
+/** Persistently record the ID of the just created blob */
+static int
+nvme_blob_id_set(struct vos_pool *pool, uint64_t blob_id)
+{
+	struct umem_instance	*umm = &pool->vp_umm;
+	struct vos_pool_df	*pool_df = vos_pool_ptr2df(pool);
+	int			 rc;
+
+	rc = umem_tx_begin(umm);
+	if (rc)
+		return rc;
+
+	rc = umem_tx_add_ptr(umm, &pool_df->pd_nvme_blob_id,
+			     sizeof(pool_df->pd_nvme_blob_id));
+	if (rc) {
+		umem_tx_abort(umm, rc);
+		return rc;
+	}
+
+	pool_df->pd_nvme_blob_id = blob_id;
+	return umem_tx_commit(umm);
+}
+
+int
+vos_nvme_pool_open(struct vos_pool *pool, const char *path)
+{
+	struct vos_pool_df	*pool_df = vos_pool_ptr2df(pool);
+	struct vos_blob		*blob;
+	uint64_t		 blob_id;
+	int			 rc;
+
+	if (pool_df->pd_nvme_size == 0)
+		return 0; /* SCM only pool */
+
+	/* NB: pool is created by the management service on behalf of all
+	 * xstreams, so the blob is created on the first open, which is
+	 * called by the xstream owning the pool.
+	 */
+	blob_id = pool_df->pd_nvme_blob_id;
+	if (blob_id == 0) {
+		rc = blob_create(path, pool_df->pd_nvme_size, &blob_id);
+		if (rc == -DER_UNINIT) {
+			D_WARN("No NVMe device, pool "DF_UUID" will store all "
+			       "records on SCM\n", DP_UUID(pool->vp_id));
+			return 0;
+		} else if (rc) {
+			return rc;
+		}
+
+		rc = nvme_blob_id_set(pool, blob_id);
+		if (rc) {
+			D_ERROR("Failed to save NVMe blob ID: %d\n", rc);
+			blob_delete(path, blob_id);
+			return rc;
+		}
+		D_DEBUG(DB_MGMT, "Created NVMe blob "DF_X64" for pool "
+			DF_UUID"\n", blob_id, DP_UUID(pool->vp_id));
+	}
+
+	D_ALLOC_PTR(blob);
+	if (blob == NULL)
+		return -DER_NOMEM;
+
+	rc = blob_open(path, blob_id, blob);
+	if (rc == -DER_UNINIT) {
+		/* records stored on NVMe before are inaccessible */
+		D_ERROR("No NVMe device for pool "DF_UUID"\n",
+			DP_UUID(pool->vp_id));
+		D_GOTO(failed, rc);
+	} else if (rc) {
+		D_GOTO(failed, rc);
+	}
+
+	rc = vea_load(&pool->vp_umm, &pool_df->pd_vea_df, NULL,
+		      &pool->vp_vea_info);
+	if (rc == -DER_UNINIT) {
+		rc = vea_format(&pool->vp_umm, &pool_df->pd_vea_df, blob_id,
+				VOS_NVME_BLK_SZ, VOS_NVME_HDR_BLKS,
+				pool_df->pd_nvme_size, NULL, NULL, false);
+		if (rc == 0)
+			rc = vea_load(&pool->vp_umm, &pool_df->pd_vea_df, NULL,
+				      &pool->vp_vea_info);
+	}
+
+	if (rc) {
+		D_ERROR("Failed to load NVMe space of pool "DF_UUID": %d\n",
+			DP_UUID(pool->vp_id), rc);
+		blob_close(blob);
+		D_GOTO(failed, rc);
+	}
+
+	pool->vp_blob = blob;
+	return 0;
+failed:
+	D_FREE_PTR(blob);
+	return rc;
+}
+
+void
+vos_nvme_pool_close(struct vos_pool *pool)
+{
+	if (pool->vp_vea_info != NULL) {
+		vea_unload(pool->vp_vea_info);
+		pool->vp_vea_info = NULL;
+	}
+
+	if (pool->vp_blob != NULL) {
+		blob_close(pool->vp_blob);
+		D_FREE_PTR(pool->vp_blob);
+	}
+}
+
+int
+vos_nvme_pool_destroy(const char *path)
+{
+	PMEMobjpool	*pop;
+	uint64_t	 blob_id;
+
+	pop = vos_pmemobj_open(path, POBJ_LAYOUT_NAME(vos_pool_layout));
+	if (pop == NULL) {
+		D_ERROR("Failed to open pool %s: %s\n", path,
+			pmemobj_errormsg());
+		return -DER_NO_HDL;
+	}
+
+	blob_id = vos_pool_pop2df(pop)->pd_nvme_blob_id;
+	vos_pmemobj_close(pop);
+
+	if (blob_id == 0)
+		return 0;
+
+	return blob_delete(path, blob_id);
+}
+
+/**
+ * evtree callback to free NVMe extent. The tree only knows its memory
+ * instance, so find the opened pool by the pool ID stored in the root.
+ */
+static int
+vos_nvme_free_cb(struct umem_instance *umm, uint64_t blk_off,
+		 uint32_t blk_cnt, void *args)
+{
+	struct vos_pool	*pool;
+	struct d_ulink	*hlink;
+	struct d_uuid	 ukey;
+	int		 rc;
+
+	uuid_copy(ukey.uuid, vos_pool_pop2df(umm->umm_u.pmem_pool)->pd_id);
+	hlink = d_uhash_link_lookup(vos_pool_hhash_get(), &ukey);
+	if (hlink == NULL)
+		return -DER_NO_HDL;
+
+	pool = container_of(hlink, struct vos_pool, vp_hlink);
+	if (vos_pool_has_nvme(pool))
+		rc = vea_tx_free(pool->vp_vea_info, blk_off, blk_cnt);
+	else
+		rc = -DER_UNINIT;
+
+	vos_pool_decref(pool);
+	return rc;
+}
+
+struct evt_desc_cbs vos_evt_desc_cbs = {
+	.dc_nvme_free_cb	= vos_nvme_free_cb,
+	.dc_nvme_free_args	= NULL,
+	.dc_blk_sz		= VOS_NVME_BLK_SZ,
+};
@@ -67,10 +67,30 @@ struct vos_zc_context {
 	unsigned int		 zc_actv_cnt;
 	unsigned int		 zc_actv_at;
 	struct pobj_action	*zc_actv;
+	/** NVMe extents reserved for the update, published by update_end */
+	d_list_t		 zc_nvme_resrvd;
 };
 
 static void vos_zcc_destroy(struct vos_zc_context *zcc, int err);
 
+/** DMA buffer of a NVMe extent returned by zero-copy fetch */
+struct nvme_buf {
+	struct nvme_buf		*nb_next;
+	void			*nb_buf;
+};
+
+/** record extent staged in DMA buffer, it's written to NVMe by update_end */
+struct nvme_rec {
+	/** staging buffer, NULL if the extent is stored on SCM */
+	void			*nr_buf;
+	/** data size of the extent */
+	daos_size_t		 nr_size;
+	/** start block of the reserved NVMe extent */
+	uint64_t		 nr_blk_off;
+	/** the extent has been written by vos_obj_zc_flush() */
+	bool			 nr_written;
+};
+
 /** I/O buffer for a I/O descriptor */
 struct iod_buf {
 	/** scatter/gather list for the ZC IO on this descriptor */
@@ -85,6 +105,15 @@ struct iod_buf {
 	unsigned int		 db_mmid_nr;
 	/** pre-allocated pmem buffers (for zc update only) */
 	umem_id_t		*db_mmids;
+	/** staged NVMe extents, indexed as db_mmids (for zc update only) */
+	struct nvme_rec		*db_nvme_recs;
+	/**
+	 * SCM records flushed by vos_obj_zc_flush, indexed as db_mmids, it is
+	 * NULL if nothing has been flushed (for zc update only)
+	 */
+	bool			*db_flushed;
+	/** DMA buffers to be released by fetch_end (for zc fetch only) */
+	struct nvme_buf		*db_nvme_bufs;
 };
 
 static bool
@@ -348,6 +377,20 @@ enum {
 	SUBTR_EVT	= (1 << 1),	/**< subtree is evtree */
 };
 
+/** Open the subtree whose root has been loaded in \a rbund */
+static int
+tree_open(struct vos_object *obj, struct vos_rec_bundle *rbund, int flags,
+	  daos_handle_t *sub_toh)
+{
+	struct umem_attr *uma = vos_obj2uma(obj);
+
+	if (flags & SUBTR_EVT)
+		return evt_open_inplace(rbund->rb_evt, uma, &vos_evt_desc_cbs,
+					sub_toh);
+
+	return dbtree_open_inplace(rbund->rb_btr, uma, sub_toh);
+}
+
 /**
  * Load the subtree roots embedded in the parent tree record.
  *
@@ -360,7 +403,6 @@ tree_prepare(struct vos_object *obj, daos_epoch_range_t *epr,
 	     daos_handle_t toh, enum vos_tree_class tclass,
 	     daos_key_t *key, int flags, daos_handle_t *sub_toh)
 {
-	struct umem_attr	*uma = vos_obj2uma(obj);
 	daos_csum_buf_t		 csum;
 	struct vos_key_bundle	 kbund;
 	struct vos_rec_bundle	 rbund;
@@ -405,19 +447,74 @@ tree_prepare(struct vos_object *obj, daos_epoch_range_t *epr,
 			D_GOTO(failed, rc);
 	}
 
-	if (flags & SUBTR_EVT) {
-		rc = evt_open_inplace(rbund.rb_evt, uma, sub_toh);
-		if (rc != 0)
-			D_GOTO(failed, rc);
-	} else {
-		rc = dbtree_open_inplace(rbund.rb_btr, uma, sub_toh);
-		if (rc != 0)
-			D_GOTO(failed, rc);
-	}
+	rc = tree_open(obj, &rbund, flags, sub_toh);
  failed:
 	return rc;
 }
 
+/**
+ * Look up a batch of akeys under the same dkey, the akey tree is searched
+ * in one pass by dbtree_lookup_batch(). Subtree roots of akeys are returned
+ * in \a rbunds, rbunds[i].rb_btr is NULL if the akey does not exist.
+ */
+static int
+akey_lookup_batch(daos_handle_t toh, daos_epoch_range_t *epr,
+		  unsigned int iod_nr, daos_iod_t *iods,
+		  struct vos_rec_bundle *rbunds)
+{
+	struct vos_key_bundle	*kbunds;
+	daos_iov_t		*kiovs;
+	daos_iov_t		*riovs;
+	daos_csum_buf_t		*csums;
+	daos_key_t		*tmps;
+	int			*rcs;
+	int			 i;
+	int			 rc;
+
+	D_ALLOC(kbunds, iod_nr * sizeof(*kbunds));
+	D_ALLOC(kiovs, iod_nr * sizeof(*kiovs));
+	D_ALLOC(riovs, iod_nr * sizeof(*riovs));
+	D_ALLOC(csums, iod_nr * sizeof(*csums));
+	D_ALLOC(tmps, iod_nr * sizeof(*tmps));
+	D_ALLOC(rcs, iod_nr * sizeof(*rcs));
+	if (kbunds == NULL || kiovs == NULL || riovs == NULL ||
+	    csums == NULL || tmps == NULL || rcs == NULL)
+		D_GOTO(out, rc = -DER_NOMEM);
+
+	for (i = 0; i < iod_nr; i++) {
+		tree_key_bundle2iov(&kbunds[i], &kiovs[i]);
+		kbunds[i].kb_key = &iods[i].iod_name;
+		kbunds[i].kb_epr = epr;
+
+		tree_rec_bundle2iov(&rbunds[i], &riovs[i]);
+		rbunds[i].rb_mmid = UMMID_NULL;
+		rbunds[i].rb_csum = &csums[i];
+		memset(&csums[i], 0, sizeof(csums[i]));
+		daos_iov_set(&tmps[i], NULL, 0);
+		rbunds[i].rb_iov = &tmps[i];
+	}
+
+	rc = dbtree_lookup_batch(toh, kiovs, riovs, rcs, iod_nr);
+	for (i = 0; i < iod_nr && rc == 0; i++) {
+		if (rcs[i] != 0 && rcs[i] != -DER_NONEXIST)
+			rc = rcs[i];
+	}
+
+	/* only subtree roots are returned, buffers are released */
+	for (i = 0; i < iod_nr; i++) {
+		rbunds[i].rb_csum = NULL;
+		rbunds[i].rb_iov = NULL;
+	}
+ out:
+	D_FREE(kbunds);
+	D_FREE(kiovs);
+	D_FREE(riovs);
+	D_FREE(csums);
+	D_FREE(tmps);
+	D_FREE(rcs);
+	return rc;
+}
+
 /** Close the opened trees */
 static void
 tree_release(daos_handle_t toh, bool is_array)
@@ -440,10 +537,33 @@ tree_release(daos_handle_t toh, bool is_array)
  * @defgroup vos_obj_io_func functions for object regular I/O
  * @{
  */
+/**
+ * Return the stored checksum \a src to the checksum buffer \a dst of I/O
+ * descriptor, \a dst is optional. Length of \a dst is set to zero if there is
+ * no stored checksum or \a dst is too small.
+ */
+static void
+iod_csum_copy_out(daos_csum_buf_t *dst, daos_csum_buf_t *src)
+{
+	if (dst == NULL)
+		return;
+
+	if (src == NULL || src->cs_len == 0 || dst->cs_csum == NULL ||
+	    dst->cs_buf_len < src->cs_len) {
+		dst->cs_len = 0;
+		return;
+	}
+
+	memcpy(dst->cs_csum, src->cs_csum, src->cs_len);
+	dst->cs_len  = src->cs_len;
+	dst->cs_type = src->cs_type;
+}
+
 /** Fetch the single value within the specified epoch range of an key */
 static int
 akey_fetch_single(daos_handle_t toh, daos_epoch_range_t *epr,
-		  daos_size_t *rsize, struct iod_buf *iobuf)
+		  daos_csum_buf_t *csum_out, daos_size_t *rsize,
+		  struct iod_buf *iobuf)
 {
 	struct vos_key_bundle	 kbund;
 	struct vos_rec_bundle	 rbund;
@@ -474,15 +594,86 @@ akey_fetch_single(daos_handle_t toh, daos_epoch_range_t *epr,
 	if (rc != 0)
 		D_GOTO(out, rc);
 
+	iod_csum_copy_out(csum_out, &csum);
 	*rsize = rbund.rb_rsize;
  out:
 	return rc;
 }
 
-/** Fetch a extent from an akey */
+/**
+ * Read \a nr records of the NVMe extent \a ent to a DMA buffer and fill
+ * \a iobuf with it. The buffer is released at here for copy fetch, or by
+ * vos_obj_zc_fetch_end() for zero-copy fetch.
+ */
 static int
-akey_fetch_recx(daos_handle_t toh, daos_epoch_range_t *epr, daos_recx_t *recx,
-		daos_size_t *rsize_p, struct iod_buf *iobuf)
+akey_fetch_nvme(struct vos_object *obj, struct evt_entry *ent, daos_size_t nr,
+		struct iod_buf *iobuf)
+{
+	struct vos_pool	*pool = vos_obj2pool(obj);
+	struct nvme_buf	*nbuf = NULL;
+	daos_iov_t	 iov;
+	daos_size_t	 len = nr * ent->en_inob;
+	daos_off_t	 off;
+	uint64_t	 blk_off;
+	void		*buf;
+	int		 rc;
+
+	if (iobuf_sgl_empty(iobuf))
+		return 0; /* size fetch */
+
+	if (!vos_pool_has_nvme(pool)) {
+		D_ERROR("Pool "DF_UUID" has NVMe extent but no NVMe device\n",
+			DP_UUID(pool->vp_id));
+		return -DER_IO;
+	}
+
+	/* the selected part may start in the middle of a block */
+	off = ent->en_offset * ent->en_inob;
+	blk_off = ent->en_blk_off + off / VOS_NVME_BLK_SZ;
+	off %= VOS_NVME_BLK_SZ;
+
+	if (iobuf->db_zc) {
+		D_ALLOC_PTR(nbuf);
+		if (nbuf == NULL)
+			return -DER_NOMEM;
+	}
+
+	buf = vos_nvme_buf_alloc(off + len);
+	if (buf == NULL) {
+		D_FREE_PTR(nbuf);
+		return -DER_NOMEM;
+	}
+
+	if (nbuf != NULL) {
+		nbuf->nb_buf = buf;
+		nbuf->nb_next = iobuf->db_nvme_bufs;
+		iobuf->db_nvme_bufs = nbuf;
+	}
+
+	rc = vos_nvme_rw(pool, blk_off, buf, off + len, false);
+	if (rc != 0) {
+		D_ERROR("Failed to read NVMe block "DF_U64": %d\n",
+			blk_off, rc);
+		D_GOTO(out, rc);
+	}
+
+	daos_iov_set(&iov, buf + off, len);
+	rc = iobuf_fetch(iobuf, &iov);
+out:
+	if (nbuf == NULL)
+		vos_nvme_buf_free(buf);
+	return rc;
+}
+
+/**
+ * Fetch a extent from an akey. The stored checksum is returned to \a csum_out
+ * only if \a recx is exactly an extent written by one update.
+ */
+static int
+akey_fetch_recx(struct vos_object *obj, daos_handle_t toh,
+		daos_epoch_range_t *epr, daos_recx_t *recx,
+		daos_csum_buf_t *csum_out, daos_size_t *rsize_p,
+		struct iod_buf *iobuf)
 {
 	struct evt_entry	*ent;
 	/* At present, this is not exposed in interface but passing it toggles
@@ -496,6 +687,7 @@ akey_fetch_recx(daos_handle_t toh, daos_epoch_range_t *epr, daos_recx_t *recx,
 	daos_off_t		 index;
 	daos_off_t		 end;
 	unsigned int		 rsize;
+	unsigned int		 ent_nr;
 	int			 rc;
 
 	index = recx->rx_idx;
@@ -512,6 +704,7 @@ akey_fetch_recx(daos_handle_t toh, daos_epoch_range_t *epr, daos_recx_t *recx,
 
 	rsize = 0;
 	holes = 0;
+	ent_nr = 0;
 	evt_ent_list_for_each(ent, &ent_list) {
 		daos_off_t	lo = ent->en_sel_rect.rc_off_lo;
 		daos_off_t	hi = ent->en_sel_rect.rc_off_hi;
@@ -519,6 +712,7 @@ akey_fetch_recx(daos_handle_t toh, daos_epoch_range_t *epr, daos_recx_t *recx,
 
 		D_ASSERT(hi >= lo);
 		nr = hi - lo + 1;
+		ent_nr++;
 
 		if (lo != index) {
 			D_ASSERTF(lo > index,
@@ -552,8 +746,12 @@ akey_fetch_recx(daos_handle_t toh, daos_epoch_range_t *epr, daos_recx_t *recx,
 			holes = 0;
 		}
 
-		daos_iov_set(&iov, ent->en_addr, nr * rsize);
-		rc = iobuf_fetch(iobuf, &iov);
+		if (ent->en_flags & EVT_PTR_NVME) {
+			rc = akey_fetch_nvme(obj, ent, nr, iobuf);
+		} else {
+			daos_iov_set(&iov, ent->en_addr, nr * rsize);
+			rc = iobuf_fetch(iobuf, &iov);
+		}
 		if (rc != 0)
 			D_GOTO(failed, rc);
 
@@ -574,6 +772,18 @@ akey_fetch_recx(daos_handle_t toh, daos_epoch_range_t *epr, daos_recx_t *recx,
 				D_GOTO(failed, rc);
 		}
 	}
+
+	if (csum_out != NULL) {
+		ent = NULL;
+		if (ent_nr == 1) {
+			ent = d_list_entry(ent_list.el_list.next,
+					   struct evt_entry, en_link);
+			if (ent->en_rect.rc_off_lo != rect.rc_off_lo ||
+			    ent->en_rect.rc_off_hi != rect.rc_off_hi)
+				ent = NULL; /* partial extent */
+		}
+		iod_csum_copy_out(csum_out, ent ? &ent->en_csum : NULL);
+	}
 	*rsize_p = rsize;
  failed:
 	evt_ent_list_fini(&ent_list);
@@ -584,7 +794,8 @@ akey_fetch_recx(daos_handle_t toh, daos_epoch_range_t *epr, daos_recx_t *recx,
 /** fetch a set of record extents from the specified akey. */
 static int
 akey_fetch(struct vos_object *obj, daos_epoch_t epoch, daos_handle_t ak_toh,
-	   daos_iod_t *iod, struct iod_buf *iobuf)
+	   daos_iod_t *iod, struct iod_buf *iobuf,
+	   struct vos_rec_bundle *rbund)
 {
 	daos_epoch_range_t	epr;
 	daos_handle_t		toh;
@@ -599,8 +810,15 @@ akey_fetch(struct vos_object *obj, daos_epoch_t epoch, daos_handle_t ak_toh,
 		flags |= SUBTR_EVT;
 
 	epr.epr_lo = epr.epr_hi = epoch;
-	rc = tree_prepare(obj, &epr, ak_toh, VOS_BTR_AKEY, &iod->iod_name,
-			  flags, &toh);
+	if (rbund == NULL) {
+		rc = tree_prepare(obj, &epr, ak_toh, VOS_BTR_AKEY,
+				  &iod->iod_name, flags, &toh);
+	} else if (rbund->rb_btr == NULL) { /* not found by batch lookup */
+		rc = -DER_NONEXIST;
+	} else {
+		rc = tree_open(obj, rbund, flags, &toh);
+	}
+
 	if (rc == -DER_NONEXIST) {
 		D_DEBUG(DB_IO, "nonexistent akey\n");
 		vos_empty_sgl(&iobuf->db_sgl);
@@ -613,17 +831,20 @@ akey_fetch(struct vos_object *obj, daos_epoch_t epoch, daos_handle_t ak_toh,
 	}
 
 	if (iod->iod_type == DAOS_IOD_SINGLE) {
-		rc = akey_fetch_single(toh, &epr, &iod->iod_size, iobuf);
+		rc = akey_fetch_single(toh, &epr, iod->iod_csums,
+				       &iod->iod_size, iobuf);
 		D_GOTO(out, rc);
 	} /* else: array */
 
 	for (i = 0; i < iod->iod_nr; i++) {
 		daos_epoch_range_t *etmp;
+		daos_csum_buf_t	   *csum;
 		daos_size_t	    rsize;
 
 		etmp = iod->iod_eprs ? &iod->iod_eprs[i] : &epr;
-		rc = akey_fetch_recx(toh, etmp, &iod->iod_recxs[i], &rsize,
-				     iobuf);
+		csum = iod->iod_csums ? &iod->iod_csums[i] : NULL;
+		rc = akey_fetch_recx(obj, toh, etmp, &iod->iod_recxs[i], csum,
+				     &rsize, iobuf);
 		if (rc != 0) {
 			D_DEBUG(DB_IO, "Failed to fetch index %d: %d\n", i, rc);
 			D_GOTO(out, rc);
@@ -652,6 +873,7 @@ dkey_fetch(struct vos_object *obj, daos_epoch_t epoch, daos_key_t *dkey,
 	   unsigned int iod_nr, daos_iod_t *iods, daos_sg_list_t *sgls,
 	   struct vos_zc_context *zcc)
 {
+	struct vos_rec_bundle	*rbunds = NULL;
 	daos_handle_t		toh;
 	daos_epoch_range_t	epr;
 	int			i;
@@ -677,6 +899,17 @@ dkey_fetch(struct vos_object *obj, daos_epoch_t epoch, daos_key_t *dkey,
 		return rc;
 	}
 
+	if (iod_nr > 1) {
+		/* search all akeys in one pass of the akey tree */
+		D_ALLOC(rbunds, iod_nr * sizeof(*rbunds));
+		if (rbunds == NULL)
+			D_GOTO(failed, rc = -DER_NOMEM);
+
+		rc = akey_lookup_batch(toh, &epr, iod_nr, iods, rbunds);
+		if (rc != 0)
+			D_GOTO(failed, rc);
+	}
+
 	for (i = 0; i < iod_nr; i++) {
 		struct iod_buf	*iobuf;
 		struct iod_buf	 iobuf_tmp;
@@ -693,7 +926,8 @@ dkey_fetch(struct vos_object *obj, daos_epoch_t epoch, daos_key_t *dkey,
 			}
 		}
 
-		rc = akey_fetch(obj, epoch, toh, &iods[i], iobuf);
+		rc = akey_fetch(obj, epoch, toh, &iods[i], iobuf,
+				rbunds == NULL ? NULL : &rbunds[i]);
 		if (rc != 0)
 			D_GOTO(failed, rc);
 
@@ -703,6 +937,7 @@ dkey_fetch(struct vos_object *obj, daos_epoch_t epoch, daos_key_t *dkey,
 		}
 	}
  failed:
+	D_FREE(rbunds);
 	tree_release(toh, false);
 	return rc;
 }
@@ -745,7 +980,8 @@ vos_obj_fetch(daos_handle_t coh, daos_unit_oid_t oid, daos_epoch_t epoch,
 
 static int
 akey_update_single(daos_handle_t toh, daos_epoch_range_t *epr, uuid_t cookie,
-		   uint32_t pm_ver, daos_size_t rsize, struct iod_buf *iobuf)
+		   uint32_t pm_ver, daos_size_t rsize, daos_csum_buf_t *csum_in,
+		   struct iod_buf *iobuf)
 {
 	struct vos_key_bundle	kbund;
 	struct vos_rec_bundle	rbund;
@@ -759,7 +995,10 @@ akey_update_single(daos_handle_t toh, daos_epoch_range_t *epr, uuid_t cookie,
 	tree_key_bundle2iov(&kbund, &kiov);
 	kbund.kb_epr	= epr;
 
-	daos_csum_set(&csum, NULL, 0);
+	if (csum_in != NULL && csum_in->cs_len != 0 && rsize != 0)
+		csum = *csum_in;
+	else
+		daos_csum_set(&csum, NULL, 0);
 	daos_iov_set(&iov, NULL, rsize);
 
 	D_ASSERT(iobuf->db_at == 0);
@@ -784,6 +1023,12 @@ akey_update_single(daos_handle_t toh, daos_epoch_range_t *epr, uuid_t cookie,
 		D_GOTO(out, rc);
 	}
 
+	/* NB: csum::cs_csum has been changed to the checksum address of the
+	 * record by dbtree_update(), see svb_rec_copy_in().
+	 */
+	if (csum.cs_len != 0)
+		memcpy(csum.cs_csum, csum_in->cs_csum, csum.cs_len);
+
 	rc = iobuf_update(iobuf, &iov);
 	if (rc != 0)
 		D_GOTO(out, rc = -DER_IO_INVAL);
@@ -799,7 +1044,7 @@ out:
 static int
 akey_update_recx(daos_handle_t toh, daos_epoch_range_t *epr, uuid_t cookie,
 		 uint32_t pm_ver, daos_recx_t *recx, daos_size_t rsize,
-		 struct iod_buf *iobuf)
+		 daos_csum_buf_t *csum, struct iod_buf *iobuf)
 {
 	struct evt_rect	rect;
 	daos_iov_t	iov;
@@ -810,8 +1055,14 @@ akey_update_recx(daos_handle_t toh, daos_epoch_range_t *epr, uuid_t cookie,
 	rect.rc_off_hi = recx->rx_idx + recx->rx_nr - 1;
 
 	daos_iov_set(&iov, NULL, rsize);
-	if (iobuf->db_zc) {
-		rc = evt_insert(toh, cookie, pm_ver, &rect, rsize,
+	if (iobuf->db_zc && iobuf->db_nvme_recs != NULL &&
+	    iobuf->db_nvme_recs[iobuf->db_at].nr_buf != NULL) {
+		rc = evt_insert_nvme(toh, cookie, pm_ver, &rect, rsize, csum,
+				iobuf->db_nvme_recs[iobuf->db_at].nr_blk_off);
+		if (rc != 0)
+			D_GOTO(out, rc);
+	} else if (iobuf->db_zc) {
+		rc = evt_insert(toh, cookie, pm_ver, &rect, rsize, csum,
 				iobuf->db_mmids[iobuf->db_at]);
 		if (rc != 0)
 			D_GOTO(out, rc);
@@ -826,7 +1077,8 @@ akey_update_recx(daos_handle_t toh, daos_epoch_range_t *epr, uuid_t cookie,
 		 * copy actual data into those buffers after evt_insert_sgl().
 		 * See iobuf_update() for the details.
 		 */
-		rc = evt_insert_sgl(toh, cookie, pm_ver, &rect, rsize, &sgl);
+		rc = evt_insert_sgl(toh, cookie, pm_ver, &rect, rsize, csum,
+				    &sgl);
 		if (rc != 0)
 			D_GOTO(out, rc);
 
@@ -841,6 +1093,62 @@ out:
 	return rc;
 }
 
+/** minimum number of recxs of a zero-copy update to insert them in batch */
+#define VOS_EVT_BULK_MIN	16
+
+/**
+ * Insert all record extents of a zero-copy update in one batch, rebuild
+ * repopulates an array with a few large updates, they can be bulk loaded
+ * to the empty evtree.
+ */
+static int
+akey_update_recx_bulk(daos_handle_t toh, daos_epoch_range_t *epr,
+		      uuid_t cookie, uint32_t pm_ver, daos_iod_t *iod,
+		      struct iod_buf *iobuf)
+{
+	struct evt_entry	*ents;
+	struct evt_entry	*ent;
+	daos_epoch_range_t	*etmp;
+	daos_recx_t		*recx;
+	int			 i;
+	int			 rc = 0;
+
+	D_ASSERT(iobuf->db_zc);
+	D_ALLOC(ents, iod->iod_nr * sizeof(*ents));
+	if (ents == NULL)
+		return -DER_NOMEM;
+
+	for (i = 0; i < iod->iod_nr; i++) {
+		ent  = &ents[i];
+		recx = &iod->iod_recxs[i];
+		etmp = iod->iod_eprs ? &iod->iod_eprs[i] : epr;
+
+		ent->en_rect.rc_epc_lo = etmp->epr_lo;
+		ent->en_rect.rc_off_lo = recx->rx_idx;
+		ent->en_rect.rc_off_hi = recx->rx_idx + recx->rx_nr - 1;
+		ent->en_inob = iod->iod_size;
+		if (iod->iod_csums)
+			ent->en_csum = iod->iod_csums[i];
+
+		if (iobuf->db_nvme_recs != NULL &&
+		    iobuf->db_nvme_recs[iobuf->db_at].nr_buf != NULL) {
+			ent->en_flags	= EVT_PTR_NVME;
+			ent->en_blk_off	=
+				iobuf->db_nvme_recs[iobuf->db_at].nr_blk_off;
+		} else {
+			ent->en_mmid = iobuf->db_mmids[iobuf->db_at];
+		}
+
+		rc = iobuf_update(iobuf, NULL);
+		if (rc != 0)
+			D_GOTO(out, rc);
+	}
+
+	rc = evt_insert_bulk(toh, cookie, pm_ver, ents, iod->iod_nr);
+out:
+	D_FREE(ents);
+	return rc;
+}
 
 /** update a set of record extents (recx) under the same akey */
 static int
@@ -869,16 +1177,25 @@ akey_update(struct vos_object *obj, daos_epoch_t epoch, uuid_t cookie,
 
 	if (iod->iod_type == DAOS_IOD_SINGLE) {
 		rc = akey_update_single(toh, &epr, cookie, pm_ver,
-					iod->iod_size, iobuf);
+					iod->iod_size, iod->iod_csums, iobuf);
 		D_GOTO(out, rc);
 	} /* else: array */
 
+	if (iobuf->db_zc && iod->iod_nr >= VOS_EVT_BULK_MIN) {
+		rc = akey_update_recx_bulk(toh, &epr, cookie, pm_ver, iod,
+					   iobuf);
+		D_GOTO(out, rc);
+	}
+
 	for (i = 0; i < iod->iod_nr; i++) {
 		daos_epoch_range_t *etmp;
+		daos_csum_buf_t	   *csum;
 
 		etmp = iod->iod_eprs ? &iod->iod_eprs[i] : &epr;
+		csum = iod->iod_csums ? &iod->iod_csums[i] : NULL;
 		rc = akey_update_recx(toh, etmp, cookie, pm_ver,
-				      &iod->iod_recxs[i], iod->iod_size, iobuf);
+				      &iod->iod_recxs[i], iod->iod_size, csum,
+				      iobuf);
 		if (rc != 0)
 			D_GOTO(out, rc);
 	}
@@ -902,6 +1219,10 @@ dkey_update(struct vos_object *obj, daos_epoch_t epoch, uuid_t cookie,
 	if (rc != 0)
 		return rc;
 
+	rc = vos_oi_dirty_mark(vos_obj2umm(obj), obj->obj_df, epoch);
+	if (rc != 0)
+		return rc;
+
 	epr.epr_lo = epoch;
 	epr.epr_hi = DAOS_EPOCH_MAX;
 	rc = tree_prepare(obj, &epr, obj->obj_toh, VOS_BTR_DKEY, dkey,
@@ -941,6 +1262,78 @@ dkey_update(struct vos_object *obj, daos_epoch_t epoch, uuid_t cookie,
 	return rc;
 }
 
+/** Should a record extent of \a size bytes be stored on NVMe? */
+static bool
+vos_recx_on_nvme(struct vos_object *obj, daos_size_t size)
+{
+	return vos_pool_has_nvme(vos_obj2pool(obj)) &&
+	       size >= vos_nvme_thresh;
+}
+
+/** Is there any record extent of the update to be stored on NVMe? */
+static bool
+vos_update_has_nvme(struct vos_object *obj, unsigned int iod_nr,
+		    daos_iod_t *iods)
+{
+	int	i;
+	int	j;
+
+	if (!vos_pool_has_nvme(vos_obj2pool(obj)))
+		return false;
+
+	for (i = 0; i < iod_nr; i++) {
+		if (iods[i].iod_type != DAOS_IOD_ARRAY)
+			continue;
+
+		for (j = 0; j < iods[i].iod_nr; j++) {
+			if (vos_recx_on_nvme(obj, iods[i].iod_size *
+					     iods[i].iod_recxs[j].rx_nr))
+				return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * NVMe extents are written before starting the transaction, so the update
+ * is converted to zero-copy update, which stages data in DMA buffers.
+ */
+static int
+vos_obj_update_nvme(daos_handle_t coh, daos_unit_oid_t oid, daos_epoch_t epoch,
+		    uuid_t cookie, uint32_t pm_ver, daos_key_t *dkey,
+		    unsigned int iod_nr, daos_iod_t *iods, daos_sg_list_t *sgls)
+{
+	daos_handle_t	ioh;
+	int		i;
+	int		j;
+	int		rc;
+
+	rc = vos_obj_zc_update_begin(coh, oid, epoch, dkey, iod_nr, iods,
+				     &ioh);
+	if (rc != 0)
+		return rc;
+
+	for (i = 0; i < iod_nr && rc == 0; i++) {
+		daos_sg_list_t	*zc_sgl;
+		struct iod_buf	 iobuf;
+
+		memset(&iobuf, 0, sizeof(iobuf));
+		iobuf.db_sgl = sgls[i];
+
+		rc = vos_obj_zc_sgl_at(ioh, i, &zc_sgl);
+		for (j = 0; rc == 0 && j < zc_sgl->sg_nr_out; j++) {
+			rc = iobuf_cp_update(&iobuf, &zc_sgl->sg_iovs[j]);
+			if (rc != 0) {
+				D_ERROR("Invalid sgl of iod %d\n", i);
+				rc = -DER_IO_INVAL;
+			}
+		}
+	}
+
+	return vos_obj_zc_update_end(ioh, cookie, pm_ver, dkey, iod_nr, iods,
+				     rc);
+}
+
 /**
  * Update an array of records for the specified object.
  */
@@ -961,6 +1354,12 @@ vos_obj_update(daos_handle_t coh, daos_unit_oid_t oid, daos_epoch_t epoch,
 	if (rc != 0)
 		return rc;
 
+	if (sgls != NULL && vos_update_has_nvme(obj, iod_nr, iods)) {
+		vos_obj_release(vos_obj_cache_current(), obj);
+		return vos_obj_update_nvme(coh, oid, epoch, cookie, pm_ver,
+					   dkey, iod_nr, iods, sgls);
+	}
+
 	pop = vos_obj2pop(obj);
 	TX_BEGIN(pop) {
 		rc = dkey_update(obj, epoch, cookie, pm_ver, dkey, iod_nr, iods,
@@ -999,6 +1398,10 @@ key_punch(struct vos_object *obj, daos_epoch_t epoch, uuid_t cookie,
 	else if (rc)
 		D_GOTO(out, rc); /* real failure */
 
+	rc = vos_oi_dirty_mark(vos_obj2umm(obj), obj->obj_df, epoch);
+	if (rc)
+		D_GOTO(out_dk, rc);
+
 	tree_key_bundle2iov(&kbund, &kiov);
 	kbund.kb_epr	= &epr;
 
@@ -1097,6 +1500,112 @@ vos_obj_punch(daos_handle_t coh, daos_unit_oid_t oid, daos_epoch_t epoch,
 	return rc;
 }
 
+/**
+ * Aggregate the array value of \a akey under \a dkey within the epoch range
+ * \a epr. An extent written within \a epr hides the older data in its offset
+ * range, which is deleted, or trimmed if it partially overlaps with the
+ * extent, by evt_delete_range().
+ *
+ * The aggregation of an akey can't be resumed in the middle, so \a credits
+ * is charged for the extents being checked but never stops it. \a empty is
+ * set to false if the akey has any extent.
+ */
+int
+vos_obj_recx_aggregate(struct vos_object *obj, daos_epoch_range_t *epr,
+		       daos_key_t *dkey, daos_key_t *akey,
+		       unsigned int *credits, bool *empty)
+{
+	struct evt_entry	 ent;
+	struct evt_rect		*rects = NULL;
+	struct evt_rect		*tmp;
+	daos_handle_t		 dk_toh;
+	daos_handle_t		 ak_toh;
+	daos_handle_t		 ih;
+	int			 max = 0;
+	int			 nr = 0;
+	int			 i;
+	int			 rc;
+
+	*empty = true;
+	if (vos_obj_is_empty(obj))
+		return 0;
+
+	rc = vos_obj_tree_init(obj);
+	if (rc != 0)
+		return rc;
+
+	rc = tree_prepare(obj, epr, obj->obj_toh, VOS_BTR_DKEY, dkey, 0,
+			  &dk_toh);
+	if (rc != 0)
+		D_GOTO(failed_0, rc);
+
+	rc = tree_prepare(obj, epr, dk_toh, VOS_BTR_AKEY, akey, SUBTR_EVT,
+			  &ak_toh);
+	if (rc != 0)
+		D_GOTO(failed_1, rc);
+
+	/* Collect extents of the epoch range, the tree can't be modified
+	 * under the iterator.
+	 */
+	rc = evt_iter_prepare(ak_toh, EVT_ITER_EMBEDDED, &ih);
+	if (rc != 0)
+		D_GOTO(failed_2, rc);
+
+	for (rc = evt_iter_probe(ih, EVT_ITER_FIRST, NULL, NULL); rc == 0;
+	     rc = evt_iter_next(ih)) {
+		rc = evt_iter_fetch(ih, &ent, NULL);
+		if (rc != 0)
+			break;
+
+		*empty = false;
+		if (*credits > 0)
+			(*credits)--;
+
+		if (ent.en_rect.rc_epc_lo < epr->epr_lo ||
+		    ent.en_rect.rc_epc_lo > epr->epr_hi ||
+		    ent.en_rect.rc_epc_lo == 0)
+			continue;
+
+		if (nr == max) {
+			max = max == 0 ? 16 : max * 2;
+			D_ALLOC(tmp, max * sizeof(*tmp));
+			if (tmp == NULL) {
+				rc = -DER_NOMEM;
+				break;
+			}
+			if (nr > 0)
+				memcpy(tmp, rects, nr * sizeof(*tmp));
+			D_FREE(rects);
+			rects = tmp;
+		}
+		rects[nr++] = ent.en_rect;
+	}
+	evt_iter_finish(ih);
+
+	if (rc == -DER_NONEXIST)
+		rc = 0;
+	if (rc != 0)
+		D_GOTO(failed_2, rc);
+
+	for (i = 0; i < nr; i++) {
+		rects[i].rc_epc_lo--;
+		rc = evt_delete_range(ak_toh, &rects[i]);
+		if (rc != 0) {
+			D_ERROR("Failed to aggregate extent "DF_RECT": %d\n",
+				DP_RECT(&rects[i]), rc);
+			break;
+		}
+	}
+	D_DEBUG(DB_EPC, "Aggregated %d extents, rc=%d\n", nr, rc);
+ failed_2:
+	D_FREE(rects);
+	tree_release(ak_toh, true);
+ failed_1:
+	tree_release(dk_toh, false);
+ failed_0:
+	return rc == -DER_NONEXIST ? 0 : rc;
+}
+
 /**
  * @} vos_obj_io_func
  */
@@ -1179,6 +1688,7 @@ vos_zcc_create(daos_handle_t coh, daos_unit_oid_t oid, bool read_only,
 	if (zcc == NULL)
 		return -DER_NOMEM;
 
+	D_INIT_LIST_HEAD(&zcc->zc_nvme_resrvd);
 	rc = vos_obj_hold(vos_obj_cache_current(), coh, oid, epoch, read_only,
 			  &zcc->zc_obj);
 	if (rc != 0)
@@ -1200,6 +1710,29 @@ vos_zcc_create(daos_handle_t coh, daos_unit_oid_t oid, bool read_only,
 	return rc;
 }
 
+/** release DMA buffers of NVMe extents */
+static void
+vos_zcc_free_nvme(struct iod_buf *iobuf)
+{
+	struct nvme_buf	*nbuf;
+	int		 i;
+
+	while ((nbuf = iobuf->db_nvme_bufs) != NULL) {
+		iobuf->db_nvme_bufs = nbuf->nb_next;
+		vos_nvme_buf_free(nbuf->nb_buf);
+		D_FREE_PTR(nbuf);
+	}
+
+	if (iobuf->db_nvme_recs == NULL)
+		return;
+
+	for (i = 0; i < iobuf->db_mmid_nr; i++) {
+		if (iobuf->db_nvme_recs[i].nr_buf != NULL)
+			vos_nvme_buf_free(iobuf->db_nvme_recs[i].nr_buf);
+	}
+	D_FREE(iobuf->db_nvme_recs);
+}
+
 /**
  * Free zero-copy buffers for @zcc, it returns false if it is called without
  * transactoin, but @zcc has pmem buffers. Otherwise it returns true.
@@ -1214,6 +1747,8 @@ vos_zcc_free_iobuf(struct vos_zc_context *zcc, bool has_tx, int err)
 	     iobuf < &zcc->zc_iobufs[zcc->zc_iod_nr]; iobuf++) {
 
 		daos_sgl_fini(&iobuf->db_sgl, false);
+		vos_zcc_free_nvme(iobuf);
+		D_FREE(iobuf->db_flushed);
 		if (iobuf->db_mmids == NULL)
 			continue;
 
@@ -1278,6 +1813,13 @@ vos_zcc_destroy(struct vos_zc_context *zcc, int err)
 		}
 	}
 
+	if (!d_list_empty(&zcc->zc_nvme_resrvd)) {
+		/* reservations are released by publish on success */
+		D_ASSERT(err != 0 && zcc->zc_obj != NULL);
+		vea_cancel(vos_obj2pool(zcc->zc_obj)->vp_vea_info, NULL,
+			   &zcc->zc_nvme_resrvd);
+	}
+
 	if (zcc->zc_obj)
 		vos_obj_release(vos_obj_cache_current(), zcc->zc_obj);
 	vos_zcc_reserve_fini(zcc);
@@ -1409,6 +1951,135 @@ vos_zc_reserve(struct vos_zc_context *zcc, daos_size_t size)
 	return mmid;
 }
 
+/**
+ * Allocate DMA buffer for the \a idx-th extent of \a iobuf, the NVMe space
+ * is reserved and written by vos_obj_zc_update_end().
+ */
+static int
+akey_zc_nvme_stage(struct iod_buf *iobuf, int idx, daos_size_t size,
+		   void **addr)
+{
+	struct nvme_rec	*nrec;
+
+	if (iobuf->db_nvme_recs == NULL) {
+		D_ALLOC(iobuf->db_nvme_recs,
+			iobuf->db_mmid_nr * sizeof(*iobuf->db_nvme_recs));
+		if (iobuf->db_nvme_recs == NULL)
+			return -DER_NOMEM;
+	}
+
+	nrec = &iobuf->db_nvme_recs[idx];
+	nrec->nr_buf = vos_nvme_buf_alloc(size);
+	if (nrec->nr_buf == NULL)
+		return -DER_NOMEM;
+
+	nrec->nr_size = size;
+	*addr = nrec->nr_buf;
+	return 0;
+}
+
+/** Reserve NVMe space for a staged extent and write it out */
+static int
+vos_zcc_nvme_rec_write(struct vos_zc_context *zcc, struct nvme_rec *nrec)
+{
+	struct vos_pool		*pool = vos_obj2pool(zcc->zc_obj);
+	struct vea_resrvd_ext	*resrvd;
+	int			 rc;
+
+	if (nrec->nr_buf == NULL || nrec->nr_written)
+		return 0;
+
+	rc = vea_reserve(pool->vp_vea_info, vos_nvme_size2blks(nrec->nr_size),
+			 NULL, &zcc->zc_nvme_resrvd);
+	if (rc != 0) {
+		D_DEBUG(DB_IO, "Failed to reserve NVMe space: %d\n", rc);
+		return rc;
+	}
+
+	resrvd = d_list_entry(zcc->zc_nvme_resrvd.prev,
+			      struct vea_resrvd_ext, vre_link);
+	nrec->nr_blk_off = resrvd->vre_blk_off;
+
+	rc = vos_nvme_rw(pool, nrec->nr_blk_off, nrec->nr_buf, nrec->nr_size,
+			 true);
+	if (rc != 0) {
+		D_ERROR("Failed to write NVMe block "DF_U64": %d\n",
+			nrec->nr_blk_off, rc);
+		return rc;
+	}
+	nrec->nr_written = true;
+	return 0;
+}
+
+/**
+ * Reserve NVMe space for all the staged extents and write them out. This can
+ * yield, so it must be called before starting the PMDK transaction.
+ */
+static int
+vos_zcc_nvme_write(struct vos_zc_context *zcc)
+{
+	struct iod_buf		*iobuf;
+	int			 i;
+	int			 rc;
+
+	for (iobuf = &zcc->zc_iobufs[0];
+	     iobuf < &zcc->zc_iobufs[zcc->zc_iod_nr]; iobuf++) {
+		if (iobuf->db_nvme_recs == NULL)
+			continue;
+
+		for (i = 0; i < iobuf->db_mmid_nr; i++) {
+			rc = vos_zcc_nvme_rec_write(zcc,
+						    &iobuf->db_nvme_recs[i]);
+			if (rc != 0)
+				return rc;
+		}
+	}
+	return 0;
+}
+
+/** Flush the SCM record \a idx of \a iobuf if it hasn't been flushed */
+static void
+vos_zcc_scm_rec_flush(struct vos_zc_context *zcc, struct iod_buf *iobuf,
+		      unsigned int idx)
+{
+	daos_iov_t	*iov = &iobuf->db_sgl.sg_iovs[idx];
+
+	if (UMMID_IS_NULL(iobuf->db_mmids[idx]) || iov->iov_len == 0)
+		return;
+
+	if (iobuf->db_flushed != NULL && iobuf->db_flushed[idx])
+		return;
+
+	pmemobj_flush(vos_obj2pop(zcc->zc_obj), iov->iov_buf, iov->iov_len);
+	if (iobuf->db_flushed != NULL)
+		iobuf->db_flushed[idx] = true;
+}
+
+/**
+ * Flush all SCM records which haven't been flushed by vos_obj_zc_flush, the
+ * caller should drain the flushes before publishing the reservations.
+ */
+static void
+vos_zcc_scm_flush(struct vos_zc_context *zcc)
+{
+	struct iod_buf		*iobuf;
+	int			 i;
+
+	for (iobuf = &zcc->zc_iobufs[0];
+	     iobuf < &zcc->zc_iobufs[zcc->zc_iod_nr]; iobuf++) {
+		if (iobuf->db_mmids == NULL)
+			continue;
+
+		for (i = 0; i < iobuf->db_mmid_nr; i++) {
+			if (iobuf->db_nvme_recs != NULL &&
+			    iobuf->db_nvme_recs[i].nr_buf != NULL)
+				continue;
+
+			vos_zcc_scm_rec_flush(zcc, iobuf, i);
+		}
+	}
+}
+
 /**
  * Prepare pmem buffers for the zero-copy update.
  *
@@ -1445,8 +2116,14 @@ akey_zc_update_begin(struct vos_zc_context *zcc, int iod_idx)
 
 		if (iod->iod_type == DAOS_IOD_SINGLE) {
 			struct vos_irec_df *irec;
+			daos_csum_buf_t	   *csum = iod->iod_csums;
 
-			size = vos_recx2irec_size(iod->iod_size, NULL);
+			/* space for checksum should be reserved as well,
+			 * it is copied in by akey_update_single().
+			 */
+			if (csum != NULL && csum->cs_len == 0)
+				csum = NULL;
+			size = vos_recx2irec_size(iod->iod_size, csum);
 
 			mmid = vos_zc_reserve(zcc, size);
 			if (UMMID_IS_NULL(mmid))
@@ -1457,8 +2134,8 @@ akey_zc_update_begin(struct vos_zc_context *zcc, int iod_idx)
 			 */
 			irec = (struct vos_irec_df *)
 				umem_id2ptr(vos_obj2umm(obj), mmid);
-			irec->ir_cs_size = 0;
-			irec->ir_cs_type = 0;
+			irec->ir_cs_size = csum ? csum->cs_len : 0;
+			irec->ir_cs_type = csum ? csum->cs_type : 0;
 
 			addr = vos_irec2data(irec);
 			size = iod->iod_size;
@@ -1468,6 +2145,12 @@ akey_zc_update_begin(struct vos_zc_context *zcc, int iod_idx)
 			if (iod->iod_size == 0) {
 				mmid = UMMID_NULL;
 				addr = NULL;
+			} else if (vos_recx_on_nvme(obj, size * iod->iod_size)) {
+				size *= iod->iod_size;
+				rc = akey_zc_nvme_stage(iobuf, i, size, &addr);
+				if (rc != 0)
+					return rc;
+				mmid = UMMID_NULL;
 			} else {
 				size *= iod->iod_size;
 
@@ -1566,7 +2249,16 @@ vos_obj_zc_update_end(daos_handle_t ioh, uuid_t cookie, uint32_t pm_ver,
 	if (err != 0)
 		D_GOTO(out, err);
 
+	err = vos_zcc_nvme_write(zcc);
+	if (err != 0)
+		D_GOTO(out, err);
+
 	pop = vos_obj2pop(zcc->zc_obj);
+	/* flush the rest of records, then wait for all flushes including
+	 * those issued by vos_obj_zc_flush().
+	 */
+	vos_zcc_scm_flush(zcc);
+	pmemobj_drain(pop);
 
 	TX_BEGIN(pop) {
 		if (zcc->zc_actv_at != 0) {
@@ -1577,6 +2269,17 @@ vos_obj_zc_update_end(daos_handle_t ioh, uuid_t cookie, uint32_t pm_ver,
 		D_DEBUG(DB_IO, "Submit ZC update\n");
 		err = dkey_update(zcc->zc_obj, zcc->zc_epoch, cookie,
 				  pm_ver, dkey, iod_nr, iods, NULL, zcc);
+
+		if (err == 0 && !d_list_empty(&zcc->zc_nvme_resrvd))
+			err = vea_tx_publish(
+				vos_obj2pool(zcc->zc_obj)->vp_vea_info,
+				NULL, &zcc->zc_nvme_resrvd);
+
+		/* the reserved NVMe space will be cancelled, indices
+		 * referencing it must not be committed.
+		 */
+		if (err != 0 && !d_list_empty(&zcc->zc_nvme_resrvd))
+			pmemobj_tx_abort(EFAULT);
 	} TX_ONABORT {
 		err = umem_tx_errno(err);
 		D_DEBUG(DB_IO, "Failed to submit ZC update: %d\n", err);
@@ -1604,6 +2307,44 @@ vos_obj_zc_sgl_at(daos_handle_t ioh, unsigned int idx, daos_sg_list_t **sgl_pp)
 	return 0;
 }
 
+int
+vos_obj_zc_flush(daos_handle_t ioh, unsigned int idx, unsigned int rec,
+		 unsigned int nr)
+{
+	struct vos_zc_context	*zcc = vos_ioh2zcc(ioh);
+	struct iod_buf		*iobuf;
+	int			 i;
+	int			 rc;
+
+	D_ASSERT(zcc->zc_is_update);
+	if (idx >= zcc->zc_iod_nr)
+		return -DER_NONEXIST;
+
+	iobuf = &zcc->zc_iobufs[idx];
+	D_ASSERT(rec + nr <= iobuf->db_mmid_nr);
+
+	if (iobuf->db_flushed == NULL) {
+		D_ALLOC(iobuf->db_flushed,
+			iobuf->db_mmid_nr * sizeof(*iobuf->db_flushed));
+		if (iobuf->db_flushed == NULL)
+			return -DER_NOMEM;
+	}
+
+	for (i = rec; i < rec + nr; i++) {
+		if (iobuf->db_nvme_recs != NULL &&
+		    iobuf->db_nvme_recs[i].nr_buf != NULL) {
+			rc = vos_zcc_nvme_rec_write(zcc,
+						    &iobuf->db_nvme_recs[i]);
+			if (rc != 0)
+				return rc;
+			continue;
+		}
+
+		vos_zcc_scm_rec_flush(zcc, iobuf, i);
+	}
+	return 0;
+}
+
 /**
  * @} vos_obj_zio_func
  */
@@ -2183,10 +2924,70 @@ recx_iter_fetch(struct vos_obj_iter *oiter, vos_iter_entry_t *it_entry,
 	it_entry->ie_rsize	 = entry.en_inob;
 	uuid_copy(it_entry->ie_cookie, entry.en_cookie);
 	it_entry->ie_ver	= entry.en_ver;
+	it_entry->ie_csum	= entry.en_csum;
+	it_entry->ie_nvme	= (entry.en_flags & EVT_PTR_NVME) != 0;
+	/* NB: return address of the extent, no data copy */
+	if (entry.en_addr != NULL)
+		daos_iov_set(&it_entry->ie_iov, entry.en_addr,
+			     it_entry->ie_recx.rx_nr * entry.en_inob);
  out:
 	return rc;
 }
 
+static int
+recx_iter_copy(struct vos_obj_iter *oiter, daos_iov_t *iov)
+{
+	struct vos_pool	 *pool = vos_obj2pool(oiter->it_obj);
+	struct evt_entry  entry;
+	daos_size_t	  len;
+	daos_off_t	  off;
+	uint64_t	  blk_off;
+	void		 *buf;
+	int		  rc;
+
+	rc = evt_iter_fetch(oiter->it_hdl, &entry, NULL);
+	if (rc != 0)
+		return rc;
+
+	len = (entry.en_rect.rc_off_hi - entry.en_rect.rc_off_lo + 1) *
+	      entry.en_inob;
+	if (len > iov->iov_buf_len)
+		return -DER_TRUNC;
+
+	if (!(entry.en_flags & EVT_PTR_NVME)) {
+		if (entry.en_addr != NULL)
+			memcpy(iov->iov_buf, entry.en_addr, len);
+		iov->iov_len = entry.en_addr != NULL ? len : 0;
+		return 0;
+	}
+
+	if (!vos_pool_has_nvme(pool)) {
+		D_ERROR("Pool "DF_UUID" has NVMe extent but no NVMe device\n",
+			DP_UUID(pool->vp_id));
+		return -DER_IO;
+	}
+
+	/* same as akey_fetch_nvme(), the extent may start within a block */
+	off = entry.en_offset * entry.en_inob;
+	blk_off = entry.en_blk_off + off / VOS_NVME_BLK_SZ;
+	off %= VOS_NVME_BLK_SZ;
+
+	buf = vos_nvme_buf_alloc(off + len);
+	if (buf == NULL)
+		return -DER_NOMEM;
+
+	rc = vos_nvme_rw(pool, blk_off, buf, off + len, false);
+	if (rc == 0) {
+		memcpy(iov->iov_buf, buf + off, len);
+		iov->iov_len = len;
+	} else {
+		D_ERROR("Failed to read NVMe block "DF_U64": %d\n",
+			blk_off, rc);
+	}
+	vos_nvme_buf_free(buf);
+	return rc;
+}
+
 static int
 recx_iter_next(struct vos_obj_iter *oiter)
 {
@@ -2409,6 +3210,17 @@ vos_obj_iter_delete(struct vos_iterator *iter, void *args)
 	}
 }
 
+static int
+vos_obj_iter_copy(struct vos_iterator *iter, daos_iov_t *iov)
+{
+	struct vos_obj_iter *oiter = vos_iter2oiter(iter);
+
+	if (iter->it_type != VOS_ITER_RECX)
+		return -DER_NOSYS;
+
+	return recx_iter_copy(oiter, iov);
+}
+
 static int
 vos_obj_iter_empty(struct vos_iterator *iter)
 {
@@ -2437,6 +3249,7 @@ struct vos_iter_ops	vos_obj_iter_ops = {
 	.iop_next	= vos_obj_iter_next,
 	.iop_fetch	= vos_obj_iter_fetch,
 	.iop_delete	= vos_obj_iter_delete,
+	.iop_copy	= vos_obj_iter_copy,
 	.iop_empty	= vos_obj_iter_empty,
 };
 /**
@@ -81,6 +81,13 @@ vos_obj_release(struct daos_lru_cache *occ, struct vos_object *obj);
 int vos_obj_revalidate(struct daos_lru_cache *occ, daos_epoch_t epoch,
 		       struct vos_object **obj_p);
 
+/**
+ * Charge the DRAM consumed by the object and its open tree handle to the
+ * cache, it should be called by the holder of the object after opening or
+ * closing the handle.
+ */
+void vos_obj_cost_update(struct vos_object *obj);
+
 /** Evict an object reference from the cache */
 void vos_obj_evict(struct vos_object *obj);
 
@@ -173,4 +180,43 @@ int
 vos_oi_punch(struct vos_container *cont, daos_unit_oid_t oid,
 	     daos_epoch_t epoch, struct vos_obj_df *obj);
 
+/**
+ * Add \a epoch to the dirty epoch range of the object, so aggregation of any
+ * range covering \a epoch won't skip the object. It should be called within
+ * the transaction which modifies the object.
+ *
+ * \param umm	[IN]	Memory instance of the object
+ * \param obj	[IN]	Direct pointer to VOS object
+ * \param epoch	[IN]	Modified epoch
+ *
+ * \return		0 on success and negative on failure
+ */
+int
+vos_oi_dirty_mark(struct umem_instance *umm, struct vos_obj_df *obj,
+		  daos_epoch_t epoch);
+
+/**
+ * Shrink the dirty epoch range of the object after all epochs of \a epr are
+ * aggregated. It starts its own transaction.
+ *
+ * \param umm	[IN]	Memory instance of the object
+ * \param obj	[IN]	Direct pointer to VOS object
+ * \param epr	[IN]	Aggregated epoch range
+ *
+ * \return		0 on success and negative on failure
+ */
+int
+vos_oi_dirty_clear(struct umem_instance *umm, struct vos_obj_df *obj,
+		   daos_epoch_range_t *epr);
+
+/** Has the object been modified within \a epr since its last aggregation? */
+static inline bool
+vos_oi_is_dirty(struct vos_obj_df *obj, daos_epoch_range_t *epr)
+{
+	daos_epoch_range_t *dirty = &obj->vo_dirty_epr;
+
+	return dirty->epr_lo != 0 && dirty->epr_lo <= epr->epr_hi &&
+	       dirty->epr_hi >= epr->epr_lo;
+}
+
 #endif
@@ -29,8 +29,7 @@
  * LRU cache implementation:
  * Simple LRU based object cache for Object index table
  * Uses a hashtable and a doubly linked list to set and get
- * entries. The size of both hashtable and linked list are
- * fixed length.
+ * entries. The cache is per xstream, so it has no locking.
  *
  * Author: Vishwanath Venkatesan <vishwanath.venkatesan@intel.com>
  */
@@ -62,6 +61,7 @@ obj_lop_alloc(void *key, unsigned int ksize, void *args,
 	struct vos_object	*obj;
 	struct obj_lru_key	*lkey;
 	struct vos_container	*cont;
+	struct vos_ocache_stat	*stat;
 	int			 rc;
 
 	cont = (struct vos_container *)args;
@@ -82,8 +82,15 @@ obj_lop_alloc(void *key, unsigned int ksize, void *args,
 	 */
 	obj->obj_id	= lkey->olk_obj_id;
 	obj->obj_cont	= cont;
+	/* the tree handle is charged once it is opened */
+	obj->obj_llink.ll_cost = sizeof(*obj);
 	vos_cont_addref(cont);
 
+	stat = &cont->vc_pool->vp_ocache_stat;
+	stat->os_misses++;
+	stat->os_nr++;
+	stat->os_cost += obj->obj_llink.ll_cost;
+
 	*llink_p = &obj->obj_llink;
 	rc = 0;
 failed:
@@ -116,8 +123,16 @@ obj_lop_free(struct daos_llink *llink)
 	D_ASSERT(llink);
 
 	obj = container_of(llink, struct vos_object, obj_llink);
-	if (obj->obj_cont != NULL)
+	if (obj->obj_cont != NULL) {
+		struct vos_ocache_stat *stat;
+
+		stat = &obj->obj_cont->vc_pool->vp_ocache_stat;
+		if (llink->ll_evicted)
+			stat->os_evictions++;
+		stat->os_nr--;
+		stat->os_cost -= llink->ll_cost;
 		vos_cont_decref(obj->obj_cont);
+	}
 
 	vos_obj_tree_fini(obj);
 	D_FREE_PTR(obj);
@@ -143,13 +158,31 @@ static struct daos_llink_ops obj_lru_ops = {
 int
 vos_obj_cache_create(int32_t cache_size, struct daos_lru_cache **occ)
 {
-	int	rc;
+	char		*env;
+	uint64_t	 budget = 0;
+	int		 rc;
 
 	D_DEBUG(DB_TRACE, "Creating an object cache %d\n", (1 << cache_size));
 	rc = daos_lru_cache_create(cache_size, D_HASH_FT_NOLOCK,
 				   &obj_lru_ops, occ);
-	if (rc)
+	if (rc) {
 		D_ERROR("Error in creating lru cache: %d\n", rc);
+		return rc;
+	}
+
+	env = getenv("VOS_OBJ_CACHE_MB");
+	if (env != NULL)
+		budget = strtoull(env, NULL, 10) << 20;
+
+	/* NB: enumeration and rebuild touch each object once, objects are
+	 * only promoted if they are accessed again, so these scans can't
+	 * flush objects of the I/O working set.
+	 */
+	rc = daos_lru_cache_config(*occ, budget, DAOS_LRU_POL_2Q);
+	if (rc) {
+		daos_lru_cache_destroy(*occ);
+		*occ = NULL;
+	}
 	return rc;
 }
 
@@ -206,7 +239,9 @@ vos_obj_hold(struct daos_lru_cache *occ, daos_handle_t coh,
 	struct vos_object	*obj = NULL;
 	struct daos_llink	*lret = NULL;
 	struct vos_container	*cont;
+	struct vos_ocache_stat	*stat;
 	struct obj_lru_key	 lkey;
+	uint64_t		 misses;
 	int			 rc;
 
 	D_ASSERT(occ != NULL);
@@ -220,11 +255,17 @@ vos_obj_hold(struct daos_lru_cache *occ, daos_handle_t coh,
 	uuid_copy(lkey.olk_co_uuid, cont->vc_id);
 	lkey.olk_obj_id = oid;
 
+	stat = &cont->vc_pool->vp_ocache_stat;
 	while (1) {
+		/* misses are counted by obj_lop_alloc() */
+		misses = stat->os_misses;
 		rc = daos_lru_ref_hold(occ, &lkey, sizeof(lkey), cont, &lret);
 		if (rc)
 			D_GOTO(failed, rc);
 
+		if (stat->os_misses == misses)
+			stat->os_hits++;
+
 		obj = container_of(lret, struct vos_object, obj_llink);
 		if (!obj->obj_df) /* empty object */
 			break;
@@ -268,6 +309,22 @@ failed:
 	return	rc;
 }
 
+void
+vos_obj_cost_update(struct vos_object *obj)
+{
+	uint32_t	cost = sizeof(*obj);
+
+	if (!daos_handle_is_inval(obj->obj_toh))
+		cost += dbtree_hdl_size(obj->obj_toh);
+
+	if (cost != obj->obj_llink.ll_cost) {
+		obj->obj_cont->vc_pool->vp_ocache_stat.os_cost +=
+			(int64_t)cost - obj->obj_llink.ll_cost;
+		daos_lru_ref_cost_set(vos_obj_cache_current(),
+				      &obj->obj_llink, cost);
+	}
+}
+
 void
 vos_obj_evict(struct vos_object *obj)
 {
@@ -305,6 +305,60 @@ vos_oi_punch(struct vos_container *cont, daos_unit_oid_t oid,
 	return rc;
 }
 
+int
+vos_oi_dirty_mark(struct umem_instance *umm, struct vos_obj_df *obj,
+		  daos_epoch_t epoch)
+{
+	daos_epoch_range_t	*dirty = &obj->vo_dirty_epr;
+	int			 rc;
+
+	if (dirty->epr_lo != 0 && dirty->epr_lo <= epoch &&
+	    dirty->epr_hi >= epoch)
+		return 0; /* already covered, the common case */
+
+	rc = umem_tx_add_ptr(umm, dirty, sizeof(*dirty));
+	if (rc != 0)
+		return rc;
+
+	if (dirty->epr_lo == 0 || dirty->epr_lo > epoch)
+		dirty->epr_lo = epoch;
+	if (dirty->epr_hi < epoch)
+		dirty->epr_hi = epoch;
+	return 0;
+}
+
+int
+vos_oi_dirty_clear(struct umem_instance *umm, struct vos_obj_df *obj,
+		   daos_epoch_range_t *epr)
+{
+	daos_epoch_range_t	*dirty = &obj->vo_dirty_epr;
+	int			 rc;
+
+	/* Nothing to clear, or modifications before \a epr are still not
+	 * aggregated.
+	 */
+	if (dirty->epr_lo == 0 || dirty->epr_lo < epr->epr_lo)
+		return 0;
+
+	rc = umem_tx_begin(umm);
+	if (rc != 0)
+		return rc;
+
+	rc = umem_tx_add_ptr(umm, dirty, sizeof(*dirty));
+	if (rc != 0) {
+		umem_tx_abort(umm, rc);
+		return rc;
+	}
+
+	if (dirty->epr_hi <= epr->epr_hi) {
+		dirty->epr_lo = dirty->epr_hi = 0;
+	} else {
+		/* epochs above \a epr are still dirty */
+		dirty->epr_lo = epr->epr_hi + 1;
+	}
+	return umem_tx_commit(umm);
+}
+
 static struct vos_oid_iter *
 iter2oiter(struct vos_iterator *iter)
 {
@@ -70,6 +70,8 @@ pool_hop_free(struct d_ulink *hlink)
 	if (!daos_handle_is_inval(pool->vp_cont_th))
 		dbtree_close(pool->vp_cont_th);
 
+	vos_nvme_pool_close(pool);
+
 	if (pool->vp_uma.uma_u.pmem_pool)
 		vos_pmemobj_close(pool->vp_uma.uma_u.pmem_pool);
 
@@ -153,7 +155,8 @@ pool_lookup(struct d_uuid *ukey, struct vos_pool **pool)
  * Create a Versioning Object Storage Pool (VOSP) and its root object.
  */
 int
-vos_pool_create(const char *path, uuid_t uuid, daos_size_t size)
+vos_pool_create(const char *path, uuid_t uuid, daos_size_t size,
+		daos_size_t nvme_size)
 {
 	PMEMobjpool	*ph;
 	int		 rc = 0;
@@ -161,8 +164,8 @@ vos_pool_create(const char *path, uuid_t uuid, daos_size_t size)
 	if (!path || uuid_is_null(uuid))
 		return -DER_INVAL;
 
-	D_DEBUG(DB_MGMT, "Pool Path: %s, size: "DF_U64",UUID: "DF_UUID"\n",
-		path, size, DP_UUID(uuid));
+	D_DEBUG(DB_MGMT, "Pool Path: %s, size: "DF_U64", NVMe size: "DF_U64
+		", UUID: "DF_UUID"\n", path, size, nvme_size, DP_UUID(uuid));
 
 	/* Path must be a file with a certain size when size argument is 0 */
 	if (!size && access(path, F_OK) == -1) {
@@ -208,6 +211,8 @@ vos_pool_create(const char *path, uuid_t uuid, daos_size_t size)
 		pool_df->pd_pool_info.pif_size  = size;
 		/* XXX we don't really maintain the available size */
 		pool_df->pd_pool_info.pif_avail = size - pmemobj_root_size(ph);
+		/* NB: the blob is created by the first vos_pool_open() */
+		pool_df->pd_nvme_size = nvme_size;
 
 	} TX_ONABORT {
 		rc = umem_tx_errno(rc);
@@ -250,6 +255,11 @@ vos_pool_destroy(const char *path, uuid_t uuid)
 	}
 
 	D_DEBUG(DB_MGMT, "No open handles. OK to destroy\n");
+
+	rc = vos_nvme_pool_destroy(path);
+	if (rc) /* don't fail the destroy, but the space is leaked */
+		D_ERROR("Failed to delete NVMe blob of %s: %d\n", path, rc);
+
 	/**
 	 * NB: no need to explicitly destroy container index table because
 	 * pool file removal will do this for free.
@@ -359,6 +369,12 @@ vos_pool_open(const char *path, uuid_t uuid, daos_handle_t *poh)
 		D_GOTO(failed, rc);
 	}
 
+	rc = vos_nvme_pool_open(pool, path);
+	if (rc) {
+		D_ERROR("Failed to open NVMe blob: %d\n", rc);
+		D_GOTO(failed, rc);
+	}
+
 	/* Insert the opened pool to the uuid hash table */
 	rc = pool_link(pool, &ukey, poh);
 	if (rc) {
@@ -413,6 +429,9 @@ vos_pool_query(daos_handle_t poh, vos_pool_info_t *pinfo)
 		return -DER_NONEXIST;
 
 	pool_df = vos_pool_ptr2df(pool);
-	memcpy(pinfo, &pool_df->pd_pool_info, sizeof(pool_df->pd_pool_info));
+	pinfo->pif_cont_nr = pool_df->pd_pool_info.pif_cont_nr;
+	pinfo->pif_size	   = pool_df->pd_pool_info.pif_size;
+	pinfo->pif_avail   = pool_df->pd_pool_info.pif_avail;
+	pinfo->pif_ocache  = pool->vp_ocache_stat;
 	return 0;
 }
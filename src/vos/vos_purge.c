@@ -450,7 +450,8 @@ recx_max_iter_probe(int opc, vos_iter_entry_t *ent, vos_iter_entry_t *ent_max,
 /**
  * core function of aggregation, similar to discard recursively enter
  * different trees and delete the leaf record or retain based on the
- * epoch in the epoch-range. recx aggregation is done in recx_epoch_aggregate
+ * epoch in the epoch-range. recx aggregation is done by
+ * vos_obj_recx_aggregate after the single values of an akey.
  */
 int
 epoch_aggregate(struct purge_context *pcx, int *empty_ret,
@@ -523,6 +524,7 @@ epoch_aggregate(struct purge_context *pcx, int *empty_ret,
 		char			*opstr;
 		int			empty = 0;
 		bool			max_reset = false;
+		bool			recx_done = false;
 		bool			it_first = (opc & ITR_PROBE_FIRST);
 		bool			it_reuse = (opc & ITR_REUSE_ANCHOR);
 		bool			it_next  = (opc & ITR_NEXT);
@@ -616,7 +618,29 @@ epoch_aggregate(struct purge_context *pcx, int *empty_ret,
 			if (rc != 0)
 				D_GOTO(out, rc);
 
-			if (!credits) { /* credits used up by subtree return */
+			/* single values of the akey are done, aggregate its
+			 * array as well, the akey can't be deleted if the
+			 * array isn't empty.
+			 */
+			if (pcx->pc_type == VOS_ITER_AKEY && credits) {
+				bool	recx_empty;
+
+				rc = vos_obj_recx_aggregate(pcx->pc_obj,
+						&pcx->pc_param.ip_epr,
+						&pcx->pc_param.ip_dkey,
+						&ent.ie_key, &credits,
+						&recx_empty);
+				if (rc != 0)
+					D_GOTO(out, rc);
+				if (!recx_empty)
+					empty = 0;
+				recx_done = true;
+			}
+
+			/* credits used up by subtree return, the akey is
+			 * finished if its array has been aggregated.
+			 */
+			if (!credits && !recx_done) {
 				purge_ctx_anchor_ctl(pcx, vp_anchor, &anchor,
 						     ANCHOR_SET);
 				D_GOTO(out, rc);
@@ -850,6 +874,7 @@ vos_epoch_aggregate(daos_handle_t coh, daos_unit_oid_t oid,
 {
 	int			rc = 0;
 	struct purge_context	pcx;
+	struct vos_obj_df	*obj_df;
 	vos_iter_entry_t	oid_entry;
 	vos_cont_info_t		vc_info;
 
@@ -903,7 +928,26 @@ vos_epoch_aggregate(daos_handle_t coh, daos_unit_oid_t oid,
 	rc = purge_ctx_init(&pcx, &oid_entry);
 	D_ASSERT(rc == 0);
 
+	obj_df = pcx.pc_obj->obj_df;
+	if (!(anchor->pa_mask & DKEY_ANCHOR)) {
+		/* start of the object, skip it if not modified in the range
+		 * since its last aggregation.
+		 */
+		anchor->pa_skipped = (obj_df == NULL ||
+				      !vos_oi_is_dirty(obj_df, epr));
+		if (anchor->pa_skipped) {
+			D_DEBUG(DB_EPC, "Skip clean object "DF_UOID"\n",
+				DP_UOID(oid));
+			anchor->pa_mask |= DKEY_SCAN_COMPLETE;
+			*finished = true;
+			D_GOTO(out, rc = 0);
+		}
+	}
+
 	rc = epoch_aggregate(&pcx, NULL, credits, anchor, finished);
+	if (rc == 0 && *finished)
+		rc = vos_oi_dirty_clear(vos_obj2umm(pcx.pc_obj), obj_df, epr);
+out:
 	purge_ctx_fini(&pcx, rc);
 	return rc;
 }
@@ -384,7 +384,7 @@ kb_rec_alloc(struct btr_instance *tins, daos_iov_t *key_iov,
 	D_DEBUG(DB_TRACE, "Create evtree\n");
 
 	rc = evt_create_inplace(EVT_FEAT_DEFAULT, VOS_EVT_ORDER, &uma,
-				&krec->kr_evt[0], &evt_oh);
+				&vos_evt_desc_cbs, &krec->kr_evt[0], &evt_oh);
 	if (rc != 0) {
 		D_ERROR("Failed to create evtree: %d\n", rc);
 		D_GOTO(out, rc);
@@ -428,7 +428,8 @@ kb_rec_free(struct btr_instance *tins, struct btr_record *rec, void *args)
 	}
 
 	if ((krec->kr_bmap & KREC_BF_EVT) && krec->kr_evt[0].tr_order) {
-		rc = evt_open_inplace(&krec->kr_evt[0], &uma, &toh);
+		rc = evt_open_inplace(&krec->kr_evt[0], &uma,
+				      &vos_evt_desc_cbs, &toh);
 		if (rc != 0)
 			D_ERROR("Failed to open evtree: %d\n", rc);
 		else
@@ -749,6 +750,12 @@ static btr_ops_t singv_btr_ops = {
 /**
  * @} vos_singv_btr
  */
+
+/**
+ * NB: dkey and akey trees can't have BTR_FEAT_KEY_ARRAY, their hkeys carry
+ * epochs and are ordered by kb_hkey_cmp() instead of memcmp, or they are
+ * direct keys.
+ */
 static struct vos_btr_attr vos_btr_attrs[] = {
 	{
 		.ta_class	= VOS_BTR_DKEY,
@@ -815,6 +822,9 @@ vos_obj_tree_init(struct vos_object *obj)
 		rc = dbtree_open_inplace(&obj->obj_df->vo_tree,
 					 vos_obj2uma(obj), &obj->obj_toh);
 	}
+
+	if (rc == 0)
+		vos_obj_cost_update(obj);
 	return rc;
 }
 
@@ -829,6 +839,7 @@ vos_obj_tree_fini(struct vos_object *obj)
 		D_ASSERT(obj->obj_df);
 		rc = dbtree_close(obj->obj_toh);
 		obj->obj_toh = DAOS_HDL_INVAL;
+		/* NB: it is called by obj_lop_free, nothing to charge */
 	}
 	return rc;
 }
@@ -100,4 +100,29 @@ class DaosTest(object):
 
         return rc
 
+    def test_batch(self):
+        """ Run the I/O tests of daos_test with batching of small updates. """
+        rc = 1
+        urifilepath = self.test_info.get_defaultENV("DAOS_TEST_DIR", "") + "/urifile"
 
+        self.logger.info("<DAOS TEST> Starting batching test.")
+        testname = self.test_info.get_test_info('testName') + "_batch"
+        testlog = os.path.join(self.log_dir_base, testname)
+
+        prefix = self.test_info.get_defaultENV('ORT_PATH', "")
+        parameters = "--np 1 --ompi-server file:" + urifilepath
+
+        envlist = self.setup_env()
+        envlist['DAOS_OBJ_BATCH'] = "1"
+
+        nodes = NodeControlRunner.NodeControlRunner(testlog, self.test_info)
+        daos_test_cmd = nodes.start_cmd_list(self.log_dir_base, testname, prefix)
+        daos_test_cmd.add_param(parameters)
+        daos_test_cmd.add_env_vars(envlist)
+        daos_test_cmd.add_cmd("daos_test -i")
+
+        daos_test_cmd.start_process()
+        if daos_test_cmd.check_process():
+            rc = daos_test_cmd.wait_process(4000)
+
+        return rc